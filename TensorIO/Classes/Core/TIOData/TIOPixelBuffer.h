@@ -46,6 +46,9 @@ NS_ASSUME_NONNULL_BEGIN
 /**
  * The pixel buffer as an input tensor sees it, with scaling, cropping, and pixel formatting applied,
  * but prior to any normalization or removal of the alpha channel. `NULL` for an output.
+ *
+ * When the vision pipeline transformed the pixel buffer directly into the tensor, the transformed
+ * pixel buffer is created the first time it is read.
  */
 
 @property (readonly) CVPixelBufferRef transformedPixelBuffer;
@@ -19,12 +19,15 @@
 //
 
 #import "TIOPixelBuffer.h"
+#import "TIOPixelBufferLayerDescription.h"
+#import "TIOVisionPipeline.h"
 
 @interface TIOPixelBuffer()
 
 @property (readwrite) CVPixelBufferRef pixelBuffer;
 @property (readwrite) CVPixelBufferRef transformedPixelBuffer;
 @property (readwrite) CGImagePropertyOrientation orientation;
+@property (nullable) TIOPixelBufferLayerDescription *transformDescription;
 
 @end
 
@@ -44,4 +47,31 @@
     CVPixelBufferRelease(_transformedPixelBuffer);
 }
 
+/**
+ * When the vision pipeline transformed the pixel buffer straight into a tensor there is no
+ * transformed pixel buffer until one is asked for, so it is created with the pipeline of the
+ * layer it was written to.
+ */
+
+- (CVPixelBufferRef)transformedPixelBuffer {
+    @synchronized (self) {
+        if ( _transformedPixelBuffer == NULL && _transformDescription != nil ) {
+            _transformedPixelBuffer = [_transformDescription.visionPipeline transform:_pixelBuffer orientation:_orientation];
+            CVPixelBufferRetain(_transformedPixelBuffer);
+        }
+        return _transformedPixelBuffer;
+    }
+}
+
+/**
+ * Takes ownership of a retained pixel buffer, releasing the one it replaces.
+ */
+
+- (void)setTransformedPixelBuffer:(CVPixelBufferRef)transformedPixelBuffer {
+    @synchronized (self) {
+        CVPixelBufferRelease(_transformedPixelBuffer);
+        _transformedPixelBuffer = transformedPixelBuffer;
+    }
+}
+
 @end
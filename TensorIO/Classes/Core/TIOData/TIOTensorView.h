@@ -0,0 +1,131 @@
+//
+//  TIOTensorView.h
+//  TensorIO
+//
+//  Created by Phil Dow on 10/17/20.
+//  Copyright © 2020 doc.ai (http://doc.ai)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+#import "TIOData.h"
+#import "TIODataTypes.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class TIOTensorView;
+@class TIOLayerInterface;
+
+/**
+ * Converts the bytes of a tensor view to the boxed `TIOData` a model would
+ * ordinarily return for that output, e.g. an `NSArray` of `NSNumber`, a labeled
+ * `NSDictionary`, or a `TIOPixelBuffer`. Supplied by the backend.
+ */
+
+typedef _Nullable id<TIOData> (^TIOTensorViewConverter)(TIOTensorView *view);
+
+/**
+ * A typed, read-only view onto the bytes of an output tensor.
+ *
+ * A view does not copy the tensor's bytes. It is only valid until the model which
+ * produced it reuses the underlying tensor, after which `bytes` returns `NULL`. Call
+ * `copy` to acquire a view that owns a copy of the bytes and remains valid indefinitely.
+ * Copying a view that is no longer valid returns a view that is also invalid.
+ *
+ * Boxing the bytes into Objective-C objects is deferred until `data` is called.
+ */
+
+@interface TIOTensorView : NSObject <TIOData, NSCopying>
+
+/**
+ * The interface of the layer whose bytes this view exposes.
+ */
+
+@property (readonly) TIOLayerInterface *interface;
+
+/**
+ * The shape of the underlying tensor, including any batch dimension.
+ */
+
+@property (readonly) NSArray<NSNumber*> *shape;
+
+/**
+ * The data type of the underlying bytes.
+ */
+
+@property (readonly) TIODataType dtype;
+
+/**
+ * A pointer to the underlying bytes, or `NULL` once the view has been invalidated.
+ */
+
+@property (readonly, nullable) const void *bytes;
+
+/**
+ * The number of bytes in the view.
+ */
+
+@property (readonly) size_t length;
+
+/**
+ * The number of elements in the view, i.e. the product of its shape.
+ */
+
+@property (readonly) NSUInteger count;
+
+/**
+ * `YES` while `bytes` may be read, `NO` once the model has reused the underlying tensor.
+ */
+
+@property (readonly, getter=isValid) BOOL valid;
+
+/**
+ * Creates a view onto bytes owned by someone else, typically a tensor.
+ *
+ * @param bytes The bytes to view, which are not copied.
+ * @param length The number of bytes.
+ * @param shape The shape of the tensor.
+ * @param dtype The data type of the bytes.
+ * @param interface The interface of the layer the bytes belong to.
+ * @param converter A block that boxes the bytes into `TIOData`.
+ *
+ * @return instancetype A read-only view onto the bytes.
+ */
+
+- (instancetype)initWithBytes:(const void *)bytes length:(size_t)length shape:(NSArray<NSNumber*> *)shape dtype:(TIODataType)dtype interface:(TIOLayerInterface *)interface converter:(TIOTensorViewConverter)converter NS_DESIGNATED_INITIALIZER;
+
+/**
+ * Use the designated initializer.
+ */
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ * Boxes the bytes into the `TIOData` the model would otherwise have returned
+ * for this output. The result is computed once and cached.
+ */
+
+- (nullable id<TIOData>)data;
+
+/**
+ * Invalidates the view. Called by the model before it reuses the underlying tensor.
+ * Has no effect on a view that owns its bytes.
+ */
+
+- (void)invalidate;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,102 @@
+//
+//  TIOTensorView.m
+//  TensorIO
+//
+//  Created by Phil Dow on 10/17/20.
+//  Copyright © 2020 doc.ai (http://doc.ai)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "TIOTensorView.h"
+
+#import <stdatomic.h>
+
+@implementation TIOTensorView {
+    _Atomic(const void *) _bytes; // may be invalidated on a different thread than the one reading it
+    NSData *_ownedData;
+    TIOTensorViewConverter _converter;
+    id<TIOData> _data;
+}
+
+- (instancetype)initWithBytes:(const void *)bytes length:(size_t)length shape:(NSArray<NSNumber*> *)shape dtype:(TIODataType)dtype interface:(TIOLayerInterface *)interface converter:(TIOTensorViewConverter)converter {
+    if (self = [super init]) {
+        atomic_init(&_bytes, bytes);
+        _length = length;
+        _shape = shape;
+        _dtype = dtype;
+        _interface = interface;
+        _converter = converter;
+
+        NSUInteger count = 1;
+        for (NSNumber *dim in shape) {
+            count *= dim.unsignedIntegerValue;
+        }
+        _count = count;
+    }
+    return self;
+}
+
+- (id)copyWithZone:(NSZone *)zone {
+    if (_ownedData != nil) {
+        return self;
+    }
+
+    // An invalidated view has no bytes to copy and stays invalid
+
+    const void *bytes = self.bytes;
+
+    if (bytes == NULL) {
+        return self;
+    }
+
+    NSData *data = [NSData dataWithBytes:bytes length:_length];
+
+    TIOTensorView *view = [[TIOTensorView alloc] initWithBytes:data.bytes length:_length shape:_shape dtype:_dtype interface:_interface converter:_converter];
+    view->_ownedData = data;
+
+    return view;
+}
+
+- (nullable const void *)bytes {
+    return atomic_load(&_bytes);
+}
+
+- (BOOL)isValid {
+    return self.bytes != NULL;
+}
+
+- (void)invalidate {
+    if (_ownedData != nil) {
+        return;
+    }
+
+    atomic_store(&_bytes, NULL);
+}
+
+- (nullable id<TIOData>)data {
+    if (_data != nil) {
+        return _data;
+    }
+
+    NSAssert(self.isValid, @"Cannot read an invalidated tensor view, copy the view to keep its bytes");
+
+    if (!self.isValid) {
+        return nil;
+    }
+
+    _data = _converter(self);
+    return _data;
+}
+
+@end
@@ -30,7 +30,9 @@ typedef enum : NSUInteger {
     TIODataTypeUInt8,       // "uint8"
     TIODataTypeFloat32,     // "float32"
     TIODataTypeInt32,       // "int32"
-    TIODataTypeInt64        // "int64"
+    TIODataTypeInt64,       // "int64"
+    TIODataTypeFloat16,     // "float16"
+    TIODataTypeInt8         // "int8"
 } TIODataType;
 
 NSUInteger TIOByteSizeOfDataType(TIODataType dtype);
@@ -32,5 +32,9 @@ NSUInteger TIOByteSizeOfDataType(TIODataType dtype) {
         return 4;
     case TIODataTypeInt64:
         return 8;
+    case TIODataTypeFloat16:
+        return 2;
+    case TIODataTypeInt8:
+        return 1;
     }
 }
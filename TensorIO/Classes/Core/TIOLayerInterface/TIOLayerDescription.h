@@ -35,7 +35,8 @@ NS_ASSUME_NONNULL_BEGIN
 @protocol TIOLayerDescription <NSObject>
 
 /**
- * `YES` if this data is quantized (bytes of type uint8_t), `NO` if not (bytes of type float_t)
+ * `YES` if this data is quantized (bytes of type uint8_t, or int8_t for an int8 layer), `NO` if not
+ * (bytes of type float_t)
  */
 
 @property (readonly, getter=isQuantized) BOOL quantized;
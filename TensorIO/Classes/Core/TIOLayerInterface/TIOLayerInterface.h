@@ -149,6 +149,14 @@ typedef enum : NSUInteger {
 
 @property (nullable, readonly) NSDictionary *JSON;
 
+/**
+ * The underlying layer description. Use `matchCasePixelBuffer:caseVector:caseString:caseScalar:`
+ * to work with a specific kind of description, or this property to read attributes shared by all
+ * descriptions, such as the shape and whether the layer is batched.
+ */
+
+@property (readonly) id<TIOLayerDescription> layerDescription;
+
 // MARK: -
 
 /**
@@ -33,7 +33,6 @@ typedef enum : NSUInteger {
 } TIOLayerInterfaceType;
 
 @implementation TIOLayerInterface {
-    id<TIOLayerDescription> _layerDescription;
     TIOLayerInterfaceType _type;
 }
 
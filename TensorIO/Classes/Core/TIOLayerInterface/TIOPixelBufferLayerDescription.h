@@ -23,9 +23,12 @@
 
 #import "TIOLayerDescription.h"
 #import "TIOVisionModelHelpers.h"
+#import "TIODataTypes.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
+@class TIOVisionPipeline;
+
 /**
  * The description of a pixel buffer input or output layer.
  */
@@ -67,6 +70,15 @@ NS_ASSUME_NONNULL_BEGIN
 
 @property (readonly) TIOImageVolume imageVolume;
 
+/**
+ * The type of the tensor's values. `TIODataTypeUnknown` for the default, which is float32 for
+ * an unquantized layer and uint8 for a quantized one. `TIODataTypeFloat16` stores normalized
+ * pixel values in half precision. `TIODataTypeInt8` stores pixel values offset by -128, or
+ * normalized values clamped to `[-128,127]` when the layer has a normalizer.
+ */
+
+@property (readonly) TIODataType dtype;
+
 /**
  * A function that normalizes pixel values from a uint8_t range of `[0,255]` to some other
  * floating point range, may be `nil`.
@@ -81,6 +93,50 @@ NS_ASSUME_NONNULL_BEGIN
 
 @property (nullable, readonly) TIOPixelDenormalizer denormalizer ;
 
+/**
+ * The scale and channel biases applied by the normalizer, which pixel conversion uses to
+ * normalize whole rows of pixels at once. `kTIOPixelNormalizationNone` when there is no
+ * normalizer and `kTIOPixelNormalizationInvalid` when the normalizer is a custom function,
+ * in which case the function is called for every value.
+ */
+
+@property (readonly) TIOPixelNormalization normalization;
+
+/**
+ * The scale and channel biases applied by the denormalizer. `kTIOPixelDenormalizationNone`
+ * when there is no denormalizer and `kTIOPixelDenormalizationInvalid` when the denormalizer
+ * is a custom function.
+ */
+
+@property (readonly) TIOPixelDenormalization denormalization;
+
+/**
+ * How an input pixel buffer is fit to the layer when its size or aspect ratio differs.
+ * Defaults to `TIOPixelBufferResizeModeCenterCrop`.
+ */
+
+@property (readonly) TIOPixelBufferResizeMode resizeMode;
+
+/**
+ * How an input pixel buffer is sampled when it is scaled. Defaults to
+ * `TIOPixelBufferInterpolationLanczos`, the `vImageScale_ARGB8888` resize used by earlier
+ * versions of TensorIO, so existing models receive the same values. The other interpolations
+ * must be requested explicitly.
+ */
+
+@property (readonly) TIOPixelBufferInterpolation interpolation;
+
+/**
+ * The vision pipeline that transforms pixel buffers for this layer, created the first time it
+ * is used and shared by every pixel buffer written to the layer, so that its resampling
+ * coefficients are computed once for each source geometry rather than for every frame.
+ *
+ * The pipeline does not retain this description, so keep a reference to the description for as
+ * long as you use its pipeline.
+ */
+
+@property (readonly) TIOVisionPipeline *visionPipeline;
+
 // MARK: - Init
 
 /**
@@ -91,6 +147,7 @@ NS_ASSUME_NONNULL_BEGIN
  * @param shape The shape of the underlying tensor
  * @param imageVolume The shape of the image volume
  * @param batched `YES` if this tensor has a dimension for the batch size
+ * @param dtype The type of the tensor's values, `TIODataTypeUnknown` for the default
  * @param normalizer A function which normalizes the pixel values for an input layer, may be `nil`.
  * @param denormalizer A function which denormalizes pixel values for an output layer, may be `nil`
  * @param quantized `YES` if this layer expectes quantized values, `NO` otherwise
@@ -102,11 +159,70 @@ NS_ASSUME_NONNULL_BEGIN
     shape:(NSArray<NSNumber*>*)shape
     imageVolume:(TIOImageVolume)imageVolume
     batched:(BOOL)batched
+    dtype:(TIODataType)dtype
     normalizer:(nullable TIOPixelNormalizer)normalizer
     denormalizer:(nullable TIOPixelDenormalizer)denormalizer
     quantized:(BOOL)quantized
     NS_DESIGNATED_INITIALIZER;
 
+/**
+ * Creates a pixel buffer description that normalizes and denormalizes pixel values with a scale
+ * and channel biases rather than with custom functions.
+ *
+ * @param pixelFormat The expected format of the pixels
+ * @param shape The shape of the underlying tensor
+ * @param imageVolume The shape of the image volume
+ * @param batched `YES` if this tensor has a dimension for the batch size
+ * @param dtype The type of the tensor's values, `TIODataTypeUnknown` for the default
+ * @param normalization The normalization for an input layer, `kTIOPixelNormalizationNone` for none
+ * @param denormalization The denormalization for an output layer, `kTIOPixelDenormalizationNone` for none
+ * @param quantized `YES` if this layer expectes quantized values, `NO` otherwise
+ *
+ * @return instancetype A read-only instance of `TIOPixelBufferLayerDescription`
+ */
+
+- (instancetype)initWithPixelFormat:(OSType)pixelFormat
+    shape:(NSArray<NSNumber*>*)shape
+    imageVolume:(TIOImageVolume)imageVolume
+    batched:(BOOL)batched
+    dtype:(TIODataType)dtype
+    normalization:(TIOPixelNormalization)normalization
+    denormalization:(TIOPixelDenormalization)denormalization
+    quantized:(BOOL)quantized;
+
+/**
+ * Creates a pixel buffer description with a scale and channel biases and with the resize mode
+ * and interpolation used to fit input pixel buffers to the layer.
+ *
+ * @param resizeMode How input pixel buffers are fit to the layer
+ * @param interpolation How input pixel buffers are sampled when they are scaled
+ *
+ * @see -initWithPixelFormat:shape:imageVolume:batched:dtype:normalization:denormalization:quantized:
+ */
+
+- (instancetype)initWithPixelFormat:(OSType)pixelFormat
+    shape:(NSArray<NSNumber*>*)shape
+    imageVolume:(TIOImageVolume)imageVolume
+    batched:(BOOL)batched
+    dtype:(TIODataType)dtype
+    normalization:(TIOPixelNormalization)normalization
+    denormalization:(TIOPixelDenormalization)denormalization
+    resizeMode:(TIOPixelBufferResizeMode)resizeMode
+    interpolation:(TIOPixelBufferInterpolation)interpolation
+    quantized:(BOOL)quantized;
+
+/**
+ * Creates a pixel buffer description whose tensor has the default type for its quantization.
+ */
+
+- (instancetype)initWithPixelFormat:(OSType)pixelFormat
+    shape:(NSArray<NSNumber*>*)shape
+    imageVolume:(TIOImageVolume)imageVolume
+    batched:(BOOL)batched
+    normalizer:(nullable TIOPixelNormalizer)normalizer
+    denormalizer:(nullable TIOPixelDenormalizer)denormalizer
+    quantized:(BOOL)quantized;
+
 /**
  * Use the designated initializer.
  */
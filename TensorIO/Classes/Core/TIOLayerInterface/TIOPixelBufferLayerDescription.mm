@@ -19,13 +19,23 @@
 //
 
 #import "TIOPixelBufferLayerDescription.h"
+#import "TIOVisionPipeline.h"
 
-@implementation TIOPixelBufferLayerDescription
+@interface TIOVisionPipeline (TIOPixelBufferLayerDescription_Protected)
+
+- (instancetype)initWithUnretainedTIOPixelBufferDescription:(TIOPixelBufferLayerDescription *)pixelBufferDescription;
+
+@end
+
+@implementation TIOPixelBufferLayerDescription {
+    TIOVisionPipeline *_visionPipeline;
+}
 
 - (instancetype)initWithPixelFormat:(OSType)pixelFormat
     shape:(NSArray<NSNumber*>*)shape
     imageVolume:(TIOImageVolume)imageVolume
     batched:(BOOL)batched
+    dtype:(TIODataType)dtype
     normalizer:(nullable TIOPixelNormalizer)normalizer
     denormalizer:(nullable TIOPixelDenormalizer)denormalizer
     quantized:(BOOL)quantized {
@@ -35,11 +45,99 @@
         _shape = shape;
         _imageVolume = imageVolume;
         _batched = batched;
+        _dtype = dtype;
         _normalizer = normalizer;
         _denormalizer = denormalizer;
+        _normalization = normalizer == nil ? kTIOPixelNormalizationNone : kTIOPixelNormalizationInvalid;
+        _denormalization = denormalizer == nil ? kTIOPixelDenormalizationNone : kTIOPixelDenormalizationInvalid;
+        _resizeMode = TIOPixelBufferResizeModeCenterCrop;
+        _interpolation = TIOPixelBufferInterpolationLanczos;
         _quantized = quantized;
     }
     return self;
 }
 
+- (instancetype)initWithPixelFormat:(OSType)pixelFormat
+    shape:(NSArray<NSNumber*>*)shape
+    imageVolume:(TIOImageVolume)imageVolume
+    batched:(BOOL)batched
+    dtype:(TIODataType)dtype
+    normalization:(TIOPixelNormalization)normalization
+    denormalization:(TIOPixelDenormalization)denormalization
+    quantized:(BOOL)quantized {
+    
+    if (self = [self initWithPixelFormat:pixelFormat
+        shape:shape
+        imageVolume:imageVolume
+        batched:batched
+        dtype:dtype
+        normalizer:TIOPixelNormalizerWithNormalization(normalization)
+        denormalizer:TIOPixelDenormalizerWithDenormalization(denormalization)
+        quantized:quantized]) {
+        if ( _normalizer != nil ) {
+            _normalization = normalization;
+        }
+        if ( _denormalizer != nil ) {
+            _denormalization = denormalization;
+        }
+    }
+    return self;
+}
+
+- (instancetype)initWithPixelFormat:(OSType)pixelFormat
+    shape:(NSArray<NSNumber*>*)shape
+    imageVolume:(TIOImageVolume)imageVolume
+    batched:(BOOL)batched
+    dtype:(TIODataType)dtype
+    normalization:(TIOPixelNormalization)normalization
+    denormalization:(TIOPixelDenormalization)denormalization
+    resizeMode:(TIOPixelBufferResizeMode)resizeMode
+    interpolation:(TIOPixelBufferInterpolation)interpolation
+    quantized:(BOOL)quantized {
+    
+    if (self = [self initWithPixelFormat:pixelFormat
+        shape:shape
+        imageVolume:imageVolume
+        batched:batched
+        dtype:dtype
+        normalization:normalization
+        denormalization:denormalization
+        quantized:quantized]) {
+        _resizeMode = resizeMode;
+        _interpolation = interpolation;
+    }
+    return self;
+}
+
+- (instancetype)initWithPixelFormat:(OSType)pixelFormat
+    shape:(NSArray<NSNumber*>*)shape
+    imageVolume:(TIOImageVolume)imageVolume
+    batched:(BOOL)batched
+    normalizer:(nullable TIOPixelNormalizer)normalizer
+    denormalizer:(nullable TIOPixelDenormalizer)denormalizer
+    quantized:(BOOL)quantized {
+    
+    return [self initWithPixelFormat:pixelFormat
+        shape:shape
+        imageVolume:imageVolume
+        batched:batched
+        dtype:TIODataTypeUnknown
+        normalizer:normalizer
+        denormalizer:denormalizer
+        quantized:quantized];
+}
+
+/**
+ * The pipeline does not retain a description that owns it.
+ */
+
+- (TIOVisionPipeline *)visionPipeline {
+    @synchronized (self) {
+        if ( _visionPipeline == nil ) {
+            _visionPipeline = [[TIOVisionPipeline alloc] initWithUnretainedTIOPixelBufferDescription:self];
+        }
+        return _visionPipeline;
+    }
+}
+
 @end
@@ -32,6 +32,15 @@ NS_ASSUME_NONNULL_BEGIN
 @class TIOBatch;
 @class TIOModelIO;
 
+/**
+ * Called when asynchronous inference completes.
+ *
+ * @param output The results of performing inference, or `nil` if an error occurred.
+ * @param error Set if an error occurred during inference or the input was not accepted.
+ */
+
+typedef void (^TIOModelCompletionHandler)(id<TIOData> _Nullable output, NSError * _Nullable error);
+
 /**
  * An Obj-C wrapper around lower level, usually C++ model implementations. This is the primary
  * API provided by the TensorIO framework.
@@ -62,8 +71,12 @@ NS_ASSUME_NONNULL_BEGIN
  * Note that, currently, only TensorFlow Lite (TFLite) models are supported.
  *
  * @warning
- * Models are not thread safe. Models may be used on separate threads, so that you can perform
- * inference off the main thread, but you should not use the same model from multiple threads.
+ * Whether a model may be used from more than one thread at a time depends on its backend. TFLite
+ * models lend every run its own interpreter from a pool, so that `runOn:` and `run:` may be called
+ * concurrently, and they serialize calls beyond the size of the pool. `runOn:completion:` may be
+ * called from any thread. Otherwise models may be used on separate threads, so that you can
+ * perform inference off the main thread, but you should not use the same model from multiple
+ * threads at once.
  */
 
 @protocol TIOModel <NSObject>
@@ -292,6 +305,40 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (id<TIOData>)runOn:(id<TIOData>)input __attribute__((deprecated));
 
+@optional
+
+/**
+ * Performs inference on the provided input and returns only the requested outputs. Outputs
+ * that are not requested are neither fetched nor converted to `TIOData`, which avoids the cost
+ * of large auxiliary outputs a caller does not need.
+ *
+ * Optional. Check that a model responds to this selector before calling it through `id<TIOModel>`.
+ *
+ * @param input Any class conforming to `TIOData`.
+ * @param outputs The names of the output layers to return, which must be a subset of the
+ *  model's output layer names.
+ * @param error Set if an error occurred during inference. May be nil.
+ * @return TIOData A dictionary containing only the requested outputs.
+ */
+
+- (id<TIOData>)runOn:(id<TIOData>)input outputs:(NSArray<NSString*> *)outputs error:(NSError* _Nullable *)error;
+
+/**
+ * Performs inference on the provided input asynchronously and calls the completion handler with
+ * the results. Inputs are processed in the order they are submitted and the completion handler
+ * is called on a private serial queue.
+ *
+ * Backends may pipeline submissions, preparing one input while the previous input is run, and
+ * may refuse an input with an error when too many are already in flight.
+ *
+ * Optional. Check that a model responds to this selector before calling it through `id<TIOModel>`.
+ *
+ * @param input Any class conforming to `TIOData`.
+ * @param completion Called with the results of performing inference on input, or with an error.
+ */
+
+- (void)runOn:(id<TIOData>)input completion:(TIOModelCompletionHandler)completion;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -55,7 +55,9 @@
                     "g":        Float,
                     "b":        Float,
                 }
-            }
+            },
+            "resize":       String,             // optional: "center-crop" | "letterbox" | "stretch" | "fit" for image inputs
+            "interpolation": String,            // optional: "area" | "nearest" | "bilinear" | "high-quality" for image inputs
         },
     ],
  
@@ -84,7 +86,13 @@
     ],
     
     "options": {
-        "device_position":  String          // "front" | "back" for models that prefer a camera device position
+        "device_position":  String,         // "front" | "back" for models that prefer a camera device position
+        "session": {                        // optional, for backends that create a session, i.e. tensorflow
+            "intra_op_threads":     Int,    // threads used within an op, 0 lets the backend decide
+            "inter_op_threads":     Int,    // threads used to run independent ops, 0 lets the backend decide
+            "optimizer_level":      String, // "L0" | "L1"
+            "constant_folding":     Bool
+        }
     }
 }
 */
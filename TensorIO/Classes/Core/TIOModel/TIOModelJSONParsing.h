@@ -114,12 +114,26 @@ TIOLayerInterface * _Nullable TIOModelParseTIOStringDescription(NSDictionary *di
 
 _Nullable TIODataQuantizer TIODataQuantizerForDict(NSDictionary * _Nullable dict, NSError **error);
 
+/**
+ * Parses the `quantization` key of an input description whose quantized values have a data type,
+ * which determines the range of a `zero_point`.
+ */
+
+_Nullable TIODataQuantizer TIODataQuantizerForDictWithDataType(NSDictionary * _Nullable dict, TIODataType dtype, NSError **error);
+
 /**
  * Parses the `dequantization` key of an output description and returns an associated data dequantizer.
  */
 
 _Nullable TIODataDequantizer TIODataDequantizerForDict(NSDictionary * _Nullable dict, NSError **error);
 
+/**
+ * Parses the `dequantization` key of an output description whose quantized values have a data
+ * type, which determines the range of a `zero_point`.
+ */
+
+_Nullable TIODataDequantizer TIODataDequantizerForDictWithDataType(NSDictionary * _Nullable dict, TIODataType dtype, NSError **error);
+
 /**
  * Converts an array of shape values to an `TIOImageVolume`.
  */
@@ -132,6 +146,20 @@ TIOImageVolume TIOImageVolumeForShape(NSArray<NSNumber*> *_Nullable shape);
 
 OSType TIOPixelFormatForString(NSString * _Nullable formatString);
 
+/**
+ * Returns the pixel normalization described by an input dictionary, `kTIOPixelNormalizationNone`
+ * when there is none, or `kTIOPixelNormalizationInvalid` if the dictionary cannot be parsed.
+ */
+
+TIOPixelNormalization TIOPixelNormalizationForDictionary(NSDictionary * _Nullable input, NSError **error);
+
+/**
+ * Returns the pixel denormalization described by an output dictionary, `kTIOPixelDenormalizationNone`
+ * when there is none, or `kTIOPixelDenormalizationInvalid` if the dictionary cannot be parsed.
+ */
+
+TIOPixelDenormalization TIOPixelDenormalizationForDictionary(NSDictionary * _Nullable input, NSError **error);
+
 /**
  * Returns the TIOPixelNormalizer given an input dictionary.
  */
@@ -144,6 +172,20 @@ TIOPixelNormalizer _Nullable TIOPixelNormalizerForDictionary(NSDictionary * _Nul
 
 TIOPixelDenormalizer _Nullable TIOPixelDenormalizerForDictionary(NSDictionary * _Nullable input, NSError **error);
 
+/**
+ * Returns the resize mode for a resize string, `TIOPixelBufferResizeModeCenterCrop` when there
+ * is none, or `TIOPixelBufferResizeModeInvalid` if the string is not a known mode.
+ */
+
+TIOPixelBufferResizeMode TIOPixelBufferResizeModeForString(NSString * _Nullable string);
+
+/**
+ * Returns the interpolation for an interpolation string, `TIOPixelBufferInterpolationLanczos` when
+ * there is none, or `TIOPixelBufferInterpolationInvalid` if the string is not a known interpolation.
+ */
+
+TIOPixelBufferInterpolation TIOPixelBufferInterpolationForString(NSString * _Nullable string);
+
 /**
  * Returns the data type for a given dtype string.
  */
@@ -119,9 +119,9 @@ TIOLayerInterface * _Nullable TIOModelParseTIOVectorDescription(NSDictionary *di
     case TIOLayerInterfaceModePlaceholder:
         {
         NSError *error;
-        quantizer = TIODataQuantizerForDict(dict[@"quantize"], &error);
+        quantizer = TIODataQuantizerForDictWithDataType(dict[@"quantize"], dtype, &error);
         if ( error != nil ) {
-            NSLog(@"Expected quantize.standard string to be '[0,1]' or '[-1,1]', or to find scale and bias values, found: %@", dict);
+            NSLog(@"Expected quantize.standard string to be '[0,1]' or '[-1,1]', or to find scale and bias or scale and zero_point values, found: %@", dict);
             return nil;
         }
         }
@@ -139,9 +139,9 @@ TIOLayerInterface * _Nullable TIOModelParseTIOVectorDescription(NSDictionary *di
     case TIOLayerInterfaceModeOutput:
         {
         NSError *error;
-        dequantizer = TIODataDequantizerForDict(dict[@"dequantize"], &error);
+        dequantizer = TIODataDequantizerForDictWithDataType(dict[@"dequantize"], dtype, &error);
         if ( error != nil ) {
-            NSLog(@"Expected dequantize.standard string to be '[0,1]' or '[-1,1]', or to find scale and bias values, found: %@", dict);
+            NSLog(@"Expected dequantize.standard string to be '[0,1]' or '[-1,1]', or to find scale and bias or scale and zero_point values, found: %@", dict);
             return nil;
         }
         }
@@ -185,9 +185,9 @@ TIOLayerInterface * _Nullable TIOModelParseTIOScalarDescription(NSDictionary *di
     case TIOLayerInterfaceModePlaceholder:
         {
         NSError *error;
-        quantizer = TIODataQuantizerForDict(dict[@"quantize"], &error);
+        quantizer = TIODataQuantizerForDictWithDataType(dict[@"quantize"], dtype, &error);
         if ( error != nil ) {
-            NSLog(@"Expected quantize.standard string to be '[0,1]' or '[-1,1]', or to find scale and bias values, found: %@", dict);
+            NSLog(@"Expected quantize.standard string to be '[0,1]' or '[-1,1]', or to find scale and bias or scale and zero_point values, found: %@", dict);
             return nil;
         }
         }
@@ -205,9 +205,9 @@ TIOLayerInterface * _Nullable TIOModelParseTIOScalarDescription(NSDictionary *di
     case TIOLayerInterfaceModeOutput:
         {
         NSError *error;
-        dequantizer = TIODataDequantizerForDict(dict[@"dequantize"], &error);
+        dequantizer = TIODataDequantizerForDictWithDataType(dict[@"dequantize"], dtype, &error);
         if ( error != nil ) {
-            NSLog(@"Expected dequantize.standard string to be '[0,1]' or '[-1,1]', or to find scale and bias values, found: %@", dict);
+            NSLog(@"Expected dequantize.standard string to be '[0,1]' or '[-1,1]', or to find scale and bias or scale and zero_point values, found: %@", dict);
             return nil;
         }
         }
@@ -257,14 +257,14 @@ TIOLayerInterface * _Nullable TIOModelParseTIOPixelBufferDescription(NSDictionar
     
     // Normalization
     
-    TIOPixelNormalizer normalizer;
+    TIOPixelNormalization normalization;
     
     switch (mode) {
     case TIOLayerInterfaceModeInput:
     case TIOLayerInterfaceModePlaceholder:
         {
         NSError *error;
-        normalizer = TIOPixelNormalizerForDictionary(dict[@"normalize"], &error);
+        normalization = TIOPixelNormalizationForDictionary(dict[@"normalize"], &error);
         if ( error != nil ) {
             NSLog(@"Expected normalize.standard string to be '[0,1]' or '[-1,1]', or to find scale and bias values, found: %@", dict[@"normalize"]);
             return nil;
@@ -272,19 +272,19 @@ TIOLayerInterface * _Nullable TIOModelParseTIOPixelBufferDescription(NSDictionar
         }
         break;
     case TIOLayerInterfaceModeOutput:
-        normalizer = TIOPixelNormalizerNone();
+        normalization = kTIOPixelNormalizationNone;
         break;
     }
     
     // Denormalization
     
-    TIOPixelDenormalizer denormalizer;
+    TIOPixelDenormalization denormalization;
 
     switch (mode) {
     case TIOLayerInterfaceModeOutput:
         {
         NSError *error;
-        denormalizer = TIOPixelDenormalizerForDictionary(dict[@"denormalize"], &error);
+        denormalization = TIOPixelDenormalizationForDictionary(dict[@"denormalize"], &error);
         if ( error != nil ) {
             NSLog(@"Expected denormalize string to be '[0,1]' or '[-1,1]', or to find scale and bias values, found: %@", dict[@"normalize"]);
             return nil;
@@ -293,10 +293,30 @@ TIOLayerInterface * _Nullable TIOModelParseTIOPixelBufferDescription(NSDictionar
         break;
     case TIOLayerInterfaceModeInput:
     case TIOLayerInterfaceModePlaceholder:
-        denormalizer = TIOPixelDenormalizerNone();
+        denormalization = kTIOPixelDenormalizationNone;
         break;
     }
 
+    // Resizing
+    
+    TIOPixelBufferResizeMode resizeMode = TIOPixelBufferResizeModeForString(dict[@"resize"]);
+    
+    if ( resizeMode == TIOPixelBufferResizeModeInvalid ) {
+        NSLog(@"Expected dict.resize string to be 'center-crop', 'letterbox', 'stretch', or 'fit' in model.json, found %@", dict[@"resize"]);
+        return nil;
+    }
+    
+    TIOPixelBufferInterpolation interpolation = TIOPixelBufferInterpolationForString(dict[@"interpolation"]);
+    
+    if ( interpolation == TIOPixelBufferInterpolationInvalid ) {
+        NSLog(@"Expected dict.interpolation string to be 'lanczos', 'area', 'nearest', 'bilinear', or 'high-quality' in model.json, found %@", dict[@"interpolation"]);
+        return nil;
+    }
+    
+    // Data Type
+    
+    TIODataType dtype = TIODataTypeForString(dict[@"dtype"]);
+    
     // Description
     
     TIOLayerInterface *interface = [[TIOLayerInterface alloc] initWithName:name JSON:dict mode:mode pixelBufferDescription:
@@ -305,8 +325,11 @@ TIOLayerInterface * _Nullable TIOModelParseTIOPixelBufferDescription(NSDictionar
             shape:shape
             imageVolume:imageVolume
             batched:batched
-            normalizer:normalizer
-            denormalizer:denormalizer
+            dtype:dtype
+            normalization:normalization
+            denormalization:denormalization
+            resizeMode:resizeMode
+            interpolation:interpolation
             quantized:quantized]];
     
     return interface;
@@ -335,6 +358,10 @@ TIOLayerInterface * _Nullable TIOModelParseTIOStringDescription(NSDictionary *di
 // MARK: - Vector Quantization
 
 _Nullable TIODataQuantizer TIODataQuantizerForDict(NSDictionary * _Nullable dict, NSError **error) {
+    return TIODataQuantizerForDictWithDataType(dict, TIODataTypeUInt8, error);
+}
+
+_Nullable TIODataQuantizer TIODataQuantizerForDictWithDataType(NSDictionary * _Nullable dict, TIODataType dtype, NSError **error) {
     if ( dict == nil ) {
         return nil;
     }
@@ -342,6 +369,7 @@ _Nullable TIODataQuantizer TIODataQuantizerForDict(NSDictionary * _Nullable dict
     NSString *standard = dict[@"standard"];
     NSNumber *scale = dict[@"scale"];
     NSNumber *bias = dict[@"bias"];
+    NSNumber *zeroPoint = dict[@"zero_point"];
     
     if ( [standard isEqualToString:@"[0,1]"] ) {
         return TIODataQuantizerZeroToOne();
@@ -353,6 +381,12 @@ _Nullable TIODataQuantizer TIODataQuantizerForDict(NSDictionary * _Nullable dict
         *error = kTIOParserInvalidQuantizerError;
         return nil;
     }
+    else if ( scale != nil && zeroPoint != nil ) {
+        return TIODataQuantizerWithAffineQuantization({
+            .scale = scale.floatValue,
+            .zero_point = zeroPoint.intValue
+        }, dtype);
+    }
     else if ( scale != nil && bias != nil ) {
         return TIODataQuantizerWithQuantization({
             .scale = scale.floatValue,
@@ -366,6 +400,10 @@ _Nullable TIODataQuantizer TIODataQuantizerForDict(NSDictionary * _Nullable dict
 }
 
 _Nullable TIODataDequantizer TIODataDequantizerForDict(NSDictionary * _Nullable dict, NSError **error) {
+    return TIODataDequantizerForDictWithDataType(dict, TIODataTypeUInt8, error);
+}
+
+_Nullable TIODataDequantizer TIODataDequantizerForDictWithDataType(NSDictionary * _Nullable dict, TIODataType dtype, NSError **error) {
     if ( dict == nil ) {
         return nil;
     }
@@ -373,6 +411,7 @@ _Nullable TIODataDequantizer TIODataDequantizerForDict(NSDictionary * _Nullable
     NSString *standard = dict[@"standard"];
     NSNumber *scale = dict[@"scale"];
     NSNumber *bias = dict[@"bias"];
+    NSNumber *zeroPoint = dict[@"zero_point"];
     
     if ( [standard isEqualToString:@"[0,1]"] ) {
         return TIODataDequantizerZeroToOne();
@@ -384,6 +423,12 @@ _Nullable TIODataDequantizer TIODataDequantizerForDict(NSDictionary * _Nullable
         *error = kTIOParserInvalidQuantizerError;
         return nil;
     }
+    else if ( scale != nil && zeroPoint != nil ) {
+        return TIODataDequantizerWithAffineQuantization({
+            .scale = scale.floatValue,
+            .zero_point = zeroPoint.intValue
+        }, dtype);
+    }
     else if ( scale != nil && bias != nil ) {
         return TIODataDequantizerWithDequantization({
             .scale = scale.floatValue,
@@ -459,30 +504,30 @@ OSType TIOPixelFormatForString(NSString * _Nullable string) {
     }
 }
 
-TIOPixelNormalizer _Nullable TIOPixelNormalizerForDictionary(NSDictionary * _Nullable dict, NSError **error) {
+TIOPixelNormalization TIOPixelNormalizationForDictionary(NSDictionary * _Nullable dict, NSError **error) {
     NSString *normalizerString = dict[@"standard"];
     NSNumber *scaleNumber = dict[@"scale"];
     NSDictionary *biases = dict[@"bias"];
     
     if ( dict == nil ) {
-        return TIOPixelNormalizerNone();
+        return kTIOPixelNormalizationNone;
     }
     
     if ( normalizerString != nil ) {
         if ( [normalizerString isEqualToString:@"[0,1]"] ) {
-            return TIOPixelNormalizerZeroToOne();
+            return kTIOPixelNormalizationZeroToOne;
         }
         else if ( [normalizerString isEqualToString:@"[-1,1]"] ) {
-            return TIOPixelNormalizerNegativeOneToOne();
+            return kTIOPixelNormalizationNegativeOneToOne;
         }
         else {
             if ( error != nil ) { *error = kTIOParserInvalidPixelNormalizationError; }
             NSLog(@"Expected input.normalizer string to be '[0,1]' or '[-1,1]', actual value is %@", normalizerString);
-            return nil;
+            return kTIOPixelNormalizationInvalid;
         }
     }
     else if ( scaleNumber == nil && biases == nil ) {
-        return TIOPixelNormalizerNone();
+        return kTIOPixelNormalizationNone;
     }
     else {
         float_t scale = scaleNumber != nil
@@ -498,45 +543,39 @@ TIOPixelNormalizer _Nullable TIOPixelNormalizerForDictionary(NSDictionary * _Nul
             ? [biases[@"b"] floatValue]
             : 0.0;
         
-        TIOPixelNormalization normalization = {
+        return (TIOPixelNormalization) {
             .scale = scale,
             .redBias = redBias,
             .greenBias = greenBias,
             .blueBias = blueBias
         };
-        
-        if ( (redBias == greenBias) && (redBias == blueBias) ) {
-            return TIOPixelNormalizerSingleBias(normalization);
-        } else {
-            return TIOPixelNormalizerPerChannelBias(normalization);
-        }
     }
 }
 
-TIOPixelDenormalizer _Nullable TIOPixelDenormalizerForDictionary(NSDictionary * _Nullable dict, NSError **error) {
+TIOPixelDenormalization TIOPixelDenormalizationForDictionary(NSDictionary * _Nullable dict, NSError **error) {
     NSString *normalizerString = dict[@"standard"];
     NSNumber *scaleNumber = dict[@"scale"];
     NSDictionary *biases = dict[@"bias"];
     
     if ( dict == nil ) {
-        return TIOPixelDenormalizerNone();
+        return kTIOPixelDenormalizationNone;
     }
     
     if ( normalizerString != nil ) {
         if ( [normalizerString isEqualToString:@"[0,1]"] ) {
-            return TIOPixelDenormalizerZeroToOne();
+            return kTIOPixelDenormalizationZeroToOne;
         }
         else if ( [normalizerString isEqualToString:@"[-1,1]"] ) {
-            return TIOPixelDenormalizerNegativeOneToOne();
+            return kTIOPixelDenormalizationNegativeOneToOne;
         }
         else {
             if ( error != nil ) { *error = kTIOParserInvalidPixelDenormalizationError; }
             NSLog(@"Expected input.denormalizer string to be '[0,1]' or '[-1,1]', actual value is %@", normalizerString);
-            return nil;
+            return kTIOPixelDenormalizationInvalid;
         }
     }
     else if ( scaleNumber == nil && biases == nil ) {
-        return TIOPixelDenormalizerNone();
+        return kTIOPixelDenormalizationNone;
     }
     else {
         float_t scale = scaleNumber != nil
@@ -552,18 +591,68 @@ TIOPixelDenormalizer _Nullable TIOPixelDenormalizerForDictionary(NSDictionary *
             ? [biases[@"b"] floatValue]
             : 0.0;
         
-        TIOPixelNormalization normalization = {
+        return (TIOPixelDenormalization) {
             .scale = scale,
             .redBias = redBias,
             .greenBias = greenBias,
             .blueBias = blueBias
         };
-        
-        if ( (redBias == greenBias) && (redBias == blueBias) ) {
-            return TIOPixelDenormalizerSingleBias(normalization);
-        } else {
-            return TIOPixelDenormalizerPerChannelBias(normalization);
-        }
+    }
+}
+
+TIOPixelNormalizer _Nullable TIOPixelNormalizerForDictionary(NSDictionary * _Nullable dict, NSError **error) {
+    TIOPixelNormalization normalization = TIOPixelNormalizationForDictionary(dict, error);
+    
+    if ( TIOPixelNormalizationsEqual(normalization, kTIOPixelNormalizationInvalid) ) {
+        return nil;
+    }
+    
+    return TIOPixelNormalizerWithNormalization(normalization);
+}
+
+TIOPixelDenormalizer _Nullable TIOPixelDenormalizerForDictionary(NSDictionary * _Nullable dict, NSError **error) {
+    TIOPixelDenormalization denormalization = TIOPixelDenormalizationForDictionary(dict, error);
+    
+    if ( TIOPixelDenormalizationsEqual(denormalization, kTIOPixelDenormalizationInvalid) ) {
+        return nil;
+    }
+    
+    return TIOPixelDenormalizerWithDenormalization(denormalization);
+}
+
+// MARK: - Resizing
+
+TIOPixelBufferResizeMode TIOPixelBufferResizeModeForString(NSString * _Nullable string) {
+    if ( string == nil ) {
+        return TIOPixelBufferResizeModeCenterCrop;
+    } else if ( [string isEqualToString:@"center-crop"] ) {
+        return TIOPixelBufferResizeModeCenterCrop;
+    } else if ( [string isEqualToString:@"letterbox"] ) {
+        return TIOPixelBufferResizeModeLetterbox;
+    } else if ( [string isEqualToString:@"stretch"] ) {
+        return TIOPixelBufferResizeModeStretch;
+    } else if ( [string isEqualToString:@"fit"] ) {
+        return TIOPixelBufferResizeModeFit;
+    } else {
+        return TIOPixelBufferResizeModeInvalid;
+    }
+}
+
+TIOPixelBufferInterpolation TIOPixelBufferInterpolationForString(NSString * _Nullable string) {
+    if ( string == nil ) {
+        return TIOPixelBufferInterpolationLanczos;
+    } else if ( [string isEqualToString:@"lanczos"] ) {
+        return TIOPixelBufferInterpolationLanczos;
+    } else if ( [string isEqualToString:@"area"] ) {
+        return TIOPixelBufferInterpolationArea;
+    } else if ( [string isEqualToString:@"nearest"] ) {
+        return TIOPixelBufferInterpolationNearest;
+    } else if ( [string isEqualToString:@"bilinear"] ) {
+        return TIOPixelBufferInterpolationBilinear;
+    } else if ( [string isEqualToString:@"high-quality"] ) {
+        return TIOPixelBufferInterpolationHighQuality;
+    } else {
+        return TIOPixelBufferInterpolationInvalid;
     }
 }
 
@@ -582,6 +671,10 @@ TIODataType TIODataTypeForString(NSString * _Nullable string) {
         return TIODataTypeInt32;
     } else if ( [string isEqualToString:@"int64"]) {
         return TIODataTypeInt64;
+    } else if ( [string isEqualToString:@"float16"]) {
+        return TIODataTypeFloat16;
+    } else if ( [string isEqualToString:@"int8"]) {
+        return TIODataTypeInt8;
     } else {
         NSLog(@"Uknown data type (dtype) encountered in layer: %@", string);
         return TIODataTypeUnknown;
@@ -36,6 +36,74 @@ NS_ASSUME_NONNULL_BEGIN
 
 AVCaptureDevicePosition TIOModelOptionsAVCaptureDevicePositionFromString(NSString * _Nullable descriptor);
 
+/**
+ * The level of graph optimization a backend should apply when it creates a session.
+ */
+
+typedef NS_ENUM(NSInteger, TIOModelOptimizerLevel) {
+    TIOModelOptimizerLevelDefault,  // Let the backend decide
+    TIOModelOptimizerLevelL0,       // No optimizations, e.g. no common subexpression elimination
+    TIOModelOptimizerLevelL1        // Common subexpression elimination and constant folding
+};
+
+/**
+ * Converts a string representation of an optimizer level, "L0" or "L1", to a `TIOModelOptimizerLevel`.
+ * Any other value returns `TIOModelOptimizerLevelDefault`.
+ */
+
+TIOModelOptimizerLevel TIOModelOptimizerLevelFromString(NSString * _Nullable descriptor);
+
+/**
+ * Options a backend uses when it creates the session that executes a model, such as the size of
+ * its thread pools and the optimizations it applies to the graph. Read from the "session" field
+ * of a model's options. Unset values leave the decision to the backend.
+ */
+
+@interface TIOModelSessionOptions : NSObject
+
+/**
+ * The number of threads used to parallelize the execution of a single op, or 0 to let the
+ * backend decide.
+ */
+
+@property (readonly) NSUInteger intraOpThreads;
+
+/**
+ * The number of threads used to execute independent ops in parallel, or 0 to let the backend
+ * decide.
+ */
+
+@property (readonly) NSUInteger interOpThreads;
+
+/**
+ * The level of graph optimization to apply.
+ */
+
+@property (readonly) TIOModelOptimizerLevel optimizerLevel;
+
+/**
+ * A boolean `NSNumber` that turns constant folding on or off, or `nil` to let the backend decide.
+ */
+
+@property (nullable, readonly) NSNumber *constantFolding;
+
+/**
+ * Designated initializer.
+ */
+
+- (instancetype)initWithIntraOpThreads:(NSUInteger)intraOpThreads
+    interOpThreads:(NSUInteger)interOpThreads
+    optimizerLevel:(TIOModelOptimizerLevel)optimizerLevel
+    constantFolding:(nullable NSNumber *)constantFolding NS_DESIGNATED_INITIALIZER;
+
+/**
+ * Convenience initializer used when reading from a TIOModelBundle.
+ */
+
+- (instancetype)initWithDictionary:(nullable NSDictionary *)dictionary;
+
+@end
+
 /**
  * Encapsulates additional options that a model would like to communicate to it consumers.
  */
@@ -60,12 +128,26 @@ AVCaptureDevicePosition TIOModelOptionsAVCaptureDevicePositionFromString(NSStrin
 
 @property (readonly) NSString *outputFormat;
 
+/**
+ * Options for the session that executes the model.
+ */
+
+@property (readonly) TIOModelSessionOptions *session;
+
 /**
  * Designated initializer.
  */
 
 - (instancetype)initWithDevicePosition:(AVCaptureDevicePosition)devicePosition
-    outputFormat:(NSString *)outputFormat NS_DESIGNATED_INITIALIZER;
+    outputFormat:(NSString *)outputFormat
+    session:(TIOModelSessionOptions *)session NS_DESIGNATED_INITIALIZER;
+
+/**
+ * Initializes options with default session options.
+ */
+
+- (instancetype)initWithDevicePosition:(AVCaptureDevicePosition)devicePosition
+    outputFormat:(NSString *)outputFormat;
 
 /**
  * Convenience initializer used when reading from a TIOModelBundle.
@@ -40,29 +40,81 @@ NSString * TIOModelOptionsOutputFormatFromString(NSString * _Nullable descriptor
     }
 }
 
+TIOModelOptimizerLevel TIOModelOptimizerLevelFromString(NSString * _Nullable descriptor) {
+    if ( [descriptor isEqualToString:@"L0"] ) {
+        return TIOModelOptimizerLevelL0;
+    } else if ( [descriptor isEqualToString:@"L1"] ) {
+        return TIOModelOptimizerLevelL1;
+    } else {
+        return TIOModelOptimizerLevelDefault;
+    }
+}
+
+// MARK: -
+
+@implementation TIOModelSessionOptions
+
+- (instancetype)initWithIntraOpThreads:(NSUInteger)intraOpThreads interOpThreads:(NSUInteger)interOpThreads optimizerLevel:(TIOModelOptimizerLevel)optimizerLevel constantFolding:(nullable NSNumber *)constantFolding {
+    if (self = [super init]) {
+        _intraOpThreads = intraOpThreads;
+        _interOpThreads = interOpThreads;
+        _optimizerLevel = optimizerLevel;
+        _constantFolding = constantFolding;
+    }
+    return self;
+}
+
+- (instancetype)initWithDictionary:(nullable NSDictionary *)dictionary {
+    NSNumber *intraOpThreads = dictionary[@"intra_op_threads"];
+    NSNumber *interOpThreads = dictionary[@"inter_op_threads"];
+    NSNumber *constantFolding = dictionary[@"constant_folding"];
+    
+    return [self
+        initWithIntraOpThreads:intraOpThreads.unsignedIntegerValue
+        interOpThreads:interOpThreads.unsignedIntegerValue
+        optimizerLevel:TIOModelOptimizerLevelFromString(dictionary[@"optimizer_level"])
+        constantFolding:constantFolding];
+}
+
+- (instancetype)init {
+    return [self initWithDictionary:nil];
+}
+
+@end
+
+// MARK: -
+
 @implementation TIOModelOptions
 
-- (instancetype)initWithDevicePosition:(AVCaptureDevicePosition)devicePosition outputFormat:(NSString *)outputFormat {
+- (instancetype)initWithDevicePosition:(AVCaptureDevicePosition)devicePosition outputFormat:(NSString *)outputFormat session:(TIOModelSessionOptions *)session {
     if (self = [super init]) {
         _devicePosition = devicePosition;
         _outputFormat = outputFormat;
+        _session = session;
     }
     return self;
 }
 
+- (instancetype)initWithDevicePosition:(AVCaptureDevicePosition)devicePosition outputFormat:(NSString *)outputFormat {
+    return [self initWithDevicePosition:devicePosition outputFormat:outputFormat session:[[TIOModelSessionOptions alloc] init]];
+}
+
 - (instancetype)initWithDictionary:(NSDictionary *)dictionary {
     AVCaptureDevicePosition devicePosition;
     NSString *outputFormat;
+    TIOModelSessionOptions *session;
     
     if ( dictionary == nil ) {
         devicePosition = AVCaptureDevicePositionUnspecified;
         outputFormat = TIOModelOptionOutputFormatNone;
+        session = [[TIOModelSessionOptions alloc] init];
     } else {
         devicePosition = TIOModelOptionsAVCaptureDevicePositionFromString(dictionary[@"device_position"]);
         outputFormat = TIOModelOptionsOutputFormatFromString(dictionary[@"output_format"]);
+        session = [[TIOModelSessionOptions alloc] initWithDictionary:dictionary[@"session"]];
     }
     
-    return [self initWithDevicePosition:devicePosition outputFormat:outputFormat];
+    return [self initWithDevicePosition:devicePosition outputFormat:outputFormat session:session];
 }
 
 - (instancetype)init {
@@ -99,6 +99,47 @@ NS_ASSUME_NONNULL_BEGIN
 
 @property (readonly) BOOL shuffle;
 
+/**
+ * How often the trainer fetches the model's outputs, usually its loss, in
+ * training steps. The outputs are always fetched on the last step of each
+ * epoch, so that `train` and the epoch callback can report them, and
+ * additionally every `lossInterval` steps. Set to 0 to fetch the outputs only
+ * at the end of each epoch. Defaults to 1, every step.
+ *
+ * Skipping the fetch saves a forward pass on models which implement
+ * `train:placeholders:fetchOutputs:error:`.
+ */
+
+@property NSUInteger lossInterval;
+
+/**
+ * The number of micro-batches whose gradients are accumulated before they are
+ * applied to the model's weights in a single step. Each micro-batch has
+ * `batchSize` items, so the effective batch size is `batchSize *
+ * accumulationSteps`, while the peak memory of a step remains that of a
+ * single micro-batch. Accumulated gradients are also applied at the end of
+ * each epoch. Defaults to 1, no accumulation.
+ *
+ * Only models whose `accumulatesGradients` is `YES` accumulate. Other models
+ * train on each batch as usual.
+ */
+
+@property NSUInteger accumulationSteps;
+
+/**
+ * The number of batches the trainer assembles on a background queue ahead of
+ * the training step, so that requesting items from the data source overlaps
+ * with training on the current batch. Set to 0 to assemble each batch on the
+ * training thread just before it is used. Defaults to 0.
+ *
+ * When greater than 0 the data source's `itemAtIndex:` is called from a
+ * background queue, one item at a time. Models that implement
+ * `prepareBatch:error:` also write each batch's tensors on that queue, and the
+ * model is loaded before the first batch is prefetched.
+ */
+
+@property NSUInteger prefetchDepth;
+
 /**
  * Executes the training loop and returns the results.
  */
@@ -50,6 +50,13 @@
 
 @implementation TIOModelTrainer {
     NSArray<NSNumber*> *_itemOrder;
+    
+    // Batches are assembled, and prepared by models that support it, on the prefetch queue
+    // ahead of the training step
+    dispatch_queue_t _prefetchQueue;
+    NSMutableArray<TIOBatch*> *_prefetched;
+    dispatch_semaphore_t _prefetchSlots;
+    dispatch_semaphore_t _prefetchReady;
 }
 
 - (instancetype)initWithModel:(id<TIOTrainableModel>)model dataSource:(id<TIOBatchDataSource>)dataSource placeholders:(NSDictionary<NSString*, id<TIOData>> *)placeholders epochs:(NSUInteger)epochs batchSize:(NSUInteger)batchSize shuffle:(BOOL)shuffle {
@@ -60,6 +67,10 @@
         _epochs = epochs;
         _batchSize = batchSize;
         _shuffle = shuffle;
+        _lossInterval = 1;
+        _accumulationSteps = 1;
+        _prefetchDepth = 0;
+        _prefetchQueue = dispatch_queue_create("ai.doc.tensorio.trainer.prefetch", DISPATCH_QUEUE_SERIAL);
     }
     return self;
 }
@@ -71,12 +82,19 @@
     id<TIOData> results;
     
     for ( NSUInteger epoch = 0; epoch < self.epochs; epoch++ ) {
+        [self _prefetchBatches:batchCount];
+        
         for ( NSUInteger batchIndex = 0; batchIndex < batchCount; batchIndex++ ) {
             @autoreleasepool {
-                TIOBatch *batch = [self _batchAtIndex:batchIndex];
+                TIOBatch *batch = [self _nextBatchAtIndex:batchIndex];
+                NSUInteger step = epoch * batchCount + batchIndex;
                 NSError *error;
                 
-                results = [self.model train:batch placeholders:self.placeholders error:&error];
+                id<TIOData> stepResults = [self _trainBatch:batch step:step batchIndex:batchIndex batchCount:batchCount error:&error];
+                
+                if ( stepResults != nil ) {
+                    results = stepResults;
+                }
             }
         }
     }
@@ -92,10 +110,18 @@
     NSError *error;
     
     for ( NSUInteger epoch = 0; epoch < self.epochs; epoch++ ) {
+        [self _prefetchBatches:batchCount];
+        
         for ( NSUInteger batchIndex = 0; batchIndex < batchCount; batchIndex++ ) {
             @autoreleasepool {
-                TIOBatch *batch = [self _batchAtIndex:batchIndex];
-                results = [self.model train:batch placeholders:self.placeholders error:&error];
+                TIOBatch *batch = [self _nextBatchAtIndex:batchIndex];
+                NSUInteger step = epoch * batchCount + batchIndex;
+                
+                id<TIOData> stepResults = [self _trainBatch:batch step:step batchIndex:batchIndex batchCount:batchCount error:&error];
+                
+                if ( stepResults != nil ) {
+                    results = stepResults;
+                }
             }
         }
         callback(epoch, results, error);
@@ -104,6 +130,160 @@
 
 // MARK: -
 
+/**
+ * Trains the model on a batch, or accumulates the batch's gradients and applies them after
+ * every `accumulationSteps` batches and on the last batch of an epoch.
+ *
+ * @return The model's outputs if they were fetched at this step, otherwise `nil`.
+ */
+
+- (nullable id<TIOData>)_trainBatch:(TIOBatch *)batch step:(NSUInteger)step batchIndex:(NSUInteger)batchIndex batchCount:(NSUInteger)batchCount error:(NSError * _Nullable *)error {
+    BOOL fetchesOutputs = [self _fetchesOutputsAtStep:step batchIndex:batchIndex batchCount:batchCount];
+    
+    if ( !self._accumulatesGradients ) {
+        if ( fetchesOutputs ) {
+            return [self.model train:batch placeholders:self.placeholders error:error];
+        }
+        
+        [self _trainWithoutOutputs:batch error:error];
+        return nil;
+    }
+    
+    NSError *accumulateError;
+    id<TIOData> results = [self.model accumulate:batch placeholders:self.placeholders fetchOutputs:fetchesOutputs error:&accumulateError];
+    
+    // Gradients are only applied after a successful accumulation, and a failure to apply them
+    // does not hide the error of a failed accumulation
+    
+    if ( accumulateError != nil ) {
+        if ( error ) {
+            *error = accumulateError;
+        }
+        return nil;
+    }
+    
+    if ( (batchIndex + 1) % self.accumulationSteps == 0 || batchIndex == batchCount - 1 ) {
+        if ( ![self.model applyAccumulatedGradients:self.placeholders error:error] ) {
+            return nil;
+        }
+    }
+    
+    return fetchesOutputs ? results : nil;
+}
+
+/**
+ * `YES` if batches are accumulated as micro-batches, which requires a model that supports
+ * gradient accumulation. Otherwise each batch is trained on its own.
+ */
+
+- (BOOL)_accumulatesGradients {
+    return self.accumulationSteps > 1
+        && [self.model respondsToSelector:@selector(accumulatesGradients)]
+        && self.model.accumulatesGradients;
+}
+
+/**
+ * `YES` if the model's outputs should be fetched at a training step, which they always are on
+ * the last step of an epoch.
+ */
+
+- (BOOL)_fetchesOutputsAtStep:(NSUInteger)step batchIndex:(NSUInteger)batchIndex batchCount:(NSUInteger)batchCount {
+    if ( batchIndex == batchCount - 1 ) {
+        return YES;
+    }
+    
+    return self.lossInterval != 0 && (step + 1) % self.lossInterval == 0;
+}
+
+/**
+ * Trains the model on a batch without fetching its outputs when the model supports it.
+ */
+
+- (void)_trainWithoutOutputs:(TIOBatch *)batch error:(NSError * _Nullable *)error {
+    if ( [self.model respondsToSelector:@selector(train:placeholders:fetchOutputs:error:)] ) {
+        [self.model train:batch placeholders:self.placeholders fetchOutputs:NO error:error];
+    } else {
+        [self.model train:batch placeholders:self.placeholders error:error];
+    }
+}
+
+// MARK: - Prefetching
+
+/**
+ * Starts assembling an epoch's batches on the prefetch queue, at most `prefetchDepth` batches
+ * ahead of the one being trained on. Batches are assembled in the calling thread instead when
+ * `prefetchDepth` is 0.
+ *
+ * When the model can prepare batches their tensors are also written on the prefetch queue. The
+ * model is loaded on the calling thread first so that it is not loaded from two threads.
+ */
+
+- (void)_prefetchBatches:(NSUInteger)batchCount {
+    if ( self.prefetchDepth == 0 ) {
+        _prefetched = nil;
+        return;
+    }
+    
+    BOOL prepares = [self.model respondsToSelector:@selector(prepareBatch:error:)]
+        && [self.model load:nil];
+    
+    NSMutableArray<TIOBatch*> *prefetched = NSMutableArray.array;
+    dispatch_semaphore_t slots = dispatch_semaphore_create(self.prefetchDepth);
+    dispatch_semaphore_t ready = dispatch_semaphore_create(0);
+    
+    _prefetched = prefetched;
+    _prefetchSlots = slots;
+    _prefetchReady = ready;
+    
+    dispatch_async(_prefetchQueue, ^{
+        for ( NSUInteger batchIndex = 0; batchIndex < batchCount; batchIndex++ ) {
+            dispatch_semaphore_wait(slots, DISPATCH_TIME_FOREVER);
+            
+            @autoreleasepool {
+                TIOBatch *batch = [self _batchAtIndex:batchIndex];
+                
+                // A batch that cannot be prepared is trained on as is, which reports the error
+                
+                if ( prepares ) {
+                    batch = [self.model prepareBatch:batch error:nil] ?: batch;
+                }
+                
+                @synchronized (prefetched) {
+                    [prefetched addObject:batch];
+                }
+            }
+            
+            dispatch_semaphore_signal(ready);
+        }
+    });
+}
+
+/**
+ * Returns the next batch of the epoch, waiting for the prefetch queue to assemble it when
+ * prefetching, and freeing its slot so that the queue may begin on another.
+ */
+
+- (TIOBatch *)_nextBatchAtIndex:(NSUInteger)index {
+    if ( _prefetched == nil ) {
+        return [self _batchAtIndex:index];
+    }
+    
+    TIOBatch *batch;
+    
+    dispatch_semaphore_wait(_prefetchReady, DISPATCH_TIME_FOREVER);
+    
+    @synchronized (_prefetched) {
+        batch = _prefetched.firstObject;
+        [_prefetched removeObjectAtIndex:0];
+    }
+    
+    dispatch_semaphore_signal(_prefetchSlots);
+    
+    return batch;
+}
+
+// MARK: - Batches
+
 /**
  * The total number of batches needed to feed all of the data source's item
  * in chunks of the specified batch size.
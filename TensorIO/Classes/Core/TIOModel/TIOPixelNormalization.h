@@ -215,6 +215,24 @@ TIOPixelDenormalizer TIOPixelDenormalizerZeroToOne(void);
 
 TIOPixelDenormalizer TIOPixelDenormalizerNegativeOneToOne(void);
 
+// MARK: - Pixel Normalizers from Normalizations
+
+/**
+ * Returns the normalizing function for a pixel normalization: `nil` when the normalization
+ * is `kTIOPixelNormalizationNone`, a single bias normalizer when every channel shares a bias,
+ * and a per channel bias normalizer otherwise.
+ */
+
+TIOPixelNormalizer _Nullable TIOPixelNormalizerWithNormalization(TIOPixelNormalization normalization);
+
+/**
+ * Returns the denormalizing function for a pixel denormalization: `nil` when the denormalization
+ * is `kTIOPixelDenormalizationNone`, a single bias denormalizer when every channel shares a bias,
+ * and a per channel bias denormalizer otherwise.
+ */
+
+TIOPixelDenormalizer _Nullable TIOPixelDenormalizerWithDenormalization(TIOPixelDenormalization denormalization);
+
 // MARK: - Utilities
 
 /**
@@ -190,6 +190,34 @@ TIOPixelDenormalizer TIOPixelDenormalizerNegativeOneToOne(void) {
     };
 }
 
+// MARK: - Pixel Normalizers from Normalizations
+
+TIOPixelNormalizer _Nullable TIOPixelNormalizerWithNormalization(TIOPixelNormalization normalization) {
+    if ( TIOPixelNormalizationsEqual(normalization, kTIOPixelNormalizationNone)
+        || TIOPixelNormalizationsEqual(normalization, kTIOPixelNormalizationInvalid) ) {
+        return TIOPixelNormalizerNone();
+    }
+    
+    if ( normalization.redBias == normalization.greenBias && normalization.redBias == normalization.blueBias ) {
+        return TIOPixelNormalizerSingleBias(normalization);
+    } else {
+        return TIOPixelNormalizerPerChannelBias(normalization);
+    }
+}
+
+TIOPixelDenormalizer _Nullable TIOPixelDenormalizerWithDenormalization(TIOPixelDenormalization denormalization) {
+    if ( TIOPixelDenormalizationsEqual(denormalization, kTIOPixelDenormalizationNone)
+        || TIOPixelDenormalizationsEqual(denormalization, kTIOPixelDenormalizationInvalid) ) {
+        return TIOPixelDenormalizerNone();
+    }
+    
+    if ( denormalization.redBias == denormalization.greenBias && denormalization.redBias == denormalization.blueBias ) {
+        return TIOPixelDenormalizerSingleBias(denormalization);
+    } else {
+        return TIOPixelDenormalizerPerChannelBias(denormalization);
+    }
+}
+
 // MARK: - Utilities
 
 BOOL TIOPixelNormalizationsEqual(TIOPixelNormalization a, TIOPixelNormalization b) {
@@ -66,9 +66,11 @@ NS_ASSUME_NONNULL_BEGIN
 // MARK: - Run
 
 - (id<TIOData>)runOn:(id<TIOData>)input error:(NSError* _Nullable *)error;
+- (id<TIOData>)runOn:(id<TIOData>)input outputs:(NSArray<NSString*> *)outputs error:(NSError* _Nullable *)error;
 - (id<TIOData>)runOn:(id<TIOData>)input placeholders:(nullable NSDictionary<NSString*,id<TIOData>> *)placeholders error:(NSError* _Nullable *)error;
 - (id<TIOData>)run:(TIOBatch *)batch error:(NSError * _Nullable *)error;
 - (id<TIOData>)run:(TIOBatch *)batch placeholders:(nullable NSDictionary<NSString*,id<TIOData>> *)placeholders error:(NSError * _Nullable *)error;
+- (void)runOn:(id<TIOData>)input completion:(TIOModelCompletionHandler)completion;
 - (id<TIOData>)runOn:(id<TIOData>)input __attribute__((deprecated));
 
 @end
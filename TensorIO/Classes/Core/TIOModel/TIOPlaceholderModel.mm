@@ -29,7 +29,9 @@
 #import "TIOVectorLayerDescription.h"
 #import "TIOModelIO.h"
 
-@implementation TIOPlaceholderModel
+@implementation TIOPlaceholderModel {
+    dispatch_queue_t _runQueue;
+}
 
 + (nullable instancetype)modelWithBundleAtPath:(NSString *)path {
     return [[[TIOModelBundle alloc] initWithPath:path] newModel];
@@ -55,6 +57,8 @@
         _quantized = bundle.quantized;
         _type = bundle.type;
         _io = bundle.io;
+        
+        _runQueue = dispatch_queue_create("ai.doc.tensorio.placeholder.run", DISPATCH_QUEUE_SERIAL);
     }
     
     return self;
@@ -89,6 +93,10 @@
     return @{};
 }
 
+- (id<TIOData>)runOn:(id<TIOData>)input outputs:(NSArray<NSString*> *)outputs error:(NSError* _Nullable *)error {
+    return @{};
+}
+
 - (id<TIOData>)runOn:(id<TIOData>)input placeholders:(nullable NSDictionary<NSString*,id<TIOData>> *)placeholders error:(NSError* _Nullable *)error {
     return @{};
 }
@@ -101,6 +109,12 @@
     return @{};
 }
 
+- (void)runOn:(id<TIOData>)input completion:(TIOModelCompletionHandler)completion {
+    dispatch_async(_runQueue, ^{
+        completion(@{}, nil);
+    });
+}
+
 - (id<TIOData>)runOn:(id<TIOData>)input __attribute__((deprecated)) {
     return @{};
 }
@@ -20,6 +20,8 @@
 
 #import <Foundation/Foundation.h>
 
+#import "TIODataTypes.h"
+
 NS_ASSUME_NONNULL_BEGIN
 
 // MARK: - Quantization
@@ -150,4 +152,95 @@ TIODataDequantizer TIODataDequantizerNegativeOneToOne(void);
 
 _Nullable TIODataDequantizer TIODataDequantizerNone(void);
 
+// MARK: - Affine Quantization
+
+/**
+ * Describes quantization with a scale and an integer zero point, the scheme used by full-integer
+ * TensorFlow Lite models.
+ *
+ * @field scale The size of a single quantized step.
+ * @field zero_point The quantized value that represents zero.
+ *
+ * Values are related to their quantized representations by the following equation:
+ * @code
+ * value = (quantized_value - zero_point) * scale
+ * @endcode
+ */
+
+typedef struct TIODataAffineQuantization {
+    float scale;
+    int32_t zero_point;
+} TIODataAffineQuantization;
+
+/**
+ * A quantizing function that rounds values to the nearest quantized step and clamps them to the
+ * range of the data type.
+ *
+ * int8 layers share the `uint8_t` signature of other quantizers. Their quantizers produce
+ * offset values, i.e. the int8 value plus 128, which `TIOInt8FromQuantizedValue` converts to the
+ * bytes an int8 tensor holds.
+ *
+ * @param quantization The scale and zero point, with the zero point given in the range of the
+ *  data type.
+ * @param dtype `TIODataTypeInt8` or `TIODataTypeUInt8`.
+ *
+ * @return TIODataQuantizer The quantizing function.
+ */
+
+TIODataQuantizer TIODataQuantizerWithAffineQuantization(TIODataAffineQuantization quantization, TIODataType dtype);
+
+/**
+ * A dequantizing function for values quantized with a scale and zero point. For int8 layers the
+ * function expects offset values, see `TIODataQuantizerWithAffineQuantization`.
+ *
+ * @param quantization The scale and zero point, with the zero point given in the range of the
+ *  data type.
+ * @param dtype `TIODataTypeInt8` or `TIODataTypeUInt8`.
+ *
+ * @return TIODataDequantizer The dequantizing function.
+ */
+
+TIODataDequantizer TIODataDequantizerWithAffineQuantization(TIODataAffineQuantization quantization, TIODataType dtype);
+
+/**
+ * Converts the offset value a quantizer produces for an int8 layer to an int8 value.
+ */
+
+NS_INLINE int8_t TIOInt8FromQuantizedValue(uint8_t value) {
+    return (int8_t)(value ^ 0x80);
+}
+
+/**
+ * Converts an int8 value to the offset value a dequantizer expects for an int8 layer.
+ */
+
+NS_INLINE uint8_t TIOQuantizedValueFromInt8(int8_t value) {
+    return (uint8_t)value ^ 0x80;
+}
+
+/**
+ * Adds a bias to floats and converts them to int8 values in a single vectorized pass, rounding
+ * to the nearest integer and clamping to `[-128,127]`.
+ *
+ * @param src The floats to convert.
+ * @param dst The buffer that receives the int8 values.
+ * @param count The number of values to convert.
+ * @param bias A value added to each float before it is converted, e.g. -128 to store pixel
+ *  values of `[0,255]` as int8 values.
+ */
+
+void TIOConvertFloat32ToInt8(const float_t *src, int8_t *dst, size_t count, float_t bias);
+
+/**
+ * Converts int8 values to floats and adds a bias to them in a single vectorized pass.
+ *
+ * @param src The int8 values to convert.
+ * @param dst The buffer that receives the floats.
+ * @param count The number of values to convert.
+ * @param bias A value added to each converted value, e.g. 128 to read int8 values as pixel
+ *  values of `[0,255]`.
+ */
+
+void TIOConvertInt8ToFloat32(const int8_t *src, float_t *dst, size_t count, float_t bias);
+
 NS_ASSUME_NONNULL_END
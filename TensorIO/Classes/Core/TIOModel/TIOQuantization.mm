@@ -20,6 +20,10 @@
 
 #import "TIOQuantization.h"
 
+#import <Accelerate/Accelerate.h>
+
+#include <vector>
+
 // MARK: - Quantization
 
 TIODataQuantizer TIODataQuantizerWithQuantization(TIODataQuantization quantization) {
@@ -83,3 +87,59 @@ TIODataDequantizer TIODataDequantizerNegativeOneToOne(void) {
 _Nullable TIODataDequantizer TIODataDequantizerNone(void) {
     return nil;
 }
+
+// MARK: - Affine Quantization
+
+/**
+ * The zero point in the unsigned range of the offset values shared by uint8 and int8 layers.
+ */
+
+static int32_t TIOOffsetZeroPoint(TIODataAffineQuantization quantization, TIODataType dtype) {
+    return dtype == TIODataTypeInt8
+        ? quantization.zero_point + 128
+        : quantization.zero_point;
+}
+
+TIODataQuantizer TIODataQuantizerWithAffineQuantization(TIODataAffineQuantization quantization, TIODataType dtype) {
+    const float scale = 1.0 / quantization.scale;
+    const float zero_point = TIOOffsetZeroPoint(quantization, dtype);
+    
+    return ^uint8_t(float_t value) {
+        float_t quantized = roundf(value * scale) + zero_point;
+        return (uint8_t)fminf(fmaxf(quantized, 0), 255);
+    };
+}
+
+TIODataDequantizer TIODataDequantizerWithAffineQuantization(TIODataAffineQuantization quantization, TIODataType dtype) {
+    const float scale = quantization.scale;
+    const float zero_point = TIOOffsetZeroPoint(quantization, dtype);
+    
+    return ^float_t(uint8_t value) {
+        return ((float_t)value - zero_point) * scale;
+    };
+}
+
+// MARK: - Int8 Conversion
+
+void TIOConvertFloat32ToInt8(const float_t *src, int8_t *dst, size_t count, float_t bias) {
+    if ( count == 0 ) {
+        return;
+    }
+    
+    const float_t low = INT8_MIN;
+    const float_t high = INT8_MAX;
+    std::vector<float_t> values(count);
+    
+    vDSP_vsadd(src, 1, &bias, values.data(), 1, count);
+    vDSP_vclip(values.data(), 1, &low, &high, values.data(), 1, count);
+    vDSP_vfixr8(values.data(), 1, (char *)dst, 1, count);
+}
+
+void TIOConvertInt8ToFloat32(const int8_t *src, float_t *dst, size_t count, float_t bias) {
+    if ( count == 0 ) {
+        return;
+    }
+    
+    vDSP_vflt8((const char *)src, 1, dst, 1, count);
+    vDSP_vsadd(dst, 1, &bias, dst, 1, count);
+}
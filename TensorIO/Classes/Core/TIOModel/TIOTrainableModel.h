@@ -84,6 +84,85 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (BOOL)exportTo:(NSURL *)fileURL error:(NSError * _Nullable *)error;
 
+@optional
+
+/**
+ * Calls the underlying training op with a single batch and a set of placeholder
+ * values, optionally skipping the work of fetching the model's outputs, which
+ * are usually its loss.
+ *
+ * Trainers that only report the loss periodically use this method to avoid
+ * fetching it on every step.
+ *
+ * @param batch A batch of input data.
+ * @param placeholders A dictionary of `TIOData` conforming placeholder values,
+ *  which will be matched to placeholder layers in the model. May be nil.
+ * @param fetchOutputs `YES` to fetch and return the model's outputs, `NO` to
+ *  only run the training op.
+ * @param error Set if an error occurred during inference. May be nil.
+ * @return TIOData The results of training, or an empty dictionary if an error
+ *  occurs or no outputs were fetched.
+ */
+
+- (id<TIOData>)train:(TIOBatch *)batch placeholders:(nullable NSDictionary<NSString*,id<TIOData>> *)placeholders fetchOutputs:(BOOL)fetchOutputs error:(NSError * _Nullable *)error;
+
+/**
+ * Converts a batch to the tensors the model trains on ahead of the training
+ * step and returns a batch carrying them, which is then passed to one of the
+ * train or accumulate methods in place of the original batch.
+ *
+ * Trainers that prefetch batches call this method from a background queue, so
+ * that writing a batch's tensors overlaps with training on the previous one.
+ * The model must already be loaded and must not be unloaded while prepared
+ * batches are outstanding.
+ *
+ * @param batch A batch of input data.
+ * @param error Set if an error occurred while preparing the batch. May be nil.
+ * @return TIOBatch A batch with the same items as `batch` that carries its
+ *  prepared tensors, or `nil` if an error occurs.
+ */
+
+- (nullable TIOBatch *)prepareBatch:(TIOBatch *)batch error:(NSError * _Nullable *)error;
+
+/**
+ * `YES` if the model can accumulate gradients over several micro-batches and
+ * apply them in a single step, `NO` otherwise.
+ */
+
+@property (readonly) BOOL accumulatesGradients;
+
+/**
+ * Computes the gradients for a single micro-batch and adds them to the model's
+ * accumulated gradients without updating its weights.
+ *
+ * Trainers that accumulate gradients call this method once for each
+ * micro-batch and then call `applyAccumulatedGradients:error:`, so that the
+ * peak memory of a step is that of a single micro-batch.
+ *
+ * @param batch A micro-batch of input data.
+ * @param placeholders A dictionary of `TIOData` conforming placeholder values,
+ *  which will be matched to placeholder layers in the model. May be nil.
+ * @param fetchOutputs `YES` to fetch and return the model's outputs, `NO` to
+ *  only accumulate the gradients.
+ * @param error Set if an error occurred during accumulation. May be nil.
+ * @return TIOData The model's outputs for the micro-batch, or an empty
+ *  dictionary if an error occurs or no outputs were fetched.
+ */
+
+- (id<TIOData>)accumulate:(TIOBatch *)batch placeholders:(nullable NSDictionary<NSString*,id<TIOData>> *)placeholders fetchOutputs:(BOOL)fetchOutputs error:(NSError * _Nullable *)error;
+
+/**
+ * Updates the model's weights with its accumulated gradients and resets them.
+ *
+ * @param placeholders A dictionary of `TIOData` conforming placeholder values,
+ *  e.g. a learning rate, which will be matched to placeholder layers in the
+ *  model. May be nil.
+ * @param error Set if an error occurred while applying the gradients. May be nil.
+ * @return BOOL `YES` if the gradients were applied, `NO` otherwise.
+ */
+
+- (BOOL)applyAccumulatedGradients:(nullable NSDictionary<NSString*,id<TIOData>> *)placeholders error:(NSError * _Nullable *)error;
+
 @end
 
 NS_ASSUME_NONNULL_END
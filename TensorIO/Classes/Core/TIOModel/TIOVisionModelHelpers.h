@@ -64,6 +64,35 @@ BOOL TIOImageVolumesEqual(TIOImageVolume a, TIOImageVolume b);
  
 int TIOImageVolumeLength(TIOImageVolume volume);
 
+// MARK: - Resizing
+
+/**
+ * How the vision pipeline fits a pixel buffer to an input layer whose size or aspect ratio
+ * differs from it. Padding is black.
+ */
+
+typedef enum : NSUInteger {
+    TIOPixelBufferResizeModeCenterCrop,     // "center-crop": fill the layer and crop the overflow equally from both sides
+    TIOPixelBufferResizeModeLetterbox,      // "letterbox": fit inside the layer and pad equally on both sides
+    TIOPixelBufferResizeModeStretch,        // "stretch": fill the layer, scaling width and height independently
+    TIOPixelBufferResizeModeFit,            // "fit": fit inside the layer and pad the right or bottom
+    TIOPixelBufferResizeModeInvalid
+} TIOPixelBufferResizeMode;
+
+/**
+ * How the vision pipeline samples a pixel buffer when it is scaled. Lanczos is the default and
+ * reproduces the values of earlier versions of TensorIO.
+ */
+
+typedef enum : NSUInteger {
+    TIOPixelBufferInterpolationLanczos,     // "lanczos": the Lanczos resampling of vImageScale_ARGB8888
+    TIOPixelBufferInterpolationArea,        // "area": average the pixels covered when scaling down, bilinear when scaling up
+    TIOPixelBufferInterpolationNearest,     // "nearest": the nearest pixel
+    TIOPixelBufferInterpolationBilinear,    // "bilinear": the four nearest pixels, which aliases when scaling down
+    TIOPixelBufferInterpolationHighQuality, // "high-quality": bicubic, widened to every pixel covered when scaling down
+    TIOPixelBufferInterpolationInvalid
+} TIOPixelBufferInterpolation;
+
 NS_ASSUME_NONNULL_END
 
 #endif /* TIOVisionModelHelpers_h */
@@ -21,6 +21,8 @@
 #import <Foundation/Foundation.h>
 #import <AVFoundation/AVFoundation.h>
 
+#import "TIODataTypes.h"
+
 NS_ASSUME_NONNULL_BEGIN
 
 @class TIOPixelBufferLayerDescription;
@@ -28,15 +30,25 @@ NS_ASSUME_NONNULL_BEGIN
 /**
  * The `TIOVisionPipeline` is responsible for scaling and croping, rotating, and converting the provided pixel buffer
  * to an ARGB or BGRA pixel format, using properties specified by the model.
+ *
+ * A pipeline remembers the crop, resampling coefficients, and rotation tables it computes for the
+ * last few source geometries, i.e. the width, height, row length, and orientation of the pixel
+ * buffers it transforms, so that a stream of frames with the same geometry is transformed without
+ * further setup. Use a layer description's `visionPipeline` rather than creating a new pipeline
+ * for every pixel buffer. A pipeline may be used from more than one thread at a time.
  */
 
 @interface TIOVisionPipeline : NSObject
 
 /**
  * A description of the pixel input expected by the model.
+ *
+ * The pipeline returned by a description's `visionPipeline` does not own that description and
+ * this property becomes `nil` once the description is deallocated, after which the pipeline
+ * transforms nothing.
  */
 
-@property (readonly) TIOPixelBufferLayerDescription *pixelBufferDescription;
+@property (nullable, readonly) TIOPixelBufferLayerDescription *pixelBufferDescription;
 
 /**
  * Designated initializer.
@@ -57,6 +69,12 @@ NS_ASSUME_NONNULL_BEGIN
  * Transform a pixel buffer into the format required by the `TIOPixelBufferLayerDescription`.
  *
  * A single TIOVisionPipeline may be used to transform multiple pixel buffers for the same model.
+ * The pixel buffer is resized with the layer's `resizeMode` and `interpolation`, rotated, and
+ * converted to the layer's pixel format in a single pass into a pooled pixel buffer.
+ *
+ * With the default Lanczos interpolation the cropped pixel buffer is scaled with
+ * `vImageScale_ARGB8888`, as in earlier versions of TensorIO, and its pixels are unchanged.
+ * Other interpolations are resampled by the pipeline itself.
  *
  * @param pixelBuffer The `CVPixelBufferRef` that will be transformed.
  * @param orientation The orientation of the pixel buffer.
@@ -66,6 +84,32 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (nullable CVPixelBufferRef)transform:(CVPixelBufferRef)pixelBuffer orientation:(CGImagePropertyOrientation)orientation;
 
+/**
+ * Transforms a pixel buffer directly into the values of an input tensor, a row at a time.
+ *
+ * The source is cropped, stretched, or padded with black to the layer's size according to its
+ * `resizeMode` and sampled with its `interpolation`, by default a center crop scaled with the
+ * Lanczos resampling of `vImageScale_ARGB8888`. Rotation is applied by remapping tensor
+ * coordinates. Each row is resampled into a row of pixels in the layer's pixel format, which the
+ * vectorized pixel kernels then reorder, drop the alpha channel from, and normalize into the
+ * tensor.
+ *
+ * The default interpolation scales the cropped source into a temporary image first and produces
+ * the same tensor values as earlier versions of TensorIO. Other interpolations are opt-in through
+ * the layer's `interpolation` and resample each row directly from the source pixel buffer, without
+ * creating intermediate images.
+ *
+ * @param pixelBuffer The ARGB or BGRA `CVPixelBufferRef` that will be transformed.
+ * @param orientation The orientation of the pixel buffer.
+ * @param buffer The tensor values, which must have room for a single item of the layer.
+ * @param dtype The type of the tensor's values, `TIODataTypeFloat32`, `TIODataTypeUInt8`,
+ * `TIODataTypeFloat16`, or `TIODataTypeInt8`. Normalized values written to an integer tensor
+ * are clamped to its range, and int8 tensors store pixel values offset by -128 when the layer
+ * has no normalizer.
+ */
+
+- (void)transform:(CVPixelBufferRef)pixelBuffer orientation:(CGImagePropertyOrientation)orientation toBuffer:(void *)buffer dtype:(TIODataType)dtype;
+
 @end
 
 NS_ASSUME_NONNULL_END
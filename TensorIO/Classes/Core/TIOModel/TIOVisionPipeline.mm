@@ -22,115 +22,736 @@
 
 #import "TIOModel.h"
 #import "TIOCVPixelBufferHelpers.h"
-#import "TIOObjcDefer.h"
 #import "TIOPixelBufferLayerDescription.h"
+#import "TIOPixelBufferPool.h"
+#import "TIOPixelKernels.h"
 
-@implementation TIOVisionPipeline
+#import <simd/simd.h>
+#import <os/lock.h>
 
-- (instancetype)initWithTIOPixelBufferDescription:(TIOPixelBufferLayerDescription *)pixelBufferDescription {
-    if (self = [super init]) {
-        _pixelBufferDescription = pixelBufferDescription;
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/**
+ * The number of source geometries whose transforms a pipeline remembers, e.g. for a camera that
+ * alternates between a few orientations.
+ */
+
+static const size_t TIOVisionPipelineGeometryCapacity = 4;
+
+// MARK: - Resampling
+
+/**
+ * The source pixels that contribute to each destination pixel along one axis. Destination pixel
+ * `i` reads `taps` consecutive source pixels starting at `start[i]`, weighted by
+ * `weights[i * taps]` through `weights[i * taps + taps - 1]`. Destination pixels outside of
+ * `[contentStart, contentEnd)` are padding and read no source pixels.
+ */
+
+struct TIOResamplingAxis {
+    std::vector<int32_t> start;
+    std::vector<float_t> weights;
+    int32_t taps;
+    int32_t contentStart;
+    int32_t contentEnd;
+};
+
+/**
+ * A single source pixel's contribution to a destination pixel.
+ */
+
+typedef std::pair<int32_t, float_t> TIOResamplingTap;
+
+/**
+ * The Keys cubic convolution kernel with `a = -0.5`, i.e. Catmull-Rom.
+ */
+
+static inline float_t TIOCubicWeight(float_t x) {
+    x = std::abs(x);
+    
+    if ( x < 1 ) {
+        return (1.5f * x - 2.5f) * x * x + 1;
+    } else if ( x < 2 ) {
+        return ((-0.5f * x + 2.5f) * x - 4) * x + 2;
+    } else {
+        return 0;
     }
-    return self;
 }
 
-- (nullable CVPixelBufferRef)transform:(CVPixelBufferRef)pixelBuffer orientation:(CGImagePropertyOrientation)orientation {
-    CVPixelBufferRef resizedPixelBuffer = NULL;
-    CVPixelBufferRef rotatedPixelBuffer = NULL;
-    CVPixelBufferRef formattedPixelBuffer = NULL;
-    
-    // Resize pixel buffer
-    // :: pixelBuffer -> resizedPixelBuffer
+/**
+ * Appends the taps that interpolate linearly between the two source pixels nearest `center`.
+ */
+
+static inline void TIOLinearTaps(float_t center, std::vector<TIOResamplingTap> &taps) {
+    const float_t from = center - 0.5f;
+    const int32_t first = (int32_t)std::floor(from);
+    const float_t fraction = from - first;
     
-    const size_t srcWidth = CVPixelBufferGetWidth(pixelBuffer);
-    const size_t srcHeight = CVPixelBufferGetHeight(pixelBuffer);
-    const size_t dstWidth = self.pixelBufferDescription.imageVolume.width;
-    const size_t dstHeight = self.pixelBufferDescription.imageVolume.height;
+    taps.emplace_back(first, 1 - fraction);
+    taps.emplace_back(first + 1, fraction);
+}
+
+/**
+ * Computes the taps that resample `length` source pixels beginning at `origin` to the
+ * `contentLength` destination pixels beginning at `contentStart`, out of `size` destination
+ * pixels. Taps that fall outside the `limit` source pixels are clamped to the edge.
+ *
+ * Nearest reads the source pixel under each destination pixel's center and bilinear the two
+ * nearest source pixels. Area averages the source area each destination pixel covers when
+ * scaling down and is bilinear when scaling up. High quality is bicubic, with the kernel
+ * widened by the scale when scaling down so that every covered source pixel contributes.
+ * Lanczos images have already been scaled by vImage and are read pixel for pixel, like nearest.
+ */
+
+static void TIOResamplingAxisCompute(TIOResamplingAxis &axis, float_t origin, float_t length, int32_t contentStart, int32_t contentLength, int32_t size, int32_t limit, TIOPixelBufferInterpolation interpolation) {
+    const float_t scale = length / contentLength;
+    const float_t stretch = std::max<float_t>(scale, 1);
+    int32_t taps;
     
-    if (srcWidth != dstWidth || srcHeight != dstHeight) {
-        resizedPixelBuffer = TIOCVPixelBufferResizeToSquare(pixelBuffer, CGSizeMake(dstWidth, dstHeight));
-    } else {
-        resizedPixelBuffer = pixelBuffer;
-        CVPixelBufferRetain(resizedPixelBuffer);
+    switch (interpolation) {
+    case TIOPixelBufferInterpolationLanczos:
+    case TIOPixelBufferInterpolationNearest:
+        taps = 1;
+        break;
+    case TIOPixelBufferInterpolationBilinear:
+        taps = 2;
+        break;
+    case TIOPixelBufferInterpolationHighQuality:
+        taps = (int32_t)std::ceil(4 * stretch) + 1;
+        break;
+    default:
+        taps = scale > 1 ? (int32_t)std::ceil(scale) + 1 : 2;
+        break;
     }
     
-    // Error handling and cleanup
+    taps = std::max(1, std::min(taps, limit));
     
-    if (resizedPixelBuffer == NULL) {
-        NSLog(@"Unable to resize pixel buffer");
-        return NULL;
+    axis.taps = taps;
+    axis.contentStart = contentStart;
+    axis.contentEnd = contentStart + contentLength;
+    axis.start.assign(size, 0);
+    axis.weights.assign(size * taps, 0);
+    
+    std::vector<TIOResamplingTap> contributions;
+    
+    for (int32_t i = axis.contentStart; i < axis.contentEnd; i++) {
+        const float_t center = origin + (i - contentStart + 0.5f) * scale;
+        
+        // Source pixels and their weights, in increasing order
+        
+        contributions.clear();
+        
+        switch (interpolation) {
+        case TIOPixelBufferInterpolationLanczos:
+        case TIOPixelBufferInterpolationNearest:
+            contributions.emplace_back((int32_t)std::floor(center), 1);
+            break;
+        case TIOPixelBufferInterpolationBilinear:
+            TIOLinearTaps(center, contributions);
+            break;
+        case TIOPixelBufferInterpolationHighQuality:
+            {
+            const float_t support = 2 * stretch;
+            float_t total = 0;
+            
+            for (int32_t j = (int32_t)std::floor(center - support); j <= (int32_t)std::ceil(center + support); j++) {
+                const float_t weight = TIOCubicWeight((j + 0.5f - center) / stretch);
+                if ( weight != 0 ) {
+                    contributions.emplace_back(j, weight);
+                    total += weight;
+                }
+            }
+            
+            for (TIOResamplingTap &tap : contributions) {
+                tap.second /= total;
+            }
+            }
+            break;
+        default:
+            if ( scale > 1 ) {
+                const float_t from = center - scale / 2;
+                const float_t to = center + scale / 2;
+                
+                for (int32_t j = (int32_t)std::floor(from); j < to; j++) {
+                    const float_t overlap = std::min<float_t>(j + 1, to) - std::max<float_t>(j, from);
+                    if ( overlap > 0 ) {
+                        contributions.emplace_back(j, overlap / scale);
+                    }
+                }
+            } else {
+                TIOLinearTaps(center, contributions);
+            }
+            break;
+        }
+        
+        // Clamp source pixels to the edges and place them relative to the first tap
+        
+        const int32_t start = std::max(0, std::min(contributions.front().first, limit - taps));
+        float_t *weights = axis.weights.data() + i * taps;
+        
+        axis.start[i] = start;
+        
+        for (const TIOResamplingTap &tap : contributions) {
+            const int32_t j = std::max(0, std::min(tap.first, limit - 1));
+            weights[std::max(0, std::min(j - start, taps - 1))] += tap.second;
+        }
     }
+}
+
+// MARK: - Geometry
+
+/**
+ * Everything the single pass transform computes for a source geometry, which is reused for
+ * every pixel buffer with that geometry: the resampling axes, the byte offsets of the first tap
+ * of each resampled column and row, and the tables that map tensor coordinates through the
+ * rotation to resampled coordinates.
+ *
+ * Lanczos geometries that scale the source first scale the `scaleRect` of the source with
+ * vImage into a `scaledWidth` by `scaledHeight` image, which the axes then sample instead of the
+ * source. `sampleBytesPerRow` is the row stride of whichever image is sampled.
+ *
+ * Tensor value `(x,y)` is sampled from resampled column `columns[x]` and row `rows[y]`, or from
+ * column `columns[y]` and row `rows[x]` when the rotation is a quarter turn and `transposed`.
+ */
+
+struct TIOVisionGeometry {
+    int32_t width;
+    int32_t height;
+    size_t bytesPerRow;
+    CGImagePropertyOrientation orientation;
+    bool scales;
+    CGRect scaleRect;
+    int32_t scaledWidth;
+    int32_t scaledHeight;
+    size_t sampleBytesPerRow;
+    TIOResamplingAxis xs;
+    TIOResamplingAxis ys;
+    std::vector<size_t> columnOffsets;
+    std::vector<size_t> rowOffsets;
+    std::vector<int32_t> columns;
+    std::vector<int32_t> rows;
+    bool transposed;
+};
+
+/**
+ * Computes the geometry that crops or pads, resamples, and rotates a source image to a tensor.
+ */
+
+static std::shared_ptr<const TIOVisionGeometry> TIOVisionGeometryCreate(int32_t srcWidth, int32_t srcHeight, size_t bytesPerRow, CGImagePropertyOrientation orientation, TIOImageVolume volume, TIOPixelBufferResizeMode resizeMode, TIOPixelBufferInterpolation interpolation) {
+    assert(volume.width > 0 && volume.height > 0);
     
-    tio_defer_block {
-        CVPixelBufferRelease(resizedPixelBuffer);
-    };
+    auto geometry = std::make_shared<TIOVisionGeometry>();
     
-    // Rotate pixel buffer
-    // :: resizedPixelBuffer -> rotatedPixelBuffer
+    geometry->width = srcWidth;
+    geometry->height = srcHeight;
+    geometry->bytesPerRow = bytesPerRow;
+    geometry->orientation = orientation;
+    geometry->scales = false;
+    geometry->sampleBytesPerRow = bytesPerRow;
+    
+    // Rotation, which swaps the width and height of the resampled image for quarter turns
+    
+    TIOCVPixelBufferCounterclockwiseRotation rotation;
     
     switch (orientation) {
     case kCGImagePropertyOrientationUp:
-        rotatedPixelBuffer = resizedPixelBuffer;
-        CVPixelBufferRetain(rotatedPixelBuffer);
+        rotation = Rotate0Degrees;
         break;
     case kCGImagePropertyOrientationRight:
-        rotatedPixelBuffer = TIOCVPixelBufferRotate(resizedPixelBuffer, Rotate270Degrees);
+        rotation = Rotate270Degrees;
         break;
     case kCGImagePropertyOrientationDown:
-        rotatedPixelBuffer = TIOCVPixelBufferRotate(resizedPixelBuffer, Rotate180Degrees);
+        rotation = Rotate180Degrees;
         break;
     case kCGImagePropertyOrientationLeft:
-        rotatedPixelBuffer = TIOCVPixelBufferRotate(resizedPixelBuffer, Rotate90Degrees);
+        rotation = Rotate90Degrees;
         break;
     default:
         NSLog(@"Unknown orientation, assuming kCGImagePropertyOrientationUp, reported: %d", orientation);
-        rotatedPixelBuffer = resizedPixelBuffer;
-        CVPixelBufferRetain(rotatedPixelBuffer);
+        rotation = Rotate0Degrees;
         break;
     }
     
-    // Error handling and cleanup
+    geometry->transposed = rotation == Rotate90Degrees || rotation == Rotate270Degrees;
+    
+    const int32_t resampledWidth = geometry->transposed ? volume.height : volume.width;
+    const int32_t resampledHeight = geometry->transposed ? volume.width : volume.height;
     
-    if (rotatedPixelBuffer == NULL) {
-        NSLog(@"Unable to rotate pixel buffer");
+    // Tensor coordinates run backwards along a flipped resampled axis
+    
+    const bool flipsColumns = rotation == Rotate90Degrees || rotation == Rotate180Degrees;
+    const bool flipsRows = rotation == Rotate180Degrees || rotation == Rotate270Degrees;
+    
+    // Fit the source to the resampled image
+    
+    float_t cropX = 0;
+    float_t cropY = 0;
+    float_t cropWidth = srcWidth;
+    float_t cropHeight = srcHeight;
+    int32_t contentX = 0;
+    int32_t contentY = 0;
+    int32_t contentWidth = resampledWidth;
+    int32_t contentHeight = resampledHeight;
+    
+    switch (resizeMode) {
+    case TIOPixelBufferResizeModeStretch:
+        break;
+    case TIOPixelBufferResizeModeLetterbox:
+    case TIOPixelBufferResizeModeFit:
+        {
+        // Fit the whole source inside the resampled image and pad the rest, equally on both sides
+        // for a letterbox or after the source in tensor coordinates for a fit
+        
+        const float_t scale = std::max((float_t)srcWidth / resampledWidth, (float_t)srcHeight / resampledHeight);
+        
+        contentWidth = std::max(1, std::min(resampledWidth, (int32_t)std::lround(srcWidth / scale)));
+        contentHeight = std::max(1, std::min(resampledHeight, (int32_t)std::lround(srcHeight / scale)));
+        
+        if ( resizeMode == TIOPixelBufferResizeModeLetterbox ) {
+            contentX = (resampledWidth - contentWidth) / 2;
+            contentY = (resampledHeight - contentHeight) / 2;
+        } else {
+            contentX = flipsColumns ? resampledWidth - contentWidth : 0;
+            contentY = flipsRows ? resampledHeight - contentHeight : 0;
+        }
+        }
+        break;
+    default:
+        {
+        // Center crop the source to the aspect ratio of the resampled image
+        
+        const float_t scale = std::min((float_t)srcWidth / resampledWidth, (float_t)srcHeight / resampledHeight);
+        
+        cropWidth = resampledWidth * scale;
+        cropHeight = resampledHeight * scale;
+        cropX = (srcWidth - cropWidth) / 2;
+        cropY = (srcHeight - cropHeight) / 2;
+        }
+        break;
+    }
+    
+    // Lanczos crops whole pixels from the center of the source, as earlier versions of TensorIO
+    // did, and scales the crop with vImage when its size differs from the content, after which
+    // the scaled image is sampled pixel for pixel
+    
+    int32_t sampledWidth = srcWidth;
+    int32_t sampledHeight = srcHeight;
+    
+    if ( interpolation == TIOPixelBufferInterpolationLanczos ) {
+        const int32_t width = std::max(1, std::min(srcWidth, (int32_t)std::lround(cropWidth)));
+        const int32_t height = std::max(1, std::min(srcHeight, (int32_t)std::lround(cropHeight)));
+        
+        cropX = (srcWidth - width) / 2;
+        cropY = (srcHeight - height) / 2;
+        cropWidth = width;
+        cropHeight = height;
+        
+        if ( width != contentWidth || height != contentHeight ) {
+            geometry->scales = true;
+            geometry->scaleRect = CGRectMake(cropX, cropY, width, height);
+            geometry->scaledWidth = contentWidth;
+            geometry->scaledHeight = contentHeight;
+            geometry->sampleBytesPerRow = (size_t)contentWidth * 4;
+            
+            cropX = 0;
+            cropY = 0;
+            cropWidth = contentWidth;
+            cropHeight = contentHeight;
+            sampledWidth = contentWidth;
+            sampledHeight = contentHeight;
+        }
+    }
+    
+    TIOResamplingAxisCompute(geometry->xs, cropX, cropWidth, contentX, contentWidth, resampledWidth, sampledWidth, interpolation);
+    TIOResamplingAxisCompute(geometry->ys, cropY, cropHeight, contentY, contentHeight, resampledHeight, sampledHeight, interpolation);
+    
+    geometry->columnOffsets.resize(resampledWidth);
+    geometry->rowOffsets.resize(resampledHeight);
+    
+    for (int32_t i = 0; i < resampledWidth; i++) {
+        geometry->columnOffsets[i] = (size_t)geometry->xs.start[i] * 4;
+    }
+    
+    for (int32_t i = 0; i < resampledHeight; i++) {
+        geometry->rowOffsets[i] = (size_t)geometry->ys.start[i] * geometry->sampleBytesPerRow;
+    }
+    
+    // Rotation tables
+    
+    geometry->columns.resize(resampledWidth);
+    geometry->rows.resize(resampledHeight);
+    
+    for (int32_t i = 0; i < resampledWidth; i++) {
+        geometry->columns[i] = flipsColumns ? resampledWidth - 1 - i : i;
+    }
+    
+    for (int32_t i = 0; i < resampledHeight; i++) {
+        geometry->rows[i] = flipsRows ? resampledHeight - 1 - i : i;
+    }
+    
+    return geometry;
+}
+
+// MARK: - Transform
+
+/**
+ * Returns the pixels a geometry samples: the source pixels, or for a Lanczos geometry that scales
+ * the source, the source's `scaleRect` scaled into `scaled` with `vImageScale_ARGB8888`, exactly
+ * as `TIOCVPixelBufferResizeToSquare` scales it. Returns NULL if the pixels cannot be scaled.
+ */
+
+static const uint8_t *TIOVisionGeometrySamplePixels(const TIOVisionGeometry &geometry, const uint8_t *pixels, std::vector<uint8_t> &scaled) {
+    if ( !geometry.scales ) {
+        return pixels;
+    }
+    
+    const CGRect rect = geometry.scaleRect;
+    
+    scaled.resize(geometry.sampleBytesPerRow * geometry.scaledHeight);
+    
+    vImage_Buffer srcImageBuffer;
+    
+    srcImageBuffer.width = (vImagePixelCount)rect.size.width;
+    srcImageBuffer.height = (vImagePixelCount)rect.size.height;
+    srcImageBuffer.rowBytes = geometry.bytesPerRow;
+    srcImageBuffer.data = (void *)(pixels + (size_t)rect.origin.y * geometry.bytesPerRow + (size_t)rect.origin.x * 4);
+    
+    vImage_Buffer destImageBuffer;
+    
+    destImageBuffer.width = (vImagePixelCount)geometry.scaledWidth;
+    destImageBuffer.height = (vImagePixelCount)geometry.scaledHeight;
+    destImageBuffer.rowBytes = geometry.sampleBytesPerRow;
+    destImageBuffer.data = scaled.data();
+    
+    if ( vImageScale_ARGB8888(&srcImageBuffer, &destImageBuffer, NULL, kvImageNoFlags) != kvImageNoError ) {
+        NSLog(@"Error scaling pixel buffer");
         return NULL;
     }
     
-    tio_defer_block {
-        CVPixelBufferRelease(rotatedPixelBuffer);
-    };
+    return scaled.data();
+}
+
+/**
+ * The order in which a source pixel's channels are written to a pixel of the layer's format:
+ * unchanged when the formats match and reversed when converting between ARGB and BGRA.
+ */
+
+static const int *TIOVisionPipelineLanes(OSType srcFormat, OSType dstFormat) {
+    static const int Identity[4] = { 0, 1, 2, 3 };
+    static const int Reversed[4] = { 3, 2, 1, 0 };
     
-    // Convert pixel buffer to ARGB
-    // :: rotatedPixelBuffer ->formattedPixelBuffer
+    return srcFormat == dstFormat ? Identity : Reversed;
+}
+
+/**
+ * Samples and rotates one row of the transformed image into `width` pixels, reordering each
+ * source pixel's channels by `lanes`. Resampled values are rounded and clamped to whole pixel
+ * values, as they would be in a scaled pixel buffer, and pixels outside of the resampled
+ * content are `padding`, already in the reordered format.
+ *
+ * Geometries whose axes read a single tap, i.e. nearest sampling or an unscaled crop, copy
+ * source pixels rather than weighting them.
+ */
+
+static void TIOResampleRow(const uint8_t *pixels, const TIOVisionGeometry &geometry, const int lanes[4], int32_t y, int32_t width, simd_uchar4 padding, uint8_t *out) {
+    const TIOResamplingAxis &xs = geometry.xs;
+    const TIOResamplingAxis &ys = geometry.ys;
+    const size_t bytesPerRow = geometry.sampleBytesPerRow;
+    const bool copies = xs.taps == 1 && ys.taps == 1;
+    const simd_float4 black = { 0, 0, 0, 0 };
+    const simd_float4 white = { 255, 255, 255, 255 };
     
-    const OSType srcFormat = CVPixelBufferGetPixelFormatType(rotatedPixelBuffer);
-    const OSType dstFormat = self.pixelBufferDescription.pixelFormat;
+    for (int32_t x = 0; x < width; x++) {
+        const int32_t rx = geometry.transposed ? geometry.columns[y] : geometry.columns[x];
+        const int32_t ry = geometry.transposed ? geometry.rows[x] : geometry.rows[y];
+        simd_uchar4 pixel;
+        
+        if ( rx < xs.contentStart || rx >= xs.contentEnd || ry < ys.contentStart || ry >= ys.contentEnd ) {
+            std::memcpy(out + x * 4, &padding, sizeof(padding));
+            continue;
+        }
+        
+        const uint8_t *origin = pixels + geometry.rowOffsets[ry] + geometry.columnOffsets[rx];
+        
+        if ( copies ) {
+            std::memcpy(&pixel, origin, sizeof(pixel));
+        } else {
+            const float_t *xWeights = xs.weights.data() + rx * xs.taps;
+            const float_t *yWeights = ys.weights.data() + ry * ys.taps;
+            simd_float4 sum = { 0, 0, 0, 0 };
+            
+            for (int32_t ty = 0; ty < ys.taps; ty++) {
+                if ( yWeights[ty] == 0 ) {
+                    continue;
+                }
+                
+                const uint8_t *row = origin + ty * bytesPerRow;
+                simd_float4 rowSum = { 0, 0, 0, 0 };
+                
+                for (int32_t tx = 0; tx < xs.taps; tx++) {
+                    simd_uchar4 tap;
+                    std::memcpy(&tap, row + tx * 4, sizeof(tap));
+                    rowSum += simd_float(tap) * xWeights[tx];
+                }
+                
+                sum += rowSum * yWeights[ty];
+            }
+            
+            pixel = simd_uchar(simd_clamp(simd_floor(sum + 0.5f), black, white));
+        }
+        
+        const simd_uchar4 reordered = { pixel[lanes[0]], pixel[lanes[1]], pixel[lanes[2]], pixel[lanes[3]] };
+        std::memcpy(out + x * 4, &reordered, sizeof(reordered));
+    }
+}
+
+/**
+ * Samples, rotates, and normalizes a pixel buffer into tensor values a row at a time. Each row
+ * is resampled into `pixelFormat` pixels and then normalized by the pixel kernels, which order
+ * the tensor's channels RGB for ARGB and BGR for BGRA, followed by alpha. A custom normalizer,
+ * whose normalization is `kTIOPixelNormalizationInvalid`, is instead called for every value.
+ */
+
+template <typename T>
+static void TIOTransformPixels(const uint8_t *pixels, const TIOVisionGeometry &geometry, const int lanes[4], OSType pixelFormat, TIOImageVolume volume, T *tensor, TIOPixelNormalization normalization, _Nullable TIOPixelNormalizer normalizer) {
+    const simd_uchar4 padding = pixelFormat == kCVPixelFormatType_32ARGB
+        ? simd_make_uchar4(255, 0, 0, 0)
+        : simd_make_uchar4(0, 0, 0, 255);
+    const int offset = pixelFormat == kCVPixelFormatType_32ARGB ? 1 : 0;
+    const bool custom = normalizer != nil && TIOPixelNormalizationsEqual(normalization, kTIOPixelNormalizationInvalid);
+    const size_t rowStride = volume.width * volume.channels;
+    
+    std::vector<uint8_t> row((size_t)volume.width * 4);
+    
+    if ( normalizer == nil ) {
+        normalization = kTIOPixelNormalizationNone;
+    }
+    
+    for (int32_t y = 0; y < volume.height; y++) {
+        T *out = tensor + y * rowStride;
+        
+        TIOResampleRow(pixels, geometry, lanes, y, volume.width, padding, row.data());
+        
+        if ( !custom ) {
+            TIONormalizePixels(row.data(), row.size(), pixelFormat, volume.width, 1, out, volume.channels, normalization);
+            continue;
+        }
+        
+        for (int32_t x = 0; x < volume.width; x++) {
+            for (int c = 0; c < volume.channels; c++) {
+                TIOStoreNormalizedValue(normalizer(row[x * 4 + (c + offset) % 4], c), out + x * volume.channels + c);
+            }
+        }
+    }
+}
+
+@implementation TIOVisionPipeline {
+    TIOPixelBufferLayerDescription *_pixelBufferDescription;
+    __weak TIOPixelBufferLayerDescription *_unretainedPixelBufferDescription;
+    os_unfair_lock _geometriesLock;
+    std::vector<std::shared_ptr<const TIOVisionGeometry>> _geometries; // least recently used first
+}
+
+- (instancetype)initWithTIOPixelBufferDescription:(TIOPixelBufferLayerDescription *)pixelBufferDescription {
+    if (self = [super init]) {
+        _pixelBufferDescription = pixelBufferDescription;
+        _geometriesLock = OS_UNFAIR_LOCK_INIT;
+    }
+    return self;
+}
+
+/**
+ * Initializes the pipeline a layer description owns, which must not retain that description.
+ */
+
+- (instancetype)initWithUnretainedTIOPixelBufferDescription:(TIOPixelBufferLayerDescription *)pixelBufferDescription {
+    if (self = [super init]) {
+        _unretainedPixelBufferDescription = pixelBufferDescription;
+        _geometriesLock = OS_UNFAIR_LOCK_INIT;
+    }
+    return self;
+}
+
+- (TIOPixelBufferLayerDescription *)pixelBufferDescription {
+    return _pixelBufferDescription != nil
+        ? _pixelBufferDescription
+        : _unretainedPixelBufferDescription;
+}
+
+/**
+ * Returns the geometry for a source pixel buffer, computing it only if it is not one of the
+ * geometries the pipeline has recently transformed. The caller passes the description it read
+ * rather than reading it again, since the pipeline's reference to it may be weak.
+ */
+
+- (std::shared_ptr<const TIOVisionGeometry>)geometryForWidth:(int32_t)width height:(int32_t)height bytesPerRow:(size_t)bytesPerRow orientation:(CGImagePropertyOrientation)orientation description:(TIOPixelBufferLayerDescription *)description {
+    std::shared_ptr<const TIOVisionGeometry> geometry;
+    
+    os_unfair_lock_lock(&_geometriesLock);
+    
+    for (auto it = _geometries.begin(); it != _geometries.end(); ++it) {
+        if ( (*it)->width == width && (*it)->height == height && (*it)->bytesPerRow == bytesPerRow && (*it)->orientation == orientation ) {
+            geometry = *it;
+            _geometries.erase(it);
+            _geometries.push_back(geometry);
+            break;
+        }
+    }
+    
+    os_unfair_lock_unlock(&_geometriesLock);
+    
+    if ( geometry != nullptr ) {
+        return geometry;
+    }
+    
+    // Compute the geometry outside the lock
+    
+    geometry = TIOVisionGeometryCreate(width, height, bytesPerRow, orientation, description.imageVolume, description.resizeMode, description.interpolation);
+    
+    os_unfair_lock_lock(&_geometriesLock);
+    
+    _geometries.push_back(geometry);
+    
+    if ( _geometries.size() > TIOVisionPipelineGeometryCapacity ) {
+        _geometries.erase(_geometries.begin());
+    }
+    
+    os_unfair_lock_unlock(&_geometriesLock);
+    
+    return geometry;
+}
+
+- (nullable CVPixelBufferRef)transform:(CVPixelBufferRef)pixelBuffer orientation:(CGImagePropertyOrientation)orientation {
+    TIOPixelBufferLayerDescription *description = self.pixelBufferDescription;
+    
+    if ( description == nil ) {
+        NSLog(@"The pixel buffer description was deallocated, unable to transform pixel buffer");
+        return NULL;
+    }
+    
+    const TIOImageVolume volume = description.imageVolume;
+    const OSType srcFormat = CVPixelBufferGetPixelFormatType(pixelBuffer);
+    const OSType dstFormat = description.pixelFormat;
     
     assert(srcFormat == kCVPixelFormatType_32BGRA || srcFormat == kCVPixelFormatType_32ARGB);
     
-    if (srcFormat == kCVPixelFormatType_32BGRA && dstFormat == kCVPixelFormatType_32ARGB ) {
-        formattedPixelBuffer = TIOCVPixelBufferCreateARGBFromBGRA(rotatedPixelBuffer);
-    } else if (srcFormat == kCVPixelFormatType_32ARGB && dstFormat == kCVPixelFormatType_32BGRA) {
-        formattedPixelBuffer = TIOCVPixelBufferCreateBGRAFromARGB(rotatedPixelBuffer);
-    } else {
-        formattedPixelBuffer = rotatedPixelBuffer;
-        CVPixelBufferRetain(formattedPixelBuffer);
+    // Cropping or padding, resampling, and rotation, which are computed once for each source geometry
+    
+    const int32_t srcWidth = (int32_t)CVPixelBufferGetWidth(pixelBuffer);
+    const int32_t srcHeight = (int32_t)CVPixelBufferGetHeight(pixelBuffer);
+    const size_t bytesPerRow = CVPixelBufferGetBytesPerRow(pixelBuffer);
+    
+    std::shared_ptr<const TIOVisionGeometry> geometry = [self geometryForWidth:srcWidth height:srcHeight bytesPerRow:bytesPerRow orientation:orientation description:description];
+    
+    const int *lanes = TIOVisionPipelineLanes(srcFormat, dstFormat);
+    
+    // Padding is opaque black
+    
+    const simd_uchar4 padding = dstFormat == kCVPixelFormatType_32ARGB
+        ? simd_make_uchar4(255, 0, 0, 0)
+        : simd_make_uchar4(0, 0, 0, 255);
+    
+    // Transform into a pixel buffer with four channels per pixel
+    
+    CVPixelBufferRef transformedPixelBuffer = [TIOPixelBufferPool.sharedPool createPixelBufferWithWidth:volume.width height:volume.height pixelFormat:dstFormat];
+    
+    if (transformedPixelBuffer == NULL) {
+        NSLog(@"Unable to create pixel buffer");
+        return NULL;
     }
     
-    // Error handling and cleanup
+    CVPixelBufferLockBaseAddress(pixelBuffer, kCVPixelBufferLock_ReadOnly);
+    
+    std::vector<uint8_t> scaled;
+    const uint8_t *pixels = TIOVisionGeometrySamplePixels(*geometry, (const uint8_t *)CVPixelBufferGetBaseAddress(pixelBuffer), scaled);
     
-    if (formattedPixelBuffer == NULL) {
-        NSLog(@"Unable to convert pixel buffer format");
+    if ( pixels == NULL ) {
+        CVPixelBufferUnlockBaseAddress(pixelBuffer, kCVPixelBufferLock_ReadOnly);
+        CVPixelBufferRelease(transformedPixelBuffer);
         return NULL;
     }
     
-    tio_defer_block {
-        CFAutorelease(formattedPixelBuffer);
-    };
+    CVPixelBufferLockBaseAddress(transformedPixelBuffer, kNilOptions);
+    
+    uint8_t *transformedPixels = (uint8_t *)CVPixelBufferGetBaseAddress(transformedPixelBuffer);
+    const size_t rowStride = CVPixelBufferGetBytesPerRow(transformedPixelBuffer);
+    
+    for (int32_t y = 0; y < volume.height; y++) {
+        TIOResampleRow(pixels, *geometry, lanes, y, volume.width, padding, transformedPixels + y * rowStride);
+    }
+    
+    CVPixelBufferUnlockBaseAddress(transformedPixelBuffer, kNilOptions);
+    CVPixelBufferUnlockBaseAddress(pixelBuffer, kCVPixelBufferLock_ReadOnly);
+    
+    return (CVPixelBufferRef)CFAutorelease(transformedPixelBuffer);
+}
+
+- (void)transform:(CVPixelBufferRef)pixelBuffer orientation:(CGImagePropertyOrientation)orientation toBuffer:(void *)buffer dtype:(TIODataType)dtype {
+    assert(dtype == TIODataTypeFloat32 || dtype == TIODataTypeUInt8 || dtype == TIODataTypeFloat16 || dtype == TIODataTypeInt8);
+    
+    TIOPixelBufferLayerDescription *description = self.pixelBufferDescription;
     
-    // Return the formatted pixel buffer
+    if ( description == nil ) {
+        NSLog(@"The pixel buffer description was deallocated, unable to transform pixel buffer");
+        return;
+    }
+    
+    const TIOImageVolume volume = description.imageVolume;
+    const OSType srcFormat = CVPixelBufferGetPixelFormatType(pixelBuffer);
+    const OSType dstFormat = description.pixelFormat;
+    
+    assert(srcFormat == kCVPixelFormatType_32BGRA || srcFormat == kCVPixelFormatType_32ARGB);
+    assert(volume.channels <= 4);
+    
+    // Cropping or padding, resampling, and rotation, which are computed once for each source geometry
+    
+    const int32_t srcWidth = (int32_t)CVPixelBufferGetWidth(pixelBuffer);
+    const int32_t srcHeight = (int32_t)CVPixelBufferGetHeight(pixelBuffer);
+    const size_t bytesPerRow = CVPixelBufferGetBytesPerRow(pixelBuffer);
+    
+    std::shared_ptr<const TIOVisionGeometry> geometry = [self geometryForWidth:srcWidth height:srcHeight bytesPerRow:bytesPerRow orientation:orientation description:description];
+    
+    // Rows are resampled into the layer's pixel format, whose channels the pixel kernels order
+    // RGB for ARGB layers and BGR for BGRA layers, followed by alpha
+    
+    const int *lanes = TIOVisionPipelineLanes(srcFormat, dstFormat);
+    
+    // Transform
+    
+    CVPixelBufferLockBaseAddress(pixelBuffer, kCVPixelBufferLock_ReadOnly);
+    
+    std::vector<uint8_t> scaled;
+    const uint8_t *pixels = TIOVisionGeometrySamplePixels(*geometry, (const uint8_t *)CVPixelBufferGetBaseAddress(pixelBuffer), scaled);
+    
+    if ( pixels == NULL ) {
+        CVPixelBufferUnlockBaseAddress(pixelBuffer, kCVPixelBufferLock_ReadOnly);
+        return;
+    }
+    
+    switch (dtype) {
+    case TIODataTypeUInt8:
+        TIOTransformPixels<uint8_t>(pixels, *geometry, lanes, dstFormat, volume, (uint8_t *)buffer,
+            description.normalization, description.normalizer);
+        break;
+    case TIODataTypeFloat16:
+        TIOTransformPixels<TIOFloat16>(pixels, *geometry, lanes, dstFormat, volume, (TIOFloat16 *)buffer,
+            description.normalization, description.normalizer);
+        break;
+    case TIODataTypeInt8:
+        TIOTransformPixels<int8_t>(pixels, *geometry, lanes, dstFormat, volume, (int8_t *)buffer,
+            description.normalization, description.normalizer);
+        break;
+    default:
+        TIOTransformPixels<float_t>(pixels, *geometry, lanes, dstFormat, volume, (float_t *)buffer,
+            description.normalization, description.normalizer);
+        break;
+    }
     
-    return formattedPixelBuffer;
+    CVPixelBufferUnlockBaseAddress(pixelBuffer, kCVPixelBufferLock_ReadOnly);
 }
 
 @end
@@ -38,14 +38,7 @@
 //  None
 
 #import "TIOCVPixelBufferHelpers.h"
-
-/**
- * Release callback to free the bytes used by a pixel buffer
- */
-
-void TIOCVPixelBufferCreateWithBytesReleaseCallback(void *releaseRefCon, const void *baseAddress) {
-    if (baseAddress != NULL) { free((void *)baseAddress); }
-}
+#import "TIOPixelBufferPool.h"
 
 CVPixelBufferRef TIOCVPixelBufferCopy(CVPixelBufferRef pixelBuffer) {
     CVPixelBufferLockBaseAddress(pixelBuffer, kNilOptions);
@@ -109,14 +102,25 @@ CVPixelBufferRef TIOCVPixelBufferRotate(CVPixelBufferRef pixelBuffer, TIOCVPixel
         .data = sourceBaseAddr,
     };
     
-    // Prepare destination image buffer with new block of memory
+    // Prepare destination image buffer with a pooled pixel buffer
     
-    unsigned char *destData = (unsigned char *)malloc(bufferHeight*sourceRowBytes);
-    const size_t destRowBytes = bufferHeight * ( sourceRowBytes / bufferWidth );
     const int destBufferWidth = bufferHeight;
     const int destBufferHeight = bufferWidth;
     const uint8_t bgColor[4] = {0, 0, 0, 0};
     
+    CVPixelBufferRef destPixelBuffer = [TIOPixelBufferPool.sharedPool createPixelBufferWithWidth:destBufferWidth height:destBufferHeight pixelFormat:pixelFormat];
+    
+    if ( destPixelBuffer == NULL ) {
+        NSLog(@"Error creating destination pixel buffer");
+        CVPixelBufferUnlockBaseAddress(pixelBuffer, kNilOptions);
+        return NULL;
+    }
+    
+    CVPixelBufferLockBaseAddress(destPixelBuffer, kNilOptions);
+    
+    unsigned char *destData = (unsigned char *)CVPixelBufferGetBaseAddress(destPixelBuffer);
+    const size_t destRowBytes = CVPixelBufferGetBytesPerRow(destPixelBuffer);
+    
     vImage_Buffer destImageBuffer = {
         .width = (vImagePixelCount)destBufferWidth,
         .height = (vImagePixelCount)destBufferHeight,
@@ -134,37 +138,16 @@ CVPixelBufferRef TIOCVPixelBufferRotate(CVPixelBufferRef pixelBuffer, TIOCVPixel
         kvImageNoFlags
     );
     
-    // Unlock source pixel buffer, we are done with it
+    // Unlock pixel buffers, we are done with them
     
+    CVPixelBufferUnlockBaseAddress(destPixelBuffer, kNilOptions);
     CVPixelBufferUnlockBaseAddress(pixelBuffer, kNilOptions);
     
     // Error handling
     
     if (err != kvImageNoError) {
         NSLog(@"vImage_Error: %ld", err);
-        return NULL;
-    }
-    
-    // Create new pixel buffer from image buffer
-    
-    CVPixelBufferRef destPixelBuffer;
-    
-    CVReturn status = CVPixelBufferCreateWithBytes(
-        NULL,
-        destBufferWidth,
-        destBufferHeight,
-        pixelFormat,
-        destData,
-        destRowBytes,
-        TIOCVPixelBufferCreateWithBytesReleaseCallback,
-        NULL,
-        NULL,
-        &destPixelBuffer
-    );
-    
-    if (status != kCVReturnSuccess) {
-        NSLog(@"Error creating destination pixel buffer");
-        free(destData);
+        CVPixelBufferRelease(destPixelBuffer);
         return NULL;
     }
     
@@ -187,21 +170,13 @@ CVPixelBufferRef TIOCVPixelBufferCreateBGRAFromARGB(CVPixelBufferRef pixelBuffer
     // Prepare destination pixel buffer
     
     CVPixelBufferRef destPixelBuffer;
-    CVReturn status;
     
-    status = CVPixelBufferCreate(
-        kCFAllocatorDefault,
-        bufferWidth,
-        bufferHeight,
-        kCVPixelFormatType_32BGRA,
-        NULL,
-        &destPixelBuffer
-    );
+    destPixelBuffer = [TIOPixelBufferPool.sharedPool createPixelBufferWithWidth:bufferWidth height:bufferHeight pixelFormat:kCVPixelFormatType_32BGRA];
     
     // Error handling
     
-    if ( status != kCVReturnSuccess ) {
-        NSLog(@"Unable to create destination pixel buffer, status: %u", status);
+    if ( destPixelBuffer == NULL ) {
+        NSLog(@"Unable to create destination pixel buffer");
         return NULL;
     }
     
@@ -270,21 +245,13 @@ CVPixelBufferRef TIOCVPixelBufferCreateARGBFromBGRA(CVPixelBufferRef pixelBuffer
     // Prepare destination pixel buffer
     
     CVPixelBufferRef destPixelBuffer;
-    CVReturn status;
     
-    status = CVPixelBufferCreate(
-        kCFAllocatorDefault,
-        bufferWidth,
-        bufferHeight,
-        kCVPixelFormatType_32ARGB,
-        NULL,
-        &destPixelBuffer
-    );
+    destPixelBuffer = [TIOPixelBufferPool.sharedPool createPixelBufferWithWidth:bufferWidth height:bufferHeight pixelFormat:kCVPixelFormatType_32ARGB];
     
     // Error handling
     
-    if ( status != kCVReturnSuccess ) {
-        NSLog(@"Unable to create destination pixel buffer, status: %u", status);
+    if ( destPixelBuffer == NULL ) {
+        NSLog(@"Unable to create destination pixel buffer");
         return NULL;
     }
     
@@ -545,12 +512,22 @@ CVPixelBufferRef TIOCVPixelBufferResizeToSquare(CVPixelBufferRef srcPixelBuffer,
     srcImageBuffer.rowBytes = sourceRowBytes;
     srcImageBuffer.data = sourceBaseAddr + offset;
     
-    // Prepare destination image buffer
+    // Prepare destination image buffer with a pooled pixel buffer
+    
+    CVPixelBufferRef destPixelBuffer = [TIOPixelBufferPool.sharedPool createPixelBufferWithWidth:destWidth height:destHeight pixelFormat:sourcePixelFormat];
+    
+    if ( destPixelBuffer == NULL ) {
+        NSLog(@"Error creating destination pixel buffer");
+        CVPixelBufferUnlockBaseAddress(srcPixelBuffer, kNilOptions);
+        return NULL;
+    }
+    
+    CVPixelBufferLockBaseAddress(destPixelBuffer, kNilOptions);
     
     vImage_Buffer destImageBuffer;
     
-    const int destRowBytes = 4*destWidth;
-    unsigned char *destData = (unsigned char *)malloc(destHeight*destRowBytes);
+    const size_t destRowBytes = CVPixelBufferGetBytesPerRow(destPixelBuffer);
+    unsigned char *destData = (unsigned char *)CVPixelBufferGetBaseAddress(destPixelBuffer);
     
     destImageBuffer.width = (vImagePixelCount)destWidth;
     destImageBuffer.height = (vImagePixelCount)destHeight;
@@ -561,38 +538,16 @@ CVPixelBufferRef TIOCVPixelBufferResizeToSquare(CVPixelBufferRef srcPixelBuffer,
     
     auto error = vImageScale_ARGB8888(&srcImageBuffer, &destImageBuffer, NULL, 0);
     
-    // Finished with the source pixel buffer, clean up
+    // Finished with the pixel buffers, clean up
     
+    CVPixelBufferUnlockBaseAddress(destPixelBuffer, kNilOptions);
     CVPixelBufferUnlockBaseAddress(srcPixelBuffer, kNilOptions);
     
     // Error handling
     
     if (error != kvImageNoError) {
         NSLog(@"Error scaling pixel buffer");
-        free(destData);
-        return NULL;
-    }
-    
-    // Create a new pixel buffer from the scaled image buffer
-    
-    CVPixelBufferRef destPixelBuffer;
-    
-    auto status = CVPixelBufferCreateWithBytes(
-        NULL,
-        destWidth,
-        destHeight,
-        sourcePixelFormat,
-        destData,
-        destRowBytes,
-        TIOCVPixelBufferCreateWithBytesReleaseCallback,
-        NULL,
-        NULL,
-        &destPixelBuffer
-    );
-    
-    if (status != kCVReturnSuccess) {
-        NSLog(@"Error creating destination pixel buffer");
-        free(destData);
+        CVPixelBufferRelease(destPixelBuffer);
         return NULL;
     }
     
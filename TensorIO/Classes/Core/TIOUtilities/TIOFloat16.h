@@ -0,0 +1,65 @@
+//
+//  TIOFloat16.h
+//  TensorIO
+//
+//  Created by Phil Dow on 10/17/20.
+//  Copyright © 2020 doc.ai (http://doc.ai)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * The bits of an IEEE 754 half precision float, which is how float16 tensors store their values.
+ */
+
+typedef uint16_t TIOFloat16;
+
+/**
+ * Converts single precision floats to half precision in a single vectorized pass, rounding to
+ * the nearest half precision value.
+ *
+ * @param src The floats to convert.
+ * @param dst The buffer that receives the half precision values, which may not overlap `src`.
+ * @param count The number of values to convert.
+ */
+
+void TIOConvertFloat32ToFloat16(const float_t *src, TIOFloat16 *dst, size_t count);
+
+/**
+ * Converts half precision floats to single precision in a single vectorized pass. The
+ * conversion is exact.
+ *
+ * @param src The half precision values to convert.
+ * @param dst The buffer that receives the floats, which may not overlap `src`.
+ * @param count The number of values to convert.
+ */
+
+void TIOConvertFloat16ToFloat32(const TIOFloat16 *src, float_t *dst, size_t count);
+
+/**
+ * Converts a single float to half precision.
+ */
+
+TIOFloat16 TIOFloat16FromFloat32(float_t value);
+
+/**
+ * Converts a single half precision value to a float.
+ */
+
+float_t TIOFloat32FromFloat16(TIOFloat16 value);
+
+NS_ASSUME_NONNULL_END
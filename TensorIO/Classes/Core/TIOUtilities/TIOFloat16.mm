@@ -0,0 +1,57 @@
+//
+//  TIOFloat16.mm
+//  TensorIO
+//
+//  Created by Phil Dow on 10/17/20.
+//  Copyright © 2020 doc.ai (http://doc.ai)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "TIOFloat16.h"
+
+#import <Accelerate/Accelerate.h>
+
+void TIOConvertFloat32ToFloat16(const float_t *src, TIOFloat16 *dst, size_t count) {
+    if ( count == 0 ) {
+        return;
+    }
+    
+    const vImage_Buffer source = { (void *)src, 1, count, count * sizeof(float_t) };
+    const vImage_Buffer destination = { dst, 1, count, count * sizeof(TIOFloat16) };
+    
+    vImageConvert_PlanarFtoPlanar16F(&source, &destination, kvImageNoFlags);
+}
+
+void TIOConvertFloat16ToFloat32(const TIOFloat16 *src, float_t *dst, size_t count) {
+    if ( count == 0 ) {
+        return;
+    }
+    
+    const vImage_Buffer source = { (void *)src, 1, count, count * sizeof(TIOFloat16) };
+    const vImage_Buffer destination = { dst, 1, count, count * sizeof(float_t) };
+    
+    vImageConvert_Planar16FtoPlanarF(&source, &destination, kvImageNoFlags);
+}
+
+TIOFloat16 TIOFloat16FromFloat32(float_t value) {
+    TIOFloat16 half;
+    TIOConvertFloat32ToFloat16(&value, &half, 1);
+    return half;
+}
+
+float_t TIOFloat32FromFloat16(TIOFloat16 value) {
+    float_t single;
+    TIOConvertFloat16ToFloat32(&value, &single, 1);
+    return single;
+}
@@ -21,8 +21,16 @@
 #ifndef TIOMeasurable_h
 #define TIOMeasurable_h
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 typedef void(^tio_measurable)(void);
 
 void tio_measuring_latency(double* latency, tio_measurable block);
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* TIOMeasurable_h */
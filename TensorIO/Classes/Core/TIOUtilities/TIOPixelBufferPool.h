@@ -0,0 +1,108 @@
+//
+//  TIOPixelBufferPool.h
+//  TensorIO
+//
+//  Created by Phil Dow on 10/17/20.
+//  Copyright © 2020 doc.ai (http://doc.ai)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+#import <CoreVideo/CoreVideo.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * Describes how often a pixel buffer pool reused memory.
+ */
+
+typedef struct TIOPixelBufferPoolStats {
+    NSUInteger hits;            // The number of pixel buffers backed by reused memory
+    NSUInteger misses;          // The number of pixel buffers backed by newly allocated memory
+    NSUInteger evictions;       // The number of idle blocks of memory freed to stay within capacity
+} TIOPixelBufferPoolStats;
+
+/**
+ * Vends 32 bit ARGB and BGRA pixel buffers backed by reusable memory.
+ *
+ * When a pixel buffer created by the pool is released its memory returns to the pool, and the
+ * next request for a pixel buffer of the same width, height, and format is backed by that memory
+ * rather than by a new allocation. The pool holds on to at most `capacity` idle blocks of memory,
+ * freeing the least recently used block when it would hold more.
+ *
+ * Rows are padded to a multiple of 64 bytes and the memory is 64 byte aligned, so that every row
+ * starts on a cache line and may be read with aligned vector loads. Always use
+ * `CVPixelBufferGetBytesPerRow` to step between rows.
+ *
+ * The pool is thread safe, and pixel buffers may be released on any thread.
+ */
+
+@interface TIOPixelBufferPool : NSObject
+
+/**
+ * The pool used by the vision pipeline and the pixel buffer data converters. The shared pool
+ * drains its idle memory when the system warns that memory is low.
+ */
+
+@property (class, readonly) TIOPixelBufferPool *sharedPool;
+
+/**
+ * Initializes a pool that holds on to at most `capacity` idle blocks of memory.
+ */
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity NS_DESIGNATED_INITIALIZER;
+
+/**
+ * Initializes a pool with a capacity of 16 idle blocks of memory.
+ */
+
+- (instancetype)init;
+
+/**
+ * The maximum number of idle blocks of memory the pool holds on to.
+ */
+
+@property (readonly) NSUInteger capacity;
+
+/**
+ * Statistics describing how often memory was reused.
+ */
+
+@property (readonly) TIOPixelBufferPoolStats stats;
+
+/**
+ * Returns a pixel buffer of the given size and format. Its contents are undefined.
+ *
+ * The caller must release the returned pixel buffer with `CVPixelBufferRelease`.
+ *
+ * @param width The width of the pixel buffer.
+ * @param height The height of the pixel buffer.
+ * @param pixelFormat The pixel format, `kCVPixelFormatType_32ARGB` or `kCVPixelFormatType_32BGRA`.
+ *
+ * @return CVPixelBufferRef A new pixel buffer, or `NULL` if memory could not be allocated or the
+ * pixel buffer could not be created.
+ */
+
+- (nullable CVPixelBufferRef)createPixelBufferWithWidth:(size_t)width height:(size_t)height pixelFormat:(OSType)pixelFormat CF_RETURNS_RETAINED;
+
+/**
+ * Frees every idle block of memory. Pixel buffers that are still in use return their memory to
+ * the pool when they are released.
+ */
+
+- (void)drain;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,225 @@
+//
+//  TIOPixelBufferPool.mm
+//  TensorIO
+//
+//  Created by Phil Dow on 10/17/20.
+//  Copyright © 2020 doc.ai (http://doc.ai)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "TIOPixelBufferPool.h"
+
+#import <os/lock.h>
+
+#include <cstdlib>
+#include <deque>
+#include <iterator>
+
+static const size_t TIOPixelBufferPoolAlignment = 64;
+static const NSUInteger TIOPixelBufferPoolDefaultCapacity = 16;
+
+/**
+ * A block of memory backing a pooled pixel buffer. While a pixel buffer holds the block, the
+ * block holds a reference to its pool, which is released when the block is recycled.
+ */
+
+struct TIOPixelBufferPoolBlock {
+    void *data;
+    size_t width;
+    size_t height;
+    OSType pixelFormat;
+    size_t bytesPerRow;
+    CFTypeRef pool;
+};
+
+@interface TIOPixelBufferPool ()
+
+- (void)recycleBlock:(TIOPixelBufferPoolBlock *)block;
+
+@end
+
+/**
+ * Release callback that returns the memory used by a pooled pixel buffer to its pool.
+ */
+
+static void TIOPixelBufferPoolReleaseCallback(void *releaseRefCon, const void *baseAddress) {
+    TIOPixelBufferPoolBlock *block = (TIOPixelBufferPoolBlock *)releaseRefCon;
+    TIOPixelBufferPool *pool = (__bridge_transfer TIOPixelBufferPool *)block->pool;
+    
+    block->pool = NULL;
+    [pool recycleBlock:block];
+}
+
+static void TIOPixelBufferPoolFreeBlock(TIOPixelBufferPoolBlock *block) {
+    free(block->data);
+    delete block;
+}
+
+@implementation TIOPixelBufferPool {
+    os_unfair_lock _lock;
+    std::deque<TIOPixelBufferPoolBlock *> _idle; // least recently used first
+    TIOPixelBufferPoolStats _stats;
+}
+
++ (TIOPixelBufferPool *)sharedPool {
+    static TIOPixelBufferPool *sharedPool = nil;
+    static dispatch_source_t memoryPressureSource = nil;
+    static dispatch_once_t onceToken;
+    
+    dispatch_once(&onceToken, ^{
+        sharedPool = [[TIOPixelBufferPool alloc] init];
+        
+        // Free idle memory when the system is under memory pressure
+        
+        dispatch_queue_t queue = dispatch_queue_create("ai.doc.tensorio.pixel-buffer-pool.memory-pressure", DISPATCH_QUEUE_SERIAL);
+        memoryPressureSource = dispatch_source_create(DISPATCH_SOURCE_TYPE_MEMORYPRESSURE, 0, DISPATCH_MEMORYPRESSURE_WARN | DISPATCH_MEMORYPRESSURE_CRITICAL, queue);
+        
+        dispatch_source_set_event_handler(memoryPressureSource, ^{
+            [sharedPool drain];
+        });
+        
+        dispatch_resume(memoryPressureSource);
+    });
+    
+    return sharedPool;
+}
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity {
+    if (self = [super init]) {
+        _capacity = capacity;
+        _lock = OS_UNFAIR_LOCK_INIT;
+        _stats = {0};
+    }
+    return self;
+}
+
+- (instancetype)init {
+    return [self initWithCapacity:TIOPixelBufferPoolDefaultCapacity];
+}
+
+- (void)dealloc {
+    for ( TIOPixelBufferPoolBlock *block : _idle ) {
+        TIOPixelBufferPoolFreeBlock(block);
+    }
+}
+
+- (TIOPixelBufferPoolStats)stats {
+    os_unfair_lock_lock(&_lock);
+    TIOPixelBufferPoolStats stats = _stats;
+    os_unfair_lock_unlock(&_lock);
+    return stats;
+}
+
+// MARK: - Pixel Buffers
+
+- (CVPixelBufferRef)createPixelBufferWithWidth:(size_t)width height:(size_t)height pixelFormat:(OSType)pixelFormat {
+    assert(pixelFormat == kCVPixelFormatType_32ARGB || pixelFormat == kCVPixelFormatType_32BGRA);
+    
+    TIOPixelBufferPoolBlock *block = NULL;
+    
+    // Take the most recently used idle block of the same size and format
+    
+    os_unfair_lock_lock(&_lock);
+    
+    for ( auto it = _idle.rbegin(); it != _idle.rend(); ++it ) {
+        if ( (*it)->width == width && (*it)->height == height && (*it)->pixelFormat == pixelFormat ) {
+            block = *it;
+            _idle.erase(std::next(it).base());
+            break;
+        }
+    }
+    
+    if ( block != NULL ) {
+        _stats.hits++;
+    } else {
+        _stats.misses++;
+    }
+    
+    os_unfair_lock_unlock(&_lock);
+    
+    // Or allocate a new one outside the lock
+    
+    if ( block == NULL ) {
+        const size_t bytesPerRow = (width * 4 + TIOPixelBufferPoolAlignment - 1) / TIOPixelBufferPoolAlignment * TIOPixelBufferPoolAlignment;
+        void *data = NULL;
+        
+        if ( posix_memalign(&data, TIOPixelBufferPoolAlignment, bytesPerRow * height) != 0 ) {
+            NSLog(@"Unable to allocate %zu bytes for pixel buffer", bytesPerRow * height);
+            return NULL;
+        }
+        
+        block = new TIOPixelBufferPoolBlock{data, width, height, pixelFormat, bytesPerRow, NULL};
+    }
+    
+    // Wrap the block in a pixel buffer that returns it to the pool when released
+    
+    CVPixelBufferRef pixelBuffer = NULL;
+    block->pool = (__bridge_retained CFTypeRef)self;
+    
+    CVReturn status = CVPixelBufferCreateWithBytes(
+        kCFAllocatorDefault,
+        width,
+        height,
+        pixelFormat,
+        block->data,
+        block->bytesPerRow,
+        TIOPixelBufferPoolReleaseCallback,
+        block,
+        NULL,
+        &pixelBuffer);
+    
+    if ( status != kCVReturnSuccess ) {
+        NSLog(@"Unable to create pooled pixel buffer, status: %d", status);
+        CFRelease(block->pool);
+        block->pool = NULL;
+        [self recycleBlock:block];
+        return NULL;
+    }
+    
+    return pixelBuffer;
+}
+
+- (void)recycleBlock:(TIOPixelBufferPoolBlock *)block {
+    TIOPixelBufferPoolBlock *evicted = NULL;
+    
+    os_unfair_lock_lock(&_lock);
+    
+    _idle.push_back(block);
+    
+    if ( _idle.size() > _capacity ) {
+        evicted = _idle.front();
+        _idle.pop_front();
+        _stats.evictions++;
+    }
+    
+    os_unfair_lock_unlock(&_lock);
+    
+    if ( evicted != NULL ) {
+        TIOPixelBufferPoolFreeBlock(evicted);
+    }
+}
+
+- (void)drain {
+    std::deque<TIOPixelBufferPoolBlock *> idle;
+    
+    os_unfair_lock_lock(&_lock);
+    idle.swap(_idle);
+    os_unfair_lock_unlock(&_lock);
+    
+    for ( TIOPixelBufferPoolBlock *block : idle ) {
+        TIOPixelBufferPoolFreeBlock(block);
+    }
+}
+
+@end
@@ -0,0 +1,168 @@
+//
+//  TIOPixelKernels.h
+//  TensorIO
+//
+//  Created by Phil Dow on 10/17/20.
+//  Copyright © 2020 doc.ai (http://doc.ai)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+#import "TIOPixelNormalization.h"
+#import "TIOFloat16.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * Kernels that copy rows of 32 bit ARGB or BGRA pixels to and from packed tensor values, applying
+ * a pixel normalization's scale and biases along the way.
+ *
+ * Each kernel is specialized at compile time on the pixel format, the number of tensor channels,
+ * the tensor's value type, and whether the normalization scales, biases, or does nothing. Three
+ * channel tensors are converted sixteen pixels at a time with NEON on ARM, float16 and int8
+ * tensors only on 64 bit ARM, and everything else one pixel at a time with four lane SIMD
+ * vectors, which the compiler lowers to NEON or SSE.
+ *
+ * The kernels work on raw memory rather than pixel buffers so that they may be called and
+ * measured on their own. Tensor values are packed, with `width * channels` values per row.
+ * The alpha channel is ignored when normalizing and set to 255 when denormalizing, and tensor
+ * channel `0`, `1`, and `2` receive the red, green, and blue biases respectively.
+ */
+
+/**
+ * Normalizes pixels into a float32 tensor, computing `value * scale + bias`.
+ *
+ * @param pixels The first row of pixels.
+ * @param bytesPerRow The number of bytes between rows of pixels, which may include padding.
+ * @param pixelFormat The pixel format, `kCVPixelFormatType_32ARGB` or `kCVPixelFormatType_32BGRA`.
+ * @param width The number of pixels in a row.
+ * @param height The number of rows.
+ * @param tensor The tensor that receives `width * height * channels` values.
+ * @param channels The number of tensor channels, from one to four.
+ * @param normalization The normalization to apply, which may not be `kTIOPixelNormalizationInvalid`.
+ */
+
+void TIONormalizePixelsToFloat32(const uint8_t *pixels, size_t bytesPerRow, OSType pixelFormat, size_t width, size_t height, float_t *tensor, size_t channels, TIOPixelNormalization normalization);
+
+/**
+ * Normalizes pixels into a uint8 tensor. Normalized values are clamped to `[0,255]` and truncated.
+ *
+ * @see TIONormalizePixelsToFloat32
+ */
+
+void TIONormalizePixelsToUInt8(const uint8_t *pixels, size_t bytesPerRow, OSType pixelFormat, size_t width, size_t height, uint8_t *tensor, size_t channels, TIOPixelNormalization normalization);
+
+/**
+ * Normalizes pixels into a float16 tensor, rounding normalized values to the nearest half
+ * precision value.
+ *
+ * @see TIONormalizePixelsToFloat32
+ */
+
+void TIONormalizePixelsToFloat16(const uint8_t *pixels, size_t bytesPerRow, OSType pixelFormat, size_t width, size_t height, TIOFloat16 *tensor, size_t channels, TIOPixelNormalization normalization);
+
+/**
+ * Normalizes pixels into an int8 tensor. Pixel values are offset by -128 when the normalization
+ * is `kTIOPixelNormalizationNone`, and normalized values are otherwise rounded to the nearest
+ * integer and clamped to `[-128,127]`.
+ *
+ * @see TIONormalizePixelsToFloat32
+ */
+
+void TIONormalizePixelsToInt8(const uint8_t *pixels, size_t bytesPerRow, OSType pixelFormat, size_t width, size_t height, int8_t *tensor, size_t channels, TIOPixelNormalization normalization);
+
+/**
+ * Denormalizes a float32 tensor into pixels, computing `(value + bias) * scale`. Denormalized
+ * values are clamped to `[0,255]` and truncated.
+ *
+ * @param tensor The tensor holding `width * height * channels` values.
+ * @param channels The number of tensor channels, from one to four.
+ * @param width The number of pixels in a row.
+ * @param height The number of rows.
+ * @param pixels The first row of pixels, which receives the denormalized values.
+ * @param bytesPerRow The number of bytes between rows of pixels, which may include padding.
+ * @param pixelFormat The pixel format, `kCVPixelFormatType_32ARGB` or `kCVPixelFormatType_32BGRA`.
+ * @param denormalization The denormalization to apply, which may not be `kTIOPixelDenormalizationInvalid`.
+ */
+
+void TIODenormalizePixelsFromFloat32(const float_t *tensor, size_t channels, size_t width, size_t height, uint8_t *pixels, size_t bytesPerRow, OSType pixelFormat, TIOPixelDenormalization denormalization);
+
+/**
+ * Denormalizes a uint8 tensor into pixels.
+ *
+ * @see TIODenormalizePixelsFromFloat32
+ */
+
+void TIODenormalizePixelsFromUInt8(const uint8_t *tensor, size_t channels, size_t width, size_t height, uint8_t *pixels, size_t bytesPerRow, OSType pixelFormat, TIOPixelDenormalization denormalization);
+
+NS_ASSUME_NONNULL_END
+
+#ifdef __cplusplus
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// MARK: - Overloads for Templated Callers
+
+inline void TIONormalizePixels(const uint8_t *pixels, size_t bytesPerRow, OSType pixelFormat, size_t width, size_t height, float_t *tensor, size_t channels, TIOPixelNormalization normalization) {
+    TIONormalizePixelsToFloat32(pixels, bytesPerRow, pixelFormat, width, height, tensor, channels, normalization);
+}
+
+inline void TIONormalizePixels(const uint8_t *pixels, size_t bytesPerRow, OSType pixelFormat, size_t width, size_t height, uint8_t *tensor, size_t channels, TIOPixelNormalization normalization) {
+    TIONormalizePixelsToUInt8(pixels, bytesPerRow, pixelFormat, width, height, tensor, channels, normalization);
+}
+
+inline void TIONormalizePixels(const uint8_t *pixels, size_t bytesPerRow, OSType pixelFormat, size_t width, size_t height, TIOFloat16 *tensor, size_t channels, TIOPixelNormalization normalization) {
+    TIONormalizePixelsToFloat16(pixels, bytesPerRow, pixelFormat, width, height, tensor, channels, normalization);
+}
+
+inline void TIONormalizePixels(const uint8_t *pixels, size_t bytesPerRow, OSType pixelFormat, size_t width, size_t height, int8_t *tensor, size_t channels, TIOPixelNormalization normalization) {
+    TIONormalizePixelsToInt8(pixels, bytesPerRow, pixelFormat, width, height, tensor, channels, normalization);
+}
+
+inline void TIODenormalizePixels(const float_t *tensor, size_t channels, size_t width, size_t height, uint8_t *pixels, size_t bytesPerRow, OSType pixelFormat, TIOPixelDenormalization denormalization) {
+    TIODenormalizePixelsFromFloat32(tensor, channels, width, height, pixels, bytesPerRow, pixelFormat, denormalization);
+}
+
+inline void TIODenormalizePixels(const uint8_t *tensor, size_t channels, size_t width, size_t height, uint8_t *pixels, size_t bytesPerRow, OSType pixelFormat, TIOPixelDenormalization denormalization) {
+    TIODenormalizePixelsFromUInt8(tensor, channels, width, height, pixels, bytesPerRow, pixelFormat, denormalization);
+}
+
+// MARK: - Custom Normalizer Values
+
+/**
+ * Stores a value returned by a custom normalizer, which the kernels cannot specialize, in a
+ * tensor of each value type. Values are clamped to the range of an integer type.
+ */
+
+inline void TIOStoreNormalizedValue(float_t value, float_t *out) {
+    *out = value;
+}
+
+inline void TIOStoreNormalizedValue(float_t value, uint8_t *out) {
+    *out = (uint8_t)std::max<float_t>(0, std::min<float_t>(255, value));
+}
+
+inline void TIOStoreNormalizedValue(float_t value, TIOFloat16 *out) {
+    const __fp16 half = value;
+    std::memcpy(out, &half, sizeof(half));
+}
+
+inline void TIOStoreNormalizedValue(float_t value, int8_t *out) {
+    *out = (int8_t)std::lrint(std::max<float_t>(INT8_MIN, std::min<float_t>(INT8_MAX, value)));
+}
+
+#endif
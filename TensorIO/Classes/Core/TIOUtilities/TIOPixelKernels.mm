@@ -0,0 +1,573 @@
+//
+//  TIOPixelKernels.mm
+//  TensorIO
+//
+//  Created by Phil Dow on 10/17/20.
+//  Copyright © 2020 doc.ai (http://doc.ai)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "TIOPixelKernels.h"
+
+#import <CoreVideo/CoreVideo.h>
+#import <simd/simd.h>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * The arithmetic a normalization requires, resolved once per call so that the per pixel work
+ * is specialized at compile time.
+ */
+
+enum class TIOPixelKernelKind {
+    None,
+    Scale,
+    ScaleAndBias
+};
+
+static TIOPixelKernelKind TIOPixelKernelKindForNormalization(TIOPixelNormalization normalization) {
+    if ( TIOPixelNormalizationsEqual(normalization, kTIOPixelNormalizationNone) ) {
+        return TIOPixelKernelKind::None;
+    } else if ( normalization.redBias == 0 && normalization.greenBias == 0 && normalization.blueBias == 0 ) {
+        return TIOPixelKernelKind::Scale;
+    } else {
+        return TIOPixelKernelKind::ScaleAndBias;
+    }
+}
+
+static const simd_float4 kTIOPixelMin = { 0, 0, 0, 0 };
+static const simd_float4 kTIOPixelMax = { 255, 255, 255, 255 };
+static const simd_float4 kTIOInt8Min = { INT8_MIN, INT8_MIN, INT8_MIN, INT8_MIN };
+static const simd_float4 kTIOInt8Max = { INT8_MAX, INT8_MAX, INT8_MAX, INT8_MAX };
+
+// MARK: - NEON Rows
+
+/**
+ * Converts as many leading pixels of a row as a NEON specialization can handle and returns the
+ * number of pixels converted. The primary templates convert nothing and leave the row to the
+ * per pixel loop.
+ */
+
+template <typename T, int Offset, int Channels, TIOPixelKernelKind Kind>
+struct TIONormalizeRowNEON {
+    static size_t run(const uint8_t *in, T *out, size_t width, TIOPixelNormalization normalization) {
+        return 0;
+    }
+};
+
+template <typename T, int Offset, int Channels, TIOPixelKernelKind Kind>
+struct TIODenormalizeRowNEON {
+    static size_t run(const T *in, uint8_t *out, size_t width, TIOPixelDenormalization denormalization) {
+        return 0;
+    }
+};
+
+#if defined(__ARM_NEON)
+
+/**
+ * Widens sixteen channel values to four vectors of floats and normalizes them.
+ */
+
+template <TIOPixelKernelKind Kind>
+static inline float32x4x4_t TIONormalizeLanesNEON(uint8x16_t values, float32x4_t scale, float32x4_t bias) {
+    const uint16x8_t low = vmovl_u8(vget_low_u8(values));
+    const uint16x8_t high = vmovl_u8(vget_high_u8(values));
+    
+    float32x4x4_t lanes = {{
+        vcvtq_f32_u32(vmovl_u16(vget_low_u16(low))),
+        vcvtq_f32_u32(vmovl_u16(vget_high_u16(low))),
+        vcvtq_f32_u32(vmovl_u16(vget_low_u16(high))),
+        vcvtq_f32_u32(vmovl_u16(vget_high_u16(high)))
+    }};
+    
+    for (int i = 0; i < 4; i++) {
+        if ( Kind == TIOPixelKernelKind::Scale ) {
+            lanes.val[i] = vmulq_f32(lanes.val[i], scale);
+        } else if ( Kind == TIOPixelKernelKind::ScaleAndBias ) {
+            lanes.val[i] = vaddq_f32(vmulq_f32(lanes.val[i], scale), bias);
+        }
+    }
+    
+    return lanes;
+}
+
+/**
+ * Denormalizes four vectors of floats and narrows them to sixteen clamped channel values.
+ */
+
+template <TIOPixelKernelKind Kind>
+static inline uint8x16_t TIODenormalizeLanesNEON(float32x4x4_t lanes, float32x4_t scale, float32x4_t bias) {
+    const float32x4_t min = vdupq_n_f32(0);
+    const float32x4_t max = vdupq_n_f32(255);
+    uint16x4_t narrowed[4];
+    
+    for (int i = 0; i < 4; i++) {
+        float32x4_t value = lanes.val[i];
+        
+        if ( Kind == TIOPixelKernelKind::Scale ) {
+            value = vmulq_f32(value, scale);
+        } else if ( Kind == TIOPixelKernelKind::ScaleAndBias ) {
+            value = vmulq_f32(vaddq_f32(value, bias), scale);
+        }
+        
+        value = vmaxq_f32(vminq_f32(value, max), min);
+        narrowed[i] = vmovn_u32(vcvtq_u32_f32(value));
+    }
+    
+    return vcombine_u8(
+        vmovn_u16(vcombine_u16(narrowed[0], narrowed[1])),
+        vmovn_u16(vcombine_u16(narrowed[2], narrowed[3])));
+}
+
+template <int Offset, TIOPixelKernelKind Kind>
+struct TIONormalizeRowNEON<float_t, Offset, 3, Kind> {
+    static size_t run(const uint8_t *in, float_t *out, size_t width, TIOPixelNormalization normalization) {
+        const float32x4_t scale = vdupq_n_f32(normalization.scale);
+        const float32x4_t red = vdupq_n_f32(normalization.redBias);
+        const float32x4_t green = vdupq_n_f32(normalization.greenBias);
+        const float32x4_t blue = vdupq_n_f32(normalization.blueBias);
+        size_t x = 0;
+        
+        for (; x + 16 <= width; x += 16) {
+            const uint8x16x4_t pixels = vld4q_u8(in + x * 4);
+            const float32x4x4_t c0 = TIONormalizeLanesNEON<Kind>(pixels.val[Offset], scale, red);
+            const float32x4x4_t c1 = TIONormalizeLanesNEON<Kind>(pixels.val[Offset+1], scale, green);
+            const float32x4x4_t c2 = TIONormalizeLanesNEON<Kind>(pixels.val[Offset+2], scale, blue);
+            
+            for (int i = 0; i < 4; i++) {
+                const float32x4x3_t values = {{ c0.val[i], c1.val[i], c2.val[i] }};
+                vst3q_f32(out + (x + i * 4) * 3, values);
+            }
+        }
+        
+        return x;
+    }
+};
+
+template <int Offset>
+struct TIONormalizeRowNEON<uint8_t, Offset, 3, TIOPixelKernelKind::None> {
+    static size_t run(const uint8_t *in, uint8_t *out, size_t width, TIOPixelNormalization normalization) {
+        size_t x = 0;
+        
+        for (; x + 16 <= width; x += 16) {
+            const uint8x16x4_t pixels = vld4q_u8(in + x * 4);
+            const uint8x16x3_t values = {{ pixels.val[Offset], pixels.val[Offset+1], pixels.val[Offset+2] }};
+            vst3q_u8(out + x * 3, values);
+        }
+        
+        return x;
+    }
+};
+
+#if defined(__aarch64__)
+
+template <int Offset, TIOPixelKernelKind Kind>
+struct TIONormalizeRowNEON<TIOFloat16, Offset, 3, Kind> {
+    static size_t run(const uint8_t *in, TIOFloat16 *out, size_t width, TIOPixelNormalization normalization) {
+        const float32x4_t scale = vdupq_n_f32(normalization.scale);
+        const float32x4_t red = vdupq_n_f32(normalization.redBias);
+        const float32x4_t green = vdupq_n_f32(normalization.greenBias);
+        const float32x4_t blue = vdupq_n_f32(normalization.blueBias);
+        size_t x = 0;
+        
+        for (; x + 16 <= width; x += 16) {
+            const uint8x16x4_t pixels = vld4q_u8(in + x * 4);
+            const float32x4x4_t c0 = TIONormalizeLanesNEON<Kind>(pixels.val[Offset], scale, red);
+            const float32x4x4_t c1 = TIONormalizeLanesNEON<Kind>(pixels.val[Offset+1], scale, green);
+            const float32x4x4_t c2 = TIONormalizeLanesNEON<Kind>(pixels.val[Offset+2], scale, blue);
+            
+            for (int i = 0; i < 2; i++) {
+                const uint16x8x3_t values = {{
+                    vreinterpretq_u16_f16(vcombine_f16(vcvt_f16_f32(c0.val[i*2]), vcvt_f16_f32(c0.val[i*2+1]))),
+                    vreinterpretq_u16_f16(vcombine_f16(vcvt_f16_f32(c1.val[i*2]), vcvt_f16_f32(c1.val[i*2+1]))),
+                    vreinterpretq_u16_f16(vcombine_f16(vcvt_f16_f32(c2.val[i*2]), vcvt_f16_f32(c2.val[i*2+1])))
+                }};
+                vst3q_u16(out + (x + i * 8) * 3, values);
+            }
+        }
+        
+        return x;
+    }
+};
+
+/**
+ * Rounds four vectors of floats to the nearest integer and narrows them, saturating, to sixteen
+ * int8 values.
+ */
+
+static inline int8x16_t TIONarrowLanesToInt8NEON(float32x4x4_t lanes) {
+    const int16x8_t low = vcombine_s16(vqmovn_s32(vcvtnq_s32_f32(lanes.val[0])), vqmovn_s32(vcvtnq_s32_f32(lanes.val[1])));
+    const int16x8_t high = vcombine_s16(vqmovn_s32(vcvtnq_s32_f32(lanes.val[2])), vqmovn_s32(vcvtnq_s32_f32(lanes.val[3])));
+    return vcombine_s8(vqmovn_s16(low), vqmovn_s16(high));
+}
+
+template <int Offset, TIOPixelKernelKind Kind>
+struct TIONormalizeRowNEON<int8_t, Offset, 3, Kind> {
+    static size_t run(const uint8_t *in, int8_t *out, size_t width, TIOPixelNormalization normalization) {
+        const float32x4_t scale = vdupq_n_f32(normalization.scale);
+        const float32x4_t red = vdupq_n_f32(normalization.redBias);
+        const float32x4_t green = vdupq_n_f32(normalization.greenBias);
+        const float32x4_t blue = vdupq_n_f32(normalization.blueBias);
+        size_t x = 0;
+        
+        for (; x + 16 <= width; x += 16) {
+            const uint8x16x4_t pixels = vld4q_u8(in + x * 4);
+            const int8x16x3_t values = {{
+                TIONarrowLanesToInt8NEON(TIONormalizeLanesNEON<Kind>(pixels.val[Offset], scale, red)),
+                TIONarrowLanesToInt8NEON(TIONormalizeLanesNEON<Kind>(pixels.val[Offset+1], scale, green)),
+                TIONarrowLanesToInt8NEON(TIONormalizeLanesNEON<Kind>(pixels.val[Offset+2], scale, blue))
+            }};
+            vst3q_s8(out + x * 3, values);
+        }
+        
+        return x;
+    }
+};
+
+/**
+ * Without a normalization int8 values are pixel values offset by -128, which flips their top bit.
+ */
+
+template <int Offset>
+struct TIONormalizeRowNEON<int8_t, Offset, 3, TIOPixelKernelKind::None> {
+    static size_t run(const uint8_t *in, int8_t *out, size_t width, TIOPixelNormalization normalization) {
+        const uint8x16_t sign = vdupq_n_u8(0x80);
+        size_t x = 0;
+        
+        for (; x + 16 <= width; x += 16) {
+            const uint8x16x4_t pixels = vld4q_u8(in + x * 4);
+            const uint8x16x3_t values = {{
+                veorq_u8(pixels.val[Offset], sign),
+                veorq_u8(pixels.val[Offset+1], sign),
+                veorq_u8(pixels.val[Offset+2], sign)
+            }};
+            vst3q_u8((uint8_t *)out + x * 3, values);
+        }
+        
+        return x;
+    }
+};
+
+#endif
+
+template <int Offset, TIOPixelKernelKind Kind>
+struct TIODenormalizeRowNEON<float_t, Offset, 3, Kind> {
+    static size_t run(const float_t *in, uint8_t *out, size_t width, TIOPixelDenormalization denormalization) {
+        const int alpha = Offset == 1 ? 0 : 3;
+        const float32x4_t scale = vdupq_n_f32(denormalization.scale);
+        const float32x4_t red = vdupq_n_f32(denormalization.redBias);
+        const float32x4_t green = vdupq_n_f32(denormalization.greenBias);
+        const float32x4_t blue = vdupq_n_f32(denormalization.blueBias);
+        size_t x = 0;
+        
+        for (; x + 16 <= width; x += 16) {
+            float32x4x4_t c0, c1, c2;
+            
+            for (int i = 0; i < 4; i++) {
+                const float32x4x3_t values = vld3q_f32(in + (x + i * 4) * 3);
+                c0.val[i] = values.val[0];
+                c1.val[i] = values.val[1];
+                c2.val[i] = values.val[2];
+            }
+            
+            uint8x16x4_t pixels;
+            pixels.val[alpha] = vdupq_n_u8(255);
+            pixels.val[Offset] = TIODenormalizeLanesNEON<Kind>(c0, scale, red);
+            pixels.val[Offset+1] = TIODenormalizeLanesNEON<Kind>(c1, scale, green);
+            pixels.val[Offset+2] = TIODenormalizeLanesNEON<Kind>(c2, scale, blue);
+            vst4q_u8(out + x * 4, pixels);
+        }
+        
+        return x;
+    }
+};
+
+template <int Offset>
+struct TIODenormalizeRowNEON<uint8_t, Offset, 3, TIOPixelKernelKind::None> {
+    static size_t run(const uint8_t *in, uint8_t *out, size_t width, TIOPixelDenormalization denormalization) {
+        const int alpha = Offset == 1 ? 0 : 3;
+        size_t x = 0;
+        
+        for (; x + 16 <= width; x += 16) {
+            const uint8x16x3_t values = vld3q_u8(in + x * 3);
+            uint8x16x4_t pixels;
+            pixels.val[alpha] = vdupq_n_u8(255);
+            pixels.val[Offset] = values.val[0];
+            pixels.val[Offset+1] = values.val[1];
+            pixels.val[Offset+2] = values.val[2];
+            vst4q_u8(out + x * 4, pixels);
+        }
+        
+        return x;
+    }
+};
+
+#endif
+
+// MARK: - Per Pixel Stores
+
+template <int Channels>
+static inline void TIOStoreNormalizedPixel(simd_float4 value, float_t *out) {
+    for (int c = 0; c < Channels; c++) {
+        out[c] = value[c];
+    }
+}
+
+template <int Channels>
+static inline void TIOStoreNormalizedPixel(simd_float4 value, uint8_t *out) {
+    const simd_uchar4 bytes = simd_uchar(simd_clamp(value, kTIOPixelMin, kTIOPixelMax));
+    
+    for (int c = 0; c < Channels; c++) {
+        out[c] = bytes[c];
+    }
+}
+
+template <int Channels>
+static inline void TIOStoreNormalizedPixel(simd_float4 value, TIOFloat16 *out) {
+    for (int c = 0; c < Channels; c++) {
+        const __fp16 half = value[c];
+        std::memcpy(out + c, &half, sizeof(half));
+    }
+}
+
+template <int Channels>
+static inline void TIOStoreNormalizedPixel(simd_float4 value, int8_t *out) {
+    const simd_float4 clamped = simd_clamp(value, kTIOInt8Min, kTIOInt8Max);
+    
+    for (int c = 0; c < Channels; c++) {
+        out[c] = (int8_t)std::lrint(clamped[c]);
+    }
+}
+
+// MARK: - Kernels
+
+template <typename T, int Offset, int Channels, TIOPixelKernelKind Kind>
+static void TIONormalizePixelsKernel(const uint8_t *pixels, size_t bytesPerRow, size_t width, size_t height, T *tensor, TIOPixelNormalization normalization) {
+    const simd_float4 scale = { normalization.scale, normalization.scale, normalization.scale, normalization.scale };
+    const simd_float4 bias = { normalization.redBias, normalization.greenBias, normalization.blueBias, 0 };
+    
+    for (size_t y = 0; y < height; y++) {
+        const uint8_t *in = pixels + y * bytesPerRow;
+        T *out = tensor + y * width * Channels;
+        size_t x = TIONormalizeRowNEON<T, Offset, Channels, Kind>::run(in, out, width, normalization);
+        
+        for (; x < width; x++) {
+            simd_uchar4 pixel;
+            std::memcpy(&pixel, in + x * 4, sizeof(pixel));
+            T *out_pixel = out + x * Channels;
+            
+            // Rotate ARGB so that the color channels come first, as they do in BGRA
+            
+            if ( Offset == 1 ) {
+                pixel = pixel.yzwx;
+            }
+            
+            if ( std::is_same<T, uint8_t>::value && Kind == TIOPixelKernelKind::None ) {
+                for (int c = 0; c < Channels; c++) {
+                    out_pixel[c] = pixel[c];
+                }
+                continue;
+            }
+            
+            if ( std::is_same<T, int8_t>::value && Kind == TIOPixelKernelKind::None ) {
+                for (int c = 0; c < Channels; c++) {
+                    out_pixel[c] = (T)(int8_t)(pixel[c] ^ 0x80);
+                }
+                continue;
+            }
+            
+            simd_float4 value = simd_float(pixel);
+            
+            if ( Kind == TIOPixelKernelKind::Scale ) {
+                value = value * scale;
+            } else if ( Kind == TIOPixelKernelKind::ScaleAndBias ) {
+                value = value * scale + bias;
+            }
+            
+            TIOStoreNormalizedPixel<Channels>(value, out_pixel);
+        }
+    }
+}
+
+template <typename T, int Offset, int Channels, TIOPixelKernelKind Kind>
+static void TIODenormalizePixelsKernel(const T *tensor, size_t width, size_t height, uint8_t *pixels, size_t bytesPerRow, TIOPixelDenormalization denormalization) {
+    const int alpha = Offset == 1 ? 0 : 3;
+    const simd_float4 scale = { denormalization.scale, denormalization.scale, denormalization.scale, denormalization.scale };
+    const simd_float4 bias = { denormalization.redBias, denormalization.greenBias, denormalization.blueBias, 0 };
+    
+    for (size_t y = 0; y < height; y++) {
+        const T *in = tensor + y * width * Channels;
+        uint8_t *out = pixels + y * bytesPerRow;
+        size_t x = TIODenormalizeRowNEON<T, Offset, Channels, Kind>::run(in, out, width, denormalization);
+        
+        for (; x < width; x++) {
+            const T *in_pixel = in + x * Channels;
+            uint8_t *out_pixel = out + x * 4;
+            simd_float4 value = { 0, 0, 0, 0 };
+            
+            for (int c = 0; c < Channels; c++) {
+                value[c] = in_pixel[c];
+            }
+            
+            if ( Kind == TIOPixelKernelKind::Scale ) {
+                value = value * scale;
+            } else if ( Kind == TIOPixelKernelKind::ScaleAndBias ) {
+                value = (value + bias) * scale;
+            }
+            
+            const simd_uchar4 bytes = simd_uchar(simd_clamp(value, kTIOPixelMin, kTIOPixelMax));
+            
+            for (int c = 0; c < Channels && c + Offset < 4; c++) {
+                out_pixel[c + Offset] = bytes[c];
+            }
+            
+            out_pixel[alpha] = 255;
+        }
+    }
+}
+
+// MARK: - Dispatch
+
+/**
+ * Resolves the runtime pixel format, channel count, and normalization kind to a specialized
+ * kernel, from the innermost template parameter outward.
+ */
+
+template <typename T, int Offset, int Channels>
+static void TIONormalizePixelsForKind(const uint8_t *pixels, size_t bytesPerRow, size_t width, size_t height, T *tensor, TIOPixelNormalization normalization) {
+    switch ( TIOPixelKernelKindForNormalization(normalization) ) {
+    case TIOPixelKernelKind::None:
+        TIONormalizePixelsKernel<T, Offset, Channels, TIOPixelKernelKind::None>(pixels, bytesPerRow, width, height, tensor, normalization);
+        break;
+    case TIOPixelKernelKind::Scale:
+        TIONormalizePixelsKernel<T, Offset, Channels, TIOPixelKernelKind::Scale>(pixels, bytesPerRow, width, height, tensor, normalization);
+        break;
+    case TIOPixelKernelKind::ScaleAndBias:
+        TIONormalizePixelsKernel<T, Offset, Channels, TIOPixelKernelKind::ScaleAndBias>(pixels, bytesPerRow, width, height, tensor, normalization);
+        break;
+    }
+}
+
+template <typename T, int Offset>
+static void TIONormalizePixelsForChannels(const uint8_t *pixels, size_t bytesPerRow, size_t width, size_t height, T *tensor, size_t channels, TIOPixelNormalization normalization) {
+    switch ( channels ) {
+    case 1:
+        TIONormalizePixelsForKind<T, Offset, 1>(pixels, bytesPerRow, width, height, tensor, normalization);
+        break;
+    case 2:
+        TIONormalizePixelsForKind<T, Offset, 2>(pixels, bytesPerRow, width, height, tensor, normalization);
+        break;
+    case 3:
+        TIONormalizePixelsForKind<T, Offset, 3>(pixels, bytesPerRow, width, height, tensor, normalization);
+        break;
+    case 4:
+        TIONormalizePixelsForKind<T, Offset, 4>(pixels, bytesPerRow, width, height, tensor, normalization);
+        break;
+    default:
+        NSLog(@"Unsupported number of tensor channels for pixel normalization: %zu", channels);
+        assert(false);
+    }
+}
+
+template <typename T>
+static void TIONormalizePixelsForFormat(const uint8_t *pixels, size_t bytesPerRow, OSType pixelFormat, size_t width, size_t height, T *tensor, size_t channels, TIOPixelNormalization normalization) {
+    assert( pixelFormat == kCVPixelFormatType_32ARGB || pixelFormat == kCVPixelFormatType_32BGRA );
+    assert( !TIOPixelNormalizationsEqual(normalization, kTIOPixelNormalizationInvalid) );
+    
+    if ( pixelFormat == kCVPixelFormatType_32ARGB ) {
+        TIONormalizePixelsForChannels<T, 1>(pixels, bytesPerRow, width, height, tensor, channels, normalization);
+    } else {
+        TIONormalizePixelsForChannels<T, 0>(pixels, bytesPerRow, width, height, tensor, channels, normalization);
+    }
+}
+
+template <typename T, int Offset, int Channels>
+static void TIODenormalizePixelsForKind(const T *tensor, size_t width, size_t height, uint8_t *pixels, size_t bytesPerRow, TIOPixelDenormalization denormalization) {
+    switch ( TIOPixelKernelKindForNormalization(denormalization) ) {
+    case TIOPixelKernelKind::None:
+        TIODenormalizePixelsKernel<T, Offset, Channels, TIOPixelKernelKind::None>(tensor, width, height, pixels, bytesPerRow, denormalization);
+        break;
+    case TIOPixelKernelKind::Scale:
+        TIODenormalizePixelsKernel<T, Offset, Channels, TIOPixelKernelKind::Scale>(tensor, width, height, pixels, bytesPerRow, denormalization);
+        break;
+    case TIOPixelKernelKind::ScaleAndBias:
+        TIODenormalizePixelsKernel<T, Offset, Channels, TIOPixelKernelKind::ScaleAndBias>(tensor, width, height, pixels, bytesPerRow, denormalization);
+        break;
+    }
+}
+
+template <typename T, int Offset>
+static void TIODenormalizePixelsForChannels(const T *tensor, size_t channels, size_t width, size_t height, uint8_t *pixels, size_t bytesPerRow, TIOPixelDenormalization denormalization) {
+    switch ( channels ) {
+    case 1:
+        TIODenormalizePixelsForKind<T, Offset, 1>(tensor, width, height, pixels, bytesPerRow, denormalization);
+        break;
+    case 2:
+        TIODenormalizePixelsForKind<T, Offset, 2>(tensor, width, height, pixels, bytesPerRow, denormalization);
+        break;
+    case 3:
+        TIODenormalizePixelsForKind<T, Offset, 3>(tensor, width, height, pixels, bytesPerRow, denormalization);
+        break;
+    case 4:
+        TIODenormalizePixelsForKind<T, Offset, 4>(tensor, width, height, pixels, bytesPerRow, denormalization);
+        break;
+    default:
+        NSLog(@"Unsupported number of tensor channels for pixel denormalization: %zu", channels);
+        assert(false);
+    }
+}
+
+template <typename T>
+static void TIODenormalizePixelsForFormat(const T *tensor, size_t channels, size_t width, size_t height, uint8_t *pixels, size_t bytesPerRow, OSType pixelFormat, TIOPixelDenormalization denormalization) {
+    assert( pixelFormat == kCVPixelFormatType_32ARGB || pixelFormat == kCVPixelFormatType_32BGRA );
+    assert( !TIOPixelDenormalizationsEqual(denormalization, kTIOPixelDenormalizationInvalid) );
+    
+    if ( pixelFormat == kCVPixelFormatType_32ARGB ) {
+        TIODenormalizePixelsForChannels<T, 1>(tensor, channels, width, height, pixels, bytesPerRow, denormalization);
+    } else {
+        TIODenormalizePixelsForChannels<T, 0>(tensor, channels, width, height, pixels, bytesPerRow, denormalization);
+    }
+}
+
+// MARK: - Public Interface
+
+void TIONormalizePixelsToFloat32(const uint8_t *pixels, size_t bytesPerRow, OSType pixelFormat, size_t width, size_t height, float_t *tensor, size_t channels, TIOPixelNormalization normalization) {
+    TIONormalizePixelsForFormat<float_t>(pixels, bytesPerRow, pixelFormat, width, height, tensor, channels, normalization);
+}
+
+void TIONormalizePixelsToUInt8(const uint8_t *pixels, size_t bytesPerRow, OSType pixelFormat, size_t width, size_t height, uint8_t *tensor, size_t channels, TIOPixelNormalization normalization) {
+    TIONormalizePixelsForFormat<uint8_t>(pixels, bytesPerRow, pixelFormat, width, height, tensor, channels, normalization);
+}
+
+void TIONormalizePixelsToFloat16(const uint8_t *pixels, size_t bytesPerRow, OSType pixelFormat, size_t width, size_t height, TIOFloat16 *tensor, size_t channels, TIOPixelNormalization normalization) {
+    TIONormalizePixelsForFormat<TIOFloat16>(pixels, bytesPerRow, pixelFormat, width, height, tensor, channels, normalization);
+}
+
+void TIONormalizePixelsToInt8(const uint8_t *pixels, size_t bytesPerRow, OSType pixelFormat, size_t width, size_t height, int8_t *tensor, size_t channels, TIOPixelNormalization normalization) {
+    TIONormalizePixelsForFormat<int8_t>(pixels, bytesPerRow, pixelFormat, width, height, tensor, channels, normalization);
+}
+
+void TIODenormalizePixelsFromFloat32(const float_t *tensor, size_t channels, size_t width, size_t height, uint8_t *pixels, size_t bytesPerRow, OSType pixelFormat, TIOPixelDenormalization denormalization) {
+    TIODenormalizePixelsForFormat<float_t>(tensor, channels, width, height, pixels, bytesPerRow, pixelFormat, denormalization);
+}
+
+void TIODenormalizePixelsFromUInt8(const uint8_t *tensor, size_t channels, size_t width, size_t height, uint8_t *pixels, size_t bytesPerRow, OSType pixelFormat, TIOPixelDenormalization denormalization) {
+    TIODenormalizePixelsForFormat<uint8_t>(tensor, channels, width, height, pixels, bytesPerRow, pixelFormat, denormalization);
+}
@@ -22,6 +22,9 @@
 
 #import "TIOVectorLayerDescription.h"
 #import "TIOScalarLayerDescription.h"
+#import "TIOFloat16.h"
+
+#include <vector>
 
 @implementation NSArray (TIOTFLiteData)
 
@@ -36,7 +39,15 @@
     
     const void *bytes = data.bytes;
     
-    if ( description.isQuantized && dequantizer != nil ) {
+    if ( dtype == TIODataTypeInt8 && description.isQuantized && dequantizer != nil ) {
+        for ( NSUInteger i = 0; i < length; i++ ) {
+            [array addObject:@(dequantizer(TIOQuantizedValueFromInt8(((int8_t *)bytes)[i])))];
+        }
+    } else if ( dtype == TIODataTypeInt8 ) {
+        for ( NSUInteger i = 0; i < length; i++ ) {
+            [array addObject:@(((int8_t *)bytes)[i])];
+        }
+    } else if ( description.isQuantized && dequantizer != nil ) {
         for ( NSUInteger i = 0; i < length; i++ ) {
             [array addObject:@(dequantizer(((uint8_t *)bytes)[i]))];
         }
@@ -52,6 +63,12 @@
         for ( NSUInteger i = 0; i < length; i++ ) {
             [array addObject:@(((int64_t *)bytes)[i])];
         }
+    } else if ( dtype == TIODataTypeFloat16 ) {
+        std::vector<float_t> values(length);
+        TIOConvertFloat16ToFloat32((const TIOFloat16 *)bytes, values.data(), length);
+        for ( NSUInteger i = 0; i < length; i++ ) {
+            [array addObject:@(values[i])];
+        }
     } else {
         for ( NSUInteger i = 0; i < length; i++ ) {
             [array addObject:@(((float_t *)bytes)[i])];
@@ -62,6 +79,12 @@
 }
 
 - (NSData *)dataForDescription:(id<TIOLayerDescription>)description {
+    NSMutableData *data = [NSArray bufferForDescription:description];
+    [self getBytes:data.mutableBytes description:description];
+    return data;
+}
+
+- (void)getBytes:(void *)buffer description:(id<TIOLayerDescription>)description {
     assert([description isKindOfClass:TIOVectorLayerDescription.class]
         || [description isKindOfClass:TIOScalarLayerDescription.class]);
     
@@ -72,14 +95,15 @@
     TIODataType dtype = ((TIOVectorLayerDescription *)description).dtype;
     TIODataQuantizer quantizer = ((TIOVectorLayerDescription *)description).quantizer;
 
-    // TODO: Cache data object so we aren't always mallocing and freeing memory
-    // This is the what we do in the JNI implementation on Android: NSMutableData.mutableData
-    // The model instance manages buffers and passes them to the data converters
-    
-    NSMutableData *data = [NSArray bufferForDescription:description];
-    void *buffer = data.mutableBytes;
-
-    if ( description.isQuantized && quantizer != nil ) {
+    if ( dtype == TIODataTypeInt8 && description.isQuantized && quantizer != nil ) {
+        for ( NSInteger i = 0; i < self.count; i++ ) {
+            ((int8_t *)buffer)[i] = TIOInt8FromQuantizedValue(quantizer(((NSNumber *)self[i]).floatValue));
+        }
+    } else if ( dtype == TIODataTypeInt8 ) {
+        for ( NSInteger i = 0; i < self.count; i++ ) {
+            ((int8_t *)buffer)[i] = ((NSNumber *)self[i]).charValue;
+        }
+    } else if ( description.isQuantized && quantizer != nil ) {
         for ( NSInteger i = 0; i < self.count; i++ ) {
             ((uint8_t *)buffer)[i] = quantizer(((NSNumber *)self[i]).floatValue);
         }
@@ -95,13 +119,17 @@
         for ( NSInteger i = 0; i < self.count; i++ ) {
             ((int64_t *)buffer)[i] = (int64_t)((NSNumber *)self[i]).longLongValue;
         }
+    } else if ( dtype == TIODataTypeFloat16 ) {
+        std::vector<float_t> values(self.count);
+        for ( NSInteger i = 0; i < self.count; i++ ) {
+            values[i] = ((NSNumber *)self[i]).floatValue;
+        }
+        TIOConvertFloat32ToFloat16(values.data(), (TIOFloat16 *)buffer, self.count);
     } else {
         for ( NSInteger i = 0; i < self.count; i++ ) {
             ((float_t *)buffer)[i] = ((NSNumber *)self[i]).floatValue;
         }
     }
-    
-    return data;
 }
 
 + (NSMutableData *)bufferForDescription:(id<TIOLayerDescription>)description {
@@ -128,6 +156,10 @@
         size = length * sizeof(int32_t);
     } else if ( dtype == TIODataTypeInt64 ) {
         size = length * sizeof(int64_t);
+    } else if ( dtype == TIODataTypeFloat16 ) {
+        size = length * sizeof(TIOFloat16);
+    } else if ( dtype == TIODataTypeInt8 ) {
+        size = length * sizeof(int8_t);
     } else {
         size = length * sizeof(float_t);
     }
@@ -24,6 +24,7 @@
 #import "TIOStringLayerDescription.h"
 #import "TIOScalarLayerDescription.h"
 #import "TIODataTypes.h"
+#import "TIOFloat16.h"
 
 @implementation NSData (TIOTFLiteData)
 
@@ -39,7 +40,19 @@
         TIODataType dtype = ((TIOVectorLayerDescription *)description).dtype;
         NSUInteger length = ((TIOVectorLayerDescription *)description).length;
 
-        if ( description.isQuantized && dequantizer != nil ) {
+        if ( dtype == TIODataTypeInt8 && description.isQuantized && dequantizer != nil ) {
+            size_t dest_size = length * sizeof(float_t);
+            float_t *buffer = (float_t *)malloc(dest_size);
+            for ( NSInteger i = 0; i < length; i++ ) {
+                ((float_t *)buffer)[i] = dequantizer(TIOQuantizedValueFromInt8(((int8_t *)bytes)[i]));
+            }
+            NSData *data = [[NSData alloc] initWithBytes:buffer length:dest_size];
+            free(buffer);
+            return data;
+        } else if ( dtype == TIODataTypeInt8 ) {
+            size_t dest_size = length * sizeof(int8_t);
+            return [[NSData alloc] initWithBytes:bytes length:dest_size];
+        } else if ( description.isQuantized && dequantizer != nil ) {
             size_t dest_size = length * sizeof(float_t);
             float_t *buffer = (float_t *)malloc(dest_size);
             for ( NSInteger i = 0; i < length; i++ ) {
@@ -57,6 +70,11 @@
         } else if ( dtype == TIODataTypeInt64 ) {
             size_t dest_size = length * sizeof(int64_t);
             return [[NSData alloc] initWithBytes:bytes length:dest_size];
+        } else if ( dtype == TIODataTypeFloat16 ) {
+            size_t dest_size = length * sizeof(float_t);
+            NSMutableData *data = [[NSMutableData alloc] initWithLength:dest_size];
+            TIOConvertFloat16ToFloat32((const TIOFloat16 *)bytes, (float_t *)data.mutableBytes, length);
+            return data;
         } else {
             size_t dest_size = length * sizeof(float_t);
             return [[NSData alloc] initWithBytes:bytes length:dest_size];
@@ -87,6 +105,16 @@
             return [[NSData alloc] initWithBytes:bytes length:dest_size];
         }
         break;
+        case TIODataTypeFloat16: {
+            size_t dest_size = length * sizeof(TIOFloat16);
+            return [[NSData alloc] initWithBytes:bytes length:dest_size];
+        }
+        break;
+        case TIODataTypeInt8: {
+            size_t dest_size = length * sizeof(int8_t);
+            return [[NSData alloc] initWithBytes:bytes length:dest_size];
+        }
+        break;
         default: {
             @throw [NSException exceptionWithName:@"Unsupported Data Type" reason:nil userInfo:nil];
             return nil;
@@ -99,7 +127,19 @@
         TIODataType dtype = ((TIOScalarLayerDescription *)description).dtype;
         NSUInteger length = ((TIOScalarLayerDescription *)description).length;
 
-        if ( description.isQuantized && dequantizer != nil ) {
+        if ( dtype == TIODataTypeInt8 && description.isQuantized && dequantizer != nil ) {
+            size_t dest_size = length * sizeof(float_t);
+            float_t *buffer = (float_t *)malloc(dest_size);
+            for ( NSInteger i = 0; i < length; i++ ) {
+                ((float_t *)buffer)[i] = dequantizer(TIOQuantizedValueFromInt8(((int8_t *)bytes)[i]));
+            }
+            NSData *data = [[NSData alloc] initWithBytes:buffer length:dest_size];
+            free(buffer);
+            return data;
+        } else if ( dtype == TIODataTypeInt8 ) {
+            size_t dest_size = length * sizeof(int8_t);
+            return [[NSData alloc] initWithBytes:bytes length:dest_size];
+        } else if ( description.isQuantized && dequantizer != nil ) {
             size_t dest_size = length * sizeof(float_t);
             float_t *buffer = (float_t *)malloc(dest_size);
             for ( NSInteger i = 0; i < length; i++ ) {
@@ -117,6 +157,11 @@
         } else if ( dtype == TIODataTypeInt64 ) {
             size_t dest_size = length * sizeof(int64_t);
             return [[NSData alloc] initWithBytes:bytes length:dest_size];
+        } else if ( dtype == TIODataTypeFloat16 ) {
+            size_t dest_size = length * sizeof(float_t);
+            NSMutableData *data = [[NSMutableData alloc] initWithLength:dest_size];
+            TIOConvertFloat16ToFloat32((const TIOFloat16 *)bytes, (float_t *)data.mutableBytes, length);
+            return data;
         } else {
             size_t dest_size = length * sizeof(float_t);
             return [[NSData alloc] initWithBytes:bytes length:dest_size];
@@ -128,23 +173,30 @@
 }
 
 - (NSData *)dataForDescription:(id<TIOLayerDescription>)description {
+    NSMutableData *data = [NSData bufferForDescription:description];
+    [self getBytes:data.mutableBytes description:description];
+    return data;
+}
+
+- (void)getBytes:(void *)buffer description:(id<TIOLayerDescription>)description {
     assert([description isKindOfClass:TIOVectorLayerDescription.class]
         || [description isKindOfClass:TIOStringLayerDescription.class]
         || [description isKindOfClass:TIOScalarLayerDescription.class]);
     
-    // TODO: Cache data object so we aren't always mallocing and freeing memory
-    // This is the what we do in the JNI implementation on Android: NSMutableData.mutableData
-    // The model instance manages buffers and passes them to the data converters
-    
-    NSMutableData *data = [NSData bufferForDescription:description];
-    void *buffer = data.mutableBytes;
-    
     if ( [description isKindOfClass:TIOVectorLayerDescription.class] ) {
         TIODataQuantizer quantizer = ((TIOVectorLayerDescription *)description).quantizer;
         TIODataType dtype = ((TIOVectorLayerDescription *)description).dtype;
         NSUInteger length = ((TIOVectorLayerDescription *)description).length;
 
-        if ( description.isQuantized && quantizer != nil ) {
+        if ( dtype == TIODataTypeInt8 && description.isQuantized && quantizer != nil ) {
+            float_t *bytes = (float_t *)self.bytes;
+            for ( NSInteger i = 0; i < length; i++ ) {
+                ((int8_t *)buffer)[i] = TIOInt8FromQuantizedValue(quantizer(bytes[i]));
+            }
+        } else if ( dtype == TIODataTypeInt8 ) {
+            size_t src_size = length * sizeof(int8_t);
+            [self getBytes:buffer length:src_size];
+        } else if ( description.isQuantized && quantizer != nil ) {
             float_t *bytes = (float_t *)self.bytes;
             for ( NSInteger i = 0; i < length; i++ ) {
                 ((uint8_t *)buffer)[i] = quantizer(bytes[i]);
@@ -158,6 +210,8 @@
         } else if ( dtype == TIODataTypeInt64 ) {
             size_t src_size = length * sizeof(int64_t);
             [self getBytes:buffer length:src_size];
+        } else if ( dtype == TIODataTypeFloat16 ) {
+            TIOConvertFloat32ToFloat16((const float_t *)self.bytes, (TIOFloat16 *)buffer, length);
         } else {
             size_t src_size = length * sizeof(float_t);
             [self getBytes:buffer length:src_size];
@@ -188,6 +242,16 @@
             [self getBytes:buffer length:src_size];
         }
         break;
+        case TIODataTypeFloat16: {
+            size_t src_size = length * sizeof(TIOFloat16);
+            [self getBytes:buffer length:src_size];
+        }
+        break;
+        case TIODataTypeInt8: {
+            size_t src_size = length * sizeof(int8_t);
+            [self getBytes:buffer length:src_size];
+        }
+        break;
         default: {
             @throw [NSException exceptionWithName:@"Unsupported Data Type" reason:nil userInfo:nil];
         }
@@ -199,7 +263,15 @@
         TIODataType dtype = ((TIOScalarLayerDescription *)description).dtype;
         NSUInteger length = ((TIOScalarLayerDescription *)description).length;
 
-        if ( description.isQuantized && quantizer != nil ) {
+        if ( dtype == TIODataTypeInt8 && description.isQuantized && quantizer != nil ) {
+            float_t *bytes = (float_t *)self.bytes;
+            for ( NSInteger i = 0; i < length; i++ ) {
+                ((int8_t *)buffer)[i] = TIOInt8FromQuantizedValue(quantizer(bytes[i]));
+            }
+        } else if ( dtype == TIODataTypeInt8 ) {
+            size_t src_size = length * sizeof(int8_t);
+            [self getBytes:buffer length:src_size];
+        } else if ( description.isQuantized && quantizer != nil ) {
             float_t *bytes = (float_t *)self.bytes;
             for ( NSInteger i = 0; i < length; i++ ) {
                 ((uint8_t *)buffer)[i] = quantizer(bytes[i]);
@@ -213,6 +285,8 @@
         } else if ( dtype == TIODataTypeInt64 ) {
             size_t src_size = length * sizeof(int64_t);
             [self getBytes:buffer length:src_size];
+        } else if ( dtype == TIODataTypeFloat16 ) {
+            TIOConvertFloat32ToFloat16((const float_t *)self.bytes, (TIOFloat16 *)buffer, length);
         } else {
             size_t src_size = length * sizeof(float_t);
             [self getBytes:buffer length:src_size];
@@ -220,8 +294,6 @@
     } else {
         @throw [NSException exceptionWithName:@"Unsupported Layer Description" reason:nil userInfo:nil];
     }
-    
-    return data;
 }
 
 + (NSMutableData *)bufferForDescription:(id<TIOLayerDescription>)description {
@@ -241,6 +313,10 @@
             size = length * sizeof(int32_t);
         } else if ( dtype == TIODataTypeInt64 ) {
             size = length * sizeof(int64_t);
+        } else if ( dtype == TIODataTypeFloat16 ) {
+            size = length * sizeof(TIOFloat16);
+        } else if ( dtype == TIODataTypeInt8 ) {
+            size = length * sizeof(int8_t);
         } else {
             size = length * sizeof(float_t);
         }
@@ -266,6 +342,14 @@
             size = length * sizeof(int64_t);
         }
         break;
+        case TIODataTypeFloat16: {
+            size = length * sizeof(TIOFloat16);
+        }
+        break;
+        case TIODataTypeInt8: {
+            size = length * sizeof(int8_t);
+        }
+        break;
         default: {
             @throw [NSException exceptionWithName:@"Unsupported Data Type" reason:nil userInfo:nil];
         }
@@ -285,6 +369,10 @@
             size = length * sizeof(int32_t);
         } else if ( dtype == TIODataTypeInt64 ) {
             size = length * sizeof(int64_t);
+        } else if ( dtype == TIODataTypeFloat16 ) {
+            size = length * sizeof(TIOFloat16);
+        } else if ( dtype == TIODataTypeInt8 ) {
+            size = length * sizeof(int8_t);
         } else {
             size = length * sizeof(float_t);
         }
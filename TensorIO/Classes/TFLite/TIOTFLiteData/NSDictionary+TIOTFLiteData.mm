@@ -32,6 +32,10 @@
     return nil;
 }
 
+- (void)getBytes:(void *)buffer description:(id<TIOLayerDescription>)description {
+    NSAssert(NO, @"This method is unimplemented. Tensor bytes cannot be captured from a dictionary.");
+}
+
 + (NSMutableData *)bufferForDescription:(id<TIOLayerDescription>)description {
     NSAssert(NO, @"This method is unimplemented. Tensor bytes cannot be captured from a dictionary.");
     return nil;
@@ -22,6 +22,7 @@
 
 #import "TIOVectorLayerDescription.h"
 #import "TIOScalarLayerDescription.h"
+#import "TIOFloat16.h"
 
 @implementation NSNumber (TIOTFLiteData)
 
@@ -42,7 +43,11 @@
     
     const void *bytes = data.bytes;
     
-    if ( description.isQuantized && dequantizer != nil ) {
+    if ( dtype == TIODataTypeInt8 && description.isQuantized && dequantizer != nil ) {
+        return [self initWithFloat:dequantizer(TIOQuantizedValueFromInt8(((int8_t *)bytes)[0]))];
+    } else if ( dtype == TIODataTypeInt8 ) {
+        return [self initWithChar:((int8_t *)bytes)[0]];
+    } else if ( description.isQuantized && dequantizer != nil ) {
         return [self initWithFloat:dequantizer(((uint8_t *)bytes)[0])];
     } else if ( description.isQuantized && dequantizer == nil ) {
         return [self initWithUnsignedChar:((uint8_t *)bytes)[0]];
@@ -50,12 +55,20 @@
         return [self initWithLong:((uint32_t *)bytes)[0]];
     } else if ( dtype == TIODataTypeInt64 ) {
         return [self initWithLongLong:((uint64_t *)bytes)[0]];
+    } else if ( dtype == TIODataTypeFloat16 ) {
+        return [self initWithFloat:TIOFloat32FromFloat16(((TIOFloat16 *)bytes)[0])];
     } else {
         return [self initWithFloat:((float_t *)bytes)[0]];
     }
 }
 
 - (NSData *)dataForDescription:(id<TIOLayerDescription>)description {
+    NSMutableData *data = [NSNumber bufferForDescription:description];
+    [self getBytes:data.mutableBytes description:description];
+    return data;
+}
+
+- (void)getBytes:(void *)buffer description:(id<TIOLayerDescription>)description {
     assert([description isKindOfClass:TIOVectorLayerDescription.class]
         || [description isKindOfClass:TIOScalarLayerDescription.class]);
     
@@ -70,14 +83,11 @@
         dtype = ((TIOScalarLayerDescription *)description).dtype;
     }
     
-    // TODO: Cache data object so we aren't always mallocing and freeing memory
-    // This is the what we do in the JNI implementation on Android: NSMutableData.mutableData
-    // The model instance manages buffers and passes them to the data converters
-    
-    NSMutableData *data = [NSNumber bufferForDescription:description];
-    void *buffer = data.mutableBytes;
-    
-    if ( description.isQuantized && quantizer != nil ) {
+    if ( dtype == TIODataTypeInt8 && description.isQuantized && quantizer != nil ) {
+        ((int8_t *)buffer)[0] = TIOInt8FromQuantizedValue(quantizer(self.floatValue));
+    } else if ( dtype == TIODataTypeInt8 ) {
+        ((int8_t *)buffer)[0] = self.charValue;
+    } else if ( description.isQuantized && quantizer != nil ) {
         ((uint8_t *)buffer)[0] = quantizer(self.floatValue);
     } else if ( description.isQuantized && quantizer == nil ) {
         ((uint8_t *)buffer)[0] = self.unsignedCharValue;
@@ -85,11 +95,11 @@
         ((int32_t *)buffer)[0] = (int32_t)self.longValue;
     } else if ( dtype == TIODataTypeInt64 ) {
         ((int64_t *)buffer)[0] = (int64_t)self.longLongValue;
+    } else if ( dtype == TIODataTypeFloat16 ) {
+        ((TIOFloat16 *)buffer)[0] = TIOFloat16FromFloat32(self.floatValue);
     } else {
         ((float_t *)buffer)[0] = self.floatValue;
     }
-    
-    return data;
 }
 
 + (NSMutableData *)bufferForDescription:(id<TIOLayerDescription>)description {
@@ -120,6 +130,10 @@
         size = length * sizeof(int32_t);
     } else if ( dtype == TIODataTypeInt64 ) {
         size = length * sizeof(int64_t);
+    } else if ( dtype == TIODataTypeFloat16 ) {
+        size = length * sizeof(TIOFloat16);
+    } else if ( dtype == TIODataTypeInt8 ) {
+        size = length * sizeof(int8_t);
     } else {
         size = length * sizeof(float_t);
     }
@@ -22,6 +22,13 @@
 
 #import "TIOPixelBufferLayerDescription.h"
 #import "TIOVisionPipeline.h"
+#import "TIOFloat16.h"
+#import "TIOQuantization.h"
+#import "TIOPixelKernels.h"
+#import "TIOPixelBufferPool.h"
+
+#include <type_traits>
+#include <vector>
 
 /**
  * Copies a pixel buffer in ARGB or BGRA format to a tensor, which is a pointer to an array of
@@ -30,21 +37,24 @@
  * The pixel buffer must already be in the shape and format expected by the input tensor,
  * with the shape parameter describing its dimensions. The alpha channel will be ignored.
  *
- * If a normalizer is provided then the pixel buffer's values will be scaled using the
- * normalizer.
+ * Pixel values are normalized a row at a time by the vectorized pixel kernels unless the
+ * normalization is `kTIOPixelNormalizationInvalid`, which means the layer has a custom
+ * normalizer that must be called for every value.
  *
- * `tensor_t` will be `float_t` (32 bits) for an unquantized model or `uint8_t` (8 bits)
- * for a quantized model.
+ * `T` will be `float_t` (32 bits) for an unquantized model, `uint8_t` (8 bits) for a quantized
+ * model, or `TIOFloat16` or `int8_t` for layers with those dtypes.
  *
  * @param pixelBuffer The pixel buffer that will be copied to the tensor.
  * @param tensor The tensor that will receive the pixel buffer values.
  * @param shape The shape, i.e. width, height, and number of channels of the tensor.
  * @param normalizer A scaling function that will be applied to the pixel values as
  * they are copied to the tensor. May be `nil`.
+ * @param normalization The scale and biases of the normalizer, or `kTIOPixelNormalizationInvalid`
+ * for a custom normalizer.
  */
 
 template <typename T>
-void TIOCopyCVPixelBufferToTensor(CVPixelBufferRef pixelBuffer, T* _Nonnull tensor, TIOImageVolume shape, _Nullable TIOPixelNormalizer normalizer) {
+void TIOCopyCVPixelBufferToTensor(CVPixelBufferRef pixelBuffer, T* _Nonnull tensor, TIOImageVolume shape, _Nullable TIOPixelNormalizer normalizer, TIOPixelNormalization normalization) {
     
     CFRetain(pixelBuffer);
     CVPixelBufferLockBaseAddress(pixelBuffer, kNilOptions);
@@ -75,42 +85,35 @@ void TIOCopyCVPixelBufferToTensor(CVPixelBufferRef pixelBuffer, T* _Nonnull tens
     uint8_t* in = (uint8_t *)CVPixelBufferGetBaseAddress(pixelBuffer);
     T* out = tensor;
     
-    if ( normalizer == nil ) {
+    if ( TIOPixelNormalizationsEqual(normalization, kTIOPixelNormalizationInvalid) ) {
+        
+        // A custom normalizer is called for every value
+        
         for (int y = 0; y < image_height; y++) {
             for (int x = 0; x < image_width; x++) {
                 auto* in_pixel = in + (y * bytes_per_row) + (x * image_channels);
                 auto* out_pixel = out + (y * tensor_bytes_per_row) + (x * tensor_channels);
 
                 for (int c = 0; c < tensor_channels; ++c) {
-                    out_pixel[c] = in_pixel[c+channel_offset];
+                    TIOStoreNormalizedValue(normalizer(in_pixel[c+channel_offset], c), out_pixel + c);
                 }
             }
         }
     } else {
-        for (int y = 0; y < image_height; y++) {
-            for (int x = 0; x < image_width; x++) {
-                auto* in_pixel = in + (y * bytes_per_row) + (x * image_channels);
-                auto* out_pixel = out + (y * tensor_bytes_per_row) + (x * tensor_channels);
-
-                for (int c = 0; c < tensor_channels; ++c) {
-                    out_pixel[c] = normalizer(in_pixel[c+channel_offset], c);
-                }
-            }
-        }
+        TIONormalizePixels(in, bytes_per_row, sourcePixelFormat, image_width, image_height, out, tensor_channels, normalization);
     }
     
     CVPixelBufferUnlockBaseAddress(pixelBuffer, kNilOptions);
     CFRelease(pixelBuffer);
 }
 
-// TODO: ensure 16 byte pixel buffer alignment
-
 /**
  * Copies tensor bytes directly into  a pixel buffer from a tensor, applying a denormalization
  * function and adjusting for the pixel format.
  *
- * The resulting pixel buffer will (eventually) be 16 byte aligned. The caller must release the
- * pixelBuffer with `CVPixelBufferRelease`.
+ * The resulting pixel buffer comes from the shared `TIOPixelBufferPool`, so its rows are 64 byte
+ * aligned and its memory is reused once it is released. The caller must release the pixelBuffer
+ * with `CVPixelBufferRelease`.
  *
  * @param pixelBuffer A pointer to the pixel buffer that will be filled with the transformed tensor data
  * @param tensor A pointer to the tensor that contains the image data
@@ -118,39 +121,31 @@ void TIOCopyCVPixelBufferToTensor(CVPixelBufferRef pixelBuffer, T* _Nonnull tens
  * @param pixelFormat The format of the tensor image data, must be kCVPixelFormatType_32ARGB or kCVPixelFormatType_32BGRA.
  * Note that the alpha channel is ignored.
  * @param denormalizer A function that can convert the tensor image data to pixel values, may be `nil`.
+ * @param denormalization The scale and biases of the denormalizer, or `kTIOPixelDenormalizationInvalid`
+ * for a custom denormalizer.
  *
  * @return CVReturn `kCVReturnSuccess` if the operation was successful, some other value if not
  */
 
 template <typename T>
-CVReturn TIOCreateCVPixelBufferFromTensor(_Nonnull CVPixelBufferRef * _Nonnull pixelBuffer, T * _Nonnull tensor, TIOImageVolume shape, OSType pixelFormat, _Nullable TIOPixelDenormalizer denormalizer) {
+CVReturn TIOCreateCVPixelBufferFromTensor(_Nonnull CVPixelBufferRef * _Nonnull pixelBuffer, T * _Nonnull tensor, TIOImageVolume shape, OSType pixelFormat, _Nullable TIOPixelDenormalizer denormalizer, TIOPixelDenormalization denormalization) {
     
     assert( pixelFormat == kCVPixelFormatType_32ARGB || pixelFormat == kCVPixelFormatType_32BGRA );
-    assert( shape.width % 16 == 0);
     
     const int tensor_channels = shape.channels;
     const int tensor_bytes_per_row = shape.width * tensor_channels;
     
     const int image_width = shape.width;
     const int image_height = shape.height;
-    const int bytes_per_row = shape.width * 4;
     const int image_channels = 4; // by definition (ARGB, BGRA)
     
-    CVPixelBufferRef outputBuffer = NULL;
-    
-    CVReturn status = CVPixelBufferCreate(
-        kCFAllocatorDefault,
-        image_width,
-        image_height,
-        pixelFormat,
-        NULL,
-        &outputBuffer);
+    CVPixelBufferRef outputBuffer = [TIOPixelBufferPool.sharedPool createPixelBufferWithWidth:image_width height:image_height pixelFormat:pixelFormat];
     
     // Error handling
     
-    if ( status != kCVReturnSuccess ) {
+    if ( outputBuffer == NULL ) {
         NSLog(@"Couldn't create pixel buffer");
-        return status;
+        return kCVReturnAllocationFailed;
     }
     
     // Copy the pixel data
@@ -160,6 +155,8 @@ CVReturn TIOCreateCVPixelBufferFromTensor(_Nonnull CVPixelBufferRef * _Nonnull p
     
     CVPixelBufferLockBaseAddress(outputBuffer, kNilOptions);
     
+    const size_t bytes_per_row = CVPixelBufferGetBytesPerRow(outputBuffer);
+    
     const int channel_offset = pixelFormat == kCVPixelFormatType_32ARGB
         ? 1
         : 0;
@@ -171,20 +168,10 @@ CVReturn TIOCreateCVPixelBufferFromTensor(_Nonnull CVPixelBufferRef * _Nonnull p
     T* in_addr = tensor;
     uint8_t* out_addr = (uint8_t *)CVPixelBufferGetBaseAddress(outputBuffer);
     
-    if ( denormalizer == nil ) {
-        for (int y = 0; y < image_height; y++) {
-            for (int x = 0; x < image_width; x++) {
-                auto* in_pixel = in_addr + (y * tensor_bytes_per_row) + (x * tensor_channels);
-                auto* out_pixel = out_addr + (y * bytes_per_row) + (x * image_channels);
-                
-                for (int c = 0; c < tensor_channels; ++c) {
-                    out_pixel[c+channel_offset] = in_pixel[c];
-                }
-                
-                out_pixel[alpha_channel] = 255;
-            }
-        }
-    } else {
+    if ( TIOPixelDenormalizationsEqual(denormalization, kTIOPixelDenormalizationInvalid) ) {
+        
+        // A custom denormalizer is called for every value
+        
         for (int y = 0; y < image_height; y++) {
             for (int x = 0; x < image_width; x++) {
                 auto* in_pixel = in_addr + (y * tensor_bytes_per_row) + (x * tensor_channels);
@@ -197,6 +184,8 @@ CVReturn TIOCreateCVPixelBufferFromTensor(_Nonnull CVPixelBufferRef * _Nonnull p
                 out_pixel[alpha_channel] = 255;
             }
         }
+    } else {
+        TIODenormalizePixels(in_addr, tensor_channels, image_width, image_height, out_addr, bytes_per_row, pixelFormat, denormalization);
     }
     
     // Clean up
@@ -207,11 +196,37 @@ CVReturn TIOCreateCVPixelBufferFromTensor(_Nonnull CVPixelBufferRef * _Nonnull p
     return kCVReturnSuccess;
 }
 
+/**
+ * Copies an input pixel buffer to a tensor, either directly when the pixel buffer already has the
+ * size, format, and orientation the layer expects, or with a vision pipeline that transforms it
+ * into the tensor in a single pass.
+ *
+ * @param pipeline The pipeline that transforms the pixel buffer, or `nil` to copy it directly.
+ * @param pixelBuffer The pixel buffer that will be copied to the tensor.
+ * @param orientation The orientation of the pixel buffer.
+ * @param tensor The tensor that will receive the pixel buffer values.
+ * @param description The description of the layer.
+ */
+
+template <typename T>
+void TIOCopyPixelBufferToTensor(TIOVisionPipeline * _Nullable pipeline, CVPixelBufferRef pixelBuffer, CGImagePropertyOrientation orientation, T * _Nonnull tensor, TIOPixelBufferLayerDescription *description) {
+    if ( pipeline != nil ) {
+        const TIODataType dtype = std::is_same<T, uint8_t>::value ? TIODataTypeUInt8
+            : std::is_same<T, int8_t>::value ? TIODataTypeInt8
+            : std::is_same<T, TIOFloat16>::value ? TIODataTypeFloat16
+            : TIODataTypeFloat32;
+        [pipeline transform:pixelBuffer orientation:orientation toBuffer:tensor dtype:dtype];
+    } else {
+        TIOCopyCVPixelBufferToTensor<T>(pixelBuffer, tensor, description.imageVolume, description.normalizer, description.normalization);
+    }
+}
+
 // MARK: -
 
 @interface TIOPixelBuffer (TIOTFLiteData_Protected)
 
 @property (readwrite) CVPixelBufferRef transformedPixelBuffer;
+@property (nullable) TIOPixelBufferLayerDescription *transformDescription;
 
 @end
 
@@ -225,13 +240,45 @@ CVReturn TIOCreateCVPixelBufferFromTensor(_Nonnull CVPixelBufferRef * _Nonnull p
     
     const void *bytes = data.bytes;
     
-    if ( description.isQuantized ) {
+    if ( pixelBufferDescription.dtype == TIODataTypeInt8 ) {
+        // Widen the int8 tensor, restoring the offset of pixel values when there is no denormalizer
+        
+        size_t length = TIOImageVolumeLength(pixelBufferDescription.imageVolume);
+        float_t bias = pixelBufferDescription.denormalizer == nil ? 128 : 0;
+        std::vector<float_t> values(length);
+        TIOConvertInt8ToFloat32((const int8_t *)bytes, values.data(), length, bias);
+        
+        result = TIOCreateCVPixelBufferFromTensor<float_t>(
+            &pixelBuffer,
+            values.data(),
+            pixelBufferDescription.imageVolume,
+            pixelBufferDescription.pixelFormat,
+            pixelBufferDescription.denormalizer,
+            pixelBufferDescription.denormalization
+        );
+    } else if ( description.isQuantized ) {
         result = TIOCreateCVPixelBufferFromTensor<uint8_t>(
             &pixelBuffer,
             (uint8_t *)bytes,
             pixelBufferDescription.imageVolume,
             pixelBufferDescription.pixelFormat,
-            pixelBufferDescription.denormalizer
+            pixelBufferDescription.denormalizer,
+            pixelBufferDescription.denormalization
+        );
+    } else if ( pixelBufferDescription.dtype == TIODataTypeFloat16 ) {
+        // Widen the half precision tensor and create the pixel buffer from single precision values
+        
+        size_t length = TIOImageVolumeLength(pixelBufferDescription.imageVolume);
+        std::vector<float_t> values(length);
+        TIOConvertFloat16ToFloat32((const TIOFloat16 *)bytes, values.data(), length);
+        
+        result = TIOCreateCVPixelBufferFromTensor<float_t>(
+            &pixelBuffer,
+            values.data(),
+            pixelBufferDescription.imageVolume,
+            pixelBufferDescription.pixelFormat,
+            pixelBufferDescription.denormalizer,
+            pixelBufferDescription.denormalization
         );
     } else {
         result = TIOCreateCVPixelBufferFromTensor<float_t>(
@@ -239,7 +286,8 @@ CVReturn TIOCreateCVPixelBufferFromTensor(_Nonnull CVPixelBufferRef * _Nonnull p
             (float_t *)bytes,
             pixelBufferDescription.imageVolume,
             pixelBufferDescription.pixelFormat,
-            pixelBufferDescription.denormalizer
+            pixelBufferDescription.denormalizer,
+            pixelBufferDescription.denormalization
         );
     }
 
@@ -254,17 +302,23 @@ CVReturn TIOCreateCVPixelBufferFromTensor(_Nonnull CVPixelBufferRef * _Nonnull p
 }
 
 - (NSData *)dataForDescription:(id<TIOLayerDescription>)description {
+    NSMutableData *data = [TIOPixelBuffer bufferForDescription:description];
+    [self getBytes:data.mutableBytes description:description];
+    return data;
+}
+
+- (void)getBytes:(void *)buffer description:(id<TIOLayerDescription>)description {
     assert([description isKindOfClass:TIOPixelBufferLayerDescription.class]);
     
     TIOPixelBufferLayerDescription *pixelBufferDescription = (TIOPixelBufferLayerDescription *)description;
     
     // If the pixel buffer is already the right size, format, and orientation simpy copy it to the tensor.
-    // Otherwise, run it through the vision pipeline
+    // Otherwise, transform it into the tensor with the vision pipeline
     
     CVPixelBufferRef pixelBuffer = self.pixelBuffer;
     CGImagePropertyOrientation orientation = self.orientation;
     
-    CVPixelBufferRef transformedPixelBuffer;
+    TIOVisionPipeline *pipeline = nil;
     
     int width = (int)CVPixelBufferGetWidth(pixelBuffer);
     int height = (int)CVPixelBufferGetHeight(pixelBuffer);
@@ -274,35 +328,51 @@ CVReturn TIOCreateCVPixelBufferFromTensor(_Nonnull CVPixelBufferRef * _Nonnull p
         && height == pixelBufferDescription.imageVolume.height
         && pixelFormat == pixelBufferDescription.pixelFormat
         && orientation == kCGImagePropertyOrientationUp ) {
-        transformedPixelBuffer = pixelBuffer;
+        CVPixelBufferRetain(pixelBuffer);
+        self.transformedPixelBuffer = pixelBuffer;
+        self.transformDescription = nil;
     } else {
-        TIOVisionPipeline *pipeline = [[TIOVisionPipeline alloc] initWithTIOPixelBufferDescription:pixelBufferDescription];
-        transformedPixelBuffer = [pipeline transform:self.pixelBuffer orientation:self.orientation];
+        pipeline = pixelBufferDescription.visionPipeline;
+        self.transformedPixelBuffer = NULL;
+        self.transformDescription = pixelBufferDescription;
     }
     
-    CVPixelBufferRetain(transformedPixelBuffer);
-    self.transformedPixelBuffer = transformedPixelBuffer;
-    
-    NSMutableData *data = [TIOPixelBuffer bufferForDescription:description];
-    void *buffer = data.mutableBytes;
+    // Float16 and int8 values are written directly, with int8 pixel values offset when there is
+    // no normalizer
     
-    if ( description.isQuantized ) {
-        TIOCopyCVPixelBufferToTensor<uint8_t>(
-            transformedPixelBuffer,
+    if ( pixelBufferDescription.dtype == TIODataTypeInt8 ) {
+        TIOCopyPixelBufferToTensor<int8_t>(
+            pipeline,
+            pixelBuffer,
+            orientation,
+            (int8_t *)buffer,
+            pixelBufferDescription
+        );
+    } else if ( description.isQuantized ) {
+        TIOCopyPixelBufferToTensor<uint8_t>(
+            pipeline,
+            pixelBuffer,
+            orientation,
             (uint8_t *)buffer,
-            pixelBufferDescription.imageVolume,
-            pixelBufferDescription.normalizer
+            pixelBufferDescription
+        );
+    } else if ( pixelBufferDescription.dtype == TIODataTypeFloat16 ) {
+        TIOCopyPixelBufferToTensor<TIOFloat16>(
+            pipeline,
+            pixelBuffer,
+            orientation,
+            (TIOFloat16 *)buffer,
+            pixelBufferDescription
         );
     } else {
-        TIOCopyCVPixelBufferToTensor<float_t>(
-            transformedPixelBuffer,
+        TIOCopyPixelBufferToTensor<float_t>(
+            pipeline,
+            pixelBuffer,
+            orientation,
             (float_t *)buffer,
-            pixelBufferDescription.imageVolume,
-            pixelBufferDescription.normalizer
+            pixelBufferDescription
         );
     }
-    
-    return data;
 }
 
 + (NSMutableData *)bufferForDescription:(id<TIOLayerDescription>)description {
@@ -311,8 +381,12 @@ CVReturn TIOCreateCVPixelBufferFromTensor(_Nonnull CVPixelBufferRef * _Nonnull p
     size_t length = TIOImageVolumeLength(pixelBufferDescription.imageVolume);
     size_t size = 0;
     
-    if ( description.isQuantized ) {
+    if ( pixelBufferDescription.dtype == TIODataTypeInt8 ) {
+        size = length * sizeof(int8_t);
+    } else if ( description.isQuantized ) {
         size = length * sizeof(uint8_t);
+    } else if ( pixelBufferDescription.dtype == TIODataTypeFloat16 ) {
+        size = length * sizeof(TIOFloat16);
     } else {
         size = length * sizeof(float_t);
     }
@@ -38,14 +38,26 @@ NS_ASSUME_NONNULL_BEGIN
 - (nullable instancetype)initWithData:(NSData *)data description:(id<TIOLayerDescription>)description;
 
 /**
- * Requests that a conforming object fill an NSData object with bytes that can later be copied to a TFLTensor
+ * Requests that a conforming object fill an NSData object with bytes that can later be copied to a tensor
  *
  * @param description A description of the data this buffer expects.
- * @return NSData object filled with bytes that can be copied to a TFLTensor
+ * @return NSData object filled with bytes that can be copied to a tensor
  */
 
 - (NSData *)dataForDescription:(id<TIOLayerDescription>)description;
 
+/**
+ * Requests that a conforming object write its bytes directly to a buffer, typically the memory
+ * backing a TFLite input tensor. Avoids the intermediate allocation and copy that
+ * `dataForDescription:` requires.
+ *
+ * @param buffer The destination buffer, which must be at least as large as the buffer returned by
+ *  `bufferForDescription:` for the same description.
+ * @param description A description of the data this buffer expects.
+ */
+
+- (void)getBytes:(void *)buffer description:(id<TIOLayerDescription>)description;
+
 /**
  * Returns a reusable data object for a given description. Call `mutableBytes` on the returned object to
  * acquire a pointer to the underlying data buffer, which you can fill with bytes.
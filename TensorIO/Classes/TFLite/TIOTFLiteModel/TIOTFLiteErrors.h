@@ -43,4 +43,39 @@ extern NSError * const kTIOTFLiteModelConstructInterpreterError;
 
 extern NSError * const kTIOTFLiteModelAllocateTensorsError;
 
+/**
+ * Set the `TIOModel` run error to `kTIOTFLiteModelResizeTensorsError` when the tflite
+ * input tensors cannot be resized to hold a batch.
+ */
+
+extern NSError * const kTIOTFLiteModelResizeTensorsError;
+
+/**
+ * Set the `TIOModel` run error to `kTIOTFLiteModelInterpreterUnavailableError` when no
+ * interpreter becomes available before the model's checkout timeout.
+ */
+
+extern NSError * const kTIOTFLiteModelInterpreterUnavailableError;
+
+/**
+ * Set the `TIOModel` load error to `kTIOTFLiteModelRunPlanError` when the tflite model's
+ * input and output tensors do not match the layers described by the model bundle.
+ */
+
+extern NSError * const kTIOTFLiteModelRunPlanError;
+
+/**
+ * Passed to a `runOn:completion:` completion handler as `kTIOTFLiteModelPipelineFullError`
+ * when the input is refused because the pipeline already holds as many inputs as it may.
+ */
+
+extern NSError * const kTIOTFLiteModelPipelineFullError;
+
+/**
+ * Set the `TIOModel` run error to `kTIOTFLiteModelUnloadedError` when the model is unloaded
+ * after it was loaded for a run but before an interpreter could be checked out.
+ */
+
+extern NSError * const kTIOTFLiteModelUnloadedError;
+
 NS_ASSUME_NONNULL_END
@@ -31,3 +31,23 @@ NSError * const kTIOTFLiteModelConstructInterpreterError = [NSError errorWithDom
 NSError * const kTIOTFLiteModelAllocateTensorsError = [NSError errorWithDomain:@"doc.ai.netrunner" code:103 userInfo:@{
     NSLocalizedDescriptionKey: @"Unable to allocate tensors"
 }];
+
+NSError * const kTIOTFLiteModelResizeTensorsError = [NSError errorWithDomain:@"doc.ai.netrunner" code:104 userInfo:@{
+    NSLocalizedDescriptionKey: @"Unable to resize input tensors for batch"
+}];
+
+NSError * const kTIOTFLiteModelInterpreterUnavailableError = [NSError errorWithDomain:@"doc.ai.netrunner" code:105 userInfo:@{
+    NSLocalizedDescriptionKey: @"Timed out waiting for an available interpreter"
+}];
+
+NSError * const kTIOTFLiteModelRunPlanError = [NSError errorWithDomain:@"doc.ai.netrunner" code:106 userInfo:@{
+    NSLocalizedDescriptionKey: @"Model tensors do not match the model description"
+}];
+
+NSError * const kTIOTFLiteModelPipelineFullError = [NSError errorWithDomain:@"doc.ai.netrunner" code:107 userInfo:@{
+    NSLocalizedDescriptionKey: @"Pipeline is full, the input was dropped"
+}];
+
+NSError * const kTIOTFLiteModelUnloadedError = [NSError errorWithDomain:@"doc.ai.netrunner" code:108 userInfo:@{
+    NSLocalizedDescriptionKey: @"The model was unloaded before the input could be run"
+}];
@@ -0,0 +1,119 @@
+//
+//  TIOTFLiteInterpreterPool.h
+//  TensorIO
+//
+//  Created by Phil Dow on 10/17/20.
+//  Copyright © 2020 doc.ai (http://doc.ai)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+#import "TIOTFLiteModel.h"
+
+#import "c_api.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class TIOLayerInterface;
+
+/**
+ * A pool of TFLite interpreters that share a single model.
+ *
+ * An interpreter is not thread safe, but any number of interpreters may share the same
+ * `TfLiteModel`. The pool lends interpreters to callers one at a time, creating them lazily up to
+ * its capacity, and blocks callers for a bounded amount of time when every interpreter is busy.
+ *
+ * Each interpreter remembers the batch size its input tensors were last resized to, and the pool
+ * prefers lending an interpreter that already matches the requested batch size so that tensors
+ * are not reallocated unnecessarily.
+ *
+ * The pool deletes its interpreters and releases its model when it is deallocated. Keep a strong
+ * reference to the pool for as long as an interpreter is checked out and check the interpreter
+ * back in to that same pool, so that an interpreter in use is never deleted out from under its
+ * caller.
+ */
+
+@interface TIOTFLiteInterpreterPool : NSObject
+
+/**
+ * The maximum number of interpreters the pool will create.
+ */
+
+@property (readonly) NSUInteger capacity;
+
+/**
+ * Statistics describing how the pool has been used and how often callers had to wait.
+ */
+
+@property (readonly) TIOTFLiteInterpreterPoolStats stats;
+
+/**
+ * Called with an idle interpreter as it is checked out, before its tensors are resized or
+ * reallocated and before the caller writes to them. Anything that points into the interpreter's
+ * tensor memory must let go of it here.
+ */
+
+@property (nullable, copy) void (^willLendInterpreter)(TfLiteInterpreter *interpreter);
+
+/**
+ * Called with each interpreter as the pool is deallocated, before the interpreter is deleted.
+ */
+
+@property (nullable, copy) void (^willDeleteInterpreter)(TfLiteInterpreter *interpreter);
+
+/**
+ * Creates a pool of interpreters for a model. The pool takes over a reference to the model
+ * acquired from the shared `TIOTFLiteModelCache`, which it releases after deleting its
+ * interpreters.
+ *
+ * @param model The TFLite model shared by every interpreter.
+ * @param path The path the model was acquired at.
+ * @param inputs The model's input interfaces, used to identify batched input tensors.
+ * @param capacity The maximum number of interpreters, at least one.
+ *
+ * @return instancetype A pool with no interpreters checked out.
+ */
+
+- (instancetype)initWithModel:(TfLiteModel *)model path:(NSString *)path inputs:(NSArray<TIOLayerInterface*> *)inputs capacity:(NSUInteger)capacity NS_DESIGNATED_INITIALIZER;
+
+/**
+ * Use the designated initializer.
+ */
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ * Checks an interpreter out of the pool, waiting for one to become available if necessary. The
+ * interpreter's input tensors are sized for the batch and its tensors allocated.
+ *
+ * @param batchSize The number of items the interpreter's batched input tensors must hold.
+ * @param timeout The maximum number of seconds to wait for an interpreter.
+ * @param error Set if no interpreter became available or if it could not be prepared.
+ *
+ * @return TfLiteInterpreter An interpreter for the exclusive use of the caller, or `NULL`. It must be
+ *  returned to the pool with `checkinInterpreter:`.
+ */
+
+- (nullable TfLiteInterpreter *)checkoutInterpreterForBatchSize:(NSUInteger)batchSize timeout:(NSTimeInterval)timeout error:(NSError * _Nullable *)error;
+
+/**
+ * Returns a previously checked out interpreter to the pool.
+ */
+
+- (void)checkinInterpreter:(TfLiteInterpreter *)interpreter;
+
+@end
+
+NS_ASSUME_NONNULL_END
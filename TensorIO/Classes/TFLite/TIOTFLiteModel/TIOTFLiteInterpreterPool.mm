@@ -0,0 +1,259 @@
+//
+//  TIOTFLiteInterpreterPool.mm
+//  TensorIO
+//
+//  Created by Phil Dow on 10/17/20.
+//  Copyright © 2020 doc.ai (http://doc.ai)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "TIOTFLiteInterpreterPool.h"
+
+#import "TIOTFLiteErrors.h"
+#import "TIOTFLiteModelCache.h"
+#import "TIOLayerInterface.h"
+#import "TIOLayerDescription.h"
+
+#import <os/lock.h>
+
+#include <unordered_map>
+#include <vector>
+
+@implementation TIOTFLiteInterpreterPool {
+    TfLiteModel *_model;
+    NSString *_path;
+    NSArray<TIOLayerInterface*> *_inputs;
+    
+    dispatch_semaphore_t _available;
+    os_unfair_lock _lock;
+    
+    // Every interpreter the pool has created, mapped to the batch size its inputs are sized for
+    
+    std::unordered_map<TfLiteInterpreter*, NSUInteger> _batchSizes;
+    std::vector<TfLiteInterpreter*> _idle;
+    
+    TIOTFLiteInterpreterPoolStats _stats;
+}
+
+- (instancetype)initWithModel:(TfLiteModel *)model path:(NSString *)path inputs:(NSArray<TIOLayerInterface*> *)inputs capacity:(NSUInteger)capacity {
+    NSAssert(capacity > 0, @"An interpreter pool must have a capacity of at least one");
+    
+    if (self = [super init]) {
+        _model = model;
+        _path = path;
+        _inputs = inputs;
+        _capacity = MAX(capacity, 1);
+        _available = dispatch_semaphore_create(_capacity);
+        _lock = OS_UNFAIR_LOCK_INIT;
+        _stats = {0};
+    }
+    return self;
+}
+
+- (void)dealloc {
+    for ( auto &entry : _batchSizes ) {
+        if ( _willDeleteInterpreter != nil ) {
+            _willDeleteInterpreter(entry.first);
+        }
+        TfLiteInterpreterDelete(entry.first);
+    }
+    
+    // Interpreters must be deleted before the model they were created for
+    
+    [TIOTFLiteModelCache.sharedCache releaseModelAtPath:_path];
+}
+
+- (TIOTFLiteInterpreterPoolStats)stats {
+    os_unfair_lock_lock(&_lock);
+    TIOTFLiteInterpreterPoolStats stats = _stats;
+    os_unfair_lock_unlock(&_lock);
+    return stats;
+}
+
+// MARK: - Checkout
+
+- (nullable TfLiteInterpreter *)checkoutInterpreterForBatchSize:(NSUInteger)batchSize timeout:(NSTimeInterval)timeout error:(NSError * _Nullable *)error {
+    
+    // Wait for an interpreter, recording whether we had to and for how long
+    
+    BOOL contended = NO;
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    
+    if ( dispatch_semaphore_wait(_available, DISPATCH_TIME_NOW) != 0 ) {
+        contended = YES;
+        
+        if ( dispatch_semaphore_wait(_available, dispatch_time(DISPATCH_TIME_NOW, (int64_t)(timeout * NSEC_PER_SEC))) != 0 ) {
+            os_unfair_lock_lock(&_lock);
+            _stats.timeouts++;
+            _stats.waitTime += CFAbsoluteTimeGetCurrent() - start;
+            os_unfair_lock_unlock(&_lock);
+            
+            NSLog(@"Timed out after %f seconds waiting for an interpreter", timeout);
+            if (error) {
+                *error = kTIOTFLiteModelInterpreterUnavailableError;
+            }
+            return NULL;
+        }
+    }
+    
+    // Prefer an idle interpreter already sized for the batch, otherwise take any idle interpreter,
+    // and only create a new interpreter if none are idle
+    
+    TfLiteInterpreter *interpreter = NULL;
+    NSUInteger currentBatchSize = 0;
+    
+    os_unfair_lock_lock(&_lock);
+    
+    _stats.checkouts++;
+    
+    if ( contended ) {
+        _stats.contended++;
+        _stats.waitTime += CFAbsoluteTimeGetCurrent() - start;
+    }
+    
+    for ( auto it = _idle.begin(); it != _idle.end(); it++ ) {
+        if ( _batchSizes[*it] == batchSize ) {
+            interpreter = *it;
+            _idle.erase(it);
+            break;
+        }
+    }
+    
+    if ( interpreter == NULL && !_idle.empty() ) {
+        interpreter = _idle.back();
+        _idle.pop_back();
+    }
+    
+    if ( interpreter != NULL ) {
+        currentBatchSize = _batchSizes[interpreter];
+    }
+    
+    os_unfair_lock_unlock(&_lock);
+    
+    // An idle interpreter's tensors may still be referenced from a previous checkout
+    
+    if ( interpreter != NULL && self.willLendInterpreter != nil ) {
+        self.willLendInterpreter(interpreter);
+    }
+    
+    if ( interpreter == NULL ) {
+        interpreter = TfLiteInterpreterCreate(_model, NULL);
+        
+        if ( interpreter == NULL ) {
+            NSLog(@"Failed to construct interpreter");
+            dispatch_semaphore_signal(_available);
+            if (error) {
+                *error = kTIOTFLiteModelConstructInterpreterError;
+            }
+            return NULL;
+        }
+        
+        os_unfair_lock_lock(&_lock);
+        _batchSizes[interpreter] = 0;
+        _stats.interpreters = _batchSizes.size();
+        os_unfair_lock_unlock(&_lock);
+    }
+    
+    // Resize and allocate only when the batch size changes
+    
+    if ( currentBatchSize != batchSize ) {
+        if ( ![self _prepareInterpreter:interpreter batchSize:batchSize error:error] ) {
+            os_unfair_lock_lock(&_lock);
+            _batchSizes[interpreter] = 0;
+            _idle.push_back(interpreter);
+            os_unfair_lock_unlock(&_lock);
+            
+            dispatch_semaphore_signal(_available);
+            return NULL;
+        }
+        
+        os_unfair_lock_lock(&_lock);
+        _batchSizes[interpreter] = batchSize;
+        os_unfair_lock_unlock(&_lock);
+    }
+    
+    return interpreter;
+}
+
+- (void)checkinInterpreter:(TfLiteInterpreter *)interpreter {
+    os_unfair_lock_lock(&_lock);
+    _idle.push_back(interpreter);
+    os_unfair_lock_unlock(&_lock);
+    
+    dispatch_semaphore_signal(_available);
+}
+
+// MARK: - Batching
+
+/**
+ * Resizes the leading dimension of every batched input tensor to the batch size and allocates
+ * the interpreter's tensors.
+ */
+
+- (BOOL)_prepareInterpreter:(TfLiteInterpreter *)interpreter batchSize:(NSUInteger)batchSize error:(NSError * _Nullable *)error {
+    
+    for ( int index = 0; index < _inputs.count; index++ ) {
+        TIOLayerInterface *interface = _inputs[index];
+        const TfLiteTensor *tensor = TfLiteInterpreterGetInputTensor(interpreter, index);
+        
+        // A layer is batched if its description says so with a -1 dimension, or if the tensor
+        // carries the leading batch dimension TFLite models conventionally omit from model.json
+        
+        BOOL batched = interface.layerDescription.isBatched
+            || TfLiteTensorNumDims(tensor) > interface.layerDescription.shape.count;
+        
+        if ( !batched ) {
+            if ( batchSize == 1 ) {
+                continue;
+            }
+            NSLog(@"Input layer %@ has no batch dimension and cannot be run with a batch size of %lu", interface.name, (unsigned long)batchSize);
+            if (error) {
+                *error = kTIOTFLiteModelResizeTensorsError;
+            }
+            return NO;
+        }
+        
+        std::vector<int> dims(TfLiteTensorNumDims(tensor));
+        
+        for ( int dim = 0; dim < dims.size(); dim++ ) {
+            dims[dim] = TfLiteTensorDim(tensor, dim);
+        }
+        
+        if ( dims[0] == (int)batchSize ) {
+            continue;
+        }
+        
+        dims[0] = (int)batchSize;
+        
+        if (TfLiteInterpreterResizeInputTensor(interpreter, index, dims.data(), (int32_t)dims.size()) != kTfLiteOk) {
+            NSLog(@"Failed to resize input layer %@ to batch size %lu", interface.name, (unsigned long)batchSize);
+            if (error) {
+                *error = kTIOTFLiteModelResizeTensorsError;
+            }
+            return NO;
+        }
+    }
+    
+    if (TfLiteInterpreterAllocateTensors(interpreter) != kTfLiteOk) {
+        NSLog(@"Failed to allocate tensors for batch size %lu", (unsigned long)batchSize);
+        if (error) {
+            *error = kTIOTFLiteModelAllocateTensorsError;
+        }
+        return NO;
+    }
+    
+    return YES;
+}
+
+@end
@@ -26,6 +26,34 @@
 NS_ASSUME_NONNULL_BEGIN
 
 @class TIOModelIO;
+@class TIOTensorView;
+
+/**
+ * Describes how a model's pool of interpreters has been used.
+ */
+
+typedef struct TIOTFLiteInterpreterPoolStats {
+    NSUInteger interpreters;    // The number of interpreters created so far
+    NSUInteger checkouts;       // The number of times an interpreter was requested
+    NSUInteger contended;       // The number of requests that had to wait for an interpreter
+    NSUInteger timeouts;        // The number of requests that gave up waiting
+    NSTimeInterval waitTime;    // The total number of seconds spent waiting for an interpreter
+} TIOTFLiteInterpreterPoolStats;
+
+/**
+ * Describes how inputs have moved through a model's asynchronous inference pipeline. Stage
+ * times are totals in milliseconds, divide by `completed` for a per-input average.
+ */
+
+typedef struct TIOTFLitePipelineStats {
+    NSUInteger submitted;       // The number of inputs accepted by the pipeline
+    NSUInteger completed;       // The number of inputs that produced outputs
+    NSUInteger failed;          // The number of accepted inputs that produced an error
+    NSUInteger dropped;         // The number of inputs refused because the pipeline was full
+    double prepareTime;         // Time spent preparing inputs and writing them to input tensors
+    double invokeTime;          // Time spent invoking the interpreter
+    double captureTime;         // Time spent reading outputs from output tensors
+} TIOTFLitePipelineStats;
 
 /**
  * An Objective-C wrapper around TensorFlow lite models that provides a unified interface to the
@@ -33,6 +61,9 @@ NS_ASSUME_NONNULL_BEGIN
  *
  * See `TIOModel` for more information about TensorIO models and for a description of the
  * conforming properties and methods here.
+ *
+ * Instances loaded from the same model file share a single memory mapped copy of the model's
+ * weights. Each instance only allocates its own interpreters and their tensor arenas.
  */
 
 @interface TIOTFLiteModel : NSObject <TIOModel>
@@ -52,6 +83,91 @@ NS_ASSUME_NONNULL_BEGIN
 @property (readonly) BOOL loaded;
 @property (readonly) TIOModelIO *io;
 
+// MARK: - Concurrency
+
+/**
+ * The maximum number of interpreters the model creates to service concurrent calls to `runOn:`
+ * and `run:`. Interpreters share the loaded model and are created as they are needed. Defaults
+ * to 1, which serializes inference.
+ *
+ * The pool is never smaller than `pipelineDepth`, so that each input in flight in the
+ * asynchronous pipeline has its own input tensors.
+ *
+ * Set this property before the model is loaded. Changes take effect the next time it is loaded.
+ */
+
+@property NSUInteger interpreterPoolSize;
+
+/**
+ * The maximum number of seconds a call to `runOn:` or `run:` waits for an interpreter when all
+ * of them are busy, after which the call fails with `kTIOTFLiteModelInterpreterUnavailableError`.
+ * Defaults to 10 seconds.
+ */
+
+@property NSTimeInterval interpreterCheckoutTimeout;
+
+/**
+ * Statistics describing use of and contention for the model's interpreters since it was loaded.
+ */
+
+@property (readonly) TIOTFLiteInterpreterPoolStats interpreterPoolStats;
+
+/**
+ * The maximum number of inputs submitted with `runOn:completion:` that may be in flight at once.
+ * Inputs submitted while the pipeline is full are refused with `kTIOTFLiteModelPipelineFullError`.
+ * Defaults to 2, which double buffers the input tensors so that one input is prepared while the
+ * previous one is invoked. A depth of 3 also overlaps output capture.
+ *
+ * Set this property before the model is loaded. Once `runOn:completion:` has been called the
+ * depth is fixed and later changes are ignored.
+ */
+
+@property NSUInteger pipelineDepth;
+
+/**
+ * Statistics describing the asynchronous pipeline since the model was initialized, including the
+ * time spent in each stage.
+ */
+
+@property (readonly) TIOTFLitePipelineStats pipelineStats;
+
+// MARK: - Warmup and Latency
+
+/**
+ * The number of times `load:` invokes the model on zero-filled inputs before returning, so that
+ * the first real inference does not pay for lazy initialization. Defaults to 0, no warmup.
+ */
+
+@property NSUInteger warmupIterations;
+
+/**
+ * The number of milliseconds the most recent `load:` spent loading the model, excluding warmup.
+ */
+
+@property (readonly) double loadLatency;
+
+/**
+ * The number of milliseconds the most recent `load:` spent warming the model up.
+ */
+
+@property (readonly) double warmupLatency;
+
+/**
+ * The number of milliseconds the first invocation of the model after it was loaded took. This is
+ * the first warmup invocation when `warmupIterations` is non-zero, and otherwise the first call
+ * to run the model. 0 until the model has been invoked.
+ */
+
+@property (readonly) double coldInferenceLatency;
+
+/**
+ * The number of milliseconds the second invocation of the model after it was loaded took, which
+ * approximates the latency of an inference once the model is warm. 0 until the model has been
+ * invoked twice.
+ */
+
+@property (readonly) double warmInferenceLatency;
+
 // MARK: - Initialization
 
 /**
@@ -110,6 +226,9 @@ NS_ASSUME_NONNULL_BEGIN
  * may do this as well in order to provide finer grained control to consumers.
  *
  * Conforming classes should override this method to perform custom unloading and set `loaded=NO`.
+ *
+ * Unloading does not wait for runs in progress. Those runs finish on the interpreters they have
+ * already checked out, which are deleted along with the model once they are checked back in.
  */
 
 - (void)unload;
@@ -127,6 +246,40 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (id<TIOData>)runOn:(id<TIOData>)input error:(NSError* _Nullable *)error;
 
+/**
+ * Performs inference on the provided input and returns only the requested outputs. Outputs
+ * that are not requested are neither fetched nor converted to `TIOData`, which avoids the cost
+ * of large auxiliary outputs a caller does not need. The interpreter always computes every
+ * output, but unrequested outputs are not read from their tensors, so no `TIOPixelBuffer` or
+ * other object is constructed for them.
+ *
+ * @param input Any class conforming to `TIOData`.
+ * @param outputs The names of the output layers to return, which must be a subset of the
+ *  model's output layer names.
+ * @param error Set if an error occurred during inference. May be nil.
+ * @return TIOData A dictionary containing only the requested outputs.
+ */
+
+- (id<TIOData>)runOn:(id<TIOData>)input outputs:(NSArray<NSString*> *)outputs error:(NSError* _Nullable *)error;
+
+/**
+ * Performs inference on the provided input and returns read-only views onto the output tensors
+ * rather than boxed `TIOData`.
+ *
+ * No bytes are copied and no Objective-C objects are created for the output values. Each view
+ * points into the tensors of the interpreter that produced it and is valid until that interpreter
+ * is lent to another run or the model is unloaded. With a single interpreter that is the next
+ * run, and with a larger `interpreterPoolSize` it may be sooner than the next run on the calling
+ * thread. Copy a view to keep its bytes, or call `data` on it to box its values the way
+ * `runOn:error:` would.
+ *
+ * @param input Any class conforming to `TIOData`.
+ * @param error Set if an error occurred during inference. May be nil.
+ * @return NSDictionary Views onto the output tensors keyed by output layer name.
+ */
+
+- (NSDictionary<NSString*,TIOTensorView*> *)runViewsOn:(id<TIOData>)input error:(NSError* _Nullable *)error;
+
 /**
  * Performs inference on the provided input and returns the results.
  *
@@ -149,9 +302,15 @@ NS_ASSUME_NONNULL_BEGIN
  * batch items, effectively rows of data, each of which contains feature values
  * as columns. See `TIOBatch` for more information.
  *
+ * A batch of more than one item is run with a single invocation of the interpreter. The
+ * leading dimension of each input tensor is resized to the batch size, which requires that
+ * every input layer be batched. Tensors are only reallocated the first time a batch size is
+ * seen.
+ *
  * @param batch A batch of input data.
  * @param error Set if an error occurred during inference. May be nil.
- * @return TIOData The results of performing inference on input.
+ * @return TIOData The results of performing inference on input. For a batch of one item, a
+ *  dictionary of outputs. For a larger batch, an array with one such dictionary per item.
  */
 
 - (id<TIOData>)run:(TIOBatch *)batch error:(NSError * _Nullable *)error;
@@ -171,6 +330,27 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (id<TIOData>)run:(TIOBatch *)batch placeholders:(nullable NSDictionary<NSString*,id<TIOData>> *)placeholders error:(NSError * _Nullable *)error;
 
+/**
+ * Performs inference on the provided input asynchronously and calls the completion handler with
+ * the results.
+ *
+ * Inputs move through three stages, each on its own serial queue: preparing the input and
+ * writing it to an interpreter's input tensors, invoking the interpreter, and capturing its
+ * outputs. Because every input in flight holds its own interpreter, an input is prepared while
+ * the one before it is invoked, and at steady state throughput is limited by the slowest stage
+ * rather than by the sum of the stages.
+ *
+ * Inputs complete in the order they are submitted. The completion handler is called on the
+ * private queue that captures outputs and should return promptly.
+ *
+ * @param input Any class conforming to `TIOData`.
+ * @param completion Called with the results of performing inference on input, or with an error.
+ *  The error is `kTIOTFLiteModelPipelineFullError` if `pipelineDepth` inputs are already in flight
+ *  and `kTIOTFLiteModelUnloadedError` if the model was unloaded before the input was prepared.
+ */
+
+- (void)runOn:(id<TIOData>)input completion:(TIOModelCompletionHandler)completion;
+
 /**
  * Deprecated. Use `runOn:error:` or one of the other similar methods instead.
  */
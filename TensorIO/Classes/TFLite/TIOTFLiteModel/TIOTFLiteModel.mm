@@ -38,11 +38,58 @@
 #import "NSArray+TIOExtensions.h"
 #import "TIOBatch.h"
 #import "TIOModelIO.h"
+#import "TIODataTypes.h"
+#import "TIOTensorView.h"
+#import "TIOTFLiteInterpreterPool.h"
+#import "TIOTFLiteRunPlan.h"
+#import "TIOTFLiteModelCache.h"
+#import "TIOObjcDefer.h"
+#import "TIOMeasurable.h"
 
-#import "TFLTensorFlowLite.h"
+#import "c_api.h"
+
+#import <os/lock.h>
+
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <unordered_map>
+
+/**
+ * An interpreter checked out of the model's pool, along with the pool it must be checked back in
+ * to and the plan the model was loaded with. The lease keeps both alive, so that a model unloaded
+ * during a run deletes the interpreter only once it has been checked in.
+ */
+
+struct TIOTFLiteLease {
+    TIOTFLiteInterpreterPool *pool;
+    std::shared_ptr<const TIOTFLiteRunPlan> plan;
+    TfLiteInterpreter *interpreter;
+};
 
 @implementation TIOTFLiteModel {
-    TFLInterpreter *interpreter;
+    TIOTFLiteInterpreterPool *_pool;
+    std::shared_ptr<const TIOTFLiteRunPlan> _plan;
+    std::atomic<NSUInteger> _invocations;
+    
+    // The first two invocations may run on different interpreters at the same time
+    
+    std::atomic<double> _coldInferenceLatency;
+    std::atomic<double> _warmInferenceLatency;
+    
+    // Views handed out by runViewsOn:, by the interpreter whose tensors they point into
+    
+    std::unordered_map<TfLiteInterpreter*, NSHashTable<TIOTensorView*>*> _views;
+    os_unfair_lock _viewsLock;
+    
+    // Asynchronous pipeline
+    
+    dispatch_queue_t _prepareQueue;
+    dispatch_queue_t _invokeQueue;
+    dispatch_queue_t _captureQueue;
+    dispatch_semaphore_t _pipelineSlots;
+    os_unfair_lock _pipelineLock;
+    TIOTFLitePipelineStats _pipelineStats;
 }
 
 + (nullable instancetype)modelWithBundleAtPath:(NSString *)path {
@@ -53,6 +100,8 @@
     #ifdef DEBUG
     NSLog(@"Deallocating model");
     #endif
+    
+    [self unload];
 }
 
 - (nullable instancetype)initWithBundle:(TIOModelBundle *)bundle {
@@ -71,6 +120,18 @@
         _backend = bundle.backend;
         _modes = bundle.modes;
         _io = bundle.io;
+        
+        _viewsLock = OS_UNFAIR_LOCK_INIT;
+        
+        _interpreterPoolSize = 1;
+        _interpreterCheckoutTimeout = 10.0;
+        
+        _pipelineDepth = 2;
+        _pipelineLock = OS_UNFAIR_LOCK_INIT;
+        _pipelineStats = {0};
+        _prepareQueue = dispatch_queue_create("ai.doc.tensorio.tflite.prepare", DISPATCH_QUEUE_SERIAL);
+        _invokeQueue = dispatch_queue_create("ai.doc.tensorio.tflite.invoke", DISPATCH_QUEUE_SERIAL);
+        _captureQueue = dispatch_queue_create("ai.doc.tensorio.tflite.capture", DISPATCH_QUEUE_SERIAL);
     }
     
     return self;
@@ -87,57 +148,174 @@
  */
 
 - (BOOL)load:(NSError * _Nullable *)error {
+    @synchronized (self) {
+        if ( _loaded ) {
+            return YES;
+        }
+        
+        __block BOOL loaded;
+        
+        _warmupLatency = 0;
+        tio_measuring_latency(&_loadLatency, ^{
+            loaded = [self _load:error];
+        });
+        
+        if ( loaded && self.warmupIterations > 0 ) {
+            tio_measuring_latency(&_warmupLatency, ^{
+                [self _warmup:self.warmupIterations];
+            });
+        }
+        
+        return loaded;
+    }
+}
+
+- (BOOL)_load:(NSError * _Nullable *)error {
     if ( _loaded ) {
         return YES;
     }
     
     NSString *graphPath = self.bundle.modelFilepath;
-    BOOL didAllocateTensors = NO;
-    NSError *liteError = nil;
     
-    // Load Graph
+    // Load Graph, sharing the mapped model with any other instance loaded from the same file
     
-    interpreter = [[TFLInterpreter alloc] initWithModelPath:graphPath error:&liteError];
+    TfLiteModel *liteModel = [TIOTFLiteModelCache.sharedCache acquireModelAtPath:graphPath];
     
-    if (!interpreter) {
-        NSLog(@"Failed to init interpreter with model at path %@, error: %@", graphPath, liteError);
+    if (!liteModel) {
+        NSLog(@"Failed to load model at path %@", graphPath);
         if (error) {
             *error = kTIOTFLiteModelLoadModelError;
         }
         return NO;
     }
     
-    didAllocateTensors = [interpreter allocateTensorsWithError:&liteError];
+    // Build Interpreters, constructing and allocating the first one up front so that
+    // a model which cannot be interpreted fails to load. The pool holds an interpreter
+    // for every input in flight in the asynchronous pipeline. The pool owns the model from here on
+    // and releases it once it has deleted its interpreters
+    
+    NSUInteger capacity = MAX(self.interpreterPoolSize, self.pipelineDepth);
+    TIOTFLiteInterpreterPool *pool = [[TIOTFLiteInterpreterPool alloc] initWithModel:liteModel path:graphPath inputs:self.io.inputs.all capacity:capacity];
+    
+    // Views point into an interpreter's tensors, which may be reallocated as soon as it is lent out
+    // and are freed when it is deleted
     
-    if (!didAllocateTensors) {
-        NSLog(@"Failed to allocate tensors for model %@, error: %@", self.identifier, liteError);
+    __weak TIOTFLiteModel *weakSelf = self;
+    pool.willLendInterpreter = ^(TfLiteInterpreter *lentInterpreter) {
+        [weakSelf _invalidateViewsForInterpreter:lentInterpreter];
+    };
+    pool.willDeleteInterpreter = ^(TfLiteInterpreter *deletedInterpreter) {
+        [weakSelf _invalidateViewsForInterpreter:deletedInterpreter];
+    };
+    
+    NSError *poolError;
+    TfLiteInterpreter *interpreter = [pool checkoutInterpreterForBatchSize:1 timeout:self.interpreterCheckoutTimeout error:&poolError];
+    
+    if (!interpreter) {
+        NSLog(@"Failed to prepare interpreter for model %@, error: %@", self.identifier, poolError);
         if (error) {
-            *error = kTIOTFLiteModelAllocateTensorsError;
+            *error = poolError;
         }
         return NO;
     }
-
+    
+    // Resolve everything the hot path needs about each layer once, checking the model's tensors
+    // against the layers described in the bundle along the way
+    
+    auto plan = std::make_shared<TIOTFLiteRunPlan>();
+    BOOL planned = TIOTFLiteBuildRunPlan(self.io, interpreter, *plan);
+    [pool checkinInterpreter:interpreter];
+    
+    if (!planned) {
+        NSLog(@"Failed to build run plan for model %@", self.identifier);
+        if (error) {
+            *error = kTIOTFLiteModelRunPlanError;
+        }
+        return NO;
+    }
+    
     #ifdef DEBUG
     NSLog(@"Loaded model");
     #endif
     
+    _pool = pool;
+    _plan = plan;
+    _invocations = 0;
+    _coldInferenceLatency = 0;
+    _warmInferenceLatency = 0;
+    
     _loaded = YES;
     return YES;
 }
 
+/**
+ * Invokes an interpreter on zero-filled inputs, which prepares its kernels and faults in the
+ * model's weights. Failures are logged but do not fail the load.
+ */
+
+- (void)_warmup:(NSUInteger)iterations {
+    NSError *checkoutError;
+    TIOTFLiteLease lease = [self _checkoutInterpreterForBatchSize:1 error:&checkoutError];
+    TfLiteInterpreter *interpreter = lease.interpreter;
+    
+    if (interpreter == NULL) {
+        NSLog(@"Unable to warm up model %@, error: %@", self.identifier, checkoutError);
+        return;
+    }
+    
+    tio_defer_block {
+        [lease.pool checkinInterpreter:interpreter];
+    };
+    
+    for ( const TIOTFLiteInputPlan &layer : lease.plan->inputs ) {
+        TfLiteTensor *tensor = TfLiteInterpreterGetInputTensor(interpreter, layer.index);
+        std::memset(TfLiteTensorData(tensor), 0, TfLiteTensorByteSize(tensor));
+    }
+    
+    for ( NSUInteger i = 0; i < iterations; i++ ) {
+        [self _runInference:interpreter];
+    }
+}
+
 /**
  * Unloads the model and sets loaded=NO
  */
 
 - (void)unload {
+    @synchronized (self) {
+        [self _unload];
+    }
+}
+
+- (void)_unload {
     if ( !_loaded ) {
         return;
     }
     
-    interpreter = nil;
+    // The pool deletes its interpreters and then releases the model once every interpreter checked
+    // out of it has been checked back in. Views into idle interpreters are invalidated now and views
+    // into interpreters still in use as those interpreters are deleted
+    
+    [self _invalidateAllViews];
+    _pool = nil;
+    _plan = nullptr;
     _loaded = NO;
 }
 
+- (double)coldInferenceLatency {
+    return _coldInferenceLatency;
+}
+
+- (double)warmInferenceLatency {
+    return _warmInferenceLatency;
+}
+
+- (TIOTFLiteInterpreterPoolStats)interpreterPoolStats {
+    @synchronized (self) {
+        return _pool != nil ? _pool.stats : (TIOTFLiteInterpreterPoolStats){0};
+    }
+}
+
 // MARK: - Perform Inference
 
 - (id<TIOData>)runOn:(id<TIOData>)input {
@@ -145,21 +323,83 @@
 }
 
 - (id<TIOData>)runOn:(id<TIOData>)input error:(NSError * _Nullable *)error {
+    return [self _runOn:input outputs:nil error:error];
+}
+
+- (id<TIOData>)runOn:(id<TIOData>)input outputs:(NSArray<NSString*> *)outputs error:(NSError * _Nullable *)error {
+    NSAssert([[NSSet setWithArray:outputs] isSubsetOfSet:[NSSet setWithArray:self.io.outputs.keys]], @"Requested outputs are not output layer names");
+    return [self _runOn:input outputs:outputs error:error];
+}
+
+/**
+ * Performs inference on a single input, capturing only the named outputs, or every output if
+ * `outputs` is `nil`.
+ */
+
+- (id<TIOData>)_runOn:(id<TIOData>)input outputs:(nullable NSArray<NSString*> *)outputs error:(NSError * _Nullable *)error {
     NSError *loadError;
     [self load:&loadError];
     
     if (loadError != nil) {
         NSLog(@"There was a problem loading the model from runOn, error: %@", loadError);
-        if (*error) {
+        if (error) {
             *error = loadError;
         }
         return @{};
     }
     
-    [self _prepareInput:input];
-    [self _runInference];
+    NSError *checkoutError;
+    TIOTFLiteLease lease = [self _checkoutInterpreterForBatchSize:1 error:&checkoutError];
+    TfLiteInterpreter *interpreter = lease.interpreter;
+    
+    if (interpreter == NULL) {
+        if (error) {
+            *error = checkoutError;
+        }
+        return @{};
+    }
+    
+    tio_defer_block {
+        [lease.pool checkinInterpreter:interpreter];
+    };
+    
+    [self _prepareInput:input interpreter:interpreter plan:*lease.plan];
+    [self _runInference:interpreter];
+    
+    return [self _captureOutput:interpreter plan:*lease.plan outputs:outputs];
+}
+
+- (NSDictionary<NSString*,TIOTensorView*> *)runViewsOn:(id<TIOData>)input error:(NSError * _Nullable *)error {
+    NSError *loadError;
+    [self load:&loadError];
+    
+    if (loadError != nil) {
+        NSLog(@"There was a problem loading the model from runViewsOn, error: %@", loadError);
+        if (error) {
+            *error = loadError;
+        }
+        return @{};
+    }
+    
+    NSError *checkoutError;
+    TIOTFLiteLease lease = [self _checkoutInterpreterForBatchSize:1 error:&checkoutError];
+    TfLiteInterpreter *interpreter = lease.interpreter;
+    
+    if (interpreter == NULL) {
+        if (error) {
+            *error = checkoutError;
+        }
+        return @{};
+    }
+    
+    tio_defer_block {
+        [lease.pool checkinInterpreter:interpreter];
+    };
+    
+    [self _prepareInput:input interpreter:interpreter plan:*lease.plan];
+    [self _runInference:interpreter];
     
-    return [self _captureOutput];
+    return [self _captureViews:interpreter plan:*lease.plan];
 }
 
 - (id<TIOData>)runOn:(id<TIOData>)input placeholders:(nullable NSDictionary<NSString*,id<TIOData>> *)placeholders error:(NSError* _Nullable *)error {
@@ -169,7 +409,7 @@
 
 - (id<TIOData>)run:(TIOBatch *)batch error:(NSError * _Nullable *)error {
     NSAssert([[NSSet setWithArray:batch.keys] isEqualToSet:[NSSet setWithArray:self.io.inputs.keys]], @"Batch keys do not match input layer names");
-    NSAssert(batch.count == 1, @"Batch size must be 1 for TensorFlow Lite models");
+    NSAssert(batch.count > 0, @"Batch must contain at least one item");
     
     // Load
     
@@ -178,29 +418,49 @@
     
     if (loadError != nil) {
         NSLog(@"There was a problem loading the model from run:error:, error: %@", loadError);
-        if (*error) {
+        if (error) {
             *error = loadError;
         }
         return @{};
     }
     
-    // Prepare Inputs
+    // Acquire an interpreter whose input tensors are sized for the batch
+    
+    NSError *checkoutError;
+    TIOTFLiteLease lease = [self _checkoutInterpreterForBatchSize:batch.count error:&checkoutError];
+    TfLiteInterpreter *interpreter = lease.interpreter;
     
-    TIOBatchItem *item = batch[0];
+    if (interpreter == NULL) {
+        if (error) {
+            *error = checkoutError;
+        }
+        return @{};
+    }
     
-    for ( NSString *name in item ) {
-        int index = [self.io.inputs indexForName:name].intValue;
-        TFLTensor *tensor = [self inputTensorAtIndex:index];
-        TIOLayerInterface *interface = self.io.inputs[name];
-        id<TIOData> input = item[name];
+    tio_defer_block {
+        [lease.pool checkinInterpreter:interpreter];
+    };
     
-        [self _prepareInput:input tensor:tensor interface:interface];
+    // Prepare Inputs, each batch item is written at its offset into the batched tensor
+    
+    for ( const TIOTFLiteInputPlan &layer : lease.plan->inputs ) {
+        TfLiteTensor *tensor = TfLiteInterpreterGetInputTensor(interpreter, layer.index);
+        NSArray<id<TIOData>> *column = [batch valuesForKey:layer.name];
+        
+        for ( NSUInteger batchIndex = 0; batchIndex < column.count; batchIndex++ ) {
+            [self _prepareInput:column[batchIndex] tensor:tensor layer:layer batchIndex:batchIndex];
+        }
     }
     
     // Run Inference and Return Output
     
-    [self _runInference];
-    return [self _captureOutput];
+    [self _runInference:interpreter];
+    
+    if ( batch.count == 1 ) {
+        return [self _captureOutput:interpreter plan:*lease.plan outputs:nil];
+    } else {
+        return [self _captureOutput:interpreter plan:*lease.plan batchSize:batch.count];
+    }
 }
 
 - (id<TIOData>)run:(TIOBatch *)batch placeholders:(nullable NSDictionary<NSString*,id<TIOData>> *)placeholders error:(NSError * _Nullable *)error {
@@ -208,6 +468,198 @@
     return @{};
 }
 
+// MARK: - Pipelined Inference
+
+- (void)runOn:(id<TIOData>)input completion:(TIOModelCompletionHandler)completion {
+    dispatch_semaphore_t slots = [self _pipelineSlots];
+    
+    // Refuse the input rather than queue it without bound when the pipeline is full
+    
+    if ( dispatch_semaphore_wait(slots, DISPATCH_TIME_NOW) != 0 ) {
+        os_unfair_lock_lock(&_pipelineLock);
+        _pipelineStats.dropped++;
+        os_unfair_lock_unlock(&_pipelineLock);
+        
+        dispatch_async(_captureQueue, ^{
+            completion(nil, kTIOTFLiteModelPipelineFullError);
+        });
+        return;
+    }
+    
+    os_unfair_lock_lock(&_pipelineLock);
+    _pipelineStats.submitted++;
+    os_unfair_lock_unlock(&_pipelineLock);
+    
+    // Prepare: acquire an interpreter of our own, so that its input tensors may be written while
+    // the previous input's interpreter is invoked, and write the input to them
+    
+    dispatch_async(_prepareQueue, ^{
+        NSError *error;
+        
+        if ( ![self load:&error] ) {
+            NSLog(@"There was a problem loading the model from runOn:completion:, error: %@", error);
+            [self _failPipelinedRun:error slots:slots completion:completion];
+            return;
+        }
+        
+        // The lease travels with the input through every stage, so that each stage uses the pool
+        // and plan the interpreter was checked out with even if the model is unloaded meanwhile
+        
+        TIOTFLiteLease lease = [self _checkoutInterpreterForBatchSize:1 error:&error];
+        TfLiteInterpreter *interpreter = lease.interpreter;
+        
+        if ( interpreter == NULL ) {
+            [self _failPipelinedRun:error slots:slots completion:completion];
+            return;
+        }
+        
+        double prepareTime;
+        tio_measuring_latency(&prepareTime, ^{
+            [self _prepareInput:input interpreter:interpreter plan:*lease.plan];
+        });
+        
+        // Invoke
+        
+        dispatch_async(self->_invokeQueue, ^{
+            double invokeTime;
+            tio_measuring_latency(&invokeTime, ^{
+                [self _runInference:interpreter];
+            });
+            
+            // Capture, after which the interpreter may be reused
+            
+            dispatch_async(self->_captureQueue, ^{
+                __block id<TIOData> output;
+                double captureTime;
+                tio_measuring_latency(&captureTime, ^{
+                    output = [self _captureOutput:interpreter plan:*lease.plan outputs:nil];
+                });
+                
+                [lease.pool checkinInterpreter:interpreter];
+                
+                os_unfair_lock_lock(&self->_pipelineLock);
+                self->_pipelineStats.completed++;
+                self->_pipelineStats.prepareTime += prepareTime;
+                self->_pipelineStats.invokeTime += invokeTime;
+                self->_pipelineStats.captureTime += captureTime;
+                os_unfair_lock_unlock(&self->_pipelineLock);
+                
+                dispatch_semaphore_signal(slots);
+                completion(output, nil);
+            });
+        });
+    });
+}
+
+- (TIOTFLitePipelineStats)pipelineStats {
+    os_unfair_lock_lock(&_pipelineLock);
+    TIOTFLitePipelineStats stats = _pipelineStats;
+    os_unfair_lock_unlock(&_pipelineLock);
+    return stats;
+}
+
+@synthesize pipelineDepth = _pipelineDepth;
+
+- (NSUInteger)pipelineDepth {
+    @synchronized (self) {
+        return _pipelineDepth;
+    }
+}
+
+/**
+ * The pipeline depth sizes both the semaphore bounding the inputs in flight and the interpreter
+ * pool, so it is fixed once the first input has been submitted.
+ */
+
+- (void)setPipelineDepth:(NSUInteger)pipelineDepth {
+    @synchronized (self) {
+        if ( _pipelineSlots != nil ) {
+            NSLog(@"The pipeline depth cannot be changed after the first call to runOn:completion:, it remains %lu", (unsigned long)_pipelineDepth);
+            return;
+        }
+        _pipelineDepth = pipelineDepth;
+    }
+}
+
+/**
+ * Returns the semaphore bounding the number of inputs in flight, created on first use with the
+ * pipeline depth, after which the depth no longer changes.
+ */
+
+- (dispatch_semaphore_t)_pipelineSlots {
+    @synchronized (self) {
+        if ( _pipelineSlots == nil ) {
+            _pipelineSlots = dispatch_semaphore_create(MAX(self.pipelineDepth, 1));
+        }
+        return _pipelineSlots;
+    }
+}
+
+/**
+ * Releases a pipelined input's slot and reports its error. Called from the prepare stage, before
+ * an interpreter has been checked out.
+ */
+
+- (void)_failPipelinedRun:(NSError *)error slots:(dispatch_semaphore_t)slots completion:(TIOModelCompletionHandler)completion {
+    os_unfair_lock_lock(&_pipelineLock);
+    _pipelineStats.failed++;
+    os_unfair_lock_unlock(&_pipelineLock);
+    
+    // Pass through the invoke and capture queues so that completions remain in submission order
+    
+    dispatch_async(_invokeQueue, ^{
+        dispatch_async(self->_captureQueue, ^{
+            dispatch_semaphore_signal(slots);
+            completion(nil, error);
+        });
+    });
+}
+
+// MARK: - Interpreters
+
+/**
+ * Checks an interpreter out of the pool whose batched input tensors hold `batchSize` items. The
+ * caller must check the interpreter back in to the lease's pool when it is done with it, and
+ * should use the lease's plan rather than the model's.
+ *
+ * @param batchSize The number of items in the batch
+ * @param error Set if no interpreter became available in time or it could not be resized
+ *
+ * @return TIOTFLiteLease A lease whose interpreter is for the exclusive use of the caller, or whose
+ *  interpreter is `NULL`
+ */
+
+- (TIOTFLiteLease)_checkoutInterpreterForBatchSize:(NSUInteger)batchSize error:(NSError * _Nullable *)error {
+    TIOTFLiteLease lease = { nil, nullptr, NULL };
+    
+    @synchronized (self) {
+        lease.pool = _pool;
+        lease.plan = _plan;
+    }
+    
+    // The model may have been unloaded since the caller loaded it
+    
+    if (lease.pool == nil) {
+        NSLog(@"The model was unloaded before an interpreter could be checked out for batch size %lu", (unsigned long)batchSize);
+        if (error) {
+            *error = kTIOTFLiteModelUnloadedError;
+        }
+        return lease;
+    }
+    
+    NSError *checkoutError;
+    lease.interpreter = [lease.pool checkoutInterpreterForBatchSize:batchSize timeout:self.interpreterCheckoutTimeout error:&checkoutError];
+    
+    if (lease.interpreter == NULL) {
+        NSLog(@"There was a problem acquiring an interpreter for batch size %lu, error: %@", (unsigned long)batchSize, checkoutError);
+        if (error) {
+            *error = checkoutError;
+        }
+    }
+    
+    return lease;
+}
+
 // MARK: - Prepare Inputs
 
 /**
@@ -215,40 +667,39 @@
  * copies their bytes to those input layers.
  *
  * @param data Any class conforming to the `TIOData` protocol
+ * @param interpreter The interpreter whose input tensors will receive the bytes
+ * @param plan The plan the interpreter was checked out with
  */
 
-- (void)_prepareInput:(id<TIOData>)data  {
+- (void)_prepareInput:(id<TIOData>)data interpreter:(TfLiteInterpreter *)interpreter plan:(const TIOTFLiteRunPlan &)plan {
     
     // When preparing inputs we take into account the type of input provided
     // and the number of inputs that are available
     
     if ( [data isKindOfClass:NSDictionary.class] ) {
         
-        // With a dictionary input, regardless the count, iterate through the keys and values, mapping them to indices,
-        // and prepare the indexed tensors with the values
-    
+        // With a dictionary input, regardless the count, walk the planned layers and prepare each
+        // tensor with the value for that layer's name
+        
         NSDictionary<NSString*,id<TIOData>> *dictionaryData = (NSDictionary *)data;
         NSAssert([[NSSet setWithArray:dictionaryData.allKeys] isEqualToSet:[NSSet setWithArray:self.io.inputs.keys]],
             @"Batch keys do not match input layer names");
-    
-        for ( NSString *name in dictionaryData ) {
-            int index = [self.io.inputs indexForName:name].intValue;
-            TFLTensor *tensor = [self inputTensorAtIndex:index];
-            TIOLayerInterface *interface = self.io.inputs[name];
-            id<TIOData> input = dictionaryData[name];
+        
+        for ( const TIOTFLiteInputPlan &layer : plan.inputs ) {
+            TfLiteTensor *tensor = TfLiteInterpreterGetInputTensor(interpreter, layer.index);
+            id<TIOData> input = dictionaryData[layer.name];
             
-            [self _prepareInput:input tensor:tensor interface:interface];
+            [self _prepareInput:input tensor:tensor layer:layer batchIndex:0];
         }
     }
-    else if ( self.io.inputs.count == 1 ) {
-    
+    else if ( plan.inputs.size() == 1 ) {
+        
         // If there is a single input available, simply take the input as it is
         
-        TFLTensor *tensor = [self inputTensorAtIndex:0];
-        TIOLayerInterface *interface = self.io.inputs[0];
-        id<TIOData> input = data;
+        const TIOTFLiteInputPlan &layer = plan.inputs[0];
+        TfLiteTensor *tensor = TfLiteInterpreterGetInputTensor(interpreter, layer.index);
         
-        [self _prepareInput:input tensor:tensor interface:interface];
+        [self _prepareInput:data tensor:tensor layer:layer batchIndex:0];
     }
     else {
         
@@ -259,60 +710,36 @@
         // With an array input, iterate through its entries, preparing the indexed tensors with their values
         
         NSArray<id<TIOData>> *arrayData = (NSArray *)data;
-        assert(arrayData.count == self.io.inputs.count);
+        assert(arrayData.count == plan.inputs.size());
         
-        for ( int index = 0; index < arrayData.count; index++ ) {
-            TFLTensor *tensor = [self inputTensorAtIndex:index];
-            TIOLayerInterface *interface = self.io.inputs[index];
-            id<TIOData> input = arrayData[index];
+        for ( const TIOTFLiteInputPlan &layer : plan.inputs ) {
+            TfLiteTensor *tensor = TfLiteInterpreterGetInputTensor(interpreter, layer.index);
+            id<TIOData> input = arrayData[layer.index];
             
-            [self _prepareInput:input tensor:tensor interface:interface];
+            [self _prepareInput:input tensor:tensor layer:layer batchIndex:0];
         }
     }
 }
 
 /**
- * Requests the input to copy its bytes to the tensor
+ * Requests the input to write its bytes directly to the tensor's memory, avoiding any intermediate
+ * buffers.
  *
- * @param input The data whose bytes will be copied to the tensor
+ * @param input The data whose bytes will be written to the tensor
  * @param tensor A pointer to the tensor which will receive those bytes
- * @param interface A description of the data which the tensor expects
+ * @param layer The planned input layer, which describes the data the tensor expects
+ * @param batchIndex The position of the input in the batch, which determines where in the tensor
+ *  its bytes are written
  */
 
-- (void)_prepareInput:(id<TIOData>)input tensor:(TFLTensor *)tensor interface:(TIOLayerInterface *)interface {
-    __block NSData *data = nil;
-    NSError *liteError = nil;
-    
-    [interface
-        matchCasePixelBuffer:^(TIOPixelBufferLayerDescription *pixelBufferDescription) {
-            assert( [input isKindOfClass:TIOPixelBuffer.class] );
-            
-            data = [(id<TIOTFLiteData>)input dataForDescription:pixelBufferDescription];
-            
-        } caseVector:^(TIOVectorLayerDescription *vectorDescription) {
-            assert( [input isKindOfClass:NSArray.class]
-                ||  [input isKindOfClass:NSData.class]
-                ||  [input isKindOfClass:NSNumber.class] );
-            
-            data = [(id<TIOTFLiteData>)input dataForDescription:vectorDescription];
-            
-        } caseString:^(TIOStringLayerDescription * _Nonnull stringDescription) {
-            assert( [input isKindOfClass:NSData.class]);
-            
-            data = [(id<TIOTFLiteData>)input dataForDescription:stringDescription];
-        
-        } caseScalar:^(TIOScalarLayerDescription * _Nonnull scalarDescription) {
-            assert( [input isKindOfClass:NSArray.class]
-                ||  [input isKindOfClass:NSData.class]
-                ||  [input isKindOfClass:NSNumber.class] );
-                
-            data = [(id<TIOTFLiteData>)input dataForDescription:scalarDescription];
-        }];
-    
-    
-    if ( ![tensor copyData:data error:&liteError] ) {
-        NSLog(@"There was a problem writing the data buffer to the tensor, error: %@", liteError);
+- (void)_prepareInput:(id<TIOData>)input tensor:(TfLiteTensor *)tensor layer:(const TIOTFLiteInputPlan &)layer batchIndex:(NSUInteger)batchIndex {
+    if ( TfLiteTensorData(tensor) == NULL || TfLiteTensorByteSize(tensor) < (batchIndex+1) * layer.byteCount ) {
+        NSLog(@"Input tensor %@ cannot hold %zu bytes at batch index %lu, it has %zu bytes", layer.name, layer.byteCount, (unsigned long)batchIndex, TfLiteTensorByteSize(tensor));
+        return;
     }
+    
+    void *buffer = (uint8_t *)TfLiteTensorData(tensor) + batchIndex * layer.byteCount;
+    layer.write(input, buffer, layer.description);
 }
 
 // MARK: - Execute Inference
@@ -321,11 +748,29 @@
  * Runs inference on the model. Inputs must be copied to the input tensors prior to calling this method
  */
 
-- (void)_runInference {
-    NSError *liteError = nil;
+- (void)_runInference:(TfLiteInterpreter *)interpreter {
+    NSUInteger invocation = _invocations++;
+    __block TfLiteStatus status;
+    
+    // Only the first two invocations after a load are timed, to record cold and warm latency
     
-    if (![interpreter invokeWithError:&liteError]) {
-        NSLog(@"Failed to invoke for model %@, error: %@", self.identifier, liteError);
+    if ( invocation < 2 ) {
+        double latency;
+        tio_measuring_latency(&latency, ^{
+            status = TfLiteInterpreterInvoke(interpreter);
+        });
+        
+        if ( invocation == 0 ) {
+            _coldInferenceLatency = latency;
+        } else {
+            _warmInferenceLatency = latency;
+        }
+    } else {
+        status = TfLiteInterpreterInvoke(interpreter);
+    }
+    
+    if (status != kTfLiteOk) {
+        NSLog(@"Failed to invoke for model %@", self.identifier);
     }
 }
 
@@ -334,103 +779,174 @@
 /**
  * Captures outputs from the model.
  *
+ * @param plan The plan the interpreter was checked out with.
+ * @param names The names of the outputs to capture, or `nil` to capture every output. The tensors
+ *  of other outputs are not read.
+ *
  * @return TIOData A class that is appropriate to the model output. Currently all outputs are
  * wrapped in an instance of `NSDictionary` whose keys are taken from the JSON description of the
  * model outputs.
  */
 
-- (id<TIOData>)_captureOutput {
-   
-    NSMutableDictionary<NSString*,id<TIOData>> *outputs = [[NSMutableDictionary alloc] init];
-
-    for ( int index = 0; index < self.io.outputs.count; index++ ) {
-        TIOLayerInterface *interface = self.io.outputs[index];
-        TFLTensor *tensor = [self outputTensorAtIndex:index];
+- (id<TIOData>)_captureOutput:(TfLiteInterpreter *)interpreter plan:(const TIOTFLiteRunPlan &)plan outputs:(nullable NSArray<NSString*> *)names {
+    
+    NSMutableDictionary<NSString*,id<TIOData>> *outputs = [[NSMutableDictionary alloc] initWithCapacity:plan.outputs.size()];
+    
+    for ( const TIOTFLiteOutputPlan &layer : plan.outputs ) {
+        if ( names != nil && ![names containsObject:layer.name] ) {
+            continue;
+        }
+        
+        const TfLiteTensor *tensor = TfLiteInterpreterGetOutputTensor(interpreter, layer.index);
+        void *bytes = TfLiteTensorData(tensor);
+        
+        if (!bytes) {
+            NSLog(@"There was a problem reading the data buffer from the tensor %@", layer.name);
+            continue;
+        }
         
-        id<TIOData> data = [self _captureOutput:tensor interface:interface];
-        outputs[interface.name] = data;
+        // The readers copy what they need, so the tensor's memory may be wrapped without a copy
+        
+        NSData *data = [NSData dataWithBytesNoCopy:bytes length:TfLiteTensorByteSize(tensor) freeWhenDone:NO];
+        outputs[layer.name] = layer.read(data, layer.description);
     }
-
+    
     return [outputs copy];
 }
 
 /**
- * Copies bytes from the tensor to an appropriate class that conforms to `TIOData`
+ * Captures outputs from the model after running it on a batch, splitting each output tensor along
+ * its batch dimension. An output without a batch dimension is shared by every batch item.
  *
- * @param tensor The output tensor whose bytes will be captured
- * @param interface A description of the data which this tensor contains
+ * @return TIOData An `NSArray` with one entry per batch item, each of which is an `NSDictionary`
+ * of outputs equivalent to the output of running the model on that item alone.
  */
 
-- (id<TIOData>)_captureOutput:(TFLTensor *)tensor interface:(TIOLayerInterface *)interface {
-    __block id<TIOData> output;
+- (id<TIOData>)_captureOutput:(TfLiteInterpreter *)interpreter plan:(const TIOTFLiteRunPlan &)plan batchSize:(NSUInteger)batchSize {
     
-    NSError *liteError = nil;
-    NSData *data = [tensor dataWithError:&liteError];
-
-    if (!data) {
-        NSLog(@"There was a problem reading the data buffer from the tensor, error: %@", liteError);
-        return nil;
+    NSMutableArray<NSMutableDictionary<NSString*,id<TIOData>>*> *outputs = [[NSMutableArray alloc] initWithCapacity:batchSize];
+    
+    for ( NSUInteger batchIndex = 0; batchIndex < batchSize; batchIndex++ ) {
+        [outputs addObject:[[NSMutableDictionary alloc] initWithCapacity:plan.outputs.size()]];
     }
     
-    [interface
-        matchCasePixelBuffer:^(TIOPixelBufferLayerDescription * _Nonnull pixelBufferDescription) {
-            output = [[TIOPixelBuffer alloc] initWithData:data description:pixelBufferDescription];
+    for ( const TIOTFLiteOutputPlan &layer : plan.outputs ) {
+        const TfLiteTensor *tensor = TfLiteInterpreterGetOutputTensor(interpreter, layer.index);
+        uint8_t *bytes = (uint8_t *)TfLiteTensorData(tensor);
         
-        } caseVector:^(TIOVectorLayerDescription * _Nonnull vectorDescription) {
-            
-            TIOVector *vector = [[TIOVector alloc] initWithData:data description:vectorDescription];
-            
-            if ( vectorDescription.isLabeled ) {
-                // If the vector's output is labeled, return a dictionary mapping labels to values
-                output = [vectorDescription labeledValues:vector];
-            } else {
-                // If the vector's output is single-valued just return that value
-                output = vector.count == 1
-                    ? vector[0]
-                    : vector;
+        if (!bytes) {
+            NSLog(@"There was a problem reading the data buffer from the tensor %@", layer.name);
+            continue;
+        }
+        
+        // An output is batched if its description says so with a -1 dimension, or if the tensor
+        // carries the leading batch dimension TFLite models conventionally omit from model.json
+        
+        BOOL batched = layer.description.isBatched
+            || TfLiteTensorNumDims(tensor) > layer.description.shape.count;
+        
+        BOOL split = batched
+            && TfLiteTensorNumDims(tensor) > 0
+            && TfLiteTensorDim(tensor, 0) == (int32_t)batchSize;
+        
+        if ( !split ) {
+            NSData *data = [NSData dataWithBytesNoCopy:bytes length:TfLiteTensorByteSize(tensor) freeWhenDone:NO];
+            id<TIOData> shared = layer.read(data, layer.description);
+            for ( NSUInteger batchIndex = 0; batchIndex < batchSize; batchIndex++ ) {
+                outputs[batchIndex][layer.name] = shared;
             }
-        } caseString:^(TIOStringLayerDescription * _Nonnull stringDescription) {
-            output = [[NSData alloc] initWithData:data description:stringDescription];
+            continue;
+        }
         
-        } caseScalar:^(TIOScalarLayerDescription * _Nonnull scalarDescription) {
-            output = [[NSNumber alloc] initWithData:data description:scalarDescription];
-        }];
+        size_t length = TfLiteTensorByteSize(tensor) / batchSize;
+        
+        for ( NSUInteger batchIndex = 0; batchIndex < batchSize; batchIndex++ ) {
+            NSData *data = [NSData dataWithBytesNoCopy:bytes + batchIndex * length length:length freeWhenDone:NO];
+            outputs[batchIndex][layer.name] = layer.read(data, layer.description);
+        }
+    }
     
-    return output;
+    return [outputs copy];
 }
 
-// MARK: - Utilities
+// MARK: - Capture Views
 
 /**
- * Returns a pointer to an input tensor at a given index
+ * Wraps each output tensor in a read-only view without copying or boxing its bytes. The views
+ * are invalidated the next time the interpreter is lent out.
+ *
+ * @return NSDictionary Views onto the output tensors keyed by the names of the output layers.
  */
- 
-- (nullable TFLTensor *)inputTensorAtIndex:(NSUInteger)index {
-    NSError *liteError = nil;
-    
-    TFLTensor *tensor = [interpreter inputTensorAtIndex:index error:&liteError];
+
+- (NSDictionary<NSString*,TIOTensorView*> *)_captureViews:(TfLiteInterpreter *)interpreter plan:(const TIOTFLiteRunPlan &)plan {
+    NSMutableDictionary<NSString*,TIOTensorView*> *views = [[NSMutableDictionary alloc] initWithCapacity:plan.outputs.size()];
+    NSHashTable<TIOTensorView*> *interpreterViews = [NSHashTable weakObjectsHashTable];
     
-    if (!tensor) {
-        // TODO: error
+    for ( const TIOTFLiteOutputPlan &layer : plan.outputs ) {
+        const TfLiteTensor *tensor = TfLiteInterpreterGetOutputTensor(interpreter, layer.index);
+        
+        NSMutableArray<NSNumber*> *shape = [[NSMutableArray alloc] init];
+        for ( int32_t dim = 0; dim < TfLiteTensorNumDims(tensor); dim++ ) {
+            [shape addObject:@(TfLiteTensorDim(tensor, dim))];
+        }
+        
+        TIOTensorView *view = [[TIOTensorView alloc]
+            initWithBytes:TfLiteTensorData(tensor)
+            length:TfLiteTensorByteSize(tensor)
+            shape:shape
+            dtype:layer.dtype
+            interface:layer.interface
+            converter:layer.converter];
+        
+        [interpreterViews addObject:view];
+        views[layer.name] = view;
     }
     
-    return tensor;
+    os_unfair_lock_lock(&_viewsLock);
+    _views[interpreter] = interpreterViews;
+    os_unfair_lock_unlock(&_viewsLock);
+    
+    return [views copy];
 }
 
 /**
- * Returns a pointer to an output tensor at a given index
+ * Invalidates the views into an interpreter's tensors before they are reallocated or overwritten.
+ * Called as the interpreter is lent out, before it is resized, and before it is deleted. Views
+ * produced by other interpreters remain valid.
  */
 
-- (nullable TFLTensor *)outputTensorAtIndex:(NSUInteger)index {
-    NSError *liteError = nil;
+- (void)_invalidateViewsForInterpreter:(TfLiteInterpreter *)interpreter {
+    NSHashTable<TIOTensorView*> *views;
     
-    TFLTensor *tensor = [interpreter outputTensorAtIndex:index error:&liteError];
+    os_unfair_lock_lock(&_viewsLock);
+    auto it = _views.find(interpreter);
+    if ( it != _views.end() ) {
+        views = it->second;
+        _views.erase(it);
+    }
+    os_unfair_lock_unlock(&_viewsLock);
     
-    if (!tensor) {
-        // TODO: error
+    for ( TIOTensorView *view in views ) {
+        [view invalidate];
     }
+}
+
+/**
+ * Invalidates every view handed out, as the model is unloaded.
+ */
+
+- (void)_invalidateAllViews {
+    std::unordered_map<TfLiteInterpreter*, NSHashTable<TIOTensorView*>*> views;
     
-    return tensor;
+    os_unfair_lock_lock(&_viewsLock);
+    views.swap(_views);
+    os_unfair_lock_unlock(&_viewsLock);
+    
+    for ( auto &entry : views ) {
+        for ( TIOTensorView *view in entry.second ) {
+            [view invalidate];
+        }
+    }
 }
 
 @end
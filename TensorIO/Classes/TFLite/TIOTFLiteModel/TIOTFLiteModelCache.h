@@ -0,0 +1,73 @@
+//
+//  TIOTFLiteModelCache.h
+//  TensorIO
+//
+//  Created by Phil Dow on 10/17/20.
+//  Copyright © 2020 doc.ai (http://doc.ai)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+#import "c_api.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * A process-wide, reference counted cache of TFLite models keyed by file path.
+ *
+ * A model's flatbuffer is memory mapped read-only and a single `TfLiteModel` is shared by every
+ * `TIOTFLiteModel` loaded from the same file, so that the model's weights are resident once no
+ * matter how many instances exist. Each instance only pays for its own interpreters and their
+ * tensor arenas.
+ *
+ * The model and its mapping are released when the last instance using them releases the path.
+ */
+
+@interface TIOTFLiteModelCache : NSObject
+
+/**
+ * The shared cache.
+ */
+
++ (instancetype)sharedCache;
+
+/**
+ * Acquires the model at a path, mapping and creating it if it is not already in use, and
+ * otherwise returning the model already in use and incrementing its reference count. Every
+ * successful call must be balanced by a call to `releaseModelAtPath:`.
+ *
+ * @param path The path to a .tflite file.
+ *
+ * @return TfLiteModel The shared model, or `NULL` if it could not be mapped or created.
+ */
+
+- (nullable TfLiteModel *)acquireModelAtPath:(NSString *)path;
+
+/**
+ * Releases a model previously acquired with `acquireModelAtPath:`, deleting the model and
+ * unmapping its file when its reference count reaches zero.
+ */
+
+- (void)releaseModelAtPath:(NSString *)path;
+
+/**
+ * The number of models currently held by the cache.
+ */
+
+@property (readonly) NSUInteger count;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,180 @@
+//
+//  TIOTFLiteModelCache.mm
+//  TensorIO
+//
+//  Created by Phil Dow on 10/17/20.
+//  Copyright © 2020 doc.ai (http://doc.ai)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "TIOTFLiteModelCache.h"
+
+#import <os/lock.h>
+
+#include <string>
+#include <unordered_map>
+
+/**
+ * A cached model and the mapped file backing it, which must outlive the model. While the file is
+ * mapped and the model created the entry is pending: its model is `NULL` and other callers
+ * acquiring the same path wait on `loading`.
+ */
+
+struct TIOTFLiteModelCacheEntry {
+    TfLiteModel *model;
+    NSData *mapping;
+    NSUInteger references;
+    dispatch_group_t loading;
+};
+
+@implementation TIOTFLiteModelCache {
+    os_unfair_lock _lock;
+    std::unordered_map<std::string, TIOTFLiteModelCacheEntry> _entries;
+}
+
++ (instancetype)sharedCache {
+    static TIOTFLiteModelCache *sharedCache = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sharedCache = [[TIOTFLiteModelCache alloc] init];
+    });
+    return sharedCache;
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _lock = OS_UNFAIR_LOCK_INIT;
+    }
+    return self;
+}
+
+- (NSUInteger)count {
+    NSUInteger count = 0;
+    
+    os_unfair_lock_lock(&_lock);
+    for ( auto &entry : _entries ) {
+        if ( entry.second.loading == nil ) {
+            count++;
+        }
+    }
+    os_unfair_lock_unlock(&_lock);
+    
+    return count;
+}
+
+- (nullable TfLiteModel *)acquireModelAtPath:(NSString *)path {
+    std::string key = [self _keyForPath:path];
+    
+    os_unfair_lock_lock(&_lock);
+    
+    // Wait for any other caller that is loading the same file, then take its model. If it failed
+    // to load, its entry is gone and we load the file ourselves
+    
+    for (;;) {
+        auto it = _entries.find(key);
+        
+        if ( it == _entries.end() ) {
+            break;
+        }
+        
+        if ( it->second.loading == nil ) {
+            it->second.references++;
+            TfLiteModel *model = it->second.model;
+            os_unfair_lock_unlock(&_lock);
+            return model;
+        }
+        
+        dispatch_group_t pending = it->second.loading;
+        os_unfair_lock_unlock(&_lock);
+        dispatch_group_wait(pending, DISPATCH_TIME_FOREVER);
+        os_unfair_lock_lock(&_lock);
+    }
+    
+    // Insert a pending entry so that two instances loading the same file at the same time do not
+    // both map it, and map and create the model outside the lock so that acquiring and releasing
+    // other models is not blocked on file I/O and flatbuffer verification
+    
+    dispatch_group_t loading = dispatch_group_create();
+    dispatch_group_enter(loading);
+    _entries[key] = {NULL, nil, 0, loading};
+    
+    os_unfair_lock_unlock(&_lock);
+    
+    NSError *mappingError;
+    NSData *mapping = [NSData dataWithContentsOfFile:path options:NSDataReadingMappedAlways error:&mappingError];
+    TfLiteModel *model = NULL;
+    
+    if ( mapping == nil ) {
+        NSLog(@"Failed to map model at path %@, error: %@", path, mappingError);
+    } else {
+        model = TfLiteModelCreate(mapping.bytes, mapping.length);
+        
+        if ( model == NULL ) {
+            NSLog(@"Failed to create model from mapped file at path %@", path);
+        }
+    }
+    
+    os_unfair_lock_lock(&_lock);
+    
+    if ( model == NULL ) {
+        _entries.erase(key);
+    } else {
+        _entries[key] = {model, mapping, 1, nil};
+    }
+    
+    os_unfair_lock_unlock(&_lock);
+    
+    dispatch_group_leave(loading);
+    
+    return model;
+}
+
+- (void)releaseModelAtPath:(NSString *)path {
+    std::string key = [self _keyForPath:path];
+    TIOTFLiteModelCacheEntry released = {NULL, nil, 0, nil};
+    
+    os_unfair_lock_lock(&_lock);
+    
+    auto it = _entries.find(key);
+    
+    if ( it == _entries.end() || it->second.loading != nil ) {
+        os_unfair_lock_unlock(&_lock);
+        NSLog(@"Released model at path %@ which was not acquired", path);
+        return;
+    }
+    
+    if ( --it->second.references == 0 ) {
+        released = it->second;
+        _entries.erase(it);
+    }
+    
+    os_unfair_lock_unlock(&_lock);
+    
+    // Delete the model before its mapping is released
+    
+    if ( released.model != NULL ) {
+        TfLiteModelDelete(released.model);
+        released.mapping = nil;
+    }
+}
+
+/**
+ * Keys models by their resolved path so that different spellings of a path share a model.
+ */
+
+- (std::string)_keyForPath:(NSString *)path {
+    return path.stringByResolvingSymlinksInPath.stringByStandardizingPath.UTF8String;
+}
+
+@end
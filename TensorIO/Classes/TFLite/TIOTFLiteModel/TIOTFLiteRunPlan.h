@@ -0,0 +1,112 @@
+//
+//  TIOTFLiteRunPlan.h
+//  TensorIO
+//
+//  Created by Phil Dow on 10/17/20.
+//  Copyright © 2020 doc.ai (http://doc.ai)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+#import "TIOData.h"
+#import "TIODataTypes.h"
+#import "TIOTensorView.h"
+
+#import "c_api.h"
+
+#include <vector>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class TIOModelIO;
+@class TIOLayerInterface;
+@protocol TIOLayerDescription;
+
+/**
+ * Writes a single input item to a buffer in the format the layer's tensor expects.
+ */
+
+typedef void (*TIOTFLiteInputWriter)(id<TIOData> input, void *buffer, id<TIOLayerDescription> description);
+
+/**
+ * Boxes the bytes of a single output item into the `TIOData` the model returns for that layer.
+ */
+
+typedef _Nullable id<TIOData> (*TIOTFLiteOutputReader)(NSData *data, id<TIOLayerDescription> description);
+
+/**
+ * Everything needed to write an input layer, resolved once when the model loads.
+ */
+
+struct TIOTFLiteInputPlan {
+    NSString *name;
+    int32_t index;
+    TIOLayerInterface *interface;
+    id<TIOLayerDescription> description;
+    TIODataType dtype;
+    BOOL quantized;
+    size_t byteCount; // per batch item
+    TIOTFLiteInputWriter write;
+};
+
+/**
+ * Everything needed to read an output layer, resolved once when the model loads.
+ */
+
+struct TIOTFLiteOutputPlan {
+    NSString *name;
+    int32_t index;
+    TIOLayerInterface *interface;
+    id<TIOLayerDescription> description;
+    TIODataType dtype;
+    BOOL quantized;
+    TIOTFLiteOutputReader read;
+    TIOTensorViewConverter converter;
+};
+
+/**
+ * An immutable description of how to run a loaded model, ordered by tensor index.
+ *
+ * Tensor handles belong to an interpreter rather than to the model, and the interpreter pool may
+ * lend out any of several interpreters, so the plan records tensor indices, which resolve to
+ * handles with a single array lookup in the C API.
+ */
+
+struct TIOTFLiteRunPlan {
+    std::vector<TIOTFLiteInputPlan> inputs;
+    std::vector<TIOTFLiteOutputPlan> outputs;
+};
+
+/**
+ * Builds a run plan for a model's layers, checking them against the tensors of an interpreter
+ * created for that model. Every tensor must have the type the layer's dtype and quantization
+ * call for, and every input tensor must hold exactly one item of its layer.
+ *
+ * @param io The model's inputs and outputs.
+ * @param interpreter An interpreter whose tensors have been allocated for a batch size of one.
+ * @param plan The plan to fill.
+ *
+ * @return BOOL `YES` if every layer matched its tensor, `NO` otherwise.
+ */
+
+BOOL TIOTFLiteBuildRunPlan(TIOModelIO *io, TfLiteInterpreter *interpreter, TIOTFLiteRunPlan &plan);
+
+/**
+ * Maps a TFLite tensor type to the corresponding TensorIO data type.
+ */
+
+TIODataType TIODataTypeForTfLiteType(TfLiteType type);
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,305 @@
+//
+//  TIOTFLiteRunPlan.mm
+//  TensorIO
+//
+//  Created by Phil Dow on 10/17/20.
+//  Copyright © 2020 doc.ai (http://doc.ai)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "TIOTFLiteRunPlan.h"
+
+#import "TIOModelIO.h"
+#import "TIOLayerInterface.h"
+#import "TIOLayerDescription.h"
+#import "TIOPixelBufferLayerDescription.h"
+#import "TIOVectorLayerDescription.h"
+#import "TIOStringLayerDescription.h"
+#import "TIOScalarLayerDescription.h"
+#import "TIOPixelBuffer.h"
+#import "TIOVisionModelHelpers.h"
+#import "TIOTFLiteData.h"
+#import "NSArray+TIOTFLiteData.h"
+#import "NSNumber+TIOTFLiteData.h"
+#import "NSData+TIOTFLiteData.h"
+#import "TIOPixelBuffer+TIOTFLiteData.h"
+
+TIODataType TIODataTypeForTfLiteType(TfLiteType type) {
+    switch (type) {
+    case kTfLiteUInt8:
+        return TIODataTypeUInt8;
+    case kTfLiteFloat32:
+        return TIODataTypeFloat32;
+    case kTfLiteInt32:
+        return TIODataTypeInt32;
+    case kTfLiteInt64:
+        return TIODataTypeInt64;
+    case kTfLiteFloat16:
+        return TIODataTypeFloat16;
+    case kTfLiteInt8:
+        return TIODataTypeInt8;
+    default:
+        return TIODataTypeUnknown;
+    }
+}
+
+// MARK: - Input Writers
+
+static void TIOTFLiteWritePixelBuffer(id<TIOData> input, void *buffer, id<TIOLayerDescription> description) {
+    assert( [input isKindOfClass:TIOPixelBuffer.class] );
+    
+    [(id<TIOTFLiteData>)input getBytes:buffer description:description];
+}
+
+static void TIOTFLiteWriteVector(id<TIOData> input, void *buffer, id<TIOLayerDescription> description) {
+    assert( [input isKindOfClass:NSArray.class]
+        ||  [input isKindOfClass:NSData.class]
+        ||  [input isKindOfClass:NSNumber.class] );
+    
+    [(id<TIOTFLiteData>)input getBytes:buffer description:description];
+}
+
+static void TIOTFLiteWriteString(id<TIOData> input, void *buffer, id<TIOLayerDescription> description) {
+    assert( [input isKindOfClass:NSData.class] );
+    
+    [(id<TIOTFLiteData>)input getBytes:buffer description:description];
+}
+
+static void TIOTFLiteWriteScalar(id<TIOData> input, void *buffer, id<TIOLayerDescription> description) {
+    assert( [input isKindOfClass:NSArray.class]
+        ||  [input isKindOfClass:NSData.class]
+        ||  [input isKindOfClass:NSNumber.class] );
+    
+    [(id<TIOTFLiteData>)input getBytes:buffer description:description];
+}
+
+// MARK: - Output Readers
+
+static id<TIOData> TIOTFLiteReadPixelBuffer(NSData *data, id<TIOLayerDescription> description) {
+    return [[TIOPixelBuffer alloc] initWithData:data description:description];
+}
+
+static id<TIOData> TIOTFLiteReadLabeledVector(NSData *data, id<TIOLayerDescription> description) {
+    TIOVectorLayerDescription *vectorDescription = (TIOVectorLayerDescription *)description;
+    TIOVector *vector = [[TIOVector alloc] initWithData:data description:vectorDescription];
+    
+    return [vectorDescription labeledValues:vector];
+}
+
+static id<TIOData> TIOTFLiteReadVector(NSData *data, id<TIOLayerDescription> description) {
+    TIOVector *vector = [[TIOVector alloc] initWithData:data description:description];
+    
+    // If the vector's output is single-valued just return that value
+    
+    return vector.count == 1
+        ? vector[0]
+        : vector;
+}
+
+static id<TIOData> TIOTFLiteReadString(NSData *data, id<TIOLayerDescription> description) {
+    return [[NSData alloc] initWithData:data description:description];
+}
+
+static id<TIOData> TIOTFLiteReadScalar(NSData *data, id<TIOLayerDescription> description) {
+    return [[NSNumber alloc] initWithData:data description:description];
+}
+
+// MARK: - Plan
+
+/**
+ * Returns the type of the values the data converters read and write for a vector or scalar.
+ */
+
+static TIODataType TIOTFLiteDataTypeForNumericDescription(TIODataType dtype, BOOL quantized) {
+    if ( dtype == TIODataTypeInt8 ) {
+        return TIODataTypeInt8;
+    } else if ( quantized ) {
+        return TIODataTypeUInt8;
+    } else if ( dtype == TIODataTypeInt32 || dtype == TIODataTypeInt64 || dtype == TIODataTypeFloat16 ) {
+        return dtype;
+    } else {
+        return TIODataTypeFloat32;
+    }
+}
+
+/**
+ * Returns the type of the values the data converters read and write for a layer, which its
+ * tensor must have. Int8 layers take precedence over quantization, and quantized layers are
+ * otherwise uint8. Pixel buffers are float32 unless they are float16, and vectors and scalars
+ * are float32 unless they are int32, int64, or float16.
+ */
+
+static TIODataType TIOTFLiteDataTypeForInterface(TIOLayerInterface *interface) {
+    __block TIODataType dtype = TIODataTypeUnknown;
+    
+    [interface
+        matchCasePixelBuffer:^(TIOPixelBufferLayerDescription * _Nonnull pixelBufferDescription) {
+            dtype = pixelBufferDescription.dtype == TIODataTypeInt8 ? TIODataTypeInt8
+                : pixelBufferDescription.isQuantized ? TIODataTypeUInt8
+                : pixelBufferDescription.dtype == TIODataTypeFloat16 ? TIODataTypeFloat16
+                : TIODataTypeFloat32;
+            
+        } caseVector:^(TIOVectorLayerDescription * _Nonnull vectorDescription) {
+            dtype = TIOTFLiteDataTypeForNumericDescription(vectorDescription.dtype, vectorDescription.isQuantized);
+            
+        } caseString:^(TIOStringLayerDescription * _Nonnull stringDescription) {
+            dtype = stringDescription.dtype;
+            
+        } caseScalar:^(TIOScalarLayerDescription * _Nonnull scalarDescription) {
+            dtype = TIOTFLiteDataTypeForNumericDescription(scalarDescription.dtype, scalarDescription.isQuantized);
+        }];
+    
+    return dtype;
+}
+
+/**
+ * Returns the number of bytes the data converters read and write for a single item of a layer,
+ * which its tensor must hold.
+ */
+
+static size_t TIOTFLiteByteCountForInterface(TIOLayerInterface *interface) {
+    __block size_t count = 0;
+    
+    [interface
+        matchCasePixelBuffer:^(TIOPixelBufferLayerDescription * _Nonnull pixelBufferDescription) {
+            count = TIOImageVolumeLength(pixelBufferDescription.imageVolume);
+        } caseVector:^(TIOVectorLayerDescription * _Nonnull vectorDescription) {
+            count = vectorDescription.length;
+        } caseString:^(TIOStringLayerDescription * _Nonnull stringDescription) {
+            count = stringDescription.length;
+        } caseScalar:^(TIOScalarLayerDescription * _Nonnull scalarDescription) {
+            count = 1;
+        }];
+    
+    return count * TIOByteSizeOfDataType(TIOTFLiteDataTypeForInterface(interface));
+}
+
+/**
+ * Checks that a tensor has the type a layer's data converters use and, for inputs, exactly the
+ * number of bytes they write for a single item. Interpreters are sized for a single item when
+ * the plan is built.
+ */
+
+static BOOL TIOTFLiteTensorMatchesInterface(const TfLiteTensor *tensor, TIOLayerInterface *interface, size_t byteCount, BOOL input) {
+    const TIODataType expected = TIOTFLiteDataTypeForInterface(interface);
+    const TIODataType actual = TIODataTypeForTfLiteType(TfLiteTensorType(tensor));
+    
+    if ( actual == TIODataTypeUnknown || actual != expected ) {
+        NSLog(@"Tensor for layer %@ has type %d but the layer's dtype and quantization require type %lu", interface.name, TfLiteTensorType(tensor), (unsigned long)expected);
+        return NO;
+    }
+    
+    if ( input ? TfLiteTensorByteSize(tensor) != byteCount : TfLiteTensorByteSize(tensor) < byteCount ) {
+        NSLog(@"Tensor for layer %@ has %zu bytes but the layer describes %zu bytes", interface.name, TfLiteTensorByteSize(tensor), byteCount);
+        return NO;
+    }
+    
+    return YES;
+}
+
+BOOL TIOTFLiteBuildRunPlan(TIOModelIO *io, TfLiteInterpreter *interpreter, TIOTFLiteRunPlan &plan) {
+    plan.inputs.clear();
+    plan.outputs.clear();
+    
+    if ( TfLiteInterpreterGetInputTensorCount(interpreter) != io.inputs.count ) {
+        NSLog(@"Model has %d input tensors but describes %lu input layers", TfLiteInterpreterGetInputTensorCount(interpreter), (unsigned long)io.inputs.count);
+        return NO;
+    }
+    
+    if ( TfLiteInterpreterGetOutputTensorCount(interpreter) != io.outputs.count ) {
+        NSLog(@"Model has %d output tensors but describes %lu output layers", TfLiteInterpreterGetOutputTensorCount(interpreter), (unsigned long)io.outputs.count);
+        return NO;
+    }
+    
+    // Inputs
+    
+    for ( int32_t index = 0; index < io.inputs.count; index++ ) {
+        TIOLayerInterface *interface = io.inputs[index];
+        const TfLiteTensor *tensor = TfLiteInterpreterGetInputTensor(interpreter, index);
+        __block TIOTFLiteInputWriter write = NULL;
+        
+        [interface
+            matchCasePixelBuffer:^(TIOPixelBufferLayerDescription * _Nonnull pixelBufferDescription) {
+                write = TIOTFLiteWritePixelBuffer;
+            } caseVector:^(TIOVectorLayerDescription * _Nonnull vectorDescription) {
+                write = TIOTFLiteWriteVector;
+            } caseString:^(TIOStringLayerDescription * _Nonnull stringDescription) {
+                write = TIOTFLiteWriteString;
+            } caseScalar:^(TIOScalarLayerDescription * _Nonnull scalarDescription) {
+                write = TIOTFLiteWriteScalar;
+            }];
+        
+        TIOTFLiteInputPlan layer;
+        layer.name = interface.name;
+        layer.index = index;
+        layer.interface = interface;
+        layer.description = interface.layerDescription;
+        layer.dtype = TIODataTypeForTfLiteType(TfLiteTensorType(tensor));
+        layer.quantized = interface.layerDescription.isQuantized;
+        layer.byteCount = TIOTFLiteByteCountForInterface(interface);
+        layer.write = write;
+        
+        if ( !TIOTFLiteTensorMatchesInterface(tensor, interface, layer.byteCount, YES) ) {
+            return NO;
+        }
+        
+        plan.inputs.push_back(layer);
+    }
+    
+    // Outputs
+    
+    for ( int32_t index = 0; index < io.outputs.count; index++ ) {
+        TIOLayerInterface *interface = io.outputs[index];
+        const TfLiteTensor *tensor = TfLiteInterpreterGetOutputTensor(interpreter, index);
+        __block TIOTFLiteOutputReader read = NULL;
+        
+        [interface
+            matchCasePixelBuffer:^(TIOPixelBufferLayerDescription * _Nonnull pixelBufferDescription) {
+                read = TIOTFLiteReadPixelBuffer;
+            } caseVector:^(TIOVectorLayerDescription * _Nonnull vectorDescription) {
+                read = vectorDescription.isLabeled
+                    ? TIOTFLiteReadLabeledVector
+                    : TIOTFLiteReadVector;
+            } caseString:^(TIOStringLayerDescription * _Nonnull stringDescription) {
+                read = TIOTFLiteReadString;
+            } caseScalar:^(TIOScalarLayerDescription * _Nonnull scalarDescription) {
+                read = TIOTFLiteReadScalar;
+            }];
+        
+        id<TIOLayerDescription> description = interface.layerDescription;
+        
+        TIOTensorViewConverter converter = ^id<TIOData>(TIOTensorView *view) {
+            NSData *data = [NSData dataWithBytesNoCopy:(void *)view.bytes length:view.length freeWhenDone:NO];
+            return read(data, description);
+        };
+        
+        TIOTFLiteOutputPlan layer;
+        layer.name = interface.name;
+        layer.index = index;
+        layer.interface = interface;
+        layer.description = description;
+        layer.dtype = TIODataTypeForTfLiteType(TfLiteTensorType(tensor));
+        layer.quantized = description.isQuantized;
+        layer.read = read;
+        layer.converter = converter;
+        
+        if ( !TIOTFLiteTensorMatchesInterface(tensor, interface, TIOTFLiteByteCountForInterface(interface), NO) ) {
+            return NO;
+        }
+        
+        plan.outputs.push_back(layer);
+    }
+    
+    return YES;
+}
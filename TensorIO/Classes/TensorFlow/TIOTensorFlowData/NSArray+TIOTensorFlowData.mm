@@ -24,6 +24,9 @@
 #import "TIOVectorLayerDescription.h"
 #import "TIOScalarLayerDescription.h"
 #import "NSArray+TIOExtensions.h"
+#import "TIOTensorFlowDataLayout.h"
+#import "TIOTensorFlowColumnEnumeration.h"
+#import "TIOFloat16.h"
 
 #include <vector>
 
@@ -45,7 +48,19 @@
     TIODataType dtype = ((TIOVectorLayerDescription *)description).dtype;
     NSMutableArray *array = NSMutableArray.array;
     
-    if ( description.isQuantized && dequantizer != nil ) {
+    if ( dtype == TIODataTypeInt8 && description.isQuantized && dequantizer != nil ) {
+        auto flat_tensor = tensor.flat<int8_t>();
+        auto tensor_data = flat_tensor.data();
+        for ( NSUInteger i = 0; i < length; i++ ) {
+            [array addObject:@(dequantizer(TIOQuantizedValueFromInt8(((int8_t *)tensor_data)[i])))];
+        }
+    } else if ( dtype == TIODataTypeInt8 ) {
+        auto flat_tensor = tensor.flat<int8_t>();
+        auto tensor_data = flat_tensor.data();
+        for ( NSUInteger i = 0; i < length; i++ ) {
+            [array addObject:@(((int8_t *)tensor_data)[i])];
+        }
+    } else if ( description.isQuantized && dequantizer != nil ) {
         auto flat_tensor = tensor.flat<uint8_t>();
         auto tensor_data = flat_tensor.data();
         for ( NSUInteger i = 0; i < length; i++ ) {
@@ -69,6 +84,14 @@
         for ( NSUInteger i = 0; i < length; i++ ) {
             [array addObject:@(((int64_t *)tensor_data)[i])];
         }
+    } else if ( dtype == TIODataTypeFloat16 ) {
+        auto flat_tensor = tensor.flat<Eigen::half>();
+        auto tensor_data = reinterpret_cast<const TIOFloat16 *>(flat_tensor.data());
+        std::vector<float_t> values(length);
+        TIOConvertFloat16ToFloat32(tensor_data, values.data(), length);
+        for ( NSUInteger i = 0; i < length; i++ ) {
+            [array addObject:@(values[i])];
+        }
     } else {
         auto flat_tensor = tensor.flat<float_t>();
         auto tensor_data = flat_tensor.data();
@@ -87,6 +110,12 @@
 // MARK: - Batch (Training)
 
 + (tensorflow::Tensor)tensorWithColumn:(NSArray<id<TIOTensorFlowData>>*)column description:(id<TIOLayerDescription>)description {
+    tensorflow::Tensor tensor(TIOTensorFlowDataTypeForDescription(description), TIOTensorFlowShapeForDescription(description, column.count));
+    [self fillTensor:tensor withColumn:column description:description];
+    return tensor;
+}
+
++ (void)fillTensor:(tensorflow::Tensor &)tensor withColumn:(NSArray<id<TIOTensorFlowData>>*)column description:(id<TIOLayerDescription>)description {
     assert([description isKindOfClass:TIOVectorLayerDescription.class]
         || [description isKindOfClass:TIOScalarLayerDescription.class]);
     
@@ -95,99 +124,99 @@
     TIODataQuantizer quantizer = ((TIOVectorLayerDescription *)description).quantizer;
     TIODataType dtype = ((TIOVectorLayerDescription *)description).dtype;
     NSUInteger length = ((TIOVectorLayerDescription *)description).length;
-    int32_t batch_size = (int32_t)column.count;
-    
-    // Establish shape
-    
-    std::vector<tensorflow::int64> dims;
-    
-    if ( description.isBatched ) {
-        dims.push_back(batch_size);
-    }
-    
-    // Ignore any shape but batch if scalar layer
-    
-    if ( ![description isKindOfClass:TIOScalarLayerDescription.class] ) {
-        for ( NSNumber *dim in description.shape.excludingBatch ) {
-            dims.push_back(dim.integerValue);
-        }
-    }
-    
-    tensorflow::gtl::ArraySlice<tensorflow::int64> dim_sizes(dims);
-    tensorflow::TensorShape shape = tensorflow::TensorShape(dim_sizes);
     
     // Typed enumeration over the column
     
-    if ( description.isQuantized && quantizer != nil ) {
-        tensorflow::Tensor tensor(tensorflow::DT_UINT8, shape);
+    if ( dtype == TIODataTypeInt8 && description.isQuantized && quantizer != nil ) {
+        auto flat_tensor = tensor.flat<int8_t>();
+        auto buffer = flat_tensor.data();
+        
+        TIOTensorFlowEnumerateColumn(column, length, ^(id<TIOTensorFlowData> _Nonnull obj, NSUInteger idx) {
+            NSArray *arrobj = (NSArray *)obj;
+            size_t offset = idx * length;
+            for ( NSInteger i = 0; i < arrobj.count; i++ ) {
+                ((int8_t *)buffer)[offset+i] = TIOInt8FromQuantizedValue(quantizer(((NSNumber *)arrobj[i]).floatValue));
+            }
+        });
+    } else if ( dtype == TIODataTypeInt8 ) {
+        auto flat_tensor = tensor.flat<int8_t>();
+        auto buffer = flat_tensor.data();
+        
+        TIOTensorFlowEnumerateColumn(column, length, ^(id<TIOTensorFlowData> _Nonnull obj, NSUInteger idx) {
+            NSArray *arrobj = (NSArray *)obj;
+            size_t offset = idx * length;
+            for ( NSInteger i = 0; i < arrobj.count; i++ ) {
+                ((int8_t *)buffer)[offset+i] = ((NSNumber *)arrobj[i]).charValue;
+            }
+        });
+    } else if ( description.isQuantized && quantizer != nil ) {
         auto flat_tensor = tensor.flat<uint8_t>();
         auto buffer = flat_tensor.data();
         
-        [column enumerateObjectsUsingBlock:^(id<TIOTensorFlowData> _Nonnull obj, NSUInteger idx, BOOL * _Nonnull stop) {
+        TIOTensorFlowEnumerateColumn(column, length, ^(id<TIOTensorFlowData> _Nonnull obj, NSUInteger idx) {
             NSArray *arrobj = (NSArray *)obj;
             size_t offset = idx * length;
             for ( NSInteger i = 0; i < arrobj.count; i++ ) {
                 ((uint8_t *)buffer)[offset+i] = quantizer(((NSNumber *)arrobj[i]).floatValue);
             }
-        }];
-        
-        return tensor;
+        });
     } else if ( description.isQuantized && quantizer == nil ) {
-        tensorflow::Tensor tensor(tensorflow::DT_UINT8, shape);
         auto flat_tensor = tensor.flat<uint8_t>();
         auto buffer = flat_tensor.data();
         
-        [column enumerateObjectsUsingBlock:^(id<TIOTensorFlowData> _Nonnull obj, NSUInteger idx, BOOL * _Nonnull stop) {
+        TIOTensorFlowEnumerateColumn(column, length, ^(id<TIOTensorFlowData> _Nonnull obj, NSUInteger idx) {
             NSArray *arrobj = (NSArray *)obj;
             size_t offset = idx * length;
             for ( NSInteger i = 0; i < arrobj.count; i++ ) {
                 ((uint8_t *)buffer)[offset+i] = ((NSNumber *)arrobj[i]).unsignedCharValue;
             }
-        }];
-        
-        return tensor;
+        });
     } else if ( dtype == TIODataTypeInt32 ) {
-        tensorflow::Tensor tensor(tensorflow::DT_INT32, shape);
         auto flat_tensor = tensor.flat<int32_t>();
         auto buffer = flat_tensor.data();
         
-        [column enumerateObjectsUsingBlock:^(id<TIOTensorFlowData> _Nonnull obj, NSUInteger idx, BOOL * _Nonnull stop) {
+        TIOTensorFlowEnumerateColumn(column, length, ^(id<TIOTensorFlowData> _Nonnull obj, NSUInteger idx) {
             NSArray *arrobj = (NSArray *)obj;
             size_t offset = idx * length;
             for ( NSInteger i = 0; i < arrobj.count; i++ ) {
                 ((int32_t *)buffer)[offset+i] = (int32_t)((NSNumber *)arrobj[i]).longValue;
             }
-        }];
-        
-        return tensor;
+        });
     } else if ( dtype == TIODataTypeInt64 ) {
-        tensorflow::Tensor tensor(tensorflow::DT_INT64, shape);
         auto flat_tensor = tensor.flat<int64_t>();
         auto buffer = flat_tensor.data();
         
-        [column enumerateObjectsUsingBlock:^(id<TIOTensorFlowData> _Nonnull obj, NSUInteger idx, BOOL * _Nonnull stop) {
+        TIOTensorFlowEnumerateColumn(column, length, ^(id<TIOTensorFlowData> _Nonnull obj, NSUInteger idx) {
             NSArray *arrobj = (NSArray *)obj;
             size_t offset = idx * length;
             for ( NSInteger i = 0; i < arrobj.count; i++ ) {
                 ((int64_t *)buffer)[offset+i] = (int64_t)((NSNumber *)arrobj[i]).longLongValue;
             }
-        }];
+        });
+    } else if ( dtype == TIODataTypeFloat16 ) {
+        auto flat_tensor = tensor.flat<Eigen::half>();
+        auto buffer = reinterpret_cast<TIOFloat16 *>(flat_tensor.data());
         
-        return tensor;
+        TIOTensorFlowEnumerateColumn(column, length, ^(id<TIOTensorFlowData> _Nonnull obj, NSUInteger idx) {
+            NSArray *arrobj = (NSArray *)obj;
+            size_t offset = idx * length;
+            std::vector<float_t> values(arrobj.count);
+            for ( NSInteger i = 0; i < arrobj.count; i++ ) {
+                values[i] = ((NSNumber *)arrobj[i]).floatValue;
+            }
+            TIOConvertFloat32ToFloat16(values.data(), buffer + offset, arrobj.count);
+        });
     } else {
-        tensorflow::Tensor tensor(tensorflow::DT_FLOAT, shape);
         auto flat_tensor = tensor.flat<float_t>();
         auto buffer = flat_tensor.data();
         
-        [column enumerateObjectsUsingBlock:^(id<TIOTensorFlowData> _Nonnull obj, NSUInteger idx, BOOL * _Nonnull stop) {
+        TIOTensorFlowEnumerateColumn(column, length, ^(id<TIOTensorFlowData> _Nonnull obj, NSUInteger idx) {
             NSArray *arrobj = (NSArray *)obj;
             size_t offset = idx * length;
             for ( NSInteger i = 0; i < arrobj.count; i++ ) {
                 ((float_t *)buffer)[offset+i] = ((NSNumber *)arrobj[i]).floatValue;
             }
-        }];
-        
-        return tensor;
+        });
     }
 }
 
@@ -25,6 +25,8 @@
 #import "TIOStringLayerDescription.h"
 #import "TIOScalarLayerDescription.h"
 #import "NSArray+TIOExtensions.h"
+#import "TIOTensorFlowDataLayout.h"
+#import "TIOFloat16.h"
 
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wdocumentation"
@@ -47,7 +49,23 @@
         NSUInteger length = ((TIOVectorLayerDescription *)description).length;
         TIODataType dtype = ((TIOVectorLayerDescription *)description).dtype;
         
-        if ( description.isQuantized && dequantizer != nil ) {
+        if ( dtype == TIODataTypeInt8 && description.isQuantized && dequantizer != nil ) {
+            size_t byte_count = length * sizeof(float_t);
+            auto flat_tensor = tensor.flat<int8_t>();
+            auto tensor_data = flat_tensor.data();
+            float_t *buffer = (float_t *)malloc(byte_count);
+            for ( NSInteger i = 0; i < length; i++ ) {
+                ((float_t *)buffer)[i] = dequantizer(TIOQuantizedValueFromInt8(((int8_t *)tensor_data)[i]));
+            }
+            NSData *data = [[NSData alloc] initWithBytes:buffer length:byte_count];
+            free(buffer);
+            return data;
+        } else if ( dtype == TIODataTypeInt8 ) {
+            size_t tensor_byte_count = length * sizeof(int8_t);
+            auto flat_tensor = tensor.flat<int8_t>();
+            auto tensor_data = flat_tensor.data();
+            return [[NSData alloc] initWithBytes:tensor_data length:tensor_byte_count];
+        } else if ( description.isQuantized && dequantizer != nil ) {
             size_t byte_count = length * sizeof(float_t);
             auto flat_tensor = tensor.flat<uint8_t>();
             auto tensor_data = flat_tensor.data();
@@ -73,6 +91,13 @@
             auto flat_tensor = tensor.flat<int64_t>();
             auto tensor_data = flat_tensor.data();
             return [[NSData alloc] initWithBytes:tensor_data length:tensor_byte_count];
+        } else if ( dtype == TIODataTypeFloat16 ) {
+            size_t byte_count = length * sizeof(float_t);
+            auto flat_tensor = tensor.flat<Eigen::half>();
+            auto tensor_data = reinterpret_cast<const TIOFloat16 *>(flat_tensor.data());
+            NSMutableData *data = [[NSMutableData alloc] initWithLength:byte_count];
+            TIOConvertFloat16ToFloat32(tensor_data, (float_t *)data.mutableBytes, length);
+            return data;
         } else {
             size_t tensor_byte_count = length * sizeof(float_t);
             auto flat_tensor = tensor.flat<float_t>();
@@ -113,6 +138,20 @@
             return [[NSData alloc] initWithBytes:tensor_data length:tensor_byte_count];
         }
         break;
+        case TIODataTypeFloat16: {
+            size_t tensor_byte_count = length * sizeof(TIOFloat16);
+            auto flat_tensor = tensor.flat<Eigen::half>();
+            auto tensor_data = flat_tensor.data();
+            return [[NSData alloc] initWithBytes:tensor_data length:tensor_byte_count];
+        }
+        break;
+        case TIODataTypeInt8: {
+            size_t tensor_byte_count = length * sizeof(int8_t);
+            auto flat_tensor = tensor.flat<int8_t>();
+            auto tensor_data = flat_tensor.data();
+            return [[NSData alloc] initWithBytes:tensor_data length:tensor_byte_count];
+        }
+        break;
         default: {
             @throw [NSException exceptionWithName:@"Unsupported Data Type" reason:nil userInfo:nil];
             return nil;
@@ -133,6 +172,12 @@
 // MARK: - Batch (Training)
 
 + (tensorflow::Tensor)tensorWithColumn:(NSArray<id<TIOTensorFlowData>>*)column description:(id<TIOLayerDescription>)description {
+    tensorflow::Tensor tensor(TIOTensorFlowDataTypeForDescription(description), TIOTensorFlowShapeForDescription(description, column.count));
+    [self fillTensor:tensor withColumn:column description:description];
+    return tensor;
+}
+
++ (void)fillTensor:(tensorflow::Tensor &)tensor withColumn:(NSArray<id<TIOTensorFlowData>>*)column description:(id<TIOLayerDescription>)description {
     assert([description isKindOfClass:TIOVectorLayerDescription.class]
         || [description isKindOfClass:TIOStringLayerDescription.class]
         || [description isKindOfClass:TIOScalarLayerDescription.class]);
@@ -145,31 +190,32 @@
         TIODataQuantizer quantizer = ((TIOVectorLayerDescription *)description).quantizer;
         TIODataType dtype = ((TIOVectorLayerDescription *)description).dtype;
         NSUInteger length = ((TIOVectorLayerDescription *)description).length;
-        int32_t batch_size = (int32_t)column.count;
-        
-        // Establish shape
-        
-        std::vector<tensorflow::int64> dims;
-        
-        if ( description.isBatched ) {
-            dims.push_back(batch_size);
-        }
-        
-        // Ignore any shape but batch if scalar layer
-    
-        if ( ![description isKindOfClass:TIOScalarLayerDescription.class] ) {
-            for ( NSNumber *dim in description.shape.excludingBatch ) {
-                dims.push_back(dim.integerValue);
-            }
-        }
-        
-        tensorflow::gtl::ArraySlice<tensorflow::int64> dim_sizes(dims);
-        tensorflow::TensorShape shape = tensorflow::TensorShape(dim_sizes);
         
         // Typed enumeration over the column
         
-        if ( description.isQuantized && quantizer != nil ) {
-            tensorflow::Tensor tensor(tensorflow::DT_UINT8, shape);
+        if ( dtype == TIODataTypeInt8 && description.isQuantized && quantizer != nil ) {
+            auto flat_tensor = tensor.flat<int8_t>();
+            auto buffer = flat_tensor.data();
+            
+            [column enumerateObjectsUsingBlock:^(id<TIOTensorFlowData> _Nonnull obj, NSUInteger idx, BOOL * _Nonnull stop) {
+                NSData *dataobj = (NSData *)obj;
+                size_t offset = idx * length;
+                float_t *bytes = (float_t *)dataobj.bytes;
+                for ( NSInteger i = 0; i < length; i++ ) {
+                    ((int8_t *)buffer)[offset+i] = TIOInt8FromQuantizedValue(quantizer(bytes[i]));
+                }
+            }];
+        } else if ( dtype == TIODataTypeInt8 ) {
+            size_t tensor_byte_count = length * sizeof(int8_t);
+            auto flat_tensor = tensor.flat<int8_t>();
+            auto buffer = flat_tensor.data();
+            
+            [column enumerateObjectsUsingBlock:^(id<TIOTensorFlowData> _Nonnull obj, NSUInteger idx, BOOL * _Nonnull stop) {
+                NSData *dataobj = (NSData *)obj;
+                size_t offset = idx * length;
+                [dataobj getBytes:(buffer+offset) length:tensor_byte_count];
+            }];
+        } else if ( description.isQuantized && quantizer != nil ) {
             auto flat_tensor = tensor.flat<uint8_t>();
             auto buffer = flat_tensor.data();
             
@@ -181,11 +227,8 @@
                     ((uint8_t *)buffer)[offset+i] = quantizer(bytes[i]);
                 }
             }];
-            
-            return tensor;
         } else if ( description.isQuantized && quantizer == nil ) {
             size_t tensor_byte_count = length * sizeof(uint8_t);
-            tensorflow::Tensor tensor(tensorflow::DT_UINT8, shape);
             auto flat_tensor = tensor.flat<uint8_t>();
             auto buffer = flat_tensor.data();
             
@@ -194,11 +237,8 @@
                 size_t offset = idx * length;
                 [dataobj getBytes:(buffer+offset) length:tensor_byte_count];
             }];
-            
-            return tensor;
         } else if ( dtype == TIODataTypeInt32 ) {
             size_t tensor_byte_count = length * sizeof(int32_t);
-            tensorflow::Tensor tensor(tensorflow::DT_INT32, shape);
             auto flat_tensor = tensor.flat<int32_t>();
             auto buffer = flat_tensor.data();
             
@@ -207,11 +247,8 @@
                 size_t offset = idx * length;
                 [dataobj getBytes:(buffer+offset) length:tensor_byte_count];
             }];
-            
-            return tensor;
         } else if ( dtype == TIODataTypeInt64 ) {
             size_t tensor_byte_count = length * sizeof(int64_t);
-            tensorflow::Tensor tensor(tensorflow::DT_INT64, shape);
             auto flat_tensor = tensor.flat<int64_t>();
             auto buffer = flat_tensor.data();
             
@@ -220,11 +257,17 @@
                 size_t offset = idx * length;
                 [dataobj getBytes:(buffer+offset) length:tensor_byte_count];
             }];
+        } else if ( dtype == TIODataTypeFloat16 ) {
+            auto flat_tensor = tensor.flat<Eigen::half>();
+            auto buffer = reinterpret_cast<TIOFloat16 *>(flat_tensor.data());
             
-            return tensor;
+            [column enumerateObjectsUsingBlock:^(id<TIOTensorFlowData> _Nonnull obj, NSUInteger idx, BOOL * _Nonnull stop) {
+                NSData *dataobj = (NSData *)obj;
+                size_t offset = idx * length;
+                TIOConvertFloat32ToFloat16((const float_t *)dataobj.bytes, buffer + offset, length);
+            }];
         } else {
             size_t tensor_byte_count = length * sizeof(float_t);
-            tensorflow::Tensor tensor(tensorflow::DT_FLOAT, shape);
             auto flat_tensor = tensor.flat<float_t>();
             auto buffer = flat_tensor.data();
             
@@ -233,36 +276,17 @@
                 size_t offset = idx * length;
                 [dataobj getBytes:(buffer+offset) length:tensor_byte_count];
             }];
-            
-            return tensor;
         }
         
     } else if ( [description isKindOfClass:TIOStringLayerDescription.class] ) {
         NSUInteger length = ((TIOStringLayerDescription *)description).length;
         TIODataType dtype = ((TIOStringLayerDescription *)description).dtype;
-        int32_t batch_size = (int32_t)column.count;
-        
-        // Establish shape
-        
-        std::vector<tensorflow::int64> dims;
-        
-        if ( description.isBatched ) {
-            dims.push_back(batch_size);
-        }
-        
-        for ( NSNumber *dim in description.shape.excludingBatch ) {
-            dims.push_back(dim.integerValue);
-        }
-        
-        tensorflow::gtl::ArraySlice<tensorflow::int64> dim_sizes(dims);
-        tensorflow::TensorShape shape = tensorflow::TensorShape(dim_sizes);
         
         // Typed enumeration over the column
         
         switch (dtype) {
         case TIODataTypeUInt8: {
             size_t tensor_byte_count = length * sizeof(uint8_t);
-            tensorflow::Tensor tensor(tensorflow::DT_UINT8, shape);
             auto flat_tensor = tensor.flat<uint8_t>();
             auto buffer = flat_tensor.data();
             
@@ -271,13 +295,10 @@
                 size_t offset = idx * length;
                 [dataobj getBytes:(buffer+offset) length:tensor_byte_count];
             }];
-            
-            return tensor;
         }
         break;
         case TIODataTypeFloat32: {
             size_t tensor_byte_count = length * sizeof(float_t);
-            tensorflow::Tensor tensor(tensorflow::DT_FLOAT, shape);
             auto flat_tensor = tensor.flat<float_t>();
             auto buffer = flat_tensor.data();
             
@@ -286,13 +307,10 @@
                 size_t offset = idx * length;
                 [dataobj getBytes:(buffer+offset) length:tensor_byte_count];
             }];
-            
-            return tensor;
         }
         break;
         case TIODataTypeInt32: {
             size_t tensor_byte_count = length * sizeof(int32_t);
-            tensorflow::Tensor tensor(tensorflow::DT_INT32, shape);
             auto flat_tensor = tensor.flat<int32_t>();
             auto buffer = flat_tensor.data();
             
@@ -301,13 +319,10 @@
                 size_t offset = idx * length;
                 [dataobj getBytes:(buffer+offset) length:tensor_byte_count];
             }];
-            
-            return tensor;
         }
         break;
         case TIODataTypeInt64: {
             size_t tensor_byte_count = length * sizeof(int64_t);
-            tensorflow::Tensor tensor(tensorflow::DT_INT64, shape);
             auto flat_tensor = tensor.flat<int64_t>();
             auto buffer = flat_tensor.data();
             
@@ -316,8 +331,30 @@
                 size_t offset = idx * length;
                 [dataobj getBytes:(buffer+offset) length:tensor_byte_count];
             }];
+        }
+        break;
+        case TIODataTypeFloat16: {
+            size_t tensor_byte_count = length * sizeof(TIOFloat16);
+            auto flat_tensor = tensor.flat<Eigen::half>();
+            auto buffer = flat_tensor.data();
+            
+            [column enumerateObjectsUsingBlock:^(id<TIOTensorFlowData> _Nonnull obj, NSUInteger idx, BOOL * _Nonnull stop) {
+                NSData *dataobj = (NSData *)obj;
+                size_t offset = idx * length;
+                [dataobj getBytes:(buffer+offset) length:tensor_byte_count];
+            }];
+        }
+        break;
+        case TIODataTypeInt8: {
+            size_t tensor_byte_count = length * sizeof(int8_t);
+            auto flat_tensor = tensor.flat<int8_t>();
+            auto buffer = flat_tensor.data();
             
-            return tensor;
+            [column enumerateObjectsUsingBlock:^(id<TIOTensorFlowData> _Nonnull obj, NSUInteger idx, BOOL * _Nonnull stop) {
+                NSData *dataobj = (NSData *)obj;
+                size_t offset = idx * length;
+                [dataobj getBytes:(buffer+offset) length:tensor_byte_count];
+            }];
         }
         break;
         default: {
@@ -44,4 +44,8 @@
     return tensorflow::Tensor(tensorflow::DT_FLOAT, {});
 }
 
++ (void)fillTensor:(tensorflow::Tensor &)tensor withColumn:(NSArray<id<TIOTensorFlowData>>*)column description:(id<TIOLayerDescription>)description {
+    NSAssert(NO, @"This method is unimplemented. Tensor bytes cannot be captured from a dictionary.");
+}
+
 @end
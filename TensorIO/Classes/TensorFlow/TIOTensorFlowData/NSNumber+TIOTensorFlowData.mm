@@ -24,6 +24,8 @@
 #import "TIOVectorLayerDescription.h"
 #import "TIOScalarLayerDescription.h"
 #import "NSArray+TIOExtensions.h"
+#import "TIOTensorFlowDataLayout.h"
+#import "TIOFloat16.h"
 
 #include <vector>
 
@@ -43,7 +45,17 @@
     TIODataDequantizer dequantizer = ((TIOVectorLayerDescription *)description).dequantizer;
     TIODataType dtype = ((TIOVectorLayerDescription *)description).dtype;
     
-    if ( description.isQuantized && dequantizer != nil ) {
+    if ( dtype == TIODataTypeInt8 && description.isQuantized && dequantizer != nil ) {
+        auto flat_tensor = tensor.flat<int8_t>();
+        auto tensor_data = flat_tensor.data();
+        int8_t value = tensor_data[0];
+        return [self initWithFloat:dequantizer(TIOQuantizedValueFromInt8(value))];
+    } else if ( dtype == TIODataTypeInt8 ) {
+        auto flat_tensor = tensor.flat<int8_t>();
+        auto tensor_data = flat_tensor.data();
+        int8_t value = tensor_data[0];
+        return [self initWithChar:value];
+    } else if ( description.isQuantized && dequantizer != nil ) {
         auto flat_tensor = tensor.flat<uint8_t>();
         auto tensor_data = flat_tensor.data();
         uint8_t value = tensor_data[0];
@@ -63,6 +75,11 @@
         auto tensor_data = flat_tensor.data();
         int64_t value = tensor_data[0];
         return [self initWithLongLong:value];
+    } else if ( dtype == TIODataTypeFloat16 ) {
+        auto flat_tensor = tensor.flat<Eigen::half>();
+        auto tensor_data = reinterpret_cast<const TIOFloat16 *>(flat_tensor.data());
+        float_t value = TIOFloat32FromFloat16(tensor_data[0]);
+        return [self initWithFloat:value];
     } else {
         auto flat_tensor = tensor.flat<float_t>();
         auto tensor_data = flat_tensor.data();
@@ -78,6 +95,12 @@
 // MARK: - Batch (Training)
 
 + (tensorflow::Tensor)tensorWithColumn:(NSArray<id<TIOTensorFlowData>>*)column description:(id<TIOLayerDescription>)description {
+    tensorflow::Tensor tensor(TIOTensorFlowDataTypeForDescription(description), TIOTensorFlowShapeForDescription(description, column.count));
+    [self fillTensor:tensor withColumn:column description:description];
+    return tensor;
+}
+
++ (void)fillTensor:(tensorflow::Tensor &)tensor withColumn:(NSArray<id<TIOTensorFlowData>>*)column description:(id<TIOLayerDescription>)description {
     assert([description isKindOfClass:TIOVectorLayerDescription.class]
         || [description isKindOfClass:TIOScalarLayerDescription.class]);
     
@@ -86,31 +109,26 @@
     TIODataQuantizer quantizer = ((TIOVectorLayerDescription *)description).quantizer;
     TIODataType dtype = ((TIOVectorLayerDescription *)description).dtype;
     NSUInteger length = ((TIOVectorLayerDescription *)description).length;
-    int32_t batch_size = (int32_t)column.count;
-    
-    // Establish shape
-    
-    std::vector<tensorflow::int64> dims;
-    
-    if ( description.isBatched ) {
-        dims.push_back(batch_size);
-    }
-    
-    // Ignore any shape but batch if scalar layer
-    
-    if ( ![description isKindOfClass:TIOScalarLayerDescription.class] ) {
-        for ( NSNumber *dim in description.shape.excludingBatch ) {
-            dims.push_back(dim.integerValue);
-        }
-    }
-    
-    tensorflow::gtl::ArraySlice<tensorflow::int64> dim_sizes(dims);
-    tensorflow::TensorShape shape = tensorflow::TensorShape(dim_sizes);
     
     // Typed enumeration over the column
     
-    if ( description.isQuantized && quantizer != nil ) {
-        tensorflow::Tensor tensor(tensorflow::DT_UINT8, shape);
+    if ( dtype == TIODataTypeInt8 && description.isQuantized && quantizer != nil ) {
+        auto flat_tensor = tensor.flat<int8_t>();
+        auto buffer = flat_tensor.data();
+        
+        [column enumerateObjectsUsingBlock:^(id<TIOTensorFlowData> _Nonnull obj, NSUInteger idx, BOOL * _Nonnull stop) {
+            size_t offset = idx * length;
+            buffer[offset] = TIOInt8FromQuantizedValue(quantizer(((NSNumber *)obj).floatValue));
+        }];
+    } else if ( dtype == TIODataTypeInt8 ) {
+        auto flat_tensor = tensor.flat<int8_t>();
+        auto buffer = flat_tensor.data();
+        
+        [column enumerateObjectsUsingBlock:^(id<TIOTensorFlowData> _Nonnull obj, NSUInteger idx, BOOL * _Nonnull stop) {
+            size_t offset = idx * length;
+            buffer[offset] = ((NSNumber *)obj).charValue;
+        }];
+    } else if ( description.isQuantized && quantizer != nil ) {
         auto flat_tensor = tensor.flat<uint8_t>();
         auto buffer = flat_tensor.data();
         
@@ -118,10 +136,7 @@
             size_t offset = idx * length;
             buffer[offset] = quantizer(((NSNumber *)obj).floatValue);
         }];
-        
-        return tensor;
     } else if ( description.isQuantized && quantizer == nil ) {
-        tensorflow::Tensor tensor(tensorflow::DT_UINT8, shape);
         auto flat_tensor = tensor.flat<uint8_t>();
         auto buffer = flat_tensor.data();
         
@@ -129,10 +144,7 @@
             size_t offset = idx * length;
             buffer[offset] = ((NSNumber *)obj).unsignedCharValue;
         }];
-        
-        return tensor;
     } else if ( dtype == TIODataTypeInt32 ) {
-        tensorflow::Tensor tensor(tensorflow::DT_INT32, shape);
         auto flat_tensor = tensor.flat<int32_t>();
         auto buffer = flat_tensor.data();
         
@@ -140,10 +152,7 @@
             size_t offset = idx * length;
             buffer[offset] = (int32_t)((NSNumber *)obj).longValue;
         }];
-        
-        return tensor;
     } else if ( dtype == TIODataTypeInt64 ) {
-        tensorflow::Tensor tensor(tensorflow::DT_INT64, shape);
         auto flat_tensor = tensor.flat<int64_t>();
         auto buffer = flat_tensor.data();
         
@@ -151,10 +160,15 @@
             size_t offset = idx * length;
             buffer[offset] = (int64_t)((NSNumber *)obj).longLongValue;
         }];
+    } else if ( dtype == TIODataTypeFloat16 ) {
+        auto flat_tensor = tensor.flat<Eigen::half>();
+        auto buffer = reinterpret_cast<TIOFloat16 *>(flat_tensor.data());
         
-        return tensor;
+        [column enumerateObjectsUsingBlock:^(id<TIOTensorFlowData> _Nonnull obj, NSUInteger idx, BOOL * _Nonnull stop) {
+            size_t offset = idx * length;
+            buffer[offset] = TIOFloat16FromFloat32(((NSNumber *)obj).floatValue);
+        }];
     } else {
-        tensorflow::Tensor tensor(tensorflow::DT_FLOAT, shape);
         auto flat_tensor = tensor.flat<float_t>();
         auto buffer = flat_tensor.data();
         
@@ -162,8 +176,6 @@
             size_t offset = idx * length;
             buffer[offset] = ((NSNumber *)obj).floatValue;
         }];
-        
-        return tensor;
     }
 }
 
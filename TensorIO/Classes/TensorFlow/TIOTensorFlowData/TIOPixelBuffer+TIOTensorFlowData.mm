@@ -21,33 +21,59 @@
 #import "TIOPixelBuffer+TIOTensorFlowData.h"
 #import "TIOPixelBufferLayerDescription.h"
 #import "TIOVisionPipeline.h"
+#import "TIOTensorFlowDataLayout.h"
+#import "TIOTensorFlowColumnEnumeration.h"
+#import "TIOFloat16.h"
+#import "TIOQuantization.h"
+#import "TIOPixelKernels.h"
+#import "TIOPixelBufferPool.h"
 
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wdocumentation"
 #include "tensorflow/core/framework/tensor.h"
 #pragma clang diagnostic pop
 
+#include <type_traits>
+
+/**
+ * The values of a tensor as the type the pixel kernels write, which for a float16 tensor are the
+ * bits of its half precision values.
+ */
+
+template <typename T>
+T *TIOTensorFlowPixelData(tensorflow::Tensor &tensor) {
+    return tensor.flat<T>().data();
+}
+
+template <>
+TIOFloat16 *TIOTensorFlowPixelData<TIOFloat16>(tensorflow::Tensor &tensor) {
+    return reinterpret_cast<TIOFloat16 *>(tensor.flat<Eigen::half>().data());
+}
+
 /**
  * Copies a pixel buffer in ARGB or BGRA format to a tensor.
  *
  * The pixel buffer must already be in the shape and format expected by the input tensor,
  * with the shape parameter describing its dimensions. The alpha channel will be ignored.
  *
- * If a normalizer is provided then the pixel buffer's values will be scaled using the
- * normalizer.
+ * Pixel values are normalized a row at a time by the vectorized pixel kernels unless the
+ * normalization is `kTIOPixelNormalizationInvalid`, which means the layer has a custom
+ * normalizer that must be called for every value.
  *
- * `tensor_t` will be `float_t` (32 bits) for an unquantized model or `uint8_t` (8 bits)
- * for a quantized model.
+ * `T` will be `float_t` (32 bits) for an unquantized model, `uint8_t` (8 bits) for a quantized
+ * model, or `TIOFloat16` or `int8_t` for layers with those dtypes.
  *
  * @param pixelBuffer The pixel buffer that will be copied to the tensor.
  * @param tensor The tensor that will receive the pixel buffer values.
  * @param shape The shape, i.e. width, height, and number of channels of the tensor.
  * @param normalizer A scaling function that will be applied to the pixel values as
  * they are copied to the tensor. May be `nil`.
+ * @param normalization The scale and biases of the normalizer, or `kTIOPixelNormalizationInvalid`
+ * for a custom normalizer.
  */
 
 template <typename T>
-void TIOCopyCVPixelBufferToTensorFlowTensor(CVPixelBufferRef pixelBuffer, tensorflow::Tensor tensor, TIOImageVolume shape, _Nullable TIOPixelNormalizer normalizer, size_t offset) {
+void TIOCopyCVPixelBufferToTensorFlowTensor(CVPixelBufferRef pixelBuffer, tensorflow::Tensor tensor, TIOImageVolume shape, _Nullable TIOPixelNormalizer normalizer, TIOPixelNormalization normalization, size_t offset) {
     
     CFRetain(pixelBuffer);
     CVPixelBufferLockBaseAddress(pixelBuffer, kNilOptions);
@@ -71,42 +97,36 @@ void TIOCopyCVPixelBufferToTensorFlowTensor(CVPixelBufferRef pixelBuffer, tensor
     assert(image_channels >= shape.channels);
     
     uint8_t* in = (uint8_t *)CVPixelBufferGetBaseAddress(pixelBuffer);
-    T* out = tensor.flat<T>().data() + offset;
+    T* out = TIOTensorFlowPixelData<T>(tensor) + offset;
     
-    if ( normalizer == nil ) {
+    if ( TIOPixelNormalizationsEqual(normalization, kTIOPixelNormalizationInvalid) ) {
+        
+        // A custom normalizer is called for every value
+        
         for (int y = 0; y < image_height; y++) {
             for (int x = 0; x < image_width; x++) {
                 auto* in_pixel = in + (y * bytes_per_row) + (x * image_channels);
                 auto* out_pixel = out + (y * tensor_bytes_per_row) + (x * tensor_channels);
                 for (int c = 0; c < tensor_channels; ++c) {
-                    out_pixel[c] = in_pixel[c+channel_offset];
+                    TIOStoreNormalizedValue(normalizer(in_pixel[c+channel_offset], c), out_pixel + c);
                 }
             }
         }
     } else {
-        for (int y = 0; y < image_height; y++) {
-            for (int x = 0; x < image_width; x++) {
-                auto* in_pixel = in + (y * bytes_per_row) + (x * image_channels);
-                auto* out_pixel = out + (y * tensor_bytes_per_row) + (x * tensor_channels);
-                for (int c = 0; c < tensor_channels; ++c) {
-                    out_pixel[c] = normalizer(in_pixel[c+channel_offset], c);
-                }
-            }
-        }
+        TIONormalizePixels(in, bytes_per_row, sourcePixelFormat, image_width, image_height, out, tensor_channels, normalization);
     }
     
     CVPixelBufferUnlockBaseAddress(pixelBuffer, kNilOptions);
     CFRelease(pixelBuffer);
 }
 
-// TODO: ensure 16 byte pixel buffer alignment
-
 /**
  * Copies tensor bytes directly into a pixel buffer from a tensor, applying a denormalization
  * function and adjusting for the pixel format.
  *
- * The resulting pixel buffer will (eventually) be 16 byte aligned. The caller must release the
- * pixelBuffer with `CVPixelBufferRelease`.
+ * The resulting pixel buffer comes from the shared `TIOPixelBufferPool`, so its rows are 64 byte
+ * aligned and its memory is reused once it is released. The caller must release the pixelBuffer
+ * with `CVPixelBufferRelease`.
  *
  * @param pixelBuffer A pointer to the pixel buffer that will be filled with the transformed tensor data
  * @param tensor A pointer to the tensor that contains the image data
@@ -114,38 +134,30 @@ void TIOCopyCVPixelBufferToTensorFlowTensor(CVPixelBufferRef pixelBuffer, tensor
  * @param pixelFormat The format of the tensor image data, must be kCVPixelFormatType_32ARGB or kCVPixelFormatType_32BGRA.
  * Note that the alpha channel is ignored.
  * @param denormalizer A function that can convert the tensor image data to pixel values, may be `nil`.
+ * @param denormalization The scale and biases of the denormalizer, or `kTIOPixelDenormalizationInvalid`
+ * for a custom denormalizer.
  *
  * @return CVReturn `kCVReturnSuccess` if the operation was successful, some other value if not
  */
 
 template <typename T>
-CVReturn TIOCreateCVPixelBufferFromTensorFlowTensor(_Nonnull CVPixelBufferRef * _Nonnull pixelBuffer, tensorflow::Tensor tensor, TIOImageVolume shape, OSType pixelFormat, _Nullable TIOPixelDenormalizer denormalizer) {
+CVReturn TIOCreateCVPixelBufferFromTensorFlowTensor(_Nonnull CVPixelBufferRef * _Nonnull pixelBuffer, tensorflow::Tensor tensor, TIOImageVolume shape, OSType pixelFormat, _Nullable TIOPixelDenormalizer denormalizer, TIOPixelDenormalization denormalization) {
     
     assert( pixelFormat == kCVPixelFormatType_32ARGB || pixelFormat == kCVPixelFormatType_32BGRA );
-    assert( shape.width % 16 == 0);
     
     const int tensor_channels = shape.channels;
     const int tensor_bytes_per_row = shape.width * tensor_channels;
     const int image_width = shape.width;
     const int image_height = shape.height;
-    const int bytes_per_row = shape.width * 4;
     const int image_channels = 4; // by definition (ARGB, BGRA)
     
-    CVPixelBufferRef outputBuffer = NULL;
-    
-    CVReturn status = CVPixelBufferCreate(
-        kCFAllocatorDefault,
-        image_width,
-        image_height,
-        pixelFormat,
-        NULL,
-        &outputBuffer);
+    CVPixelBufferRef outputBuffer = [TIOPixelBufferPool.sharedPool createPixelBufferWithWidth:image_width height:image_height pixelFormat:pixelFormat];
     
     // Error handling
     
-    if ( status != kCVReturnSuccess ) {
+    if ( outputBuffer == NULL ) {
         NSLog(@"Couldn't create pixel buffer");
-        return status;
+        return kCVReturnAllocationFailed;
     }
     
     // Copy the pixel data
@@ -155,6 +167,8 @@ CVReturn TIOCreateCVPixelBufferFromTensorFlowTensor(_Nonnull CVPixelBufferRef *
     
     CVPixelBufferLockBaseAddress(outputBuffer, kNilOptions);
     
+    const size_t bytes_per_row = CVPixelBufferGetBytesPerRow(outputBuffer);
+    
     const int channel_offset = pixelFormat == kCVPixelFormatType_32ARGB
         ? 1
         : 0;
@@ -166,18 +180,10 @@ CVReturn TIOCreateCVPixelBufferFromTensorFlowTensor(_Nonnull CVPixelBufferRef *
     T* in_addr = tensor.flat<T>().data();
     uint8_t* out_addr = (uint8_t *)CVPixelBufferGetBaseAddress(outputBuffer);
     
-    if ( denormalizer == nil ) {
-        for (int y = 0; y < image_height; y++) {
-            for (int x = 0; x < image_width; x++) {
-                auto* in_pixel = in_addr + (y * tensor_bytes_per_row) + (x * tensor_channels);
-                auto* out_pixel = out_addr + (y * bytes_per_row) + (x * image_channels);
-                for (int c = 0; c < tensor_channels; ++c) {
-                    out_pixel[c+channel_offset] = in_pixel[c];
-                }
-                out_pixel[alpha_channel] = 255;
-            }
-        }
-    } else {
+    if ( TIOPixelDenormalizationsEqual(denormalization, kTIOPixelDenormalizationInvalid) ) {
+        
+        // A custom denormalizer is called for every value
+        
         for (int y = 0; y < image_height; y++) {
             for (int x = 0; x < image_width; x++) {
                 auto* out_pixel = out_addr + (y * bytes_per_row) + (x * image_channels);
@@ -188,6 +194,8 @@ CVReturn TIOCreateCVPixelBufferFromTensorFlowTensor(_Nonnull CVPixelBufferRef *
                 out_pixel[alpha_channel] = 255;
             }
         }
+    } else {
+        TIODenormalizePixels(in_addr, tensor_channels, image_width, image_height, out_addr, bytes_per_row, pixelFormat, denormalization);
     }
     
     // Clean up
@@ -198,11 +206,38 @@ CVReturn TIOCreateCVPixelBufferFromTensorFlowTensor(_Nonnull CVPixelBufferRef *
     return kCVReturnSuccess;
 }
 
+/**
+ * Copies an input pixel buffer to a tensor, either directly when the pixel buffer already has the
+ * size, format, and orientation the layer expects, or with a vision pipeline that transforms it
+ * into the tensor in a single pass.
+ *
+ * @param pipeline The pipeline that transforms the pixel buffer, or `nil` to copy it directly.
+ * @param pixelBuffer The pixel buffer that will be copied to the tensor.
+ * @param orientation The orientation of the pixel buffer.
+ * @param tensor The tensor that will receive the pixel buffer values.
+ * @param description The description of the layer.
+ * @param offset The offset into the tensor at which the pixel buffer values are written.
+ */
+
+template <typename T>
+void TIOCopyPixelBufferToTensorFlowTensor(TIOVisionPipeline * _Nullable pipeline, CVPixelBufferRef pixelBuffer, CGImagePropertyOrientation orientation, tensorflow::Tensor tensor, TIOPixelBufferLayerDescription *description, size_t offset) {
+    if ( pipeline != nil ) {
+        const TIODataType dtype = std::is_same<T, uint8_t>::value ? TIODataTypeUInt8
+            : std::is_same<T, int8_t>::value ? TIODataTypeInt8
+            : std::is_same<T, TIOFloat16>::value ? TIODataTypeFloat16
+            : TIODataTypeFloat32;
+        [pipeline transform:pixelBuffer orientation:orientation toBuffer:TIOTensorFlowPixelData<T>(tensor) + offset dtype:dtype];
+    } else {
+        TIOCopyCVPixelBufferToTensorFlowTensor<T>(pixelBuffer, tensor, description.imageVolume, description.normalizer, description.normalization, offset);
+    }
+}
+
 // MARK: -
 
 @interface TIOPixelBuffer (TIOTensorFlowData_Protected)
 
 @property (readwrite) CVPixelBufferRef transformedPixelBuffer;
+@property (nullable) TIOPixelBufferLayerDescription *transformDescription;
 
 @end
 
@@ -215,13 +250,50 @@ CVReturn TIOCreateCVPixelBufferFromTensorFlowTensor(_Nonnull CVPixelBufferRef *
     CVPixelBufferRef pixelBuffer = NULL;
     CVReturn result;
     
-    if ( description.isQuantized ) {
+    if ( pixelBufferDescription.dtype == TIODataTypeInt8 ) {
+        // Widen the int8 tensor, restoring the offset of pixel values when there is no denormalizer
+        
+        float_t bias = pixelBufferDescription.denormalizer == nil ? 128 : 0;
+        tensorflow::Tensor values(tensorflow::DT_FLOAT, tensor.shape());
+        TIOConvertInt8ToFloat32(
+            tensor.flat<int8_t>().data(),
+            values.flat<float_t>().data(),
+            (size_t)tensor.NumElements(),
+            bias);
+        
+        result = TIOCreateCVPixelBufferFromTensorFlowTensor<float_t>(
+            &pixelBuffer,
+            values,
+            pixelBufferDescription.imageVolume,
+            pixelBufferDescription.pixelFormat,
+            pixelBufferDescription.denormalizer,
+            pixelBufferDescription.denormalization
+        );
+    } else if ( description.isQuantized ) {
         result = TIOCreateCVPixelBufferFromTensorFlowTensor<uint8_t>(
             &pixelBuffer,
             tensor,
             pixelBufferDescription.imageVolume,
             pixelBufferDescription.pixelFormat,
-            pixelBufferDescription.denormalizer
+            pixelBufferDescription.denormalizer,
+            pixelBufferDescription.denormalization
+        );
+    } else if ( pixelBufferDescription.dtype == TIODataTypeFloat16 ) {
+        // Widen the half precision tensor and create the pixel buffer from single precision values
+        
+        tensorflow::Tensor values(tensorflow::DT_FLOAT, tensor.shape());
+        TIOConvertFloat16ToFloat32(
+            reinterpret_cast<const TIOFloat16 *>(tensor.flat<Eigen::half>().data()),
+            values.flat<float_t>().data(),
+            (size_t)tensor.NumElements());
+        
+        result = TIOCreateCVPixelBufferFromTensorFlowTensor<float_t>(
+            &pixelBuffer,
+            values,
+            pixelBufferDescription.imageVolume,
+            pixelBufferDescription.pixelFormat,
+            pixelBufferDescription.denormalizer,
+            pixelBufferDescription.denormalization
         );
     } else {
         result = TIOCreateCVPixelBufferFromTensorFlowTensor<float_t>(
@@ -229,7 +301,8 @@ CVReturn TIOCreateCVPixelBufferFromTensorFlowTensor(_Nonnull CVPixelBufferRef *
             tensor,
             pixelBufferDescription.imageVolume,
             pixelBufferDescription.pixelFormat,
-            pixelBufferDescription.denormalizer
+            pixelBufferDescription.denormalizer,
+            pixelBufferDescription.denormalization
         );
     }
     
@@ -248,112 +321,118 @@ CVReturn TIOCreateCVPixelBufferFromTensorFlowTensor(_Nonnull CVPixelBufferRef *
 // MARK: - Batch (Training)
 
 + (tensorflow::Tensor)tensorWithColumn:(NSArray<id<TIOTensorFlowData>>*)column description:(id<TIOLayerDescription>)description {
+    tensorflow::Tensor tensor(TIOTensorFlowDataTypeForDescription(description), TIOTensorFlowShapeForDescription(description, column.count));
+    [self fillTensor:tensor withColumn:column description:description];
+    return tensor;
+}
+
++ (void)fillTensor:(tensorflow::Tensor &)tensor withColumn:(NSArray<id<TIOTensorFlowData>>*)column description:(id<TIOLayerDescription>)description {
     assert([description isKindOfClass:TIOPixelBufferLayerDescription.class]);
     
-    int32_t batch_size = (int32_t)column.count;
-    
     TIOPixelBufferLayerDescription *pixelBufferDescription = (TIOPixelBufferLayerDescription *)description;
     
-    // Tensor shape
+    // Item length
     
     const int t_channels = pixelBufferDescription.imageVolume.channels;
     const int t_width = pixelBufferDescription.imageVolume.width;
     const int t_height = pixelBufferDescription.imageVolume.height;
     const int length = t_height * t_width * t_channels;
     
-    std::vector<tensorflow::int64> dims;
-    
-    if ( description.isBatched ) {
-        dims.push_back(batch_size);
-    }
-    
-    dims.push_back(t_height);
-    dims.push_back(t_width);
-    dims.push_back(t_channels);
-    
-    tensorflow::gtl::ArraySlice<tensorflow::int64> dim_sizes(dims);
-    tensorflow::TensorShape shape = tensorflow::TensorShape(dim_sizes);
-    
     // Typed enumeration over the column
     
-    if ( description.isQuantized ) {
-        tensorflow::Tensor tensor(tensorflow::DT_UINT8, shape);
-        
-        [column enumerateObjectsUsingBlock:^(id<TIOTensorFlowData> _Nonnull obj, NSUInteger idx, BOOL * _Nonnull stop) {
+    if ( description.isQuantized && pixelBufferDescription.dtype != TIODataTypeInt8 ) {
+        TIOTensorFlowEnumerateColumn(column, (NSUInteger)length, ^(id<TIOTensorFlowData> _Nonnull obj, NSUInteger idx) {
             size_t offset = idx * length;
            
             CVPixelBufferRef pixelBuffer = ((TIOPixelBuffer *)obj).pixelBuffer;
             CGImagePropertyOrientation orientation = ((TIOPixelBuffer *)obj).orientation;
             
-            CVPixelBufferRef transformedPixelBuffer;
+            TIOVisionPipeline *pipeline = nil;
             
             int width = (int)CVPixelBufferGetWidth(pixelBuffer);
             int height = (int)CVPixelBufferGetHeight(pixelBuffer);
             OSType pixelFormat = CVPixelBufferGetPixelFormatType(pixelBuffer);
             
-            // Transform image using vision pipeline
+            // Copy the pixel buffer directly or transform it into the tensor with the vision pipeline
             
             if ( width == pixelBufferDescription.imageVolume.width
                 && height == pixelBufferDescription.imageVolume.height
                 && pixelFormat == pixelBufferDescription.pixelFormat
                 && orientation == kCGImagePropertyOrientationUp ) {
-                transformedPixelBuffer = pixelBuffer;
+                CVPixelBufferRetain(pixelBuffer);
+                ((TIOPixelBuffer *)obj).transformedPixelBuffer = pixelBuffer;
+                ((TIOPixelBuffer *)obj).transformDescription = nil;
             } else {
-                TIOVisionPipeline *pipeline = [[TIOVisionPipeline alloc] initWithTIOPixelBufferDescription:pixelBufferDescription];
-                transformedPixelBuffer = [pipeline transform:pixelBuffer orientation:orientation];
+                pipeline = pixelBufferDescription.visionPipeline;
+                ((TIOPixelBuffer *)obj).transformedPixelBuffer = NULL;
+                ((TIOPixelBuffer *)obj).transformDescription = pixelBufferDescription;
             }
             
-            CVPixelBufferRetain(transformedPixelBuffer);
-            ((TIOPixelBuffer *)obj).transformedPixelBuffer = transformedPixelBuffer;
-            
-            TIOCopyCVPixelBufferToTensorFlowTensor<uint8_t>(
-                transformedPixelBuffer,
+            TIOCopyPixelBufferToTensorFlowTensor<uint8_t>(
+                pipeline,
+                pixelBuffer,
+                orientation,
                 tensor,
-                pixelBufferDescription.imageVolume,
-                pixelBufferDescription.normalizer,
+                pixelBufferDescription,
                 offset);
-        }];
-        
-        return tensor;
+        });
     } else {
-        tensorflow::Tensor tensor(tensorflow::DT_FLOAT, shape);
-        
-        [column enumerateObjectsUsingBlock:^(id<TIOTensorFlowData> _Nonnull obj, NSUInteger idx, BOOL * _Nonnull stop) {
+        TIOTensorFlowEnumerateColumn(column, (NSUInteger)length, ^(id<TIOTensorFlowData> _Nonnull obj, NSUInteger idx) {
             size_t offset = idx * length;
             
             CVPixelBufferRef pixelBuffer = ((TIOPixelBuffer *)obj).pixelBuffer;
             CGImagePropertyOrientation orientation = ((TIOPixelBuffer *)obj).orientation;
             
-            CVPixelBufferRef transformedPixelBuffer;
+            TIOVisionPipeline *pipeline = nil;
             
             int width = (int)CVPixelBufferGetWidth(pixelBuffer);
             int height = (int)CVPixelBufferGetHeight(pixelBuffer);
             OSType pixelFormat = CVPixelBufferGetPixelFormatType(pixelBuffer);
             
-            // Transform image using vision pipeline
+            // Copy the pixel buffer directly or transform it into the tensor with the vision pipeline
             
             if ( width == pixelBufferDescription.imageVolume.width
                 && height == pixelBufferDescription.imageVolume.height
                 && pixelFormat == pixelBufferDescription.pixelFormat
                 && orientation == kCGImagePropertyOrientationUp ) {
-                transformedPixelBuffer = pixelBuffer;
+                CVPixelBufferRetain(pixelBuffer);
+                ((TIOPixelBuffer *)obj).transformedPixelBuffer = pixelBuffer;
+                ((TIOPixelBuffer *)obj).transformDescription = nil;
             } else {
-                TIOVisionPipeline *pipeline = [[TIOVisionPipeline alloc] initWithTIOPixelBufferDescription:pixelBufferDescription];
-                transformedPixelBuffer = [pipeline transform:pixelBuffer orientation:orientation];
+                pipeline = pixelBufferDescription.visionPipeline;
+                ((TIOPixelBuffer *)obj).transformedPixelBuffer = NULL;
+                ((TIOPixelBuffer *)obj).transformDescription = pixelBufferDescription;
             }
             
-            CVPixelBufferRetain(transformedPixelBuffer);
-            ((TIOPixelBuffer *)obj).transformedPixelBuffer = transformedPixelBuffer;
+            // Float16 and int8 values are written directly, with int8 pixel values offset when
+            // there is no normalizer
             
-            TIOCopyCVPixelBufferToTensorFlowTensor<float_t>(
-                transformedPixelBuffer,
-                tensor,
-                pixelBufferDescription.imageVolume,
-                pixelBufferDescription.normalizer,
-                offset);
-        }];
-        
-        return tensor;
+            if ( pixelBufferDescription.dtype == TIODataTypeFloat16 ) {
+                TIOCopyPixelBufferToTensorFlowTensor<TIOFloat16>(
+                    pipeline,
+                    pixelBuffer,
+                    orientation,
+                    tensor,
+                    pixelBufferDescription,
+                    offset);
+            } else if ( pixelBufferDescription.dtype == TIODataTypeInt8 ) {
+                TIOCopyPixelBufferToTensorFlowTensor<int8_t>(
+                    pipeline,
+                    pixelBuffer,
+                    orientation,
+                    tensor,
+                    pixelBufferDescription,
+                    offset);
+            } else {
+                TIOCopyPixelBufferToTensorFlowTensor<float_t>(
+                    pipeline,
+                    pixelBuffer,
+                    orientation,
+                    tensor,
+                    pixelBufferDescription,
+                    offset);
+            }
+        });
     }
 }
 
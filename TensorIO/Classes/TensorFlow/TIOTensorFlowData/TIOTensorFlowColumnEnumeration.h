@@ -0,0 +1,57 @@
+//
+//  TIOTensorFlowColumnEnumeration.h
+//  TensorIO
+//
+//  Created by Phil Dow on 10/17/20.
+//  Copyright © 2020 doc.ai (http://doc.ai)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+#import "TIOTensorFlowData.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * The maximum number of items in a column the data converters prepare at the same time when they
+ * fill a tensor. Defaults to the number of active processors, and 1 prepares items serially.
+ */
+
+NSUInteger TIOTensorFlowColumnConcurrency(void);
+
+/**
+ * Sets the maximum number of items in a column the data converters prepare at the same time.
+ * Values less than 1 are treated as 1.
+ */
+
+void TIOTensorFlowSetColumnConcurrency(NSUInteger concurrency);
+
+/**
+ * Calls a block with each item in a column and its index, returning once every item has been
+ * visited.
+ *
+ * The column is split into contiguous runs of items which are visited in parallel on the shared
+ * global queue, up to the column concurrency, so the block must only write to its item's slice
+ * of a tensor. Columns with fewer than a few thousand values in total are visited serially,
+ * where dispatching would cost more than it saves.
+ *
+ * @param column The column of items.
+ * @param length The number of values each item writes to the tensor.
+ * @param block Called with each item and its index in the column.
+ */
+
+void TIOTensorFlowEnumerateColumn(NSArray<id<TIOTensorFlowData>> *column, NSUInteger length, void (^block)(id<TIOTensorFlowData> obj, NSUInteger idx));
+
+NS_ASSUME_NONNULL_END
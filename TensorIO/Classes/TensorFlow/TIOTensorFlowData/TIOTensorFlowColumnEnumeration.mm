@@ -0,0 +1,65 @@
+//
+//  TIOTensorFlowColumnEnumeration.mm
+//  TensorIO
+//
+//  Created by Phil Dow on 10/17/20.
+//  Copyright © 2020 doc.ai (http://doc.ai)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "TIOTensorFlowColumnEnumeration.h"
+
+#include <atomic>
+
+/**
+ * Columns with fewer values than this are enumerated serially.
+ */
+
+static const NSUInteger TIOTensorFlowParallelColumnMinimumValues = 4096;
+
+static std::atomic<NSUInteger> TIOTensorFlowColumnConcurrencyLimit(NSProcessInfo.processInfo.activeProcessorCount);
+
+NSUInteger TIOTensorFlowColumnConcurrency(void) {
+    return TIOTensorFlowColumnConcurrencyLimit.load();
+}
+
+void TIOTensorFlowSetColumnConcurrency(NSUInteger concurrency) {
+    TIOTensorFlowColumnConcurrencyLimit.store(MAX(concurrency, (NSUInteger)1));
+}
+
+void TIOTensorFlowEnumerateColumn(NSArray<id<TIOTensorFlowData>> *column, NSUInteger length, void (^block)(id<TIOTensorFlowData> obj, NSUInteger idx)) {
+    const NSUInteger count = column.count;
+    const NSUInteger runs = MIN(count, TIOTensorFlowColumnConcurrencyLimit.load());
+    
+    if ( runs <= 1 || count * length < TIOTensorFlowParallelColumnMinimumValues ) {
+        for ( NSUInteger idx = 0; idx < count; idx++ ) {
+            block(column[idx], idx);
+        }
+        return;
+    }
+    
+    const NSUInteger runLength = (count + runs - 1) / runs;
+    dispatch_queue_t queue = dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0);
+    
+    dispatch_apply(runs, queue, ^(size_t run) {
+        @autoreleasepool {
+            const NSUInteger start = run * runLength;
+            const NSUInteger end = MIN(start + runLength, count);
+            
+            for ( NSUInteger idx = start; idx < end; idx++ ) {
+                block(column[idx], idx);
+            }
+        }
+    });
+}
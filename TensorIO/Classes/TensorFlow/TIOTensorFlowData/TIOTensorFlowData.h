@@ -69,6 +69,18 @@ NS_ASSUME_NONNULL_BEGIN
 
 + (tensorflow::Tensor)tensorWithColumn:(NSArray<id<TIOTensorFlowData>>*)column description:(id<TIOLayerDescription>)description;
 
+/**
+ * Requests that a conforming object write an array of data of this type into an existing
+ * tensor, which lets a model reuse its input tensors rather than allocate new ones every run.
+ *
+ * @param tensor A tensor of the type and shape `tensorWithColumn:description:` would create
+ *  for the column.
+ * @param column An array of data of the type conforming to this protocol.
+ * @param description A description of the data this tensor expects.
+ */
+
++ (void)fillTensor:(tensorflow::Tensor &)tensor withColumn:(NSArray<id<TIOTensorFlowData>>*)column description:(id<TIOLayerDescription>)description;
+
 @end
 
 NS_ASSUME_NONNULL_END
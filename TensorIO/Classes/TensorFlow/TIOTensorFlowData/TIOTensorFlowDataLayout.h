@@ -0,0 +1,53 @@
+//
+//  TIOTensorFlowDataLayout.h
+//  TensorIO
+//
+//  Created by Phil Dow on 10/17/20.
+//  Copyright © 2020 doc.ai (http://doc.ai)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdocumentation"
+
+#include "tensorflow/core/framework/tensor.h"
+
+#pragma clang diagnostic pop
+
+NS_ASSUME_NONNULL_BEGIN
+
+@protocol TIOLayerDescription;
+
+/**
+ * Returns the type of the tensor the data converters fill for a layer. Quantized layers are
+ * always bytes, and unquantized vectors and scalars are floats unless they are 32 or 64 bit
+ * integers.
+ */
+
+tensorflow::DataType TIOTensorFlowDataTypeForDescription(id<TIOLayerDescription> description);
+
+/**
+ * Returns the shape of the tensor the data converters fill for a column of a layer's data. The
+ * batch dimension is only included if the layer is batched, and scalar layers otherwise have
+ * no dimensions.
+ *
+ * @param description The layer's description.
+ * @param batchSize The number of items in the column.
+ */
+
+tensorflow::TensorShape TIOTensorFlowShapeForDescription(id<TIOLayerDescription> description, NSUInteger batchSize);
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,93 @@
+//
+//  TIOTensorFlowDataLayout.mm
+//  TensorIO
+//
+//  Created by Phil Dow on 10/17/20.
+//  Copyright © 2020 doc.ai (http://doc.ai)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "TIOTensorFlowDataLayout.h"
+
+#include <vector>
+
+#import "TIOLayerDescription.h"
+#import "TIOPixelBufferLayerDescription.h"
+#import "TIOVectorLayerDescription.h"
+#import "TIOStringLayerDescription.h"
+#import "TIOScalarLayerDescription.h"
+
+tensorflow::DataType TIOTensorFlowDataTypeForDescription(id<TIOLayerDescription> description) {
+    TIODataType dtype = TIODataTypeFloat32;
+    
+    if ( [description isKindOfClass:TIOVectorLayerDescription.class] ) {
+        dtype = ((TIOVectorLayerDescription *)description).dtype;
+    } else if ( [description isKindOfClass:TIOPixelBufferLayerDescription.class] ) {
+        dtype = ((TIOPixelBufferLayerDescription *)description).dtype;
+    } else if ( [description isKindOfClass:TIOScalarLayerDescription.class] ) {
+        dtype = ((TIOScalarLayerDescription *)description).dtype;
+    } else if ( [description isKindOfClass:TIOStringLayerDescription.class] ) {
+        dtype = ((TIOStringLayerDescription *)description).dtype;
+        
+        // Strings keep their bytes, unlike unquantized vectors and scalars
+        
+        if ( dtype == TIODataTypeUInt8 ) {
+            return tensorflow::DT_UINT8;
+        }
+    }
+    
+    // Quantized layers hold uint8 values unless they are int8 layers
+    
+    if ( dtype == TIODataTypeInt8 ) {
+        return tensorflow::DT_INT8;
+    } else if ( description.isQuantized ) {
+        return tensorflow::DT_UINT8;
+    }
+    
+    switch ( dtype ) {
+    case TIODataTypeInt32:
+        return tensorflow::DT_INT32;
+    case TIODataTypeInt64:
+        return tensorflow::DT_INT64;
+    case TIODataTypeFloat16:
+        return tensorflow::DT_HALF;
+    default:
+        return tensorflow::DT_FLOAT;
+    }
+}
+
+tensorflow::TensorShape TIOTensorFlowShapeForDescription(id<TIOLayerDescription> description, NSUInteger batchSize) {
+    std::vector<tensorflow::int64> dims;
+    
+    if ( description.isBatched ) {
+        dims.push_back(batchSize);
+    }
+    
+    if ( [description isKindOfClass:TIOPixelBufferLayerDescription.class] ) {
+        TIOImageVolume volume = ((TIOPixelBufferLayerDescription *)description).imageVolume;
+        dims.push_back(volume.height);
+        dims.push_back(volume.width);
+        dims.push_back(volume.channels);
+    } else if ( ![description isKindOfClass:TIOScalarLayerDescription.class] ) {
+        
+        // Ignore any shape but batch if scalar layer
+        
+        for ( NSNumber *dim in description.shape.excludingBatch ) {
+            dims.push_back(dim.integerValue);
+        }
+    }
+    
+    tensorflow::gtl::ArraySlice<tensorflow::int64> dim_sizes(dims);
+    return tensorflow::TensorShape(dim_sizes);
+}
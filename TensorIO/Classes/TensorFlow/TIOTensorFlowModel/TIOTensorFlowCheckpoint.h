@@ -0,0 +1,73 @@
+//
+//  TIOTensorFlowCheckpoint.h
+//  TensorIO
+//
+//  Created by Phil Dow on 10/17/20.
+//  Copyright © 2020 doc.ai (http://doc.ai)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+#include <string>
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdocumentation"
+
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/protobuf/meta_graph.pb.h"
+#include "tensorflow/core/public/session.h"
+
+#pragma clang diagnostic pop
+
+#import "TIOTensorFlowRunPlan.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * A copy of the values of a model's saved variables, keyed as the model's saver would key them
+ * in a checkpoint. A snapshot is independent of the session and may be written after training
+ * has continued.
+ */
+
+struct TIOTensorFlowCheckpointSnapshot {
+    TensorNames keys;
+    Tensors tensors;
+};
+
+/**
+ * Copies the values of every variable the model's saver would save.
+ *
+ * The variables and their checkpoint keys are read from the inputs of the saver's `SaveV2` op.
+ * Savers that are sharded or that save partitioned variables are not supported and return an
+ * `Unimplemented` status, in which case the saver must be run instead.
+ *
+ * @param session The model's session.
+ * @param meta_graph_def The model's meta graph, which describes its saver.
+ * @param snapshot The snapshot to fill.
+ */
+
+tensorflow::Status TIOTensorFlowSnapshotVariables(tensorflow::Session *session, const tensorflow::MetaGraphDef &meta_graph_def, TIOTensorFlowCheckpointSnapshot &snapshot);
+
+/**
+ * Writes a snapshot as a checkpoint in the format the saver writes, i.e. a `prefix.index` file
+ * and a `prefix.data-00000-of-00001` file.
+ *
+ * @param snapshot The variable values to write.
+ * @param prefix The path prefix of the checkpoint files.
+ */
+
+tensorflow::Status TIOTensorFlowWriteCheckpoint(const TIOTensorFlowCheckpointSnapshot &snapshot, const std::string &prefix);
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,145 @@
+//
+//  TIOTensorFlowCheckpoint.mm
+//  TensorIO
+//
+//  Created by Phil Dow on 10/17/20.
+//  Copyright © 2020 doc.ai (http://doc.ai)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "TIOTensorFlowCheckpoint.h"
+
+#include <unordered_map>
+#include <vector>
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdocumentation"
+
+#include "tensorflow/core/framework/tensor_util.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/util/tensor_bundle/tensor_bundle.h"
+
+#pragma clang diagnostic pop
+
+typedef std::unordered_map<std::string, const tensorflow::NodeDef*> TIOTensorFlowNodeMap;
+
+/**
+ * Reads the value of a `Const` node, given the name of one of its outputs.
+ */
+
+static tensorflow::Status TIOTensorFlowConstantValue(const TIOTensorFlowNodeMap &nodes, const std::string &output, tensorflow::Tensor &value) {
+    const std::string name = output.substr(0, output.find(':'));
+    auto node = nodes.find(name);
+    
+    if ( node == nodes.end() || node->second->op() != "Const" ) {
+        return tensorflow::errors::InvalidArgument("Expected a constant input to the saver: ", name);
+    }
+    
+    auto attr = node->second->attr().find("value");
+    
+    if ( attr == node->second->attr().end() || !value.FromProto(attr->second.tensor()) ) {
+        return tensorflow::errors::InvalidArgument("Unable to read the value of the constant: ", name);
+    }
+    
+    return tensorflow::Status::OK();
+}
+
+tensorflow::Status TIOTensorFlowSnapshotVariables(tensorflow::Session *session, const tensorflow::MetaGraphDef &meta_graph_def, TIOTensorFlowCheckpointSnapshot &snapshot) {
+    const tensorflow::SaverDef &saver_def = meta_graph_def.saver_def();
+    const std::string &save_tensor_name = saver_def.save_tensor_name();
+    const size_t scope_end = save_tensor_name.rfind('/');
+    
+    if ( saver_def.sharded() || scope_end == std::string::npos ) {
+        return tensorflow::errors::Unimplemented("Only an unsharded saver can be snapshotted");
+    }
+    
+    // The save op lives in the same name scope as the saver's save tensor
+    
+    const std::string save_op_name = save_tensor_name.substr(0, scope_end + 1) + "SaveV2";
+    TIOTensorFlowNodeMap nodes;
+    
+    for ( const tensorflow::NodeDef &node : meta_graph_def.graph_def().node() ) {
+        nodes[node.name()] = &node;
+    }
+    
+    auto save_op = nodes.find(save_op_name);
+    
+    if ( save_op == nodes.end() || save_op->second->op() != "SaveV2" ) {
+        return tensorflow::errors::Unimplemented("The saver has no SaveV2 op: ", save_op_name);
+    }
+    
+    // SaveV2 takes a path prefix, the checkpoint keys, their shapes and slices, and then the
+    // tensors to save, followed by any control inputs
+    
+    std::vector<std::string> inputs;
+    
+    for ( const std::string &input : save_op->second->input() ) {
+        if ( !input.empty() && input[0] != '^' ) {
+            inputs.push_back(input);
+        }
+    }
+    
+    if ( inputs.size() < 3 ) {
+        return tensorflow::errors::InvalidArgument("The saver's SaveV2 op is missing inputs");
+    }
+    
+    tensorflow::Tensor keys;
+    tensorflow::Tensor shapes_and_slices;
+    
+    TF_RETURN_IF_ERROR(TIOTensorFlowConstantValue(nodes, inputs[1], keys));
+    TF_RETURN_IF_ERROR(TIOTensorFlowConstantValue(nodes, inputs[2], shapes_and_slices));
+    
+    const size_t count = inputs.size() - 3;
+    
+    if ( (size_t)keys.NumElements() != count || (size_t)shapes_and_slices.NumElements() != count ) {
+        return tensorflow::errors::InvalidArgument("The saver's keys do not match its tensors");
+    }
+    
+    for ( size_t i = 0; i < count; i++ ) {
+        if ( !shapes_and_slices.flat<std::string>()(i).empty() ) {
+            return tensorflow::errors::Unimplemented("Partitioned variables cannot be snapshotted");
+        }
+    }
+    
+    // Fetch every variable in a single run and copy the values, which may share their buffers
+    // with variables that training goes on to update in place
+    
+    const TensorNames fetches(inputs.begin() + 3, inputs.end());
+    Tensors values;
+    
+    TF_RETURN_IF_ERROR(session->Run({}, fetches, {}, &values));
+    
+    snapshot.keys.clear();
+    snapshot.tensors.clear();
+    snapshot.keys.reserve(count);
+    snapshot.tensors.reserve(count);
+    
+    for ( size_t i = 0; i < count; i++ ) {
+        snapshot.keys.push_back(keys.flat<std::string>()(i));
+        snapshot.tensors.push_back(tensorflow::tensor::DeepCopy(values[i]));
+    }
+    
+    return tensorflow::Status::OK();
+}
+
+tensorflow::Status TIOTensorFlowWriteCheckpoint(const TIOTensorFlowCheckpointSnapshot &snapshot, const std::string &prefix) {
+    tensorflow::BundleWriter writer(tensorflow::Env::Default(), prefix);
+    
+    for ( size_t i = 0; i < snapshot.keys.size(); i++ ) {
+        TF_RETURN_IF_ERROR(writer.Add(snapshot.keys[i], snapshot.tensors[i]));
+    }
+    
+    return writer.Finish();
+}
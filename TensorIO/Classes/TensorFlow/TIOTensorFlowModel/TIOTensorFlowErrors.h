@@ -67,4 +67,23 @@ extern NSError * const TIOTensorFlowModelSessionInferenceError;
  
 extern NSError * const TIOTensorFlowModelSessionTrainError;
 
+/**
+ * Occurs when the session is unable to create a callable for the model's inputs and outputs.
+ */
+
+extern NSError * const TIOTensorFlowModelSessionCallableError;
+
+/**
+ * Occurs when an asynchronous export is requested while another export is still being written.
+ */
+
+extern NSError * const TIOTensorFlowModelExportInProgressError;
+
+/**
+ * Occurs when gradients are accumulated or applied on a model whose model.json does not
+ * declare accumulate and apply ops.
+ */
+
+extern NSError * const TIOTensorFlowModelAccumulationUnsupportedError;
+
 NS_ASSUME_NONNULL_END
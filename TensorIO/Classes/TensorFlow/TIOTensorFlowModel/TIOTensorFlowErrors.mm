@@ -47,3 +47,15 @@ NSError * const TIOTensorFlowModelSessionInferenceError = [NSError errorWithDoma
 NSError * const TIOTensorFlowModelSessionTrainError = [NSError errorWithDomain:@"ai.doc.tensorio" code:107 userInfo:@{
     NSLocalizedDescriptionKey: @"TensorFlow train sesion run error"
 }];
+
+NSError * const TIOTensorFlowModelSessionCallableError = [NSError errorWithDomain:@"ai.doc.tensorio" code:108 userInfo:@{
+    NSLocalizedDescriptionKey: @"TensorFlow session callable could not be created"
+}];
+
+NSError * const TIOTensorFlowModelExportInProgressError = [NSError errorWithDomain:@"ai.doc.tensorio" code:109 userInfo:@{
+    NSLocalizedDescriptionKey: @"An export is already in progress"
+}];
+
+NSError * const TIOTensorFlowModelAccumulationUnsupportedError = [NSError errorWithDomain:@"ai.doc.tensorio" code:110 userInfo:@{
+    NSLocalizedDescriptionKey: @"The model does not declare ops to accumulate and apply gradients"
+}];
@@ -30,6 +30,23 @@ NS_ASSUME_NONNULL_BEGIN
 
 @class TIOModelIO;
 
+/**
+ * Describes how a model has reused the tensors it feeds to its session.
+ */
+
+typedef struct TIOTensorFlowTensorPoolStats {
+    NSUInteger allocations;     // The number of input and placeholder tensors allocated
+    NSUInteger reuses;          // The number of times a tensor was refilled rather than allocated
+    NSUInteger unchanged;       // The number of times a placeholder tensor was fed as is
+} TIOTensorFlowTensorPoolStats;
+
+/**
+ * Called when an asynchronous export finishes, with the size in bytes of each exported file
+ * keyed by file name, or with an error if the export failed.
+ */
+
+typedef void (^TIOTensorFlowModelExportCompletionHandler)(NSDictionary<NSString*,NSNumber*> * _Nullable fileSizes, NSError * _Nullable error);
+
 /**
  * An Objective-C wrapper around TensorFlow models that provides a unified interface to the
  * input and output layers of the underlying model. These models are capable of
@@ -56,6 +73,91 @@ NS_ASSUME_NONNULL_BEGIN
 @property (readonly) BOOL loaded;
 @property (readonly) TIOModelIO *io;
 
+// MARK: - Warmup and Latency
+
+/**
+ * The number of times `load:` invokes the model on zero-filled inputs before returning, so that
+ * the first real inference does not pay for lazy initialization. Defaults to 0, no warmup.
+ */
+
+@property NSUInteger warmupIterations;
+
+/**
+ * The number of milliseconds the most recent `load:` spent loading the model, excluding warmup.
+ */
+
+@property (readonly) double loadLatency;
+
+/**
+ * The number of milliseconds the most recent `load:` spent warming the model up.
+ */
+
+@property (readonly) double warmupLatency;
+
+/**
+ * The number of milliseconds the first invocation of the model after it was loaded took. This is
+ * the first warmup invocation when `warmupIterations` is non-zero, and otherwise the first call
+ * to run the model. 0 until the model has been invoked.
+ */
+
+@property (readonly) double coldInferenceLatency;
+
+/**
+ * The number of milliseconds the second invocation of the model after it was loaded took, which
+ * approximates the latency of an inference once the model is warm. 0 until the model has been
+ * invoked twice.
+ */
+
+@property (readonly) double warmInferenceLatency;
+
+// MARK: - Training Options
+
+/**
+ * When `YES` a training step runs the training ops and fetches the model's outputs in a single
+ * session run, rather than running the ops and then running the graph a second time for the
+ * outputs. Fusing the step saves a forward pass, but the fused outputs are computed from the
+ * weights before the step's update is applied, so a fused loss lags the unfused loss by one step.
+ * Defaults to `NO`.
+ */
+
+@property BOOL fusesTrainingStep;
+
+// MARK: - Session Options
+
+/**
+ * The options used to create the model's session, e.g. its thread pool sizes and graph
+ * optimizations. Defaults to the session options in the model's `options`, parsed from the
+ * model.json file. Setting this property overrides them, and takes effect the next time the
+ * model is loaded.
+ */
+
+@property (null_resettable) TIOModelSessionOptions *sessionOptions;
+
+// MARK: - Tensor Reuse
+
+/**
+ * Statistics describing how often the model's input and placeholder tensors were reused since
+ * it was loaded.
+ *
+ * A loaded model keeps a tensor for every input and placeholder layer and batch size it has
+ * been run with, and writes new inputs into the existing tensor, so that steady state inference
+ * and training do not allocate input tensors. Placeholder tensors are only rewritten when the
+ * placeholder's value changes.
+ */
+
+@property (readonly) TIOTensorFlowTensorPoolStats tensorPoolStats;
+
+// MARK: - Input Preparation
+
+/**
+ * The maximum number of batch items prepared at the same time when a column of inputs is
+ * written to a tensor, e.g. images which are scaled, cropped, and copied. Items are prepared on
+ * the shared global queue and write to disjoint slices of the tensor. Shared by every TensorFlow
+ * model. Defaults to the number of active processors, and 1 prepares items serially.
+ */
+
+@property (class) NSUInteger inputPreparationConcurrency;
+
 // MARK: - Initialization
 
 /**
@@ -131,6 +233,21 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (id<TIOData>)runOn:(id<TIOData>)input error:(NSError* _Nullable *)error;
 
+/**
+ * Performs inference on the provided input and returns only the requested outputs. Outputs
+ * that are not requested are neither fetched nor converted to `TIOData`, which avoids the cost
+ * of large auxiliary outputs a caller does not need. Only the requested outputs are fetched from
+ * the session, so the parts of the graph that feed unrequested outputs are not run.
+ *
+ * @param input Any class conforming to `TIOData`.
+ * @param outputs The names of the output layers to return, which must be a subset of the
+ *  model's output layer names.
+ * @param error Set if an error occurred during inference. May be nil.
+ * @return TIOData A dictionary containing only the requested outputs.
+ */
+
+- (id<TIOData>)runOn:(id<TIOData>)input outputs:(NSArray<NSString*> *)outputs error:(NSError* _Nullable *)error;
+
 /**
  * Performs inference on the provided input and returns the results.
  *
@@ -149,9 +266,14 @@ NS_ASSUME_NONNULL_BEGIN
  * batch items, effectively rows of data, each of which contains feature values
  * as columns. See `TIOBatch` for more information.
  *
+ * A batch of more than one item is run with a single session run, which requires
+ * that every input layer be batched.
+ *
  * @param batch A batch of input data.
  * @param error Set if an error occurred during inference. May be nil.
- * @return TIOData The results of performing inference on input.
+ * @return TIOData The results of performing inference on input. For a batch of
+ *  one item, a dictionary of outputs. For a larger batch, an array with one such
+ *  dictionary per item.
  */
 
 - (id<TIOData>)run:(TIOBatch *)batch error:(NSError * _Nullable *)error;
@@ -162,15 +284,31 @@ NS_ASSUME_NONNULL_BEGIN
  * batch items, effectively rows of data, each of which contains feature values
  * as columns. See `TIOBatch` for more information.
  *
+ * A batch of more than one item is run with a single session run, which requires
+ * that every input layer be batched. Placeholders are shared by every item.
+ *
  * @param batch A batch of input data.
  * @param placeholders A dictionary of `TIOData` conforming placeholder values,
  *  which will be matched to placeholder layers in the model. May be nil.
  * @param error Set if an error occurred during inference. May be nil.
- * @return TIOData The results of performing inference on input.
+ * @return TIOData The results of performing inference on input. For a batch of
+ *  one item, a dictionary of outputs. For a larger batch, an array with one such
+ *  dictionary per item.
  */
 
 - (id<TIOData>)run:(TIOBatch *)batch placeholders:(nullable NSDictionary<NSString*,id<TIOData>> *)placeholders error:(NSError * _Nullable *)error;
 
+/**
+ * Performs inference on the provided input asynchronously. Inputs are run one at a time, in the
+ * order they are submitted, on a private serial queue, which is also where the completion
+ * handler is called.
+ *
+ * @param input Any class conforming to `TIOData`.
+ * @param completion Called with the results of performing inference on input, or with an error.
+ */
+
+- (void)runOn:(id<TIOData>)input completion:(TIOModelCompletionHandler)completion;
+
 /**
  * Deprecated. Use `runOn:error:` or one of the other similar methods instead.
  */
@@ -218,6 +356,82 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (id<TIOData>)train:(TIOBatch *)batch placeholders:(nullable NSDictionary<NSString*,id<TIOData>> *)placeholders error:(NSError * _Nullable *)error;
 
+/**
+ * Calls the underlying training op with a single batch and a set of placeholder
+ * values, optionally skipping the work of fetching the model's outputs, which
+ * are usually its loss.
+ *
+ * Trainers that only report the loss periodically use this method to avoid
+ * fetching it on every step.
+ *
+ * @param batch A batch of input data.
+ * @param placeholders A dictionary of `TIOData` conforming placeholder values,
+ *  which will be matched to placeholder layers in the model. May be nil.
+ * @param fetchOutputs `YES` to fetch and return the model's outputs, `NO` to
+ *  only run the training op.
+ * @param error Set if an error occurred during inference. May be nil.
+ * @return TIOData The results of training, or an empty dictionary if an error
+ *  occurs or no outputs were fetched.
+ */
+
+- (id<TIOData>)train:(TIOBatch *)batch placeholders:(nullable NSDictionary<NSString*,id<TIOData>> *)placeholders fetchOutputs:(BOOL)fetchOutputs error:(NSError * _Nullable *)error;
+
+/**
+ * `YES` if the model's model.json declares `accumulate_ops` and `apply_ops` in its train
+ * field, `NO` otherwise.
+ */
+
+@property (readonly) BOOL accumulatesGradients;
+
+/**
+ * Runs the accumulate ops with a single micro-batch, adding its gradients to the accumulators
+ * the graph defines without updating the model's weights.
+ *
+ * Because the weights do not change, the outputs are fetched in the same session run and are
+ * exactly those of the micro-batch. Any averaging of the accumulated gradients is up to the
+ * graph's apply ops.
+ *
+ * @param batch A micro-batch of input data.
+ * @param placeholders A dictionary of `TIOData` conforming placeholder values,
+ *  which will be matched to placeholder layers in the model. May be nil.
+ * @param fetchOutputs `YES` to fetch and return the model's outputs, `NO` to
+ *  only run the accumulate ops.
+ * @param error Set if an error occurred during accumulation. May be nil.
+ * @return TIOData The model's outputs for the micro-batch, or an empty
+ *  dictionary if an error occurs or no outputs were fetched.
+ */
+
+- (id<TIOData>)accumulate:(TIOBatch *)batch placeholders:(nullable NSDictionary<NSString*,id<TIOData>> *)placeholders fetchOutputs:(BOOL)fetchOutputs error:(NSError * _Nullable *)error;
+
+/**
+ * Runs the apply ops, which update the weights with the accumulated gradients and reset the
+ * accumulators. Only placeholders are fed.
+ *
+ * @param placeholders A dictionary of `TIOData` conforming placeholder values,
+ *  which will be matched to placeholder layers in the model. May be nil.
+ * @param error Set if an error occurred while applying the gradients. May be nil.
+ * @return BOOL `YES` if the gradients were applied, `NO` otherwise.
+ */
+
+- (BOOL)applyAccumulatedGradients:(nullable NSDictionary<NSString*,id<TIOData>> *)placeholders error:(NSError * _Nullable *)error;
+
+/**
+ * Writes a batch's input tensors ahead of the training step and returns a batch that carries
+ * them, which the train and accumulate methods then feed instead of converting the batch's
+ * values again. Placeholders are still converted when the batch is trained on.
+ *
+ * The returned batch holds its own tensors, so a prepared batch can be written while another
+ * is being trained on. Its tensors are only fed while the model stays loaded, and the batch's
+ * values are converted as usual after the model is unloaded.
+ *
+ * @param batch A batch of input data.
+ * @param error Set if the model could not be loaded. May be nil.
+ * @return TIOBatch A batch with the same items as `batch` that carries its input tensors, or
+ *  `nil` if an error occurs.
+ */
+
+- (nullable TIOBatch *)prepareBatch:(TIOBatch *)batch error:(NSError * _Nullable *)error;
+
 /**
  * Deprecated. `Use train:error:` or train:placeholders:error:` instead.
  */
@@ -234,6 +448,9 @@ NS_ASSUME_NONNULL_BEGIN
  * checkpoint.index
  * checkpoint.data-XXXXX-of-YYYYY, e.g. checkpoint.data-00000-of-00001
  *
+ * The model is loaded if it has not been. An export requested while another export is in
+ * flight fails with `TIOTensorFlowModelExportInProgressError`.
+ *
  * @param fileURL File URL to the directory in which the export will be saved
  * @param error Set to any error that occurs during the export, otherwise `nil`
  *
@@ -242,6 +459,27 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (BOOL)exportTo:(NSURL *)fileURL error:(NSError * _Nullable *)error;
 
+/**
+ * Exports the results of training to the specified directory without waiting for the
+ * checkpoint to be written. The directory must already exist, and the same files are
+ * exported as with `exportTo:error:`.
+ *
+ * The values of the model's variables are copied before this method returns, so training may
+ * continue immediately, and the copy is then written on a background queue. Only one export may
+ * be in flight at a time, and a request made while another export is being written fails with
+ * `TIOTensorFlowModelExportInProgressError`.
+ *
+ * Copying the variables briefly doubles the memory they use. Models whose saver is sharded,
+ * saves partitioned variables, or is otherwise not understood cannot be copied and are exported
+ * before this method returns.
+ *
+ * @param fileURL File URL to the directory in which the export will be saved
+ * @param completion Called on a background queue with the size of each exported file, or with
+ *  any error that occurs during the export
+ */
+
+- (void)exportTo:(NSURL *)fileURL completion:(TIOTensorFlowModelExportCompletionHandler)completion;
+
 @end
 
 NS_ASSUME_NONNULL_END
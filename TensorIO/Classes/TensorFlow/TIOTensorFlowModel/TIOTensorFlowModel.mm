@@ -21,10 +21,12 @@
 //  TODO: Overloading model.file in model.json to point to predict directory, must also point to train and eval dirs
 //  TODO: Duplicating input/output parsing but may need backend specific parsing as well
 //  TODO: Duplicated TensorType defines, should be defined elsewhere
-//  TODO: Typedefs are used elsewhere, define in shared file
 
 #import "TIOTensorFlowModel.h"
 
+#include <atomic>
+#include <map>
+#include <memory>
 #include <utility>
 #include <string>
 #include <unordered_set>
@@ -35,10 +37,13 @@
 
 #include "tensorflow/cc/saved_model/loader.h"
 #include "tensorflow/cc/saved_model/tag_constants.h"
+#include "tensorflow/core/framework/tensor_util.h"
 #include "tensorflow/core/public/session.h"
 
 #pragma clang diagnostic pop
 
+#import <os/lock.h>
+
 #import "TIOModelBundle.h"
 #import "TIOModelBundle+TensorFlowModel.h"
 #import "TIOLayerInterface.h"
@@ -55,17 +60,103 @@
 #import "TIOTensorFlowErrors.h"
 #import "TIOModelModes.h"
 #import "TIOModelIO.h"
+#import "TIOTensorFlowRunPlan.h"
+#import "TIOTensorFlowTensorPool.h"
+#import "TIOTensorFlowCheckpoint.h"
+#import "TIOTensorFlowColumnEnumeration.h"
+#import "TIOMeasurable.h"
+#import "TIOObjcDefer.h"
+
+/**
+ * A batch whose input tensors were written ahead of the training step. It reads as the batch
+ * it was prepared from, and its tensors are fed only by the tensor pool that wrote them.
+ */
 
-typedef std::pair<std::string, tensorflow::Tensor> NamedTensor;
-typedef std::vector<NamedTensor> NamedTensors;
-typedef std::vector<tensorflow::Tensor> Tensors;
-typedef std::vector<std::string> TensorNames;
+@interface TIOTensorFlowPreparedBatch : TIOBatch
+
+- (instancetype)initWithBatch:(TIOBatch *)batch tensorPool:(TIOTensorFlowTensorPool *)tensorPool tensors:(const Tensors &)tensors fed:(const std::vector<bool> &)fed;
+
+/**
+ * The pool of the loaded model that wrote the tensors.
+ */
+
+@property (readonly) TIOTensorFlowTensorPool *tensorPool;
+
+/**
+ * Appends the prepared input tensors and their fed flags.
+ */
+
+- (void)appendTensors:(Tensors &)tensors fed:(std::vector<bool> &)fed;
+
+@end
+
+@implementation TIOTensorFlowPreparedBatch {
+    TIOBatch *_batch;
+    Tensors _tensors;
+    std::vector<bool> _fed;
+}
+
+- (instancetype)initWithBatch:(TIOBatch *)batch tensorPool:(TIOTensorFlowTensorPool *)tensorPool tensors:(const Tensors &)tensors fed:(const std::vector<bool> &)fed {
+    if ((self=[super initWithKeys:batch.keys])) {
+        _batch = batch;
+        _tensorPool = tensorPool;
+        _tensors = tensors;
+        _fed = fed;
+    }
+    return self;
+}
+
+- (void)appendTensors:(Tensors &)tensors fed:(std::vector<bool> &)fed {
+    tensors.insert(tensors.end(), _tensors.begin(), _tensors.end());
+    fed.insert(fed.end(), _fed.begin(), _fed.end());
+}
+
+- (NSUInteger)count {
+    return _batch.count;
+}
+
+- (NSArray<NSString*> *)keys {
+    return _batch.keys;
+}
+
+- (void)addItem:(TIOBatchItem *)item {
+    NSAssert(NO, @"A prepared batch cannot be changed. Add items to the batch before preparing it");
+}
+
+- (TIOBatchItem *)itemAtIndex:(NSUInteger)index {
+    return [_batch itemAtIndex:index];
+}
+
+- (NSArray<id<TIOData>>*)valuesForKey:(NSString *)key {
+    return [_batch valuesForKey:key];
+}
+
+@end
+
+// MARK: -
 
 @implementation TIOTensorFlowModel {
     tensorflow::SavedModelBundle _saved_model_bundle;
+    TIOTensorFlowRunPlan _plan;
+    dispatch_queue_t _runQueue;
+    std::atomic<NSUInteger> _invocations;
+    
+    // Callables are created on demand for each combination of feeds and fetches, and those
+    // needed to predict and train are created when the model loads
+    std::map<TIOTensorFlowCallableSignature, tensorflow::Session::CallableHandle> _callables;
+    os_unfair_lock _callablesLock;
+    
+    // Input and placeholder tensors are reused from run to run while the model is loaded
+    TIOTensorFlowTensorPool *_tensorPool;
     
     // Training Support
     NSArray<NSString*> *_trainingOps;
+    NSArray<NSString*> *_accumulateOps;
+    NSArray<NSString*> *_applyOps;
+    
+    // Checkpoints are written on a background queue, one at a time
+    dispatch_queue_t _exportQueue;
+    std::atomic<bool> _exporting;
 }
 
 + (nullable instancetype)modelWithBundleAtPath:(NSString *)path {
@@ -95,6 +186,11 @@ typedef std::vector<std::string> TensorNames;
         _modes = bundle.modes;
         _io = bundle.io;
         
+        _runQueue = dispatch_queue_create("ai.doc.tensorio.tensorflow.run", DISPATCH_QUEUE_SERIAL);
+        _callablesLock = OS_UNFAIR_LOCK_INIT;
+        _exportQueue = dispatch_queue_create("ai.doc.tensorio.tensorflow.export", DISPATCH_QUEUE_SERIAL);
+        _exporting = false;
+        
         // Training parsing
         
         if ( ![self _parseTrainingDict:bundle.info[@"train"]] ) {
@@ -135,6 +231,18 @@ typedef std::vector<std::string> TensorNames;
     
     _trainingOps = train[@"ops"];
     
+    // Gradient accumulation needs both the ops that accumulate and the ops that apply
+    
+    if ( (train[@"accumulate_ops"] == nil) != (train[@"apply_ops"] == nil) ) {
+        NSLog(@"Model with identifier %@ must declare both train.accumulate_ops "
+                "and train.apply_ops in model.json to accumulate gradients",
+                _identifier);
+        return NO;
+    }
+    
+    _accumulateOps = train[@"accumulate_ops"];
+    _applyOps = train[@"apply_ops"];
+    
     return YES;
 }
 
@@ -153,6 +261,23 @@ typedef std::vector<std::string> TensorNames;
         return YES;
     }
     
+    __block BOOL loaded;
+    
+    _warmupLatency = 0;
+    tio_measuring_latency(&_loadLatency, ^{
+        loaded = [self _load:error];
+    });
+    
+    if ( loaded && self.warmupIterations > 0 ) {
+        tio_measuring_latency(&_warmupLatency, ^{
+            [self _warmup:self.warmupIterations];
+        });
+    }
+    
+    return loaded;
+}
+
+- (BOOL)_load:(NSError * _Nullable *)error {
     std::string model_dir = self.bundle.modelPredictPath.UTF8String;
     std::unordered_set<std::string> tags;
     
@@ -168,7 +293,7 @@ typedef std::vector<std::string> TensorNames;
         return NO;
     }
     
-    tensorflow::SessionOptions session_opts;
+    tensorflow::SessionOptions session_opts = [self _tensorFlowSessionOptions];
     tensorflow::RunOptions run_opts;
     tensorflow::Status status;
     
@@ -182,10 +307,101 @@ typedef std::vector<std::string> TensorNames;
         return NO;
     }
     
+    // Resolve everything the hot path needs about each layer once
+    
+    TIOTensorFlowBuildRunPlan(self.io, _trainingOps, _accumulateOps, _applyOps, _plan);
+    
+    if ( ![self _prepareCallables:error] ) {
+        [self _releaseCallables];
+        TF_CHECK_OK(_saved_model_bundle.session.get()->Close());
+        _plan = TIOTensorFlowRunPlan();
+        return NO;
+    }
+    
+    _tensorPool = [[TIOTensorFlowTensorPool alloc] init];
+    
+    _invocations = 0;
+    _coldInferenceLatency = 0;
+    _warmInferenceLatency = 0;
+    
     _loaded = YES;
     return YES;
 }
 
+/**
+ * Maps the model's session options onto the TensorFlow `ConfigProto`, leaving unset values at
+ * their TensorFlow defaults.
+ */
+
+- (tensorflow::SessionOptions)_tensorFlowSessionOptions {
+    TIOModelSessionOptions *options = self.sessionOptions;
+    tensorflow::SessionOptions session_opts;
+    tensorflow::ConfigProto &config = session_opts.config;
+    
+    if ( options.intraOpThreads != 0 ) {
+        config.set_intra_op_parallelism_threads((int32_t)options.intraOpThreads);
+    }
+    
+    if ( options.interOpThreads != 0 ) {
+        config.set_inter_op_parallelism_threads((int32_t)options.interOpThreads);
+    }
+    
+    tensorflow::OptimizerOptions *optimizer = config.mutable_graph_options()->mutable_optimizer_options();
+    
+    switch ( options.optimizerLevel ) {
+    case TIOModelOptimizerLevelL0:
+        optimizer->set_opt_level(tensorflow::OptimizerOptions::L0);
+        break;
+    case TIOModelOptimizerLevelL1:
+        optimizer->set_opt_level(tensorflow::OptimizerOptions::L1);
+        break;
+    case TIOModelOptimizerLevelDefault:
+        break;
+    }
+    
+    // Constant folding is applied both by the classic graph optimizer and by grappler
+    
+    if ( options.constantFolding != nil ) {
+        BOOL folds = options.constantFolding.boolValue;
+        optimizer->set_do_constant_folding(folds);
+        config.mutable_graph_options()->mutable_rewrite_options()->set_constant_folding(folds
+            ? tensorflow::RewriterConfig::ON
+            : tensorflow::RewriterConfig::OFF);
+    }
+    
+    return session_opts;
+}
+
+/**
+ * Runs the session on zero-filled inputs and placeholders, which lets it prune and optimize
+ * the graph and allocate its buffers. Failures are logged but do not fail the load.
+ */
+
+- (void)_warmup:(NSUInteger)iterations {
+    Tensors feeds;
+    
+    for ( const TIOTensorFlowLayerPlan &layer : _plan.inputs ) {
+        feeds.push_back(TIOTensorFlowZeroTensorForLayer(layer));
+    }
+    
+    for ( const TIOTensorFlowLayerPlan &layer : _plan.placeholders ) {
+        feeds.push_back(TIOTensorFlowZeroTensorForLayer(layer));
+    }
+    
+    const std::vector<bool> fed(feeds.size(), true);
+    const TIOTensorFlowCallableSignature signature = [self _signatureFeeding:fed fetching:[self _outputIndexesForNames:nil] targets:TIOTensorFlowTargets::None];
+    
+    for ( NSUInteger i = 0; i < iterations; i++ ) {
+        NSError *inferenceError;
+        [self _runInference:feeds signature:signature error:&inferenceError];
+        
+        if ( inferenceError != nil ) {
+            NSLog(@"Unable to warm up model %@, error: %@", self.identifier, inferenceError);
+            return;
+        }
+    }
+}
+
 /**
  * Unloads the model and sets loaded=NO
  */
@@ -195,13 +411,155 @@ typedef std::vector<std::string> TensorNames;
         return;
     }
     
+    [self _releaseCallables];
     TF_CHECK_OK(_saved_model_bundle.session.get()->Close());
+    _plan = TIOTensorFlowRunPlan();
+    _tensorPool = nil;
     _loaded = NO;
 }
 
+// MARK: - Tensor Reuse
+
+- (TIOTensorFlowTensorPoolStats)tensorPoolStats {
+    TIOTensorFlowTensorPool *tensorPool = _tensorPool;
+    
+    if ( tensorPool == nil ) {
+        return {0};
+    }
+    
+    return tensorPool.stats;
+}
+
+// MARK: - Input Preparation
+
++ (NSUInteger)inputPreparationConcurrency {
+    return TIOTensorFlowColumnConcurrency();
+}
+
++ (void)setInputPreparationConcurrency:(NSUInteger)inputPreparationConcurrency {
+    TIOTensorFlowSetColumnConcurrency(inputPreparationConcurrency);
+}
+
+// MARK: - Session Options
+
+@synthesize sessionOptions = _sessionOptions;
+
+- (TIOModelSessionOptions *)sessionOptions {
+    return _sessionOptions != nil
+        ? _sessionOptions
+        : self.options.session;
+}
+
+- (void)setSessionOptions:(nullable TIOModelSessionOptions *)sessionOptions {
+    _sessionOptions = sessionOptions;
+}
+
+// MARK: - Callables
+
+/**
+ * Creates the callables used to predict and, for trainable models, to train, accumulate
+ * gradients, and fetch the loss, which feed every input and fetch every output.
+ */
+
+- (BOOL)_prepareCallables:(NSError * _Nullable *)error {
+    std::vector<bool> fed(_plan.inputs.size() + _plan.placeholders.size(), false);
+    std::fill(fed.begin(), fed.begin() + _plan.inputs.size(), true);
+    
+    const std::vector<size_t> all = [self _outputIndexesForNames:nil];
+    tensorflow::Session::CallableHandle handle;
+    
+    if ( ![self _callable:&handle signature:[self _signatureFeeding:fed fetching:all targets:TIOTensorFlowTargets::None] error:error] ) {
+        return NO;
+    }
+    
+    if ( _modes.trains && !_plan.training_names.empty() ) {
+        if ( ![self _callable:&handle signature:[self _signatureFeeding:fed fetching:std::vector<size_t>() targets:TIOTensorFlowTargets::Train] error:error] ) {
+            return NO;
+        }
+        
+        if ( self.fusesTrainingStep && ![self _callable:&handle signature:[self _signatureFeeding:fed fetching:all targets:TIOTensorFlowTargets::Train] error:error] ) {
+            return NO;
+        }
+    }
+    
+    if ( _modes.trains && self.accumulatesGradients ) {
+        if ( ![self _callable:&handle signature:[self _signatureFeeding:fed fetching:std::vector<size_t>() targets:TIOTensorFlowTargets::Accumulate] error:error] ) {
+            return NO;
+        }
+    }
+    
+    return YES;
+}
+
+/**
+ * Returns the signature of a callable that feeds the flagged inputs and placeholders, fetches
+ * the outputs at `indexes`, and runs the planned ops selected by `targets`.
+ */
+
+- (TIOTensorFlowCallableSignature)_signatureFeeding:(const std::vector<bool> &)fed fetching:(const std::vector<size_t> &)indexes targets:(TIOTensorFlowTargets)targets {
+    TIOTensorFlowCallableSignature signature;
+    
+    signature.feeds = fed;
+    signature.fetches = std::vector<bool>(_plan.outputs.size(), false);
+    signature.targets = targets;
+    
+    for ( size_t index : indexes ) {
+        signature.fetches[index] = true;
+    }
+    
+    return signature;
+}
+
+/**
+ * Looks up the callable with a signature, creating it the first time it is needed.
+ */
+
+- (BOOL)_callable:(tensorflow::Session::CallableHandle *)handle signature:(const TIOTensorFlowCallableSignature &)signature error:(NSError * _Nullable *)error {
+    os_unfair_lock_lock(&_callablesLock);
+    
+    tio_defer_block {
+        os_unfair_lock_unlock(&self->_callablesLock);
+    };
+    
+    const auto found = _callables.find(signature);
+    
+    if ( found != _callables.end() ) {
+        *handle = found->second;
+        return YES;
+    }
+    
+    tensorflow::Session *session = _saved_model_bundle.session.get();
+    tensorflow::Status status = session->MakeCallable(TIOTensorFlowCallableOptions(_plan, signature), handle);
+    
+    if ( status != tensorflow::Status::OK() ) {
+        NSLog(@"Unable to make callable, status: %@", [NSString stringWithUTF8String:status.ToString().c_str()]);
+        if (error) {
+            *error = TIOTensorFlowModelSessionCallableError;
+        }
+        return NO;
+    }
+    
+    _callables[signature] = *handle;
+    return YES;
+}
+
+- (void)_releaseCallables {
+    os_unfair_lock_lock(&_callablesLock);
+    
+    tensorflow::Session *session = _saved_model_bundle.session.get();
+    
+    for ( const auto &callable : _callables ) {
+        session->ReleaseCallable(callable.second);
+    }
+    
+    _callables.clear();
+    
+    os_unfair_lock_unlock(&_callablesLock);
+}
+
 // MARK: - Perform Inference
 
-// All run method eventually call run:placeholders:error:
+// All run method eventually call _run:placeholders:outputs:error:
 
 - (id<TIOData>)runOn:(id<TIOData>)input {
     return [self runOn:input error:nil];
@@ -211,9 +569,20 @@ typedef std::vector<std::string> TensorNames;
     return [self runOn:input placeholders:nil error:error];
 }
 
+- (id<TIOData>)runOn:(id<TIOData>)input outputs:(NSArray<NSString*> *)outputs error:(NSError * _Nullable *)error {
+    NSAssert([[NSSet setWithArray:outputs] isSubsetOfSet:[NSSet setWithArray:self.io.outputs.keys]], @"Requested outputs are not output layer names");
+    return [self _run:[self _batchForInput:input] placeholders:nil outputs:outputs error:error];
+}
+
 - (id<TIOData>)runOn:(id<TIOData>)input placeholders:(NSDictionary<NSString*,id<TIOData>> *)placeholders error:(NSError* _Nullable *)error {
-    // Convert TIOData to TIOBatch and call run:placeholders:error:
-    
+    return [self run:[self _batchForInput:input] placeholders:placeholders error:error];
+}
+
+/**
+ * Converts `TIOData` input to a `TIOBatch` of one item.
+ */
+
+- (TIOBatch *)_batchForInput:(id<TIOData>)input {
     TIOBatch *batch;
     
     if ( [input isKindOfClass:NSDictionary.class] ) {
@@ -241,7 +610,7 @@ typedef std::vector<std::string> TensorNames;
         batch = [[TIOBatch alloc] initWithItem:(TIOBatchItem *)item];
     }
     
-    return [self run:batch placeholders:placeholders error:error];
+    return batch;
 }
 
 - (id<TIOData>)run:(TIOBatch *)batch error:(NSError * _Nullable *)error {
@@ -255,8 +624,17 @@ typedef std::vector<std::string> TensorNames;
 // * inputs, training inputs, and placeholders.
 
 - (id<TIOData>)run:(TIOBatch *)batch placeholders:(NSDictionary<NSString*,id<TIOData>> *)placeholders error:(NSError * _Nullable *)error {
+    return [self _run:batch placeholders:placeholders outputs:nil error:error];
+}
+
+/**
+ * Performs inference on a batch, fetching only the named outputs, or every output if `outputs`
+ * is `nil`.
+ */
+
+- (id<TIOData>)_run:(TIOBatch *)batch placeholders:(nullable NSDictionary<NSString*,id<TIOData>> *)placeholders outputs:(nullable NSArray<NSString*> *)outputs error:(NSError * _Nullable *)error {
     NSAssert([[NSSet setWithArray:batch.keys] isEqualToSet:[NSSet setWithArray:self.io.inputs.keys]], @"Batch keys do not match input layer names");
-    NSAssert(batch.count == 1, @"Run batch size must currently be 1 for TensorFlow models");
+    NSAssert(batch.count == 1 || [self _inputsAreBatched], @"Every input layer must be batched to run a batch of more than one item");
     
     NSError *loadError;
     NSError *inferenceError;
@@ -267,7 +645,7 @@ typedef std::vector<std::string> TensorNames;
     
     if (loadError != nil) {
         NSLog(@"There was a problem loading the model from run:error:, error: %@", loadError);
-        if (*error) {
+        if (error) {
             *error = loadError;
         }
         return @{};
@@ -275,17 +653,16 @@ typedef std::vector<std::string> TensorNames;
     
     // Pepare Inputs and Placeholders
     
-    NamedTensors inputs_t = [self _namedTensorsForBatch:batch layers:self.io.inputs];
+    Tensors feeds_t;
+    std::vector<bool> fed;
     
-    if ( placeholders != nil ) {
-        TIOBatch *placeholdersBatch = [[TIOBatch alloc] initWithItem:(TIOBatchItem *)placeholders];
-        const NamedTensors placeholders_t = [self _namedTensorsForBatch:placeholdersBatch layers:self.io.placeholders];
-        inputs_t.insert(inputs_t.end(), placeholders_t.begin(), placeholders_t.end());
-    }
+    [self _feedTensorsForBatch:batch placeholders:placeholders tensors:feeds_t fed:fed];
     
-    // Run Model
+    // Run Model, fetching only the selected outputs
     
-    const Tensors outputs_t = [self _runInference:inputs_t error:&inferenceError];
+    const std::vector<size_t> fetched = [self _outputIndexesForNames:outputs];
+    const TIOTensorFlowCallableSignature signature = [self _signatureFeeding:fed fetching:fetched targets:TIOTensorFlowTargets::None];
+    const Tensors outputs_t = [self _runInference:feeds_t signature:signature error:&inferenceError];
     
     if (inferenceError != nil ) {
         NSLog(@"There was a problem running inference, error: %@", inferenceError);
@@ -295,36 +672,83 @@ typedef std::vector<std::string> TensorNames;
         return @{};
     }
     
-    // Return Output
+    // Return Output, one set of outputs per batch item
     
-    const id<TIOData> results = [self _captureOutput:outputs_t];
+    const id<TIOData> results = batch.count == 1
+        ? [self _captureOutput:outputs_t outputs:fetched]
+        : [self _captureOutput:outputs_t outputs:fetched batchSize:batch.count];
     return results;
 }
 
+- (BOOL)_inputsAreBatched {
+    for ( const TIOTensorFlowLayerPlan &layer : _plan.inputs ) {
+        if ( !layer.description.isBatched ) {
+            return NO;
+        }
+    }
+    return YES;
+}
+
+// MARK: - Asynchronous Inference
+
+// Sessions are not pipelined, submissions are simply run one after another off the caller's thread
+
+- (void)runOn:(id<TIOData>)input completion:(TIOModelCompletionHandler)completion {
+    dispatch_async(_runQueue, ^{
+        NSError *error;
+        id<TIOData> output = [self runOn:input error:&error];
+        completion(error == nil ? output : nil, error);
+    });
+}
+
 // MARK: - Execute Inference
 
 /**
  * Runs inference on the model with prepared inputs.
  *
- * @param inputs `NamedTensors` that are ready to be passed to an inference session
- * @return Tensors The output tensors that are a result of running inference
+ * @param feeds Tensors that are ready to be passed to an inference session, in the order of the
+ *  signature's feeds
+ * @param signature The signature of the callable to run
+ * @return Tensors The output tensors that are a result of running inference, in the order of the
+ *  signature's fetches
  */
 
-- (Tensors)_runInference:(NamedTensors)inputs error:(NSError * _Nullable *)error {
-    TensorNames output_names;
+- (Tensors)_runInference:(const Tensors &)feeds signature:(const TIOTensorFlowCallableSignature &)signature error:(NSError * _Nullable *)error {
     Tensors outputs;
+    tensorflow::Session::CallableHandle handle;
     
-    for (TIOLayerInterface *interface in self.io.outputs.all) {
-        output_names.push_back(interface.name.UTF8String);
+    if ( ![self _callable:&handle signature:signature error:error] ) {
+        return outputs;
     }
     
     tensorflow::Session *session = _saved_model_bundle.session.get();
-    tensorflow::Status status;
+    __block tensorflow::Status status;
+    
+    // Only the first two invocations after a load are timed, to record cold and warm latency.
+    // The block captures pointers so that it does not copy the tensors
     
-    status = session->Run(inputs, output_names, {}, &outputs);
+    NSUInteger invocation = _invocations++;
+    
+    if ( invocation < 2 ) {
+        const Tensors *feeds_p = &feeds;
+        Tensors *outputs_p = &outputs;
+        double latency;
+        
+        tio_measuring_latency(&latency, ^{
+            status = session->RunCallable(handle, *feeds_p, outputs_p, nullptr);
+        });
+        
+        if ( invocation == 0 ) {
+            _coldInferenceLatency = latency;
+        } else {
+            _warmInferenceLatency = latency;
+        }
+    } else {
+        status = session->RunCallable(handle, feeds, &outputs, nullptr);
+    }
     
     if ( status != tensorflow::Status::OK() ) {
-        NSLog(@"Run error on session->Run with the inputs and output_names: %@", [NSString stringWithUTF8String:status.ToString().c_str()]);
+        NSLog(@"Run error on session->RunCallable: %@", [NSString stringWithUTF8String:status.ToString().c_str()]);
         if (error) {
             *error = TIOTensorFlowModelSessionInferenceError;
         }
@@ -337,151 +761,192 @@ typedef std::vector<std::string> TensorNames;
 // MARK: - Prepare Inputs
 
 /**
- * Iterates through the contents of batch, matching them to the provided io
- * layers, and prepares tensors with them.
+ * Prepares the tensors fed to a callable from a batch and its placeholders.
  *
- * @param batch A batch of training data.
- * @param layers The IO layer descriptions that direct how the batch data
- *  is processed;
- * @return NamedTensors Tensors ready to be passing to an run session.
+ * Internally the method converts the placeholders to a `TIOBatch` of one item, which allows us
+ * to reuse the tensor preparation code across inputs and placeholders.
+ *
+ * @param batch A batch of inference or training data, or `nil` to feed only placeholders.
+ * @param placeholders Placeholder values, may be `nil`.
+ * @param tensors Filled with the prepared tensors, inputs then placeholders, in plan order.
+ * @param fed Filled with a flag for every planned input and placeholder, `true` if it was fed.
  */
 
-- (NamedTensors)_namedTensorsForBatch:(TIOBatch *)batch layers:(TIOModelIOList*)layers {
-    NamedTensors tensors;
+- (void)_feedTensorsForBatch:(nullable TIOBatch *)batch placeholders:(nullable NSDictionary<NSString*,id<TIOData>> *)placeholders tensors:(Tensors &)tensors fed:(std::vector<bool> &)fed {
+    tensors.reserve(_plan.inputs.size() + _plan.placeholders.size());
+    fed.reserve(_plan.inputs.size() + _plan.placeholders.size());
     
-    for ( NSString *key in batch.keys ) {
-        NSArray<id<TIOTensorFlowData>> *column = (NSArray<id<TIOTensorFlowData>>*)[batch valuesForKey:key];
-        TIOLayerInterface *interface = layers[key];
-        
-        NamedTensor tensor = [self _namedTensorForColumn:column interface:interface];
-        tensors.push_back(tensor);
+    // A batch prepared while the model was loaded with its current pool already holds the
+    // input tensors, which are in plan order and so take the first slots of the feeds
+    
+    if ( [batch isKindOfClass:TIOTensorFlowPreparedBatch.class] && ((TIOTensorFlowPreparedBatch *)batch).tensorPool == _tensorPool ) {
+        [(TIOTensorFlowPreparedBatch *)batch appendTensors:tensors fed:fed];
+    } else if ( batch != nil ) {
+        [self _feedTensorsForBatch:batch layers:_plan.inputs placeholders:NO tensors:tensors fed:fed];
+    } else {
+        fed.insert(fed.end(), _plan.inputs.size(), false);
     }
     
-    return tensors;
+    if ( placeholders != nil ) {
+        TIOBatch *placeholdersBatch = [[TIOBatch alloc] initWithItem:(TIOBatchItem *)placeholders];
+        [self _feedTensorsForBatch:placeholdersBatch layers:_plan.placeholders placeholders:YES tensors:tensors fed:fed];
+    } else {
+        fed.insert(fed.end(), _plan.placeholders.size(), false);
+    }
 }
 
 /**
- * Prepares a tensor from an inference input
+ * Walks the planned layers, writing each layer's column in the batch to the layer's pooled
+ * tensor. Layers with no values in the batch are not fed.
  *
- * @param column A colun of data for the specified interface
- * @param interface A description of the data which the tensor expects
+ * @param batch A batch of training data.
+ * @param layers The planned layers that direct how the batch data is processed.
+ * @param placeholders `YES` if the layers are placeholders, whose tensors are only rewritten
+ *  when their values change.
+ * @param tensors The tensors to append prepared tensors to.
+ * @param fed The flags to append a flag for each layer to. Its size is the slot of the next
+ *  layer in the callable feeds.
  */
 
-- (NamedTensor)_namedTensorForColumn:(NSArray<id<TIOTensorFlowData>> *)column interface:(TIOLayerInterface *)interface {
-    __block NamedTensor named_tensor;
-    
-    [interface matchCasePixelBuffer:^(TIOPixelBufferLayerDescription * _Nonnull pixelBufferDescription) {
-        assert( [column[0] isKindOfClass:TIOPixelBuffer.class] );
-        
-        tensorflow::Tensor tensor = [column[0].class tensorWithColumn:column description:pixelBufferDescription];
-        std::string name = interface.name.UTF8String;
-    
-        named_tensor = NamedTensor(name, tensor);
-        
-    } caseVector:^(TIOVectorLayerDescription * _Nonnull vectorDescription) {
-        assert( [column[0] isKindOfClass:NSArray.class]
-            ||  [column[0] isKindOfClass:NSData.class]
-            ||  [column[0] isKindOfClass:NSNumber.class] );
-        
-        tensorflow::Tensor tensor = [column[0].class tensorWithColumn:column description:vectorDescription];
-        std::string name = interface.name.UTF8String;
-    
-        named_tensor = NamedTensor(name, tensor);
+- (void)_feedTensorsForBatch:(TIOBatch *)batch layers:(const std::vector<TIOTensorFlowLayerPlan> &)layers placeholders:(BOOL)placeholders tensors:(Tensors &)tensors fed:(std::vector<bool> &)fed {
+    for ( const TIOTensorFlowLayerPlan &layer : layers ) {
+        NSArray<id<TIOTensorFlowData>> *column = (NSArray<id<TIOTensorFlowData>>*)[batch valuesForKey:layer.name];
         
-    } caseString:^(TIOStringLayerDescription * _Nonnull stringDescription) {
-        assert( [column[0] isKindOfClass:NSData.class] );
+        if ( column.count == 0 ) {
+            fed.push_back(false);
+            continue;
+        }
         
-        tensorflow::Tensor tensor = [column[0].class tensorWithColumn:column description:stringDescription];
-        std::string name = interface.name.UTF8String;
-    
-        named_tensor = NamedTensor(name, tensor);
-    } caseScalar:^(TIOScalarLayerDescription * _Nonnull scalarDescription) {
-        assert( [column[0] isKindOfClass:NSArray.class]
-            ||  [column[0] isKindOfClass:NSData.class]
-            ||  [column[0] isKindOfClass:NSNumber.class] );
+        const size_t slot = fed.size();
         
-        tensorflow::Tensor tensor = [column[0].class tensorWithColumn:column description:scalarDescription];
-        std::string name = interface.name.UTF8String;
-    
-        named_tensor = NamedTensor(name, tensor);
-    }];
-    
-    return named_tensor;
+        tensors.push_back(placeholders
+            ? [_tensorPool placeholderTensorForLayer:layer slot:slot column:column]
+            : [_tensorPool tensorForLayer:layer slot:slot column:column]);
+        fed.push_back(true);
+    }
 }
 
 // MARK: - Capture Outputs
 
+/**
+ * Resolves the names of requested outputs to the indexes of planned output layers, in plan
+ * order, or to every output layer if `names` is `nil`.
+ */
+
+- (std::vector<size_t>)_outputIndexesForNames:(nullable NSArray<NSString*> *)names {
+    std::vector<size_t> indexes;
+    indexes.reserve(_plan.outputs.size());
+    
+    for ( size_t index = 0; index < _plan.outputs.size(); index++ ) {
+        if ( names == nil || [names containsObject:_plan.outputs[index].name] ) {
+            indexes.push_back(index);
+        }
+    }
+    
+    return indexes;
+}
+
 /**
  * Captures outputs from the model.
  *
  * @param outputTensors `Tensors` that have been produced by an inference session
+ * @param indexes The indexes of the planned output layers the tensors were fetched for
  * @return TIOData A class that is appropriate to the model output. Currently all outputs are
  *  wrapped in an instance of `NSDictionary` whose keys are taken from the json description of the
  *  model outputs.
  */
 
-- (id<TIOData>)_captureOutput:(Tensors)outputTensors {
-   
-    NSMutableDictionary<NSString*,id<TIOData>> *outputs = [[NSMutableDictionary alloc] init];
-
-    for ( int index = 0; index < self.io.outputs.count; index++ ) {
-        TIOLayerInterface *interface = self.io.outputs[index];
-        tensorflow::Tensor tensor = outputTensors[index];
-        
-        id<TIOData> data = [self _captureOutput:tensor interface:interface];
-        outputs[interface.name] = data;
+- (id<TIOData>)_captureOutput:(const Tensors &)outputTensors outputs:(const std::vector<size_t> &)indexes {
+    
+    NSMutableDictionary<NSString*,id<TIOData>> *outputs = [[NSMutableDictionary alloc] initWithCapacity:indexes.size()];
+    
+    for ( size_t index = 0; index < indexes.size(); index++ ) {
+        const TIOTensorFlowLayerPlan &layer = _plan.outputs[indexes[index]];
+        outputs[layer.name] = layer.read(outputTensors[index], layer.description);
     }
     
     return outputs.copy;
 }
 
 /**
- * Copies bytes from the tensor to an appropriate class that conforms to `TIOData`
+ * Captures outputs from the model for a batch of more than one item, splitting each batched
+ * output tensor along its leading dimension.
  *
- * @param tensor The output tensor whose bytes will be captured
- * @param interface A description of the data which this tensor contains
+ * @param outputTensors `Tensors` that have been produced by an inference session
+ * @param indexes The indexes of the planned output layers the tensors were fetched for
+ * @param batchSize The number of items in the batch
+ * @return TIOData An array with one dictionary of outputs per batch item, in batch order. An
+ *  output layer which is not batched is shared by every item.
  */
 
-- (id<TIOData>)_captureOutput:(tensorflow::Tensor)tensor interface:(TIOLayerInterface *)interface {
-    __block id<TIOData> data;
+- (id<TIOData>)_captureOutput:(const Tensors &)outputTensors outputs:(const std::vector<size_t> &)indexes batchSize:(NSUInteger)batchSize {
+    
+    NSMutableArray<NSMutableDictionary<NSString*,id<TIOData>>*> *outputs = [[NSMutableArray alloc] initWithCapacity:batchSize];
+    
+    for ( NSUInteger batchIndex = 0; batchIndex < batchSize; batchIndex++ ) {
+        [outputs addObject:[[NSMutableDictionary alloc] initWithCapacity:indexes.size()]];
+    }
     
-    [interface
-        matchCasePixelBuffer:^(TIOPixelBufferLayerDescription * _Nonnull pixelBufferDescription) {
-            data = [[TIOPixelBuffer alloc] initWithTensor:tensor description:pixelBufferDescription];
+    for ( size_t index = 0; index < indexes.size(); index++ ) {
+        const TIOTensorFlowLayerPlan &layer = _plan.outputs[indexes[index]];
+        const tensorflow::Tensor &tensor = outputTensors[index];
         
-        } caseVector:^(TIOVectorLayerDescription * _Nonnull vectorDescription) {
-            TIOVector *vector = [[TIOVector alloc] initWithTensor:tensor description:vectorDescription];
-            
-            if ( vectorDescription.isLabeled ) {
-                // If the vector's output is labeled, return a dictionary mapping labels to values
-                data = [vectorDescription labeledValues:vector];
-            } else {
-                // If the vector's output is single-valued just return that value
-                data = vector.count == 1
-                    ? vector[0]
-                    : vector;
+        BOOL split = layer.description.isBatched
+            && tensor.dims() > 0
+            && tensor.dim_size(0) == (tensorflow::int64)batchSize;
+        
+        if ( !split ) {
+            id<TIOData> shared = layer.read(tensor, layer.description);
+            for ( NSUInteger batchIndex = 0; batchIndex < batchSize; batchIndex++ ) {
+                outputs[batchIndex][layer.name] = shared;
             }
-            
-        } caseString:^(TIOStringLayerDescription * _Nonnull stringDescription) {
-            data = [[NSData alloc] initWithTensor:tensor description:stringDescription];
+            continue;
+        }
         
-        } caseScalar:^(TIOScalarLayerDescription * _Nonnull scalarDescription) {
-            TIOVector *vector = [[TIOVector alloc] initWithTensor:tensor description:scalarDescription];
-            // TODO: Use NSNumber
+        for ( NSUInteger batchIndex = 0; batchIndex < batchSize; batchIndex++ ) {
             
-            // If the vector's output is single-valued just return that value
-            data = vector.count == 1
-                ? vector[0]
-                : vector;
-        }];
+            // A slice shares the tensor's buffer but may not be aligned for reading as a flat
+            // tensor, in which case its bytes are copied
+            
+            tensorflow::Tensor item = tensor.Slice(batchIndex, batchIndex + 1);
+            
+            if ( !item.IsAligned() ) {
+                item = tensorflow::tensor::DeepCopy(item);
+            }
+            
+            outputs[batchIndex][layer.name] = layer.read(item, layer.description);
+        }
+    }
     
-    return data;
+    return [outputs copy];
 }
 
 @end
 
 // MARK: - Training
 
+/**
+ * Returns the size in bytes of each file in a checkpoint, keyed by file name.
+ */
+
+static NSDictionary<NSString*,NSNumber*> *TIOTensorFlowCheckpointFileSizes(NSURL *checkpointURL) {
+    NSFileManager *fm = NSFileManager.defaultManager;
+    NSString *directory = checkpointURL.URLByDeletingLastPathComponent.path;
+    NSString *prefix = [checkpointURL.lastPathComponent stringByAppendingString:@"."];
+    NSMutableDictionary<NSString*,NSNumber*> *fileSizes = NSMutableDictionary.dictionary;
+    
+    for ( NSString *filename in [fm contentsOfDirectoryAtPath:directory error:nil] ) {
+        if ( ![filename hasPrefix:prefix] ) {
+            continue;
+        }
+        
+        NSDictionary *attributes = [fm attributesOfItemAtPath:[directory stringByAppendingPathComponent:filename] error:nil];
+        fileSizes[filename] = @(attributes.fileSize);
+    }
+    
+    return fileSizes;
+}
+
 @implementation TIOTensorFlowModel (TIOTrainableModel)
 
 - (id<TIOData>)train:(TIOBatch *)batch {
@@ -499,6 +964,10 @@ typedef std::vector<std::string> TensorNames;
 // * inputs, training inputs, and placeholders.
 
 - (id<TIOData>)train:(TIOBatch *)batch placeholders:(nullable NSDictionary<NSString*,id<TIOData>> *)placeholders error:(NSError * _Nullable *)error {
+    return [self train:batch placeholders:placeholders fetchOutputs:YES error:error];
+}
+
+- (id<TIOData>)train:(TIOBatch *)batch placeholders:(nullable NSDictionary<NSString*,id<TIOData>> *)placeholders fetchOutputs:(BOOL)fetchOutputs error:(NSError * _Nullable *)error {
     NSError *loadError;
     NSError *trainError;
     
@@ -512,15 +981,16 @@ typedef std::vector<std::string> TensorNames;
         return @{};
     }
     
-    NamedTensors inputs_t = [self _namedTensorsForBatch:batch layers:self.io.inputs];
+    Tensors feeds_t;
+    std::vector<bool> fed;
     
-    if ( placeholders != nil ) {
-        TIOBatch *placeholdersBatch = [[TIOBatch alloc] initWithItem:(TIOBatchItem *)placeholders];
-        const NamedTensors placeholders_t = [self _namedTensorsForBatch:placeholdersBatch layers:self.io.placeholders];
-        inputs_t.insert(inputs_t.end(), placeholders_t.begin(), placeholders_t.end());
-    }
+    [self _feedTensorsForBatch:batch placeholders:placeholders tensors:feeds_t fed:fed];
+    
+    const std::vector<size_t> fetched = fetchOutputs
+        ? [self _outputIndexesForNames:nil]
+        : std::vector<size_t>();
     
-    const Tensors outputs_t = [self _runTraining:inputs_t error:&trainError];
+    const Tensors outputs_t = [self _runTraining:feeds_t fed:fed outputs:fetched error:&trainError];
     
     if (trainError != nil) {
         NSLog(@"There was a problem training the model from train:, error: %@", trainError);
@@ -530,65 +1000,237 @@ typedef std::vector<std::string> TensorNames;
         return @{};
     }
     
-    const id<TIOData> results = [self _captureOutput:outputs_t];
+    const id<TIOData> results = [self _captureOutput:outputs_t outputs:fetched];
+    return results;
+}
+
+// MARK: - Batch Preparation
+
+- (nullable TIOBatch *)prepareBatch:(TIOBatch *)batch error:(NSError * _Nullable *)error {
+    NSError *loadError;
+    
+    [self load:&loadError];
+    
+    if (loadError != nil) {
+        NSLog(@"There was a problem loading the model from prepareBatch:, error: %@", loadError);
+        if (error) {
+            *error = loadError;
+        }
+        return nil;
+    }
+    
+    TIOTensorFlowTensorPool *tensorPool = _tensorPool;
+    Tensors tensors;
+    std::vector<bool> fed;
+    
+    tensors.reserve(_plan.inputs.size());
+    fed.reserve(_plan.inputs.size());
+    
+    [self _feedTensorsForBatch:batch layers:_plan.inputs placeholders:NO tensors:tensors fed:fed];
+    
+    return [[TIOTensorFlowPreparedBatch alloc] initWithBatch:batch tensorPool:tensorPool tensors:tensors fed:fed];
+}
+
+// MARK: - Gradient Accumulation
+
+- (BOOL)accumulatesGradients {
+    return _accumulateOps.count != 0 && _applyOps.count != 0;
+}
+
+- (id<TIOData>)accumulate:(TIOBatch *)batch placeholders:(nullable NSDictionary<NSString*,id<TIOData>> *)placeholders fetchOutputs:(BOOL)fetchOutputs error:(NSError * _Nullable *)error {
+    NSError *loadError;
+    NSError *accumulateError;
+    
+    if ( !self.accumulatesGradients ) {
+        NSLog(@"Model with identifier %@ does not declare train.accumulate_ops and train.apply_ops", self.identifier);
+        if (error) {
+            *error = TIOTensorFlowModelAccumulationUnsupportedError;
+        }
+        return @{};
+    }
+    
+    [self load:&loadError];
+    
+    if (loadError != nil) {
+        NSLog(@"There was a problem loading the model from accumulate:, error: %@", loadError);
+        if (error) {
+            *error = loadError;
+        }
+        return @{};
+    }
+    
+    Tensors feeds_t;
+    std::vector<bool> fed;
+    
+    [self _feedTensorsForBatch:batch placeholders:placeholders tensors:feeds_t fed:fed];
+    
+    const std::vector<size_t> fetched = fetchOutputs
+        ? [self _outputIndexesForNames:nil]
+        : std::vector<size_t>();
+    
+    const Tensors outputs_t = [self _runTargets:TIOTensorFlowTargets::Accumulate feeds:feeds_t fed:fed outputs:fetched error:&accumulateError];
+    
+    if (accumulateError != nil) {
+        NSLog(@"There was a problem accumulating gradients from accumulate:, error: %@", accumulateError);
+        if (error) {
+            *error = accumulateError;
+        }
+        return @{};
+    }
+    
+    const id<TIOData> results = [self _captureOutput:outputs_t outputs:fetched];
     return results;
 }
 
+- (BOOL)applyAccumulatedGradients:(nullable NSDictionary<NSString*,id<TIOData>> *)placeholders error:(NSError * _Nullable *)error {
+    NSError *loadError;
+    NSError *applyError;
+    
+    if ( !self.accumulatesGradients ) {
+        NSLog(@"Model with identifier %@ does not declare train.accumulate_ops and train.apply_ops", self.identifier);
+        if (error) {
+            *error = TIOTensorFlowModelAccumulationUnsupportedError;
+        }
+        return NO;
+    }
+    
+    [self load:&loadError];
+    
+    if (loadError != nil) {
+        NSLog(@"There was a problem loading the model from applyAccumulatedGradients:, error: %@", loadError);
+        if (error) {
+            *error = loadError;
+        }
+        return NO;
+    }
+    
+    Tensors feeds_t;
+    std::vector<bool> fed;
+    
+    [self _feedTensorsForBatch:nil placeholders:placeholders tensors:feeds_t fed:fed];
+    [self _runTargets:TIOTensorFlowTargets::Apply feeds:feeds_t fed:fed outputs:std::vector<size_t>() error:&applyError];
+    
+    if (applyError != nil) {
+        NSLog(@"There was a problem applying gradients from applyAccumulatedGradients:, error: %@", applyError);
+        if (error) {
+            *error = applyError;
+        }
+        return NO;
+    }
+    
+    return YES;
+}
+
 // MARK: - Execute Training
 
 /**
  * Runs training on the model with prepared inputs.
  *
- * @param inputs `NamedTensors` that are ready to be passed to a training session
+ * When the training step is fused, the training ops run and the outputs are fetched in a single
+ * session run. Otherwise the training ops run first and the outputs, if any were requested, are
+ * fetched with a second run, which sees the updated weights.
+ *
+ * @param feeds Tensors that are ready to be passed to a training session
+ * @param fed Flags for the planned inputs and placeholders, `true` for those in `feeds`
+ * @param indexes The indexes of the planned outputs to fetch, usually all or none of them
  * @return Tensors The output tensors that are a result of running training
  */
 
-- (Tensors)_runTraining:(NamedTensors)inputs error:(NSError * _Nullable *)error {
-    TensorNames training_names;
-    TensorNames output_names;
+- (Tensors)_runTraining:(const Tensors &)feeds fed:(const std::vector<bool> &)fed outputs:(const std::vector<size_t> &)indexes error:(NSError * _Nullable *)error {
     Tensors outputs;
+    Tensors unused;
     
-    // Output names
-    
-    for (TIOLayerInterface *interface in self.io.outputs.all) {
-        output_names.push_back(interface.name.UTF8String);
-    }
+    tensorflow::Session *session = _saved_model_bundle.session.get();
+    tensorflow::Session::CallableHandle handle;
+    tensorflow::Status status;
     
-    // Training op names
+    // Train and get loss at the same time
     
-    for (NSString *op in _trainingOps) {
-         training_names.push_back(op.UTF8String);
+    if ( self.fusesTrainingStep && !indexes.empty() ) {
+        if ( ![self _callable:&handle signature:[self _signatureFeeding:fed fetching:indexes targets:TIOTensorFlowTargets::Train] error:error] ) {
+            return outputs;
+        }
+        
+        status = session->RunCallable(handle, feeds, &outputs, nullptr);
+        
+        if ( status != tensorflow::Status::OK() ) {
+            NSLog(@"Train error on session->RunCallable with the training targets and outputs: %@", [NSString stringWithUTF8String:status.ToString().c_str()]);
+            if (error) {
+                *error = TIOTensorFlowModelSessionTrainError;
+            }
+        }
+        
+        return outputs;
     }
     
     // Run training
     
-    tensorflow::Session *session = _saved_model_bundle.session.get();
-    tensorflow::Status status;
+    if ( ![self _callable:&handle signature:[self _signatureFeeding:fed fetching:std::vector<size_t>() targets:TIOTensorFlowTargets::Train] error:error] ) {
+        return outputs;
+    }
     
-    status = session->Run(inputs, {}, training_names, nullptr);
+    status = session->RunCallable(handle, feeds, &unused, nullptr);
     
     if ( status != tensorflow::Status::OK() ) {
-        NSLog(@"Train rror on session->Run with the inputs and training_names: %@", [NSString stringWithUTF8String:status.ToString().c_str()]);
+        NSLog(@"Train error on session->RunCallable with the training targets: %@", [NSString stringWithUTF8String:status.ToString().c_str()]);
         if (error) {
             *error = TIOTensorFlowModelSessionTrainError;
         }
         return outputs;
     }
     
+    if ( indexes.empty() ) {
+        return outputs;
+    }
+    
     // Get loss
     
-    status = session->Run(inputs, output_names, {}, &outputs);
+    if ( ![self _callable:&handle signature:[self _signatureFeeding:fed fetching:indexes targets:TIOTensorFlowTargets::None] error:error] ) {
+        return outputs;
+    }
+    
+    status = session->RunCallable(handle, feeds, &outputs, nullptr);
     
     if ( status != tensorflow::Status::OK() ) {
-        NSLog(@"Train error on session->Run with the inputs and output_na,mes: %@", [NSString stringWithUTF8String:status.ToString().c_str()]);
+        NSLog(@"Train error on session->RunCallable with the outputs: %@", [NSString stringWithUTF8String:status.ToString().c_str()]);
         if (error) {
             *error = TIOTensorFlowModelSessionTrainError;
         }
         return outputs;
     }
     
-    // Train and get loss at the same time : results in a slightly different output
-    // TF_CHECK_OK(session->Run(inputs, output_names, training_names, &outputs));
+    return outputs;
+}
+
+/**
+ * Runs the planned ops selected by `targets` with prepared inputs, fetching any requested
+ * outputs in the same session run.
+ *
+ * @param targets The planned ops to run
+ * @param feeds Tensors that are ready to be passed to the session
+ * @param fed Flags for the planned inputs and placeholders, `true` for those in `feeds`
+ * @param indexes The indexes of the planned outputs to fetch, may be empty
+ * @return Tensors The fetched output tensors
+ */
+
+- (Tensors)_runTargets:(TIOTensorFlowTargets)targets feeds:(const Tensors &)feeds fed:(const std::vector<bool> &)fed outputs:(const std::vector<size_t> &)indexes error:(NSError * _Nullable *)error {
+    Tensors outputs;
+    
+    tensorflow::Session *session = _saved_model_bundle.session.get();
+    tensorflow::Session::CallableHandle handle;
+    
+    if ( ![self _callable:&handle signature:[self _signatureFeeding:fed fetching:indexes targets:targets] error:error] ) {
+        return outputs;
+    }
+    
+    tensorflow::Status status = session->RunCallable(handle, feeds, &outputs, nullptr);
+    
+    if ( status != tensorflow::Status::OK() ) {
+        NSLog(@"Train error on session->RunCallable with the planned targets: %@", [NSString stringWithUTF8String:status.ToString().c_str()]);
+        if (error) {
+            *error = TIOTensorFlowModelSessionTrainError;
+        }
+    }
     
     return outputs;
 }
@@ -596,6 +1238,129 @@ typedef std::vector<std::string> TensorNames;
 // MARK: - Export
 
 - (BOOL)exportTo:(NSURL *)fileURL error:(NSError * _Nullable *)error {
+    if ( ![self _validateExportURL:fileURL error:error] ) {
+        return NO;
+    }
+    
+    if ( ![self _loadForExport:error] ) {
+        return NO;
+    }
+    
+    // Only one export may be in flight
+    
+    bool exporting = false;
+    
+    if ( !_exporting.compare_exchange_strong(exporting, true) ) {
+        if (error) {
+            *error = TIOTensorFlowModelExportInProgressError;
+        }
+        return NO;
+    }
+    
+    BOOL saved = [self _saveCheckpoint:[fileURL URLByAppendingPathComponent:@"checkpoint"] error:error];
+    _exporting = false;
+    
+    return saved;
+}
+
+- (void)exportTo:(NSURL *)fileURL completion:(TIOTensorFlowModelExportCompletionHandler)completion {
+    dispatch_queue_t rejectQueue = dispatch_get_global_queue(QOS_CLASS_UTILITY, 0);
+    NSError *error;
+    
+    if ( ![self _validateExportURL:fileURL error:&error] ) {
+        dispatch_async(rejectQueue, ^{
+            completion(nil, error);
+        });
+        return;
+    }
+    
+    if ( ![self _loadForExport:&error] ) {
+        dispatch_async(rejectQueue, ^{
+            completion(nil, error);
+        });
+        return;
+    }
+    
+    // Only one export may be in flight
+    
+    bool exporting = false;
+    
+    if ( !_exporting.compare_exchange_strong(exporting, true) ) {
+        dispatch_async(rejectQueue, ^{
+            completion(nil, TIOTensorFlowModelExportInProgressError);
+        });
+        return;
+    }
+    
+    NSURL *checkpointURL = [fileURL URLByAppendingPathComponent:@"checkpoint"];
+    
+    // Copy the variables on the caller's thread so that training may continue once we return.
+    // If the saver is unsupported or its graph can't be read, fall back to running it here
+    
+    auto snapshot = std::make_shared<TIOTensorFlowCheckpointSnapshot>();
+    tensorflow::Status status = TIOTensorFlowSnapshotVariables(_saved_model_bundle.session.get(), _saved_model_bundle.meta_graph_def, *snapshot);
+    
+    if ( status.code() == tensorflow::error::UNIMPLEMENTED || status.code() == tensorflow::error::INVALID_ARGUMENT ) {
+        #ifdef DEBUG
+        NSLog(@"Unable to copy the variables for an asynchronous export, running the saver instead: %@", [NSString stringWithUTF8String:status.ToString().c_str()]);
+        #endif
+        
+        BOOL saved = [self _saveCheckpoint:checkpointURL error:&error];
+        _exporting = false;
+        
+        dispatch_async(rejectQueue, ^{
+            completion(saved ? TIOTensorFlowCheckpointFileSizes(checkpointURL) : nil, error);
+        });
+        return;
+    }
+    
+    if ( status != tensorflow::Status::OK() ) {
+        NSLog(@"Unable to copy the variables for export, status: %@", [NSString stringWithUTF8String:status.ToString().c_str()]);
+        _exporting = false;
+        
+        dispatch_async(rejectQueue, ^{
+            completion(nil, TIOTensorFlowModelExportError);
+        });
+        return;
+    }
+    
+    // Write the checkpoint in the background
+    
+    dispatch_async(_exportQueue, ^{
+        tensorflow::Status write_status = TIOTensorFlowWriteCheckpoint(*snapshot, checkpointURL.path.UTF8String);
+        self->_exporting = false;
+        
+        if ( write_status != tensorflow::Status::OK() ) {
+            NSLog(@"Unable to write the exported checkpoint, status: %@", [NSString stringWithUTF8String:write_status.ToString().c_str()]);
+            completion(nil, TIOTensorFlowModelExportError);
+            return;
+        }
+        
+        completion(TIOTensorFlowCheckpointFileSizes(checkpointURL), nil);
+    });
+}
+
+/**
+ * Loads the model if it has not been loaded, since an export reads the variables from its session.
+ */
+
+- (BOOL)_loadForExport:(NSError * _Nullable *)error {
+    NSError *loadError;
+    
+    [self load:&loadError];
+    
+    if (loadError != nil) {
+        NSLog(@"There was a problem loading the model from exportTo:, error: %@", loadError);
+        if (error) {
+            *error = loadError;
+        }
+        return NO;
+    }
+    
+    return YES;
+}
+
+- (BOOL)_validateExportURL:(NSURL *)fileURL error:(NSError * _Nullable *)error {
     NSFileManager *fm = NSFileManager.defaultManager;
     BOOL isDirectory;
     
@@ -613,16 +1378,20 @@ typedef std::vector<std::string> TensorNames;
         return NO;
     }
     
-    // Save checkpoint
-    
-    NSURL *checkpointURL = [fileURL URLByAppendingPathComponent:@"checkpoint"];
-    
+    return YES;
+}
+
+/**
+ * Runs the model's saver, writing a checkpoint with the path prefix at `checkpointURL`.
+ */
+
+- (BOOL)_saveCheckpoint:(NSURL *)checkpointURL error:(NSError * _Nullable *)error {
     tensorflow::Tensor checkpoint_tensor(tensorflow::DT_STRING, tensorflow::TensorShape());
     checkpoint_tensor.scalar<std::string>()() = checkpointURL.path.UTF8String;
-
+    
     tensorflow::Session *session = _saved_model_bundle.session.get();
     tensorflow::MetaGraphDef meta_graph_def = _saved_model_bundle.meta_graph_def;
-
+    
     NamedTensors checkpoint_feed_dict = {{meta_graph_def.saver_def().filename_tensor_name(), checkpoint_tensor}};
     tensorflow::Status status = session->Run(checkpoint_feed_dict, {}, {meta_graph_def.saver_def().save_tensor_name()}, nullptr);
     
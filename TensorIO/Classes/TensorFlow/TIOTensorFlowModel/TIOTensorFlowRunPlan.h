@@ -0,0 +1,147 @@
+//
+//  TIOTensorFlowRunPlan.h
+//  TensorIO
+//
+//  Created by Phil Dow on 10/17/20.
+//  Copyright © 2020 doc.ai (http://doc.ai)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdocumentation"
+
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/protobuf/config.pb.h"
+
+#pragma clang diagnostic pop
+
+#import "TIOData.h"
+#import "TIODataTypes.h"
+#import "TIOTensorFlowData.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class TIOModelIO;
+@class TIOLayerInterface;
+@protocol TIOLayerDescription;
+
+typedef std::pair<std::string, tensorflow::Tensor> NamedTensor;
+typedef std::vector<NamedTensor> NamedTensors;
+typedef std::vector<tensorflow::Tensor> Tensors;
+typedef std::vector<std::string> TensorNames;
+
+/**
+ * Writes a column of input items to a tensor in the format the layer expects. The tensor has
+ * the type and shape of the layer for the column's batch size.
+ */
+
+typedef void (*TIOTensorFlowInputBuilder)(NSArray<id<TIOTensorFlowData>> *column, id<TIOLayerDescription> description, tensorflow::Tensor &tensor);
+
+/**
+ * Boxes an output tensor into the `TIOData` the model returns for that layer.
+ */
+
+typedef _Nullable id<TIOData> (*TIOTensorFlowOutputReader)(const tensorflow::Tensor &tensor, id<TIOLayerDescription> description);
+
+/**
+ * Everything needed to feed or fetch a layer, resolved once when the model loads. Input and
+ * placeholder layers have a `build` function, output layers a `read` function.
+ */
+
+struct TIOTensorFlowLayerPlan {
+    NSString *name;
+    std::string tensor_name;
+    TIOLayerInterface *interface;
+    id<TIOLayerDescription> description;
+    tensorflow::DataType tensor_dtype;
+    TIOTensorFlowInputBuilder build;
+    TIOTensorFlowOutputReader read;
+};
+
+/**
+ * An immutable description of how to run a loaded model. Layers are in the order in which
+ * callables are fed and return fetched tensors.
+ */
+
+struct TIOTensorFlowRunPlan {
+    std::vector<TIOTensorFlowLayerPlan> inputs;
+    std::vector<TIOTensorFlowLayerPlan> outputs;
+    std::vector<TIOTensorFlowLayerPlan> placeholders;
+    TensorNames training_names;
+    TensorNames accumulate_names;
+    TensorNames apply_names;
+};
+
+/**
+ * The planned ops a session callable runs as targets: none, the training ops, the ops that
+ * accumulate a micro-batch's gradients, or the ops that apply and reset accumulated gradients.
+ */
+
+enum class TIOTensorFlowTargets {
+    None,
+    Train,
+    Accumulate,
+    Apply
+};
+
+/**
+ * Identifies a session callable by what it feeds, fetches, and runs. `feeds` is indexed over the
+ * planned inputs followed by the planned placeholders, `fetches` over the planned outputs, and
+ * `targets` selects the planned ops that are run.
+ */
+
+struct TIOTensorFlowCallableSignature {
+    std::vector<bool> feeds;
+    std::vector<bool> fetches;
+    TIOTensorFlowTargets targets;
+    
+    bool operator<(const TIOTensorFlowCallableSignature &other) const {
+        return std::tie(feeds, fetches, targets) < std::tie(other.feeds, other.fetches, other.targets);
+    }
+};
+
+/**
+ * Builds a run plan for a model's layers and training ops.
+ *
+ * @param io The model's inputs, outputs, and placeholders.
+ * @param trainingOps The names of the ops run when training, may be `nil`.
+ * @param accumulateOps The names of the ops that accumulate gradients, may be `nil`.
+ * @param applyOps The names of the ops that apply accumulated gradients, may be `nil`.
+ * @param plan The plan to fill.
+ */
+
+void TIOTensorFlowBuildRunPlan(TIOModelIO *io, NSArray<NSString*> * _Nullable trainingOps, NSArray<NSString*> * _Nullable accumulateOps, NSArray<NSString*> * _Nullable applyOps, TIOTensorFlowRunPlan &plan);
+
+/**
+ * Returns a zero-filled tensor holding a single item of an input or placeholder layer, in the
+ * shape and type the layer's builder would produce. Used to warm up a model after it loads.
+ */
+
+tensorflow::Tensor TIOTensorFlowZeroTensorForLayer(const TIOTensorFlowLayerPlan &layer);
+
+/**
+ * Returns the options for creating a session callable with a signature. Feeds and fetches are
+ * listed in plan order, which is the order of the tensors passed to and returned by the callable.
+ */
+
+tensorflow::CallableOptions TIOTensorFlowCallableOptions(const TIOTensorFlowRunPlan &plan, const TIOTensorFlowCallableSignature &signature);
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,226 @@
+//
+//  TIOTensorFlowRunPlan.mm
+//  TensorIO
+//
+//  Created by Phil Dow on 10/17/20.
+//  Copyright © 2020 doc.ai (http://doc.ai)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "TIOTensorFlowRunPlan.h"
+
+#include <cstring>
+
+#import "TIOModelIO.h"
+#import "TIOLayerInterface.h"
+#import "TIOLayerDescription.h"
+#import "TIOPixelBufferLayerDescription.h"
+#import "TIOVectorLayerDescription.h"
+#import "TIOStringLayerDescription.h"
+#import "TIOScalarLayerDescription.h"
+#import "TIOPixelBuffer.h"
+#import "NSArray+TIOTensorFlowData.h"
+#import "NSData+TIOTensorFlowData.h"
+#import "NSNumber+TIOTensorFlowData.h"
+#import "TIOPixelBuffer+TIOTensorFlowData.h"
+#import "TIOTensorFlowDataLayout.h"
+
+// MARK: - Input Builders
+
+static void TIOTensorFlowBuildPixelBuffer(NSArray<id<TIOTensorFlowData>> *column, id<TIOLayerDescription> description, tensorflow::Tensor &tensor) {
+    assert( [column[0] isKindOfClass:TIOPixelBuffer.class] );
+    
+    [column[0].class fillTensor:tensor withColumn:column description:description];
+}
+
+static void TIOTensorFlowBuildVector(NSArray<id<TIOTensorFlowData>> *column, id<TIOLayerDescription> description, tensorflow::Tensor &tensor) {
+    assert( [column[0] isKindOfClass:NSArray.class]
+        ||  [column[0] isKindOfClass:NSData.class]
+        ||  [column[0] isKindOfClass:NSNumber.class] );
+    
+    [column[0].class fillTensor:tensor withColumn:column description:description];
+}
+
+static void TIOTensorFlowBuildString(NSArray<id<TIOTensorFlowData>> *column, id<TIOLayerDescription> description, tensorflow::Tensor &tensor) {
+    assert( [column[0] isKindOfClass:NSData.class] );
+    
+    [column[0].class fillTensor:tensor withColumn:column description:description];
+}
+
+static void TIOTensorFlowBuildScalar(NSArray<id<TIOTensorFlowData>> *column, id<TIOLayerDescription> description, tensorflow::Tensor &tensor) {
+    assert( [column[0] isKindOfClass:NSArray.class]
+        ||  [column[0] isKindOfClass:NSData.class]
+        ||  [column[0] isKindOfClass:NSNumber.class] );
+    
+    [column[0].class fillTensor:tensor withColumn:column description:description];
+}
+
+// MARK: - Output Readers
+
+static id<TIOData> TIOTensorFlowReadPixelBuffer(const tensorflow::Tensor &tensor, id<TIOLayerDescription> description) {
+    return [[TIOPixelBuffer alloc] initWithTensor:tensor description:description];
+}
+
+static id<TIOData> TIOTensorFlowReadLabeledVector(const tensorflow::Tensor &tensor, id<TIOLayerDescription> description) {
+    TIOVectorLayerDescription *vectorDescription = (TIOVectorLayerDescription *)description;
+    TIOVector *vector = [[TIOVector alloc] initWithTensor:tensor description:vectorDescription];
+    
+    return [vectorDescription labeledValues:vector];
+}
+
+static id<TIOData> TIOTensorFlowReadVector(const tensorflow::Tensor &tensor, id<TIOLayerDescription> description) {
+    TIOVector *vector = [[TIOVector alloc] initWithTensor:tensor description:description];
+    
+    // If the vector's output is single-valued just return that value
+    
+    return vector.count == 1
+        ? vector[0]
+        : vector;
+}
+
+static id<TIOData> TIOTensorFlowReadString(const tensorflow::Tensor &tensor, id<TIOLayerDescription> description) {
+    return [[NSData alloc] initWithTensor:tensor description:description];
+}
+
+static id<TIOData> TIOTensorFlowReadScalar(const tensorflow::Tensor &tensor, id<TIOLayerDescription> description) {
+    TIOVector *vector = [[TIOVector alloc] initWithTensor:tensor description:description];
+    // TODO: Use NSNumber
+    
+    // If the vector's output is single-valued just return that value
+    
+    return vector.count == 1
+        ? vector[0]
+        : vector;
+}
+
+// MARK: - Plan
+
+/**
+ * Resolves a single layer, its tensor's data type, and the functions that convert its data.
+ */
+
+static TIOTensorFlowLayerPlan TIOTensorFlowPlanLayer(TIOLayerInterface *interface) {
+    __block TIOTensorFlowLayerPlan layer;
+    
+    layer.name = interface.name;
+    layer.tensor_name = interface.name.UTF8String;
+    layer.interface = interface;
+    layer.description = interface.layerDescription;
+    layer.tensor_dtype = TIOTensorFlowDataTypeForDescription(interface.layerDescription);
+    
+    [interface
+        matchCasePixelBuffer:^(TIOPixelBufferLayerDescription * _Nonnull pixelBufferDescription) {
+            layer.build = TIOTensorFlowBuildPixelBuffer;
+            layer.read = TIOTensorFlowReadPixelBuffer;
+            
+        } caseVector:^(TIOVectorLayerDescription * _Nonnull vectorDescription) {
+            layer.build = TIOTensorFlowBuildVector;
+            layer.read = vectorDescription.isLabeled
+                ? TIOTensorFlowReadLabeledVector
+                : TIOTensorFlowReadVector;
+            
+        } caseString:^(TIOStringLayerDescription * _Nonnull stringDescription) {
+            layer.build = TIOTensorFlowBuildString;
+            layer.read = TIOTensorFlowReadString;
+            
+        } caseScalar:^(TIOScalarLayerDescription * _Nonnull scalarDescription) {
+            layer.build = TIOTensorFlowBuildScalar;
+            layer.read = TIOTensorFlowReadScalar;
+        }];
+    
+    return layer;
+}
+
+void TIOTensorFlowBuildRunPlan(TIOModelIO *io, NSArray<NSString*> * _Nullable trainingOps, NSArray<NSString*> * _Nullable accumulateOps, NSArray<NSString*> * _Nullable applyOps, TIOTensorFlowRunPlan &plan) {
+    plan = TIOTensorFlowRunPlan();
+    
+    for ( TIOLayerInterface *interface in io.inputs.all ) {
+        plan.inputs.push_back(TIOTensorFlowPlanLayer(interface));
+    }
+    
+    for ( TIOLayerInterface *interface in io.placeholders.all ) {
+        plan.placeholders.push_back(TIOTensorFlowPlanLayer(interface));
+    }
+    
+    for ( TIOLayerInterface *interface in io.outputs.all ) {
+        plan.outputs.push_back(TIOTensorFlowPlanLayer(interface));
+    }
+    
+    for ( NSString *op in trainingOps ) {
+        plan.training_names.push_back(op.UTF8String);
+    }
+    
+    for ( NSString *op in accumulateOps ) {
+        plan.accumulate_names.push_back(op.UTF8String);
+    }
+    
+    for ( NSString *op in applyOps ) {
+        plan.apply_names.push_back(op.UTF8String);
+    }
+}
+
+tensorflow::Tensor TIOTensorFlowZeroTensorForLayer(const TIOTensorFlowLayerPlan &layer) {
+    tensorflow::Tensor tensor(layer.tensor_dtype, TIOTensorFlowShapeForDescription(layer.description, 1));
+    
+    tensorflow::StringPiece data = tensor.tensor_data();
+    std::memset(const_cast<char *>(data.data()), 0, data.size());
+    
+    return tensor;
+}
+
+tensorflow::CallableOptions TIOTensorFlowCallableOptions(const TIOTensorFlowRunPlan &plan, const TIOTensorFlowCallableSignature &signature) {
+    tensorflow::CallableOptions options;
+    
+    for ( size_t index = 0; index < plan.inputs.size(); index++ ) {
+        if ( signature.feeds[index] ) {
+            options.add_feed(plan.inputs[index].tensor_name);
+        }
+    }
+    
+    for ( size_t index = 0; index < plan.placeholders.size(); index++ ) {
+        if ( signature.feeds[plan.inputs.size() + index] ) {
+            options.add_feed(plan.placeholders[index].tensor_name);
+        }
+    }
+    
+    for ( size_t index = 0; index < plan.outputs.size(); index++ ) {
+        if ( signature.fetches[index] ) {
+            options.add_fetch(plan.outputs[index].tensor_name);
+        }
+    }
+    
+    const TensorNames *targets = nullptr;
+    
+    switch (signature.targets) {
+    case TIOTensorFlowTargets::None:
+        break;
+    case TIOTensorFlowTargets::Train:
+        targets = &plan.training_names;
+        break;
+    case TIOTensorFlowTargets::Accumulate:
+        targets = &plan.accumulate_names;
+        break;
+    case TIOTensorFlowTargets::Apply:
+        targets = &plan.apply_names;
+        break;
+    }
+    
+    if ( targets != nullptr ) {
+        for ( const std::string &name : *targets ) {
+            options.add_target(name);
+        }
+    }
+    
+    return options;
+}
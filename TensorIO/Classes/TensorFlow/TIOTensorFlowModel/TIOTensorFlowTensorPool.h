@@ -0,0 +1,77 @@
+//
+//  TIOTensorFlowTensorPool.h
+//  TensorIO
+//
+//  Created by Phil Dow on 10/17/20.
+//  Copyright © 2020 doc.ai (http://doc.ai)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+#import "TIOTensorFlowModel.h"
+#import "TIOTensorFlowRunPlan.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * The persistent input and placeholder tensors of a loaded TensorFlow model.
+ *
+ * The pool keeps one tensor for each layer and batch size, identified by the layer's slot in
+ * the plan's feeds, and the model's converters write each new column of data into that tensor
+ * rather than into a newly allocated one. A tensor is only lent out while no one else holds a
+ * reference to its buffer, so concurrent runs, or a session that holds on to a fed tensor,
+ * fall back to allocating a new tensor for the run.
+ *
+ * Placeholder tensors additionally remember the values they were filled with and are fed as is
+ * while those values do not change.
+ */
+
+@interface TIOTensorFlowTensorPool : NSObject
+
+/**
+ * Statistics describing how often tensors were allocated and reused.
+ */
+
+@property (readonly) TIOTensorFlowTensorPoolStats stats;
+
+/**
+ * Returns a tensor filled with a column of input data.
+ *
+ * @param layer The planned input layer.
+ * @param slot The layer's index in the callable feeds, i.e. inputs then placeholders.
+ * @param column The layer's data, one item per batch item.
+ *
+ * @return tensorflow::Tensor A tensor holding the column, backed by the pooled tensor if it
+ *  was available.
+ */
+
+- (tensorflow::Tensor)tensorForLayer:(const TIOTensorFlowLayerPlan &)layer slot:(size_t)slot column:(NSArray<id<TIOTensorFlowData>> *)column;
+
+/**
+ * Returns a tensor filled with a placeholder's value, which is only rewritten if the value is
+ * not equal to the one the pooled tensor was last filled with.
+ *
+ * @param layer The planned placeholder layer.
+ * @param slot The layer's index in the callable feeds, i.e. inputs then placeholders.
+ * @param column The placeholder's value, as a column of one item.
+ *
+ * @return tensorflow::Tensor A tensor holding the value.
+ */
+
+- (tensorflow::Tensor)placeholderTensorForLayer:(const TIOTensorFlowLayerPlan &)layer slot:(size_t)slot column:(NSArray<id<TIOTensorFlowData>> *)column;
+
+@end
+
+NS_ASSUME_NONNULL_END
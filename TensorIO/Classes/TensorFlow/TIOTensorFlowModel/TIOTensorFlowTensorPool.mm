@@ -0,0 +1,146 @@
+//
+//  TIOTensorFlowTensorPool.mm
+//  TensorIO
+//
+//  Created by Phil Dow on 10/17/20.
+//  Copyright © 2020 doc.ai (http://doc.ai)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "TIOTensorFlowTensorPool.h"
+
+#import "TIOTensorFlowDataLayout.h"
+
+#import <os/lock.h>
+
+#include <map>
+#include <utility>
+
+/**
+ * A layer's slot in the callable feeds and the batch size its tensor holds.
+ */
+
+typedef std::pair<size_t, NSUInteger> TIOTensorFlowTensorPoolKey;
+
+struct TIOTensorFlowPooledTensor {
+    tensorflow::Tensor tensor;
+    NSArray *values; // The placeholder values the tensor holds, nil if unknown
+};
+
+/**
+ * Copies a placeholder's values so that later changes to a mutable value are noticed.
+ */
+
+static NSArray *TIOTensorFlowSnapshotColumn(NSArray<id<TIOTensorFlowData>> *column) {
+    NSMutableArray *snapshot = [[NSMutableArray alloc] initWithCapacity:column.count];
+    
+    for ( id<TIOTensorFlowData> item in column ) {
+        [snapshot addObject:[item conformsToProtocol:@protocol(NSCopying)]
+            ? [(id<NSCopying>)item copyWithZone:nil]
+            : item];
+    }
+    
+    return snapshot;
+}
+
+@implementation TIOTensorFlowTensorPool {
+    os_unfair_lock _lock;
+    std::map<TIOTensorFlowTensorPoolKey, TIOTensorFlowPooledTensor> _tensors;
+    TIOTensorFlowTensorPoolStats _stats;
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _lock = OS_UNFAIR_LOCK_INIT;
+        _stats = {0};
+    }
+    return self;
+}
+
+- (TIOTensorFlowTensorPoolStats)stats {
+    os_unfair_lock_lock(&_lock);
+    TIOTensorFlowTensorPoolStats stats = _stats;
+    os_unfair_lock_unlock(&_lock);
+    return stats;
+}
+
+// MARK: - Tensors
+
+- (tensorflow::Tensor)tensorForLayer:(const TIOTensorFlowLayerPlan &)layer slot:(size_t)slot column:(NSArray<id<TIOTensorFlowData>> *)column {
+    return [self _tensorForLayer:layer slot:slot column:column comparesValues:NO];
+}
+
+- (tensorflow::Tensor)placeholderTensorForLayer:(const TIOTensorFlowLayerPlan &)layer slot:(size_t)slot column:(NSArray<id<TIOTensorFlowData>> *)column {
+    return [self _tensorForLayer:layer slot:slot column:column comparesValues:YES];
+}
+
+- (tensorflow::Tensor)_tensorForLayer:(const TIOTensorFlowLayerPlan &)layer slot:(size_t)slot column:(NSArray<id<TIOTensorFlowData>> *)column comparesValues:(BOOL)comparesValues {
+    const TIOTensorFlowTensorPoolKey key(slot, column.count);
+    tensorflow::Tensor tensor;
+    BOOL pooled = NO;
+    
+    // Borrow the pooled tensor if no one else holds a reference to it. Copying the tensor
+    // shares its buffer, which marks it as in use until the copy is released
+    
+    os_unfair_lock_lock(&_lock);
+    
+    auto entry = _tensors.find(key);
+    
+    if ( entry != _tensors.end() && entry->second.tensor.RefCountIsOne() ) {
+        tensor = entry->second.tensor;
+        pooled = YES;
+        
+        if ( comparesValues && [entry->second.values isEqualToArray:column] ) {
+            _stats.unchanged++;
+            os_unfair_lock_unlock(&_lock);
+            return tensor;
+        }
+        
+        entry->second.values = nil;
+        _stats.reuses++;
+    } else {
+        _stats.allocations++;
+    }
+    
+    os_unfair_lock_unlock(&_lock);
+    
+    // Write the column outside the lock
+    
+    if ( !pooled ) {
+        tensor = tensorflow::Tensor(layer.tensor_dtype, TIOTensorFlowShapeForDescription(layer.description, column.count));
+    }
+    
+    layer.build(column, layer.description, tensor);
+    
+    NSArray *values = comparesValues
+        ? TIOTensorFlowSnapshotColumn(column)
+        : nil;
+    
+    // Remember what a borrowed tensor now holds, or pool a new tensor if the slot is empty.
+    // Entries are never removed, so the iterator is still valid
+    
+    os_unfair_lock_lock(&_lock);
+    
+    if ( pooled ) {
+        entry->second.values = values;
+    } else if ( _tensors.find(key) == _tensors.end() ) {
+        _tensors[key] = {tensor, values};
+    }
+    
+    os_unfair_lock_unlock(&_lock);
+    
+    return tensor;
+}
+
+@end
@@ -44,6 +44,51 @@ NS_ASSUME_NONNULL_BEGIN
 
 @property (readonly) NSUInteger trainCount;
 
+/**
+ * Tracks the number of times a train: method has been called that fetches the
+ * model's outputs.
+ */
+
+@property (readonly) NSUInteger fetchCount;
+
+/**
+ * Tracks the number of times the accumulate: method has been called.
+ */
+
+@property (readonly) NSUInteger accumulateCount;
+
+/**
+ * Tracks the number of times the applyAccumulatedGradients: method has been
+ * called.
+ */
+
+@property (readonly) NSUInteger applyCount;
+
+/**
+ * Tracks the number of times the prepareBatch: method has been called.
+ */
+
+@property (readonly) NSUInteger prepareCount;
+
+/**
+ * Tracks the number of times a train: or accumulate: method has been called
+ * with a batch returned by prepareBatch:.
+ */
+
+@property (readonly) NSUInteger preparedTrainCount;
+
+/**
+ * Set to `YES` to mock a model that supports gradient accumulation.
+ */
+
+@property BOOL accumulatesGradients;
+
+/**
+ * Set to `YES` to mock a model whose applyAccumulatedGradients: method fails.
+ */
+
+@property BOOL failsToApplyGradients;
+
 /**
  * Tracks the number of times the exportTo: method has been called.
  */
@@ -100,13 +145,19 @@ NS_ASSUME_NONNULL_BEGIN
 - (id<TIOData>)runOn:(id<TIOData>)input placeholders:(nullable NSDictionary<NSString*,id<TIOData>> *)placeholders error:(NSError* _Nullable *)error;
 - (id<TIOData>)run:(TIOBatch *)batch error:(NSError * _Nullable *)error;
 - (id<TIOData>)run:(TIOBatch *)batch placeholders:(nullable NSDictionary<NSString*,id<TIOData>> *)placeholders error:(NSError * _Nullable *)error;
+- (id<TIOData>)runOn:(id<TIOData>)input outputs:(NSArray<NSString*> *)outputs error:(NSError * _Nullable *)error;
+- (void)runOn:(id<TIOData>)input completion:(TIOModelCompletionHandler)completion;
 - (id<TIOData>)runOn:(id<TIOData>)input __attribute__((deprecated));
 
 // MARK: - Train
 
 - (id<TIOData>)train:(TIOBatch *)batch error:(NSError * _Nullable *)error;
 - (id<TIOData>)train:(TIOBatch *)batch placeholders:(nullable NSDictionary<NSString*,id<TIOData>> *)placeholders error:(NSError * _Nullable *)error;
+- (id<TIOData>)train:(TIOBatch *)batch placeholders:(nullable NSDictionary<NSString*,id<TIOData>> *)placeholders fetchOutputs:(BOOL)fetchOutputs error:(NSError * _Nullable *)error;
 - (id<TIOData>)train:(TIOBatch *)batch __attribute__((deprecated));
+- (id<TIOData>)accumulate:(TIOBatch *)batch placeholders:(nullable NSDictionary<NSString*,id<TIOData>> *)placeholders fetchOutputs:(BOOL)fetchOutputs error:(NSError * _Nullable *)error;
+- (BOOL)applyAccumulatedGradients:(nullable NSDictionary<NSString*,id<TIOData>> *)placeholders error:(NSError * _Nullable *)error;
+- (nullable TIOBatch *)prepareBatch:(TIOBatch *)batch error:(NSError * _Nullable *)error;
 
 - (BOOL)exportTo:(NSURL *)fileURL error:(NSError * _Nullable *)error;
 
@@ -20,14 +20,16 @@
 
 #import "TIOMockTrainableModel.h"
 
-@implementation TIOMockTrainableModel
+@implementation TIOMockTrainableModel {
+    NSHashTable<TIOBatch*> *_preparedBatches;
+}
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wobjc-designated-initializers"
 
 - (instancetype)initMock {
     if ((self=[super init])) {
-    
+        _preparedBatches = [NSHashTable weakObjectsHashTable];
     }
     return self;
 }
@@ -44,7 +46,13 @@
     if ((self=[super init])) {
         _runCount = 0;
         _trainCount = 0;
+        _fetchCount = 0;
+        _accumulateCount = 0;
+        _applyCount = 0;
         _exportCount = 0;
+        _prepareCount = 0;
+        _preparedTrainCount = 0;
+        _preparedBatches = [NSHashTable weakObjectsHashTable];
     }
     return self;
 }
@@ -86,23 +94,95 @@
     return @{};
 }
 
+- (id<TIOData>)runOn:(id<TIOData>)input outputs:(NSArray<NSString*> *)outputs error:(NSError * _Nullable *)error {
+    _runCount++;
+    return @{};
+}
+
+- (void)runOn:(id<TIOData>)input completion:(TIOModelCompletionHandler)completion {
+    _runCount++;
+    completion(@{}, nil);
+}
+
 // MARK: - Train
 
 - (id<TIOData>)train:(TIOBatch *)batch {
     _trainCount++;
+    _fetchCount++;
     return @{};
 }
 
 - (id<TIOData>)train:(TIOBatch *)batch error:(NSError * _Nullable *)error {
     _trainCount++;
+    _fetchCount++;
     return @{};
 }
 
 - (id<TIOData>)train:(TIOBatch *)batch placeholders:(nullable NSDictionary<NSString*,id<TIOData>> *)placeholders error:(NSError * _Nullable *)error {
+    [self _countPreparedBatch:batch];
     _trainCount++;
+    _fetchCount++;
+    return @{};
+}
+
+- (id<TIOData>)train:(TIOBatch *)batch placeholders:(nullable NSDictionary<NSString*,id<TIOData>> *)placeholders fetchOutputs:(BOOL)fetchOutputs error:(NSError * _Nullable *)error {
+    [self _countPreparedBatch:batch];
+    _trainCount++;
+    if ( fetchOutputs ) {
+        _fetchCount++;
+    }
+    return @{};
+}
+
+// MARK: - Gradient Accumulation
+
+- (id<TIOData>)accumulate:(TIOBatch *)batch placeholders:(nullable NSDictionary<NSString*,id<TIOData>> *)placeholders fetchOutputs:(BOOL)fetchOutputs error:(NSError * _Nullable *)error {
+    [self _countPreparedBatch:batch];
+    _accumulateCount++;
+    if ( fetchOutputs ) {
+        _fetchCount++;
+    }
     return @{};
 }
 
+- (BOOL)applyAccumulatedGradients:(nullable NSDictionary<NSString*,id<TIOData>> *)placeholders error:(NSError * _Nullable *)error {
+    _applyCount++;
+    
+    if ( self.failsToApplyGradients ) {
+        if ( error ) {
+            *error = [NSError errorWithDomain:@"ai.doc.tensorio" code:0 userInfo:nil];
+        }
+        return NO;
+    }
+    
+    return YES;
+}
+
+// MARK: - Batch Preparation
+
+- (nullable TIOBatch *)prepareBatch:(TIOBatch *)batch error:(NSError * _Nullable *)error {
+    TIOBatch *prepared = [[TIOBatch alloc] initWithKeys:batch.keys];
+    
+    for ( NSUInteger index = 0; index < batch.count; index++ ) {
+        [prepared addItem:[batch itemAtIndex:index]];
+    }
+    
+    @synchronized (_preparedBatches) {
+        [_preparedBatches addObject:prepared];
+        _prepareCount++;
+    }
+    
+    return prepared;
+}
+
+- (void)_countPreparedBatch:(TIOBatch *)batch {
+    @synchronized (_preparedBatches) {
+        if ( [_preparedBatches containsObject:batch] ) {
+            _preparedTrainCount++;
+        }
+    }
+}
+
 // MARK: - Export
 
 - (BOOL)exportTo:(NSURL *)fileURL error:(NSError * _Nullable *)error {
@@ -169,6 +169,47 @@
     XCTAssertNil(error);
 }
 
+- (void)testPixelNormalizationForDictionaryParsesScaleAndBias {
+    // it should return the scale and biases
+    // it should return no error
+    
+    NSError *error;
+    NSDictionary *dict = @{
+        @"scale": @(0.5),
+        @"bias": @{
+            @"r": @(-1),
+            @"g": @(-2),
+            @"b": @(-3)
+        }
+    };
+    
+    TIOPixelNormalization normalization = TIOPixelNormalizationForDictionary(dict, &error);
+    TIOPixelNormalization expected = {
+        .scale = 0.5,
+        .redBias = -1,
+        .greenBias = -2,
+        .blueBias = -3
+    };
+    
+    XCTAssertNil(error);
+    XCTAssertTrue(TIOPixelNormalizationsEqual(normalization, expected));
+}
+
+- (void)testPixelNormalizationForDictionaryReturnsInvalidForUnknownStandard {
+    // it should return an invalid normalization
+    // it should return an error
+    
+    NSError *error;
+    NSDictionary *dict = @{
+        @"standard": @"[0,2]"
+    };
+    
+    TIOPixelNormalization normalization = TIOPixelNormalizationForDictionary(dict, &error);
+    
+    XCTAssertNotNil(error);
+    XCTAssertTrue(TIOPixelNormalizationsEqual(normalization, kTIOPixelNormalizationInvalid));
+}
+
 // MARK: - Pixel Denormalization
 
 - (void)testPixelDenormalizerForDictionaryParsesStandardZeroToOne {
@@ -437,6 +478,27 @@
     XCTAssertNotNil(error);
 }
 
+- (void)testDataQuantizersForDictParseScaleAndZeroPointForInt8 {
+    // it should round and clamp values to int8 steps about the zero point
+    
+    NSError *error;
+    NSDictionary *dict = @{
+        @"scale": @(0.5),
+        @"zero_point": @(-10)
+    };
+    
+    TIODataQuantizer quantizer = TIODataQuantizerForDictWithDataType(dict, TIODataTypeInt8, &error);
+    TIODataDequantizer dequantizer = TIODataDequantizerForDictWithDataType(dict, TIODataTypeInt8, &error);
+    
+    XCTAssertNil(error);
+    XCTAssert(TIOInt8FromQuantizedValue(quantizer(0)) == -10);
+    XCTAssert(TIOInt8FromQuantizedValue(quantizer(1)) == -8);
+    XCTAssert(TIOInt8FromQuantizedValue(quantizer(1000)) == 127);
+    XCTAssert(TIOInt8FromQuantizedValue(quantizer(-1000)) == -128);
+    XCTAssert(dequantizer(TIOQuantizedValueFromInt8(-10)) == 0);
+    XCTAssert(dequantizer(TIOQuantizedValueFromInt8(-8)) == 1);
+}
+
 - (void)testDataDequantizerForDictParsesScaleAndBias {
     const float epsilon = 0.01;
     NSError *error;
@@ -491,6 +553,57 @@
     XCTAssertEqual(pixelFormat, TIOPixelFormatTypeInvalid);
 }
 
+// MARK: - Resizing
+
+- (void)testResizeModeForStringParsesLetterbox {
+    // it should parse letterbox
+    
+    TIOPixelBufferResizeMode resizeMode = TIOPixelBufferResizeModeForString(@"letterbox");
+    XCTAssertEqual(resizeMode, TIOPixelBufferResizeModeLetterbox);
+}
+
+- (void)testResizeModeForStringReturnsCenterCropForNilString {
+    // it should return the default
+    
+    TIOPixelBufferResizeMode resizeMode = TIOPixelBufferResizeModeForString(nil);
+    XCTAssertEqual(resizeMode, TIOPixelBufferResizeModeCenterCrop);
+}
+
+- (void)testResizeModeForStringReturnsInvalidForOtherString {
+    // it should return invalid
+    
+    TIOPixelBufferResizeMode resizeMode = TIOPixelBufferResizeModeForString(@"zoom");
+    XCTAssertEqual(resizeMode, TIOPixelBufferResizeModeInvalid);
+}
+
+- (void)testInterpolationForStringParsesNearest {
+    // it should parse nearest
+    
+    TIOPixelBufferInterpolation interpolation = TIOPixelBufferInterpolationForString(@"nearest");
+    XCTAssertEqual(interpolation, TIOPixelBufferInterpolationNearest);
+}
+
+- (void)testInterpolationForStringParsesLanczos {
+    // it should parse lanczos
+    
+    TIOPixelBufferInterpolation interpolation = TIOPixelBufferInterpolationForString(@"lanczos");
+    XCTAssertEqual(interpolation, TIOPixelBufferInterpolationLanczos);
+}
+
+- (void)testInterpolationForStringReturnsLanczosForNilString {
+    // it should return the default
+    
+    TIOPixelBufferInterpolation interpolation = TIOPixelBufferInterpolationForString(nil);
+    XCTAssertEqual(interpolation, TIOPixelBufferInterpolationLanczos);
+}
+
+- (void)testInterpolationForStringReturnsInvalidForOtherString {
+    // it should return invalid
+    
+    TIOPixelBufferInterpolation interpolation = TIOPixelBufferInterpolationForString(@"sinc");
+    XCTAssertEqual(interpolation, TIOPixelBufferInterpolationInvalid);
+}
+
 // MARK: - Image Volume
 
 - (void)testImageVolumeForShapeReturnsInvalidForNilInput {
@@ -569,4 +682,47 @@
     XCTAssert(TIODataTypeForString(@"int64") == TIODataTypeInt64);
 }
 
+- (void)testParsersFloat16DataType {
+    XCTAssert(TIODataTypeForString(@"float16") == TIODataTypeFloat16);
+}
+
+- (void)testParsersInt8DataType {
+    XCTAssert(TIODataTypeForString(@"int8") == TIODataTypeInt8);
+}
+
+// MARK: - Session Options
+
+- (void)testParsesSessionOptions {
+    TIOModelOptions *options = [[TIOModelOptions alloc] initWithDictionary:@{
+        @"session": @{
+            @"intra_op_threads": @(2),
+            @"inter_op_threads": @(1),
+            @"optimizer_level": @"L1",
+            @"constant_folding": @(YES)
+        }
+    }];
+    
+    XCTAssert(options.session.intraOpThreads == 2);
+    XCTAssert(options.session.interOpThreads == 1);
+    XCTAssert(options.session.optimizerLevel == TIOModelOptimizerLevelL1);
+    XCTAssertEqualObjects(options.session.constantFolding, @(YES));
+}
+
+- (void)testMissingSessionOptionsLeaveTheBackendDefaults {
+    TIOModelOptions *options = [[TIOModelOptions alloc] initWithDictionary:@{}];
+    
+    XCTAssertNotNil(options.session);
+    XCTAssert(options.session.intraOpThreads == 0);
+    XCTAssert(options.session.interOpThreads == 0);
+    XCTAssert(options.session.optimizerLevel == TIOModelOptimizerLevelDefault);
+    XCTAssertNil(options.session.constantFolding);
+}
+
+- (void)testParsesOptimizerLevels {
+    XCTAssert(TIOModelOptimizerLevelFromString(@"L0") == TIOModelOptimizerLevelL0);
+    XCTAssert(TIOModelOptimizerLevelFromString(@"L1") == TIOModelOptimizerLevelL1);
+    XCTAssert(TIOModelOptimizerLevelFromString(@"L2") == TIOModelOptimizerLevelDefault);
+    XCTAssert(TIOModelOptimizerLevelFromString(nil) == TIOModelOptimizerLevelDefault);
+}
+
 @end
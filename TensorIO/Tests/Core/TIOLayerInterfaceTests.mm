@@ -160,4 +160,32 @@
     XCTAssert(descriptionUInt8.length == 1);
 }
 
+// MARK: - Pixel Buffer Layer Description Tests
+
+- (void)testPixelBufferVisionPipelineIsSharedAndDoesNotRetainDescription {
+    __weak TIOPixelBufferLayerDescription *weakDescription = nil;
+    TIOVisionPipeline *pipeline = nil;
+    
+    @autoreleasepool {
+        NSArray *shape = @[@(224), @(224), @(3)];
+        TIOPixelBufferLayerDescription *description = [[TIOPixelBufferLayerDescription alloc]
+            initWithPixelFormat:kCVPixelFormatType_32BGRA
+            shape:shape
+            imageVolume:TIOImageVolumeForShape(shape)
+            batched:NO
+            normalizer:nil
+            denormalizer:nil
+            quantized:NO];
+        
+        pipeline = description.visionPipeline;
+        weakDescription = description;
+        
+        XCTAssertNotNil(pipeline);
+        XCTAssertEqual(description.visionPipeline, pipeline);
+        XCTAssertEqual(pipeline.pixelBufferDescription, description);
+    }
+    
+    XCTAssertNil(weakDescription);
+}
+
 @end
@@ -492,4 +492,153 @@
     XCTAssert([dataSource itemAtIndexCountAtIndex:2] == 2);
 }
 
+// MARK: - Loss Interval Tests
+
+- (void)testFetchesOutputsEveryStepByDefault {
+    TIOMockBatchDataSource *dataSource = [[TIOMockBatchDataSource alloc] initWithItemCount:4];
+    TIOMockTrainableModel *model = [[TIOMockTrainableModel alloc] initMock];
+    
+    TIOModelTrainer *trainer = [[TIOModelTrainer alloc] initWithModel:model dataSource:dataSource placeholders:nil epochs:2 batchSize:1 shuffle:NO];
+    
+    [trainer train];
+    
+    XCTAssert(model.trainCount == 8);
+    XCTAssert(model.fetchCount == 8);
+}
+
+- (void)testFetchesOutputsEveryKStepsAndAtTheEndOfEachEpoch {
+    TIOMockBatchDataSource *dataSource = [[TIOMockBatchDataSource alloc] initWithItemCount:5];
+    TIOMockTrainableModel *model = [[TIOMockTrainableModel alloc] initMock];
+    
+    TIOModelTrainer *trainer = [[TIOModelTrainer alloc] initWithModel:model dataSource:dataSource placeholders:nil epochs:2 batchSize:1 shuffle:NO];
+    trainer.lossInterval = 3;
+    
+    [trainer train];
+    
+    // Steps 3, 5 (end of epoch), 6, 9, and 10 (end of epoch)
+    
+    XCTAssert(model.trainCount == 10);
+    XCTAssert(model.fetchCount == 5);
+}
+
+- (void)testFetchesOutputsOnlyAtTheEndOfEachEpoch {
+    TIOMockBatchDataSource *dataSource = [[TIOMockBatchDataSource alloc] initWithItemCount:4];
+    TIOMockTrainableModel *model = [[TIOMockTrainableModel alloc] initMock];
+    
+    TIOModelTrainer *trainer = [[TIOModelTrainer alloc] initWithModel:model dataSource:dataSource placeholders:nil epochs:3 batchSize:1 shuffle:NO];
+    trainer.lossInterval = 0;
+    
+    __block NSUInteger callbacks = 0;
+    
+    [trainer train:^(NSUInteger epoch, id<TIOData> results, NSError * _Nullable error) {
+        callbacks++;
+    }];
+    
+    XCTAssert(callbacks == 3);
+    XCTAssert(model.trainCount == 12);
+    XCTAssert(model.fetchCount == 3);
+}
+
+- (void)testAccumulatesGradientsOverMicroBatchesAndAppliesThemEveryKSteps {
+    TIOMockBatchDataSource *dataSource = [[TIOMockBatchDataSource alloc] initWithItemCount:5];
+    TIOMockTrainableModel *model = [[TIOMockTrainableModel alloc] initMock];
+    model.accumulatesGradients = YES;
+    
+    TIOModelTrainer *trainer = [[TIOModelTrainer alloc] initWithModel:model dataSource:dataSource placeholders:nil epochs:2 batchSize:1 shuffle:NO];
+    trainer.accumulationSteps = 2;
+    
+    [trainer train];
+    
+    // Applies after micro-batches 2, 4, and 5 (end of epoch) in each epoch
+    
+    XCTAssert(model.trainCount == 0);
+    XCTAssert(model.accumulateCount == 10);
+    XCTAssert(model.applyCount == 6);
+    XCTAssert(model.fetchCount == 10);
+}
+
+- (void)testDoesNotReturnResultsWhenAccumulatedGradientsFailToApply {
+    TIOMockBatchDataSource *dataSource = [[TIOMockBatchDataSource alloc] initWithItemCount:1];
+    TIOMockTrainableModel *model = [[TIOMockTrainableModel alloc] initMock];
+    model.accumulatesGradients = YES;
+    model.failsToApplyGradients = YES;
+    
+    TIOModelTrainer *trainer = [[TIOModelTrainer alloc] initWithModel:model dataSource:dataSource placeholders:nil epochs:1 batchSize:1 shuffle:NO];
+    trainer.accumulationSteps = 2;
+    
+    __block NSError *trainError;
+    __block id<TIOData> trainResults;
+    
+    [trainer train:^(NSUInteger epoch, id<TIOData> results, NSError * _Nullable error) {
+        trainResults = results;
+        trainError = error;
+    }];
+    
+    XCTAssert(model.accumulateCount == 1);
+    XCTAssert(model.applyCount == 1);
+    XCTAssertNil(trainResults);
+    XCTAssertNotNil(trainError);
+}
+
+- (void)testTrainsEachBatchWhenModelDoesNotAccumulateGradients {
+    TIOMockBatchDataSource *dataSource = [[TIOMockBatchDataSource alloc] initWithItemCount:4];
+    TIOMockTrainableModel *model = [[TIOMockTrainableModel alloc] initMock];
+    
+    TIOModelTrainer *trainer = [[TIOModelTrainer alloc] initWithModel:model dataSource:dataSource placeholders:nil epochs:1 batchSize:1 shuffle:NO];
+    trainer.accumulationSteps = 4;
+    
+    [trainer train];
+    
+    XCTAssert(model.trainCount == 4);
+    XCTAssert(model.accumulateCount == 0);
+    XCTAssert(model.applyCount == 0);
+}
+
+- (void)testPrefetchesEachBatchOncePerEpoch {
+    TIOMockBatchDataSource *dataSource = [[TIOMockBatchDataSource alloc] initWithItemCount:5];
+    TIOMockTrainableModel *model = [[TIOMockTrainableModel alloc] initMock];
+    
+    TIOModelTrainer *trainer = [[TIOModelTrainer alloc] initWithModel:model dataSource:dataSource placeholders:nil epochs:3 batchSize:2 shuffle:YES];
+    trainer.prefetchDepth = 2;
+    
+    __block NSUInteger callbacks = 0;
+    
+    [trainer train:^(NSUInteger epoch, id<TIOData> results, NSError * _Nullable error) {
+        callbacks++;
+    }];
+    
+    XCTAssert(callbacks == 3);
+    XCTAssert(model.trainCount == 9);
+    
+    for ( NSUInteger index = 0; index < 5; index++ ) {
+        XCTAssert([dataSource itemAtIndexCountAtIndex:index] == 3);
+    }
+}
+
+- (void)testPrefetchPreparesEachBatchForTraining {
+    TIOMockBatchDataSource *dataSource = [[TIOMockBatchDataSource alloc] initWithItemCount:5];
+    TIOMockTrainableModel *model = [[TIOMockTrainableModel alloc] initMock];
+    
+    TIOModelTrainer *trainer = [[TIOModelTrainer alloc] initWithModel:model dataSource:dataSource placeholders:nil epochs:3 batchSize:2 shuffle:YES];
+    trainer.prefetchDepth = 2;
+    
+    [trainer train];
+    
+    XCTAssert(model.prepareCount == 9);
+    XCTAssert(model.trainCount == 9);
+    XCTAssert(model.preparedTrainCount == 9);
+}
+
+- (void)testDoesNotPrepareBatchesWithoutPrefetching {
+    TIOMockBatchDataSource *dataSource = [[TIOMockBatchDataSource alloc] initWithItemCount:5];
+    TIOMockTrainableModel *model = [[TIOMockTrainableModel alloc] initMock];
+    
+    TIOModelTrainer *trainer = [[TIOModelTrainer alloc] initWithModel:model dataSource:dataSource placeholders:nil epochs:3 batchSize:2 shuffle:YES];
+    
+    [trainer train];
+    
+    XCTAssert(model.prepareCount == 0);
+    XCTAssert(model.trainCount == 9);
+}
+
 @end
@@ -29,6 +29,7 @@
 
 - (nullable instancetype)initWithData:(NSData *)data description:(id<TIOLayerDescription>)description;
 - (NSData *)dataForDescription:(id<TIOLayerDescription>)description;
+- (void)getBytes:(void *)buffer description:(id<TIOLayerDescription>)description;
 
 @end
 
@@ -36,6 +37,7 @@
 
 - (nullable instancetype)initWithData:(NSData *)data description:(id<TIOLayerDescription>)description;
 - (NSData *)dataForDescription:(id<TIOLayerDescription>)description;
+- (void)getBytes:(void *)buffer description:(id<TIOLayerDescription>)description;
 
 @end
 
@@ -50,6 +52,7 @@
 
 - (nullable instancetype)initWithData:(NSData *)data description:(id<TIOLayerDescription>)description;
 - (NSData *)dataForDescription:(id<TIOLayerDescription>)description;
+- (void)getBytes:(void *)buffer description:(id<TIOLayerDescription>)description;
 
 @end
 
@@ -274,6 +277,60 @@
     XCTAssertEqual(n255.floatValue, 255.0f);
 }
 
+- (void)testNumberInt8WithoutQuantizer {
+    // It should write and read the int8_t numeric value
+
+    TIOVectorLayerDescription *description = [[TIOVectorLayerDescription alloc]
+        initWithShape:@[@(1)]
+        batched:NO
+        dtype:TIODataTypeInt8
+        labels:nil
+        quantized:YES
+        quantizer:nil
+        dequantizer:nil];
+
+    NSNumber *n128 = @(-128);
+    NSData *d128 = [n128 dataForDescription:description];
+    XCTAssertEqual(d128.length, 1 * sizeof(int8_t));
+    XCTAssertEqual(((int8_t *)d128.bytes)[0], -128);
+    XCTAssertEqual([[NSNumber alloc] initWithData:d128 description:description].charValue, -128);
+
+    NSNumber *n127 = @(127);
+    NSData *d127 = [n127 dataForDescription:description];
+    XCTAssertEqual(((int8_t *)d127.bytes)[0], 127);
+    XCTAssertEqual([[NSNumber alloc] initWithData:d127 description:description].charValue, 127);
+}
+
+- (void)testNumberInt8WithScaleAndZeroPoint {
+    // It should quantize the float_t numeric value to an int8_t value and dequantize it back
+
+    TIODataAffineQuantization quantization = { 0.5f, -10 };
+
+    TIOVectorLayerDescription *description = [[TIOVectorLayerDescription alloc]
+        initWithShape:@[@(1)]
+        batched:NO
+        dtype:TIODataTypeInt8
+        labels:nil
+        quantized:YES
+        quantizer:TIODataQuantizerWithAffineQuantization(quantization, TIODataTypeInt8)
+        dequantizer:TIODataDequantizerWithAffineQuantization(quantization, TIODataTypeInt8)];
+
+    NSNumber *n0 = @(0.0f);
+    NSData *d0 = [n0 dataForDescription:description];
+    XCTAssertEqual(((int8_t *)d0.bytes)[0], -10);
+    XCTAssertEqual([[NSNumber alloc] initWithData:d0 description:description].floatValue, 0.0f);
+
+    NSNumber *n1 = @(1.0f);
+    NSData *d1 = [n1 dataForDescription:description];
+    XCTAssertEqual(((int8_t *)d1.bytes)[0], -8);
+    XCTAssertEqual([[NSNumber alloc] initWithData:d1 description:description].floatValue, 1.0f);
+
+    NSNumber *n100 = @(100.0f);
+    NSData *d100 = [n100 dataForDescription:description];
+    XCTAssertEqual(((int8_t *)d100.bytes)[0], 127);
+    XCTAssertEqual([[NSNumber alloc] initWithData:d100 description:description].floatValue, 68.5f);
+}
+
 // MARK: - NSArray + TIOTFLiteData Get Bytes
 
 - (void)testArrayGetBytesFloatUnquantized {
@@ -297,6 +354,29 @@
     XCTAssertEqual(bytes[2], 1.0f);
 }
 
+- (void)testArrayGetBytesIntoBufferFloatUnquantized {
+    // It should write the float_t numeric values directly into the buffer
+
+    TIOVectorLayerDescription *description = [[TIOVectorLayerDescription alloc]
+        initWithShape:@[@(3)]
+        batched:NO
+        dtype:TIODataTypeUnknown
+        labels:nil
+        quantized:NO
+        quantizer:nil
+        dequantizer:nil];
+
+    NSArray *numbers = @[ @(-1.0f), @(0.0f), @(1.0f)];
+    float_t buffer[4] = { 9.0f, 9.0f, 9.0f, 9.0f };
+    
+    [numbers getBytes:buffer description:description];
+    
+    XCTAssertEqual(buffer[0], -1.0f);
+    XCTAssertEqual(buffer[1], 0.0f);
+    XCTAssertEqual(buffer[2], 1.0f);
+    XCTAssertEqual(buffer[3], 9.0f);
+}
+
 - (void)testArrayGetBytesUInt8QuantizedWithoutQuantizer {
     // It should get the uint8_t numeric values
 
@@ -343,6 +423,32 @@
     XCTAssertEqual(bytes[2], 255);
 }
 
+- (void)testArrayGetBytesFloat16 {
+    // It should narrow the numeric values to half precision and widen them back
+
+    TIOVectorLayerDescription *description = [[TIOVectorLayerDescription alloc]
+        initWithShape:@[@(3)]
+        batched:NO
+        dtype:TIODataTypeFloat16
+        labels:nil
+        quantized:NO
+        quantizer:nil
+        dequantizer:nil];
+
+    NSArray *numbers = @[ @(-1.0f), @(0.5f), @(2.0f)];
+    NSData *data = [numbers dataForDescription:description];
+    XCTAssertEqual(data.length, 3 * sizeof(TIOFloat16));
+    
+    TIOFloat16 *bytes = (TIOFloat16 *)data.bytes;
+    
+    XCTAssertEqual(TIOFloat32FromFloat16(bytes[0]), -1.0f);
+    XCTAssertEqual(TIOFloat32FromFloat16(bytes[1]), 0.5f);
+    XCTAssertEqual(TIOFloat32FromFloat16(bytes[2]), 2.0f);
+    
+    NSArray *result = [[NSArray alloc] initWithData:data description:description];
+    XCTAssertEqualObjects(result, numbers);
+}
+
 // MARK: - NSArray + TIOTFLiteData Init with Bytes
 
 - (void)testArrayInitWithBytesFloatUnquantized {
@@ -415,6 +521,60 @@
     XCTAssertEqual(numbers[2].unsignedCharValue, 255.0);
 }
 
+- (void)testArrayInt8WithoutQuantizer {
+    // It should write and read the int8_t numeric values
+
+    TIOVectorLayerDescription *description = [[TIOVectorLayerDescription alloc]
+        initWithShape:@[@(3)]
+        batched:NO
+        dtype:TIODataTypeInt8
+        labels:nil
+        quantized:YES
+        quantizer:nil
+        dequantizer:nil];
+
+    NSArray *numbers = @[ @(-128), @(0), @(127)];
+    NSData *data = [numbers dataForDescription:description];
+    XCTAssertEqual(data.length, 3 * sizeof(int8_t));
+
+    int8_t *bytes = (int8_t *)data.bytes;
+
+    XCTAssertEqual(bytes[0], -128);
+    XCTAssertEqual(bytes[1], 0);
+    XCTAssertEqual(bytes[2], 127);
+
+    NSArray<NSNumber*> *result = [[NSArray alloc] initWithData:data description:description];
+    XCTAssertEqual(result[0].charValue, -128);
+    XCTAssertEqual(result[1].charValue, 0);
+    XCTAssertEqual(result[2].charValue, 127);
+}
+
+- (void)testArrayInt8WithScaleAndZeroPoint {
+    // It should quantize the float_t numeric values to int8_t values and dequantize them back
+
+    TIODataAffineQuantization quantization = { 0.5f, -10 };
+
+    TIOVectorLayerDescription *description = [[TIOVectorLayerDescription alloc]
+        initWithShape:@[@(3)]
+        batched:NO
+        dtype:TIODataTypeInt8
+        labels:nil
+        quantized:YES
+        quantizer:TIODataQuantizerWithAffineQuantization(quantization, TIODataTypeInt8)
+        dequantizer:TIODataDequantizerWithAffineQuantization(quantization, TIODataTypeInt8)];
+
+    NSArray *numbers = @[ @(-1.0f), @(0.0f), @(1.0f)];
+    NSData *data = [numbers dataForDescription:description];
+    int8_t *bytes = (int8_t *)data.bytes;
+
+    XCTAssertEqual(bytes[0], -12);
+    XCTAssertEqual(bytes[1], -10);
+    XCTAssertEqual(bytes[2], -8);
+
+    NSArray<NSNumber*> *result = [[NSArray alloc] initWithData:data description:description];
+    XCTAssertEqualObjects(result, numbers);
+}
+
 // MARK: - NSData + TIOTFLiteData Get Bytes
 
 - (void)testDataGetVectorBytesFloatUnquantized {
@@ -647,6 +807,59 @@
     XCTAssertEqual(buffer[2], 255);
 }
 
+- (void)testDataInt8VectorBytesWithoutQuantizer {
+    // It should copy the int8_t values
+
+    TIOVectorLayerDescription *description = [[TIOVectorLayerDescription alloc]
+        initWithShape:@[@(3)]
+        batched:NO
+        dtype:TIODataTypeInt8
+        labels:nil
+        quantized:YES
+        quantizer:nil
+        dequantizer:nil];
+
+    int8_t values[3] = { -128, 0, 127 };
+    NSData *data = [NSData dataWithBytes:values length:3 * sizeof(int8_t)];
+
+    NSData *tensor = [data dataForDescription:description];
+    XCTAssertEqual(tensor.length, 3 * sizeof(int8_t));
+    XCTAssertEqualObjects(tensor, data);
+
+    NSData *result = [[NSData alloc] initWithData:tensor description:description];
+    XCTAssertEqualObjects(result, data);
+}
+
+- (void)testDataInt8VectorBytesWithScaleAndZeroPoint {
+    // It should quantize float_t values to int8_t values and dequantize them back to float_t values
+
+    TIODataAffineQuantization quantization = { 0.5f, -10 };
+
+    TIOVectorLayerDescription *description = [[TIOVectorLayerDescription alloc]
+        initWithShape:@[@(3)]
+        batched:NO
+        dtype:TIODataTypeInt8
+        labels:nil
+        quantized:YES
+        quantizer:TIODataQuantizerWithAffineQuantization(quantization, TIODataTypeInt8)
+        dequantizer:TIODataDequantizerWithAffineQuantization(quantization, TIODataTypeInt8)];
+
+    float_t values[3] = { -1.0f, 0.0f, 1.0f };
+    NSData *data = [NSData dataWithBytes:values length:3 * sizeof(float_t)];
+
+    NSData *tensor = [data dataForDescription:description];
+    XCTAssertEqual(tensor.length, 3 * sizeof(int8_t));
+
+    int8_t *bytes = (int8_t *)tensor.bytes;
+
+    XCTAssertEqual(bytes[0], -12);
+    XCTAssertEqual(bytes[1], -10);
+    XCTAssertEqual(bytes[2], -8);
+
+    NSData *result = [[NSData alloc] initWithData:tensor description:description];
+    XCTAssertEqualObjects(result, data);
+}
+
 // MARK: - TIOPixelBuffer + TIOTFLiteData Get Bytes
 
 - (void)testPixelBufferGetBytesUnnormalized {
@@ -929,4 +1142,990 @@
     free(bytes);
 }
 
+
+- (void)testPixelBufferInt8WithoutNormalization {
+    // Create ARGB bytes
+
+    const int width = 2;
+    const int height = 2;
+    const int channels = 4;
+
+    // Create a pixel buffer
+
+    const OSType format = kCVPixelFormatType_32ARGB;
+    CVPixelBufferRef pixelBuffer = NULL;
+
+    CVReturn status = CVPixelBufferCreate(
+        kCFAllocatorDefault,
+        width,
+        height,
+        format,
+        NULL,
+        &pixelBuffer);
+
+    if ( status != kCVReturnSuccess ) {
+        XCTFail(@"Couldn't create pixel buffer");
+    }
+
+    // Fill the pixel buffer with values that span the range of a byte
+
+    CVPixelBufferLockBaseAddress(pixelBuffer, kNilOptions);
+    uint8_t *baseAddress = (uint8_t *)CVPixelBufferGetBaseAddress(pixelBuffer);
+    size_t bytesPerRow = CVPixelBufferGetBytesPerRow(pixelBuffer);
+
+    for ( int y = 0; y < height; y++ ) {
+        for ( int x = 0; x < width; x++ ) {
+            uint8_t *pixel = baseAddress + (y * bytesPerRow) + (x * channels);
+
+            pixel[0] = 255;             // A
+            pixel[1] = 0;               // R
+            pixel[2] = 128 + x + y;     // G
+            pixel[3] = 255;             // B
+        }
+    }
+
+    CVPixelBufferUnlockBaseAddress(pixelBuffer, kNilOptions);
+
+    // Without a normalizer pixel values are offset by -128 into the int8 tensor
+
+    TIOPixelBuffer *pixelBufferWrapper = [[TIOPixelBuffer alloc] initWithPixelBuffer:pixelBuffer orientation:kCGImagePropertyOrientationUp];
+    NSArray *shape = @[@(height),@(width),@(3)];
+    TIOImageVolume volume = TIOImageVolumeForShape(shape);
+
+    TIOPixelBufferLayerDescription *description = [[TIOPixelBufferLayerDescription alloc]
+        initWithPixelFormat:kCVPixelFormatType_32ARGB
+        shape:shape
+        imageVolume:volume
+        batched:NO
+        dtype:TIODataTypeInt8
+        normalization:kTIOPixelNormalizationNone
+        denormalization:kTIOPixelDenormalizationNone
+        quantized:NO];
+
+    const int tensor_channels = 3;
+
+    NSData *data = [pixelBufferWrapper dataForDescription:description];
+    XCTAssertEqual(data.length, width * height * tensor_channels * sizeof(int8_t));
+
+    int8_t *tensor_bytes = (int8_t *)data.bytes;
+
+    for ( int y = 0; y < height; y++ ) {
+        for ( int x = 0; x < width; x++ ) {
+            int8_t *pixel = tensor_bytes + (y * width * tensor_channels) + (x * tensor_channels);
+
+            XCTAssertEqual(pixel[0], -128);     // R
+            XCTAssertEqual(pixel[1], x + y);    // G
+            XCTAssertEqual(pixel[2], 127);      // B
+        }
+    }
+
+    // Without a denormalizer the offset is restored when the tensor is read back
+
+    TIOPixelBuffer *result = [[TIOPixelBuffer alloc] initWithData:data description:description];
+    CVPixelBufferRef resultPixelBuffer = result.pixelBuffer;
+
+    CVPixelBufferLockBaseAddress(resultPixelBuffer, kCVPixelBufferLock_ReadOnly);
+    uint8_t *resultAddress = (uint8_t *)CVPixelBufferGetBaseAddress(resultPixelBuffer);
+    size_t resultBytesPerRow = CVPixelBufferGetBytesPerRow(resultPixelBuffer);
+
+    for ( int y = 0; y < height; y++ ) {
+        for ( int x = 0; x < width; x++ ) {
+            uint8_t *pixel = resultAddress + (y * resultBytesPerRow) + (x * channels);
+
+            XCTAssertEqual(pixel[1], 0);            // R
+            XCTAssertEqual(pixel[2], 128 + x + y);  // G
+            XCTAssertEqual(pixel[3], 255);          // B
+        }
+    }
+
+    CVPixelBufferUnlockBaseAddress(resultPixelBuffer, kCVPixelBufferLock_ReadOnly);
+
+    // Free memory
+
+    CFRelease(pixelBuffer);
+}
+
+// MARK: - TIOPixelBuffer + TIOTFLiteData Pixel Kernels
+
+- (void)testPixelBufferGetBytesWithNormalization {
+    // Create BGRA bytes, with a width that is not a multiple of the vectorized row length
+
+    const int width = 20;
+    const int height = 2;
+    const int channels = 4;
+
+    // Create a pixel buffer
+
+    const OSType format = kCVPixelFormatType_32BGRA;
+    CVPixelBufferRef pixelBuffer = NULL;
+
+    CVReturn status = CVPixelBufferCreate(
+        kCFAllocatorDefault,
+        width,
+        height,
+        format,
+        NULL,
+        &pixelBuffer);
+
+    if ( status != kCVReturnSuccess ) {
+        XCTFail(@"Couldn't create pixel buffer");
+    }
+
+    // Fill the pixel buffer, whose rows may be padded
+
+    CVPixelBufferLockBaseAddress(pixelBuffer, kNilOptions);
+    uint8_t *baseAddress = (uint8_t *)CVPixelBufferGetBaseAddress(pixelBuffer);
+    size_t bytesPerRow = CVPixelBufferGetBytesPerRow(pixelBuffer);
+
+    for ( int y = 0; y < height; y++ ) {
+        for ( int x = 0; x < width; x++ ) {
+            uint8_t *pixel = baseAddress + (y * bytesPerRow) + (x * channels);
+
+            pixel[0] = 10;  // B
+            pixel[1] = 20;  // G
+            pixel[2] = 30;  // R
+            pixel[3] = 255; // A
+        }
+    }
+
+    CVPixelBufferUnlockBaseAddress(pixelBuffer, kNilOptions);
+
+    // Get bytes from pixel buffer
+
+    TIOPixelBuffer *pixelBufferWrapper = [[TIOPixelBuffer alloc] initWithPixelBuffer:pixelBuffer orientation:kCGImagePropertyOrientationUp];
+    NSArray *shape = @[@(height),@(width),@(3)];
+    TIOImageVolume volume = TIOImageVolumeForShape(shape);
+    TIOPixelNormalization normalization = {
+        .scale = 0.5,
+        .redBias = -1,
+        .greenBias = -2,
+        .blueBias = -3
+    };
+
+    TIOPixelBufferLayerDescription *description = [[TIOPixelBufferLayerDescription alloc]
+        initWithPixelFormat:kCVPixelFormatType_32BGRA
+        shape:shape
+        imageVolume:volume
+        batched:NO
+        dtype:TIODataTypeUnknown
+        normalization:normalization
+        denormalization:kTIOPixelDenormalizationNone
+        quantized:NO];
+
+    XCTAssertNotNil(description.normalizer);
+    XCTAssertTrue(TIOPixelNormalizationsEqual(description.normalization, normalization));
+
+    const int tensor_channels = 3;
+
+    NSData *data = [pixelBufferWrapper dataForDescription:description];
+    float_t *tensor_bytes = (float_t *)data.bytes;
+
+    for ( int i = 0; i < width * height; i++) {
+        float_t *pixel = tensor_bytes + (i * tensor_channels);
+
+        XCTAssertEqual(pixel[0], 4);    // B
+        XCTAssertEqual(pixel[1], 8);    // G
+        XCTAssertEqual(pixel[2], 12);   // R
+    }
+
+    // Free memory
+
+    CFRelease(pixelBuffer);
+}
+
+- (void)testPixelBufferInitWithBytesWithDenormalization {
+    // Create floating point RGB bytes
+
+    const int width = 32;
+    const int height = 2;
+    const int channels = 3;
+
+    size_t size = width*height*channels*sizeof(float_t);
+    float_t *bytes = (float_t *)malloc(size);
+
+    for ( int i = 0; i < width * height; i++) {
+        float_t *pixel = bytes + (i * channels);
+
+        pixel[0] = 0.5; // R
+        pixel[1] = 0.5; // G
+        pixel[2] = 5.0; // B, out of range
+    }
+
+    // Create a pixel buffer from them
+
+    NSArray *shape = @[@(height),@(width),@(channels)];
+    TIOImageVolume volume = TIOImageVolumeForShape(shape);
+    TIOPixelDenormalization denormalization = {
+        .scale = 100,
+        .redBias = 0,
+        .greenBias = 0.5,
+        .blueBias = 1
+    };
+
+    TIOPixelBufferLayerDescription *description = [[TIOPixelBufferLayerDescription alloc]
+        initWithPixelFormat:kCVPixelFormatType_32ARGB
+        shape:shape
+        imageVolume:volume
+        batched:NO
+        dtype:TIODataTypeUnknown
+        normalization:kTIOPixelNormalizationNone
+        denormalization:denormalization
+        quantized:NO];
+
+    NSData *data = [NSData dataWithBytes:bytes length:size];
+    TIOPixelBuffer *pixelBufferWrapper = [[TIOPixelBuffer alloc] initWithData:data description:description];
+    CVPixelBufferRef pixelBuffer = pixelBufferWrapper.pixelBuffer;
+
+    // Get bytes to pixel buffer
+
+    CVPixelBufferLockBaseAddress(pixelBuffer, kNilOptions);
+    uint8_t *pixel_bytes = (uint8_t *)CVPixelBufferGetBaseAddress(pixelBuffer);
+    size_t bytesPerRow = CVPixelBufferGetBytesPerRow(pixelBuffer);
+
+    const int pixel_channels = 4;
+
+    for ( int y = 0; y < height; y++ ) {
+        for ( int x = 0; x < width; x++ ) {
+            uint8_t *pixel = pixel_bytes + (y * bytesPerRow) + (x * pixel_channels);
+
+            XCTAssertEqual(pixel[0], 255);  // A
+            XCTAssertEqual(pixel[1], 50);   // R
+            XCTAssertEqual(pixel[2], 100);  // G
+            XCTAssertEqual(pixel[3], 255);  // B, clamped
+        }
+    }
+
+    // Free memory
+
+    CVPixelBufferUnlockBaseAddress(pixelBuffer, kNilOptions);
+    free(bytes);
+}
+
+// MARK: - TIOPixelBuffer + TIOTFLiteData Vision Pipeline
+
+- (void)testPixelBufferGetBytesRotatedIntoTensor {
+    // Create ARGB bytes that are upside down
+
+    const int width = 4;
+    const int height = 2;
+    const int channels = 4;
+
+    // Create a pixel buffer
+
+    const OSType format = kCVPixelFormatType_32ARGB;
+    CVPixelBufferRef pixelBuffer = NULL;
+
+    CVReturn status = CVPixelBufferCreate(
+        kCFAllocatorDefault,
+        width,
+        height,
+        format,
+        NULL,
+        &pixelBuffer);
+
+    if ( status != kCVReturnSuccess ) {
+        XCTFail(@"Couldn't create pixel buffer");
+    }
+
+    // Fill the pixel buffer with values that identify each pixel
+
+    CVPixelBufferLockBaseAddress(pixelBuffer, kNilOptions);
+    uint8_t *baseAddress = (uint8_t *)CVPixelBufferGetBaseAddress(pixelBuffer);
+    size_t bytesPerRow = CVPixelBufferGetBytesPerRow(pixelBuffer);
+
+    for ( int y = 0; y < height; y++ ) {
+        for ( int x = 0; x < width; x++ ) {
+            uint8_t *pixel = baseAddress + (y * bytesPerRow) + (x * channels);
+
+            pixel[0] = 255;         // A
+            pixel[1] = x;           // R
+            pixel[2] = y;           // G
+            pixel[3] = 100 + x + y; // B
+        }
+    }
+
+    CVPixelBufferUnlockBaseAddress(pixelBuffer, kNilOptions);
+
+    // Get bytes from the pixel buffer, which the vision pipeline rotates and converts to BGR
+
+    TIOPixelBuffer *pixelBufferWrapper = [[TIOPixelBuffer alloc] initWithPixelBuffer:pixelBuffer orientation:kCGImagePropertyOrientationDown];
+    NSArray *shape = @[@(height),@(width),@(3)];
+    TIOImageVolume volume = TIOImageVolumeForShape(shape);
+
+    TIOPixelBufferLayerDescription *description = [[TIOPixelBufferLayerDescription alloc]
+        initWithPixelFormat:kCVPixelFormatType_32BGRA
+        shape:shape
+        imageVolume:volume
+        batched:NO
+        dtype:TIODataTypeUnknown
+        normalization:kTIOPixelNormalizationNone
+        denormalization:kTIOPixelDenormalizationNone
+        quantized:NO];
+
+    const int tensor_channels = 3;
+
+    NSData *data = [pixelBufferWrapper dataForDescription:description];
+    float_t *tensor_bytes = (float_t *)data.bytes;
+
+    for ( int y = 0; y < height; y++ ) {
+        for ( int x = 0; x < width; x++ ) {
+            float_t *pixel = tensor_bytes + (y * width * tensor_channels) + (x * tensor_channels);
+            int sx = width - 1 - x;
+            int sy = height - 1 - y;
+
+            XCTAssertEqual(pixel[0], 100 + sx + sy);    // B
+            XCTAssertEqual(pixel[1], sy);               // G
+            XCTAssertEqual(pixel[2], sx);               // R
+        }
+    }
+
+    // The transformed pixel buffer is created when it is read
+
+    CVPixelBufferRef transformedPixelBuffer = pixelBufferWrapper.transformedPixelBuffer;
+
+    XCTAssert(transformedPixelBuffer != NULL);
+    XCTAssertEqual(CVPixelBufferGetWidth(transformedPixelBuffer), width);
+    XCTAssertEqual(CVPixelBufferGetHeight(transformedPixelBuffer), height);
+    XCTAssertEqual(CVPixelBufferGetPixelFormatType(transformedPixelBuffer), kCVPixelFormatType_32BGRA);
+
+    // Free memory
+
+    CFRelease(pixelBuffer);
+}
+
+- (void)testPixelBufferGetBytesRotatedIntoFloat16AndInt8Tensors {
+    // Create ARGB bytes that are upside down, with a width that is not a multiple of the
+    // vectorized row length
+
+    const int width = 20;
+    const int height = 2;
+    const int channels = 4;
+
+    // Create a pixel buffer
+
+    const OSType format = kCVPixelFormatType_32ARGB;
+    CVPixelBufferRef pixelBuffer = NULL;
+
+    CVReturn status = CVPixelBufferCreate(
+        kCFAllocatorDefault,
+        width,
+        height,
+        format,
+        NULL,
+        &pixelBuffer);
+
+    if ( status != kCVReturnSuccess ) {
+        XCTFail(@"Couldn't create pixel buffer");
+    }
+
+    // Fill the pixel buffer with values that identify each pixel
+
+    CVPixelBufferLockBaseAddress(pixelBuffer, kNilOptions);
+    uint8_t *baseAddress = (uint8_t *)CVPixelBufferGetBaseAddress(pixelBuffer);
+    size_t bytesPerRow = CVPixelBufferGetBytesPerRow(pixelBuffer);
+
+    for ( int y = 0; y < height; y++ ) {
+        for ( int x = 0; x < width; x++ ) {
+            uint8_t *pixel = baseAddress + (y * bytesPerRow) + (x * channels);
+
+            pixel[0] = 255;         // A
+            pixel[1] = 2 * x;       // R
+            pixel[2] = 100 + 2 * y; // G
+            pixel[3] = 254;         // B
+        }
+    }
+
+    CVPixelBufferUnlockBaseAddress(pixelBuffer, kNilOptions);
+
+    // Get bytes from the pixel buffer, which the vision pipeline rotates and normalizes directly
+    // into each type of tensor
+
+    TIOPixelBuffer *pixelBufferWrapper = [[TIOPixelBuffer alloc] initWithPixelBuffer:pixelBuffer orientation:kCGImagePropertyOrientationDown];
+    NSArray *shape = @[@(height),@(width),@(3)];
+    TIOImageVolume volume = TIOImageVolumeForShape(shape);
+    TIOPixelNormalization normalization = {
+        .scale = 0.5,
+        .redBias = -1,
+        .greenBias = -1,
+        .blueBias = -1
+    };
+
+    TIOPixelBufferLayerDescription *float16Description = [[TIOPixelBufferLayerDescription alloc]
+        initWithPixelFormat:kCVPixelFormatType_32ARGB
+        shape:shape
+        imageVolume:volume
+        batched:NO
+        dtype:TIODataTypeFloat16
+        normalization:normalization
+        denormalization:kTIOPixelDenormalizationNone
+        quantized:NO];
+
+    TIOPixelBufferLayerDescription *int8Description = [[TIOPixelBufferLayerDescription alloc]
+        initWithPixelFormat:kCVPixelFormatType_32ARGB
+        shape:shape
+        imageVolume:volume
+        batched:NO
+        dtype:TIODataTypeInt8
+        normalization:normalization
+        denormalization:kTIOPixelDenormalizationNone
+        quantized:NO];
+
+    const int tensor_channels = 3;
+
+    NSData *float16Data = [pixelBufferWrapper dataForDescription:float16Description];
+    NSData *int8Data = [pixelBufferWrapper dataForDescription:int8Description];
+
+    XCTAssertEqual(float16Data.length, width * height * tensor_channels * sizeof(TIOFloat16));
+    XCTAssertEqual(int8Data.length, width * height * tensor_channels * sizeof(int8_t));
+
+    const TIOFloat16 *float16Bytes = (const TIOFloat16 *)float16Data.bytes;
+    const int8_t *int8Bytes = (const int8_t *)int8Data.bytes;
+
+    for ( int y = 0; y < height; y++ ) {
+        for ( int x = 0; x < width; x++ ) {
+            const int i = (y * width * tensor_channels) + (x * tensor_channels);
+            int sx = width - 1 - x;
+            int sy = height - 1 - y;
+
+            XCTAssertEqual(TIOFloat32FromFloat16(float16Bytes[i+0]), sx - 1);   // R
+            XCTAssertEqual(TIOFloat32FromFloat16(float16Bytes[i+1]), 49 + sy);  // G
+            XCTAssertEqual(TIOFloat32FromFloat16(float16Bytes[i+2]), 126);      // B
+
+            XCTAssertEqual(int8Bytes[i+0], sx - 1);     // R
+            XCTAssertEqual(int8Bytes[i+1], 49 + sy);    // G
+            XCTAssertEqual(int8Bytes[i+2], 126);        // B
+        }
+    }
+
+    // Free memory
+
+    CFRelease(pixelBuffer);
+}
+
+- (void)testPixelBufferGetBytesQuarterTurnsIntoTensor {
+    // Create ARGB bytes that are twice as wide as they are tall
+
+    const int width = 4;
+    const int height = 2;
+    const int channels = 4;
+
+    // Create a pixel buffer
+
+    const OSType format = kCVPixelFormatType_32ARGB;
+    CVPixelBufferRef pixelBuffer = NULL;
+
+    CVReturn status = CVPixelBufferCreate(
+        kCFAllocatorDefault,
+        width,
+        height,
+        format,
+        NULL,
+        &pixelBuffer);
+
+    if ( status != kCVReturnSuccess ) {
+        XCTFail(@"Couldn't create pixel buffer");
+    }
+
+    // Fill the pixel buffer with values that identify each pixel
+
+    CVPixelBufferLockBaseAddress(pixelBuffer, kNilOptions);
+    uint8_t *baseAddress = (uint8_t *)CVPixelBufferGetBaseAddress(pixelBuffer);
+    size_t bytesPerRow = CVPixelBufferGetBytesPerRow(pixelBuffer);
+
+    for ( int y = 0; y < height; y++ ) {
+        for ( int x = 0; x < width; x++ ) {
+            uint8_t *pixel = baseAddress + (y * bytesPerRow) + (x * channels);
+
+            pixel[0] = 255;         // A
+            pixel[1] = x;           // R
+            pixel[2] = y;           // G
+            pixel[3] = 100 + x + y; // B
+        }
+    }
+
+    CVPixelBufferUnlockBaseAddress(pixelBuffer, kNilOptions);
+
+    // The tensor is as tall as the pixel buffer is wide, so quarter turns fill it without scaling
+
+    NSArray *shape = @[@(width),@(height),@(3)];
+    TIOImageVolume volume = TIOImageVolumeForShape(shape);
+
+    TIOPixelBufferLayerDescription *description = [[TIOPixelBufferLayerDescription alloc]
+        initWithPixelFormat:kCVPixelFormatType_32ARGB
+        shape:shape
+        imageVolume:volume
+        batched:NO
+        dtype:TIODataTypeUnknown
+        normalization:kTIOPixelNormalizationNone
+        denormalization:kTIOPixelDenormalizationNone
+        quantized:NO];
+
+    const int tensor_channels = 3;
+
+    // Rotate 90 degrees counterclockwise, so that the right column of the pixel buffer becomes the top row
+
+    TIOPixelBuffer *leftWrapper = [[TIOPixelBuffer alloc] initWithPixelBuffer:pixelBuffer orientation:kCGImagePropertyOrientationLeft];
+    NSData *leftData = [leftWrapper dataForDescription:description];
+    float_t *left_bytes = (float_t *)leftData.bytes;
+
+    for ( int y = 0; y < width; y++ ) {
+        for ( int x = 0; x < height; x++ ) {
+            float_t *pixel = left_bytes + (y * height * tensor_channels) + (x * tensor_channels);
+            int sx = width - 1 - y;
+            int sy = x;
+
+            XCTAssertEqual(pixel[0], sx);               // R
+            XCTAssertEqual(pixel[1], sy);               // G
+            XCTAssertEqual(pixel[2], 100 + sx + sy);    // B
+        }
+    }
+
+    // Rotate 270 degrees counterclockwise, so that the left column of the pixel buffer becomes the top row
+
+    TIOPixelBuffer *rightWrapper = [[TIOPixelBuffer alloc] initWithPixelBuffer:pixelBuffer orientation:kCGImagePropertyOrientationRight];
+    NSData *rightData = [rightWrapper dataForDescription:description];
+    float_t *right_bytes = (float_t *)rightData.bytes;
+
+    for ( int y = 0; y < width; y++ ) {
+        for ( int x = 0; x < height; x++ ) {
+            float_t *pixel = right_bytes + (y * height * tensor_channels) + (x * tensor_channels);
+            int sx = y;
+            int sy = height - 1 - x;
+
+            XCTAssertEqual(pixel[0], sx);               // R
+            XCTAssertEqual(pixel[1], sy);               // G
+            XCTAssertEqual(pixel[2], 100 + sx + sy);    // B
+        }
+    }
+
+    // The transformed pixel buffer has the tensor's dimensions
+
+    CVPixelBufferRef transformedPixelBuffer = rightWrapper.transformedPixelBuffer;
+
+    XCTAssert(transformedPixelBuffer != NULL);
+    XCTAssertEqual(CVPixelBufferGetWidth(transformedPixelBuffer), height);
+    XCTAssertEqual(CVPixelBufferGetHeight(transformedPixelBuffer), width);
+
+    // Free memory
+
+    CFRelease(pixelBuffer);
+}
+
+- (void)testPixelBufferGetBytesCenterCroppedAndScaledDownIntoTensor {
+    // Create ARGB bytes that are twice as wide as they are tall and four times the size of the tensor
+
+    const int width = 8;
+    const int height = 4;
+    const int channels = 4;
+
+    // Create a pixel buffer
+
+    const OSType format = kCVPixelFormatType_32ARGB;
+    CVPixelBufferRef pixelBuffer = NULL;
+
+    CVReturn status = CVPixelBufferCreate(
+        kCFAllocatorDefault,
+        width,
+        height,
+        format,
+        NULL,
+        &pixelBuffer);
+
+    if ( status != kCVReturnSuccess ) {
+        XCTFail(@"Couldn't create pixel buffer");
+    }
+
+    // Fill the pixel buffer with values that change with every pixel
+
+    CVPixelBufferLockBaseAddress(pixelBuffer, kNilOptions);
+    uint8_t *baseAddress = (uint8_t *)CVPixelBufferGetBaseAddress(pixelBuffer);
+    size_t bytesPerRow = CVPixelBufferGetBytesPerRow(pixelBuffer);
+
+    for ( int y = 0; y < height; y++ ) {
+        for ( int x = 0; x < width; x++ ) {
+            uint8_t *pixel = baseAddress + (y * bytesPerRow) + (x * channels);
+
+            pixel[0] = 255;                     // A
+            pixel[1] = 10 * x;                  // R
+            pixel[2] = 10 * y;                  // G
+            pixel[3] = 100 + 10 * x + 10 * y;   // B
+        }
+    }
+
+    CVPixelBufferUnlockBaseAddress(pixelBuffer, kNilOptions);
+
+    // Center crop the middle four columns and scale them down, averaging each 2x2 block of pixels
+
+    TIOPixelBuffer *pixelBufferWrapper = [[TIOPixelBuffer alloc] initWithPixelBuffer:pixelBuffer orientation:kCGImagePropertyOrientationUp];
+    NSArray *shape = @[@(2),@(2),@(3)];
+    TIOImageVolume volume = TIOImageVolumeForShape(shape);
+
+    TIOPixelBufferLayerDescription *description = [[TIOPixelBufferLayerDescription alloc]
+        initWithPixelFormat:kCVPixelFormatType_32ARGB
+        shape:shape
+        imageVolume:volume
+        batched:NO
+        dtype:TIODataTypeUnknown
+        normalization:kTIOPixelNormalizationNone
+        denormalization:kTIOPixelDenormalizationNone
+        resizeMode:TIOPixelBufferResizeModeCenterCrop
+        interpolation:TIOPixelBufferInterpolationArea
+        quantized:NO];
+
+    const int tensor_channels = 3;
+
+    NSData *data = [pixelBufferWrapper dataForDescription:description];
+    float_t *tensor_bytes = (float_t *)data.bytes;
+
+    for ( int y = 0; y < 2; y++ ) {
+        for ( int x = 0; x < 2; x++ ) {
+            float_t *pixel = tensor_bytes + (y * 2 * tensor_channels) + (x * tensor_channels);
+
+            // Source columns 2+2x and 3+2x, rows 2y and 1+2y
+
+            float_t r = 10 * (2.5 + 2 * x);
+            float_t g = 10 * (0.5 + 2 * y);
+
+            XCTAssertEqual(pixel[0], r);            // R
+            XCTAssertEqual(pixel[1], g);            // G
+            XCTAssertEqual(pixel[2], 100 + r + g);  // B
+        }
+    }
+
+    // Free memory
+
+    CFRelease(pixelBuffer);
+}
+
+- (void)testPixelBufferGetBytesScaledLikeEarlierVersionsByDefault {
+    // Create ARGB bytes that are twice as wide as they are tall and four times the size of the tensor
+
+    const int width = 8;
+    const int height = 4;
+    const int channels = 4;
+
+    // Create a pixel buffer
+
+    const OSType format = kCVPixelFormatType_32ARGB;
+    CVPixelBufferRef pixelBuffer = NULL;
+
+    CVReturn status = CVPixelBufferCreate(
+        kCFAllocatorDefault,
+        width,
+        height,
+        format,
+        NULL,
+        &pixelBuffer);
+
+    if ( status != kCVReturnSuccess ) {
+        XCTFail(@"Couldn't create pixel buffer");
+    }
+
+    // Fill the pixel buffer with values that change with every pixel
+
+    CVPixelBufferLockBaseAddress(pixelBuffer, kNilOptions);
+    uint8_t *baseAddress = (uint8_t *)CVPixelBufferGetBaseAddress(pixelBuffer);
+    size_t bytesPerRow = CVPixelBufferGetBytesPerRow(pixelBuffer);
+
+    for ( int y = 0; y < height; y++ ) {
+        for ( int x = 0; x < width; x++ ) {
+            uint8_t *pixel = baseAddress + (y * bytesPerRow) + (x * channels);
+
+            pixel[0] = 255;                     // A
+            pixel[1] = 30 * x;                  // R
+            pixel[2] = 60 * y;                  // G
+            pixel[3] = 255 - 20 * x - 10 * y;   // B
+        }
+    }
+
+    CVPixelBufferUnlockBaseAddress(pixelBuffer, kNilOptions);
+
+    // The default description center crops and scales with vImage, as earlier versions did
+
+    TIOPixelBuffer *pixelBufferWrapper = [[TIOPixelBuffer alloc] initWithPixelBuffer:pixelBuffer orientation:kCGImagePropertyOrientationUp];
+    NSArray *shape = @[@(2),@(2),@(3)];
+    TIOImageVolume volume = TIOImageVolumeForShape(shape);
+
+    TIOPixelBufferLayerDescription *description = [[TIOPixelBufferLayerDescription alloc]
+        initWithPixelFormat:kCVPixelFormatType_32ARGB
+        shape:shape
+        imageVolume:volume
+        batched:NO
+        dtype:TIODataTypeUnknown
+        normalization:kTIOPixelNormalizationNone
+        denormalization:kTIOPixelDenormalizationNone
+        quantized:NO];
+
+    XCTAssertEqual(description.interpolation, TIOPixelBufferInterpolationLanczos);
+
+    CVPixelBufferRef resizedPixelBuffer = TIOCVPixelBufferResizeToSquare(pixelBuffer, CGSizeMake(2, 2));
+    XCTAssert(resizedPixelBuffer != NULL);
+
+    const int tensor_channels = 3;
+
+    NSData *data = [pixelBufferWrapper dataForDescription:description];
+    float_t *tensor_bytes = (float_t *)data.bytes;
+
+    CVPixelBufferLockBaseAddress(resizedPixelBuffer, kCVPixelBufferLock_ReadOnly);
+    uint8_t *resizedAddress = (uint8_t *)CVPixelBufferGetBaseAddress(resizedPixelBuffer);
+    size_t resizedBytesPerRow = CVPixelBufferGetBytesPerRow(resizedPixelBuffer);
+
+    for ( int y = 0; y < 2; y++ ) {
+        for ( int x = 0; x < 2; x++ ) {
+            float_t *pixel = tensor_bytes + (y * 2 * tensor_channels) + (x * tensor_channels);
+            uint8_t *resized = resizedAddress + (y * resizedBytesPerRow) + (x * channels);
+
+            XCTAssertEqual(pixel[0], resized[1]);   // R
+            XCTAssertEqual(pixel[1], resized[2]);   // G
+            XCTAssertEqual(pixel[2], resized[3]);   // B
+        }
+    }
+
+    // The transformed pixel buffer has the same pixels as the vImage resize
+
+    CVPixelBufferRef transformedPixelBuffer = pixelBufferWrapper.transformedPixelBuffer;
+
+    XCTAssert(transformedPixelBuffer != NULL);
+
+    CVPixelBufferLockBaseAddress(transformedPixelBuffer, kCVPixelBufferLock_ReadOnly);
+    uint8_t *transformedAddress = (uint8_t *)CVPixelBufferGetBaseAddress(transformedPixelBuffer);
+    size_t transformedBytesPerRow = CVPixelBufferGetBytesPerRow(transformedPixelBuffer);
+
+    for ( int y = 0; y < 2; y++ ) {
+        XCTAssertEqual(memcmp(transformedAddress + (y * transformedBytesPerRow), resizedAddress + (y * resizedBytesPerRow), 2 * channels), 0);
+    }
+
+    CVPixelBufferUnlockBaseAddress(transformedPixelBuffer, kCVPixelBufferLock_ReadOnly);
+    CVPixelBufferUnlockBaseAddress(resizedPixelBuffer, kCVPixelBufferLock_ReadOnly);
+
+    // Free memory
+
+    CVPixelBufferRelease(resizedPixelBuffer);
+    CFRelease(pixelBuffer);
+}
+
+- (void)testPixelBufferGetBytesLetterboxedIntoTensor {
+    // Create ARGB bytes that are twice as wide as they are tall
+
+    const int width = 4;
+    const int height = 2;
+    const int channels = 4;
+
+    // Create a pixel buffer
+
+    const OSType format = kCVPixelFormatType_32ARGB;
+    CVPixelBufferRef pixelBuffer = NULL;
+
+    CVReturn status = CVPixelBufferCreate(
+        kCFAllocatorDefault,
+        width,
+        height,
+        format,
+        NULL,
+        &pixelBuffer);
+
+    if ( status != kCVReturnSuccess ) {
+        XCTFail(@"Couldn't create pixel buffer");
+    }
+
+    // Fill the pixel buffer with values that identify each pixel
+
+    CVPixelBufferLockBaseAddress(pixelBuffer, kNilOptions);
+    uint8_t *baseAddress = (uint8_t *)CVPixelBufferGetBaseAddress(pixelBuffer);
+    size_t bytesPerRow = CVPixelBufferGetBytesPerRow(pixelBuffer);
+
+    for ( int y = 0; y < height; y++ ) {
+        for ( int x = 0; x < width; x++ ) {
+            uint8_t *pixel = baseAddress + (y * bytesPerRow) + (x * channels);
+
+            pixel[0] = 255;         // A
+            pixel[1] = 10 + x;      // R
+            pixel[2] = 20 + y;      // G
+            pixel[3] = 100 + x + y; // B
+        }
+    }
+
+    CVPixelBufferUnlockBaseAddress(pixelBuffer, kNilOptions);
+
+    // Letterbox the pixels into a square tensor, which pads a row of black above and below them
+
+    TIOPixelBuffer *pixelBufferWrapper = [[TIOPixelBuffer alloc] initWithPixelBuffer:pixelBuffer orientation:kCGImagePropertyOrientationUp];
+    NSArray *shape = @[@(width),@(width),@(3)];
+    TIOImageVolume volume = TIOImageVolumeForShape(shape);
+
+    TIOPixelBufferLayerDescription *description = [[TIOPixelBufferLayerDescription alloc]
+        initWithPixelFormat:kCVPixelFormatType_32ARGB
+        shape:shape
+        imageVolume:volume
+        batched:NO
+        dtype:TIODataTypeUnknown
+        normalization:kTIOPixelNormalizationNone
+        denormalization:kTIOPixelDenormalizationNone
+        resizeMode:TIOPixelBufferResizeModeLetterbox
+        interpolation:TIOPixelBufferInterpolationNearest
+        quantized:NO];
+
+    const int tensor_channels = 3;
+
+    NSData *data = [pixelBufferWrapper dataForDescription:description];
+    float_t *tensor_bytes = (float_t *)data.bytes;
+
+    for ( int y = 0; y < width; y++ ) {
+        for ( int x = 0; x < width; x++ ) {
+            float_t *pixel = tensor_bytes + (y * width * tensor_channels) + (x * tensor_channels);
+
+            if ( y == 0 || y == width - 1 ) {
+                XCTAssertEqual(pixel[0], 0);
+                XCTAssertEqual(pixel[1], 0);
+                XCTAssertEqual(pixel[2], 0);
+            } else {
+                int sy = y - 1;
+
+                XCTAssertEqual(pixel[0], 10 + x);       // R
+                XCTAssertEqual(pixel[1], 20 + sy);      // G
+                XCTAssertEqual(pixel[2], 100 + x + sy); // B
+            }
+        }
+    }
+
+    // The transformed pixel buffer is letterboxed the same way, with opaque padding
+
+    CVPixelBufferRef transformedPixelBuffer = pixelBufferWrapper.transformedPixelBuffer;
+
+    XCTAssert(transformedPixelBuffer != NULL);
+    XCTAssertEqual(CVPixelBufferGetWidth(transformedPixelBuffer), width);
+    XCTAssertEqual(CVPixelBufferGetHeight(transformedPixelBuffer), width);
+
+    CVPixelBufferLockBaseAddress(transformedPixelBuffer, kCVPixelBufferLock_ReadOnly);
+    uint8_t *transformedAddress = (uint8_t *)CVPixelBufferGetBaseAddress(transformedPixelBuffer);
+    size_t transformedBytesPerRow = CVPixelBufferGetBytesPerRow(transformedPixelBuffer);
+
+    uint8_t *padding = transformedAddress;
+    uint8_t *content = transformedAddress + transformedBytesPerRow + (2 * channels);
+
+    XCTAssertEqual(padding[0], 255);
+    XCTAssertEqual(padding[1], 0);
+    XCTAssertEqual(padding[2], 0);
+    XCTAssertEqual(padding[3], 0);
+
+    XCTAssertEqual(content[0], 255);
+    XCTAssertEqual(content[1], 12);
+    XCTAssertEqual(content[2], 20);
+    XCTAssertEqual(content[3], 102);
+
+    CVPixelBufferUnlockBaseAddress(transformedPixelBuffer, kCVPixelBufferLock_ReadOnly);
+
+    // Free memory
+
+    CFRelease(pixelBuffer);
+}
+
+// MARK: - TIOPixelBuffer + TIOTFLiteData Pixel Buffer Pool
+
+- (void)testPixelBufferPoolReusesMemory {
+    TIOPixelBufferPool *pool = [[TIOPixelBufferPool alloc] initWithCapacity:1];
+
+    // Rows are padded to 64 bytes and memory is aligned
+
+    CVPixelBufferRef pixelBuffer = [pool createPixelBufferWithWidth:10 height:4 pixelFormat:kCVPixelFormatType_32BGRA];
+
+    XCTAssert(pixelBuffer != NULL);
+    XCTAssertEqual(CVPixelBufferGetWidth(pixelBuffer), 10);
+    XCTAssertEqual(CVPixelBufferGetHeight(pixelBuffer), 4);
+    XCTAssertEqual(CVPixelBufferGetBytesPerRow(pixelBuffer), 64);
+
+    CVPixelBufferLockBaseAddress(pixelBuffer, kCVPixelBufferLock_ReadOnly);
+    void *baseAddress = CVPixelBufferGetBaseAddress(pixelBuffer);
+    XCTAssertEqual((uintptr_t)baseAddress % 64, 0);
+    CVPixelBufferUnlockBaseAddress(pixelBuffer, kCVPixelBufferLock_ReadOnly);
+
+    CVPixelBufferRelease(pixelBuffer);
+
+    // A pixel buffer of the same size and format reuses the memory
+
+    pixelBuffer = [pool createPixelBufferWithWidth:10 height:4 pixelFormat:kCVPixelFormatType_32BGRA];
+
+    CVPixelBufferLockBaseAddress(pixelBuffer, kCVPixelBufferLock_ReadOnly);
+    XCTAssertEqual(CVPixelBufferGetBaseAddress(pixelBuffer), baseAddress);
+    CVPixelBufferUnlockBaseAddress(pixelBuffer, kCVPixelBufferLock_ReadOnly);
+
+    CVPixelBufferRelease(pixelBuffer);
+
+    XCTAssertEqual(pool.stats.hits, 1);
+    XCTAssertEqual(pool.stats.misses, 1);
+
+    // Another format misses, and returning it evicts the idle block
+
+    pixelBuffer = [pool createPixelBufferWithWidth:10 height:4 pixelFormat:kCVPixelFormatType_32ARGB];
+    CVPixelBufferRelease(pixelBuffer);
+
+    XCTAssertEqual(pool.stats.hits, 1);
+    XCTAssertEqual(pool.stats.misses, 2);
+    XCTAssertEqual(pool.stats.evictions, 1);
+}
+
+- (void)testPixelBufferInitWithBytesIsRowAligned {
+    // Create uint8 BGR bytes whose width is not a multiple of 16
+
+    const int width = 10;
+    const int height = 2;
+    const int channels = 3;
+
+    size_t size = width*height*channels*sizeof(uint8_t);
+    uint8_t *bytes = (uint8_t *)malloc(size);
+
+    for ( int i = 0; i < width * height; i++) {
+        uint8_t *pixel = bytes + (i * channels);
+
+        pixel[0] = 1; // B
+        pixel[1] = 2; // G
+        pixel[2] = 3; // R
+    }
+
+    // Create a pixel buffer from them
+
+    NSArray *shape = @[@(height),@(width),@(channels)];
+    TIOImageVolume volume = TIOImageVolumeForShape(shape);
+
+    TIOPixelBufferLayerDescription *description = [[TIOPixelBufferLayerDescription alloc]
+        initWithPixelFormat:kCVPixelFormatType_32BGRA
+        shape:shape
+        imageVolume:volume
+        batched:NO
+        dtype:TIODataTypeUnknown
+        normalization:kTIOPixelNormalizationNone
+        denormalization:kTIOPixelDenormalizationNone
+        quantized:YES];
+
+    NSData *data = [NSData dataWithBytes:bytes length:size];
+    TIOPixelBuffer *pixelBufferWrapper = [[TIOPixelBuffer alloc] initWithData:data description:description];
+    CVPixelBufferRef pixelBuffer = pixelBufferWrapper.pixelBuffer;
+
+    // Rows are padded, and every pixel is written
+
+    size_t bytesPerRow = CVPixelBufferGetBytesPerRow(pixelBuffer);
+    XCTAssertEqual(bytesPerRow % 64, 0);
+
+    CVPixelBufferLockBaseAddress(pixelBuffer, kNilOptions);
+    uint8_t *pixel_bytes = (uint8_t *)CVPixelBufferGetBaseAddress(pixelBuffer);
+
+    const int pixel_channels = 4;
+
+    for ( int y = 0; y < height; y++ ) {
+        for ( int x = 0; x < width; x++ ) {
+            uint8_t *pixel = pixel_bytes + (y * bytesPerRow) + (x * pixel_channels);
+
+            XCTAssertEqual(pixel[0], 1);    // B
+            XCTAssertEqual(pixel[1], 2);    // G
+            XCTAssertEqual(pixel[2], 3);    // R
+            XCTAssertEqual(pixel[3], 255);  // A
+        }
+    }
+
+    // Free memory
+
+    CVPixelBufferUnlockBaseAddress(pixelBuffer, kNilOptions);
+    free(bytes);
+}
+
 @end
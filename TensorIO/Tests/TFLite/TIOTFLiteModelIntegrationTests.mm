@@ -271,6 +271,17 @@
     XCTAssert([output[@"output1"] isEqualToNumber:@(240)]);
     XCTAssert([output[@"output2"] isEqualToNumber:@(64)]);
     }
+    
+    // Selecting a single output
+    
+    {
+    NSDictionary *output = (NSDictionary *)[model runOn:vectorInputs outputs:@[@"output2"] error:&error];
+    
+    XCTAssertNil(error);
+    XCTAssert(output.count == 1);
+    XCTAssertNil(output[@"output1"]);
+    XCTAssert([output[@"output2"] isEqualToNumber:@(64)]);
+    }
 }
 
 - (void)test2x2MatricesModel {
@@ -917,4 +928,314 @@
     }
 }
 
+- (void)testBatchedMobileNetClassificationModel {
+    TIOModelBundle *bundle = [self bundleWithName:@"mobilenet_v2_1.4_224.tiobundle"];
+    id<TIOModel> model = [self loadModelFromBundle:bundle];
+    
+    XCTAssertNotNil(bundle);
+    XCTAssertNotNil(model);
+    
+    UIImage *image = [UIImage imageNamed:@"example-image"];
+    TIOPixelBuffer *imageFeature = [[TIOPixelBuffer alloc] initWithPixelBuffer:image.pixelBuffer orientation:kCGImagePropertyOrientationUp];
+    
+    TIOBatch *batch = [[TIOBatch alloc] initWithItems:@[
+        @{@"image": imageFeature},
+        @{@"image": imageFeature},
+        @{@"image": imageFeature}
+    ]];
+    
+    // Run the batch twice, the second run reuses the interpreter sized for three items
+    
+    for ( int run = 0; run < 2; run++ ) {
+        NSError *error;
+        NSArray<NSDictionary*> *output = (NSArray *)[model run:batch error:&error];
+        
+        XCTAssertNil(error);
+        XCTAssert([output isKindOfClass:NSArray.class]);
+        XCTAssert(output.count == 3);
+        
+        for ( NSDictionary *itemOutput in output ) {
+            NSDictionary *top5 = [itemOutput[@"classification"] topN:5 threshold:0.1];
+            XCTAssert(top5.count == 1);
+            XCTAssert([top5.allKeys containsObject:@"rocking chair"]);
+        }
+    }
+}
+
+// MARK: - Concurrency Tests
+
+- (void)testInterpreterPoolConcurrentInference {
+    TIOModelBundle *bundle = [self bundleWithName:@"1_in_1_out_number_test.tiobundle"];
+    TIOTFLiteModel *model = (TIOTFLiteModel *)[bundle newModel];
+    
+    XCTAssertNotNil(bundle);
+    XCTAssertNotNil(model);
+    
+    model.interpreterPoolSize = 4;
+    XCTAssert([model load:nil]);
+    
+    const size_t iterations = 64;
+    __block BOOL failed = NO;
+    
+    dispatch_apply(iterations, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t i) {
+        NSError *error;
+        NSDictionary *output = (NSDictionary *)[model runOn:@(2) error:&error];
+        
+        if ( error != nil || ![output[@"output"] isEqualToNumber:@(25)] ) {
+            failed = YES;
+        }
+    });
+    
+    XCTAssertFalse(failed);
+    
+    TIOTFLiteInterpreterPoolStats stats = model.interpreterPoolStats;
+    
+    XCTAssert(stats.interpreters >= 1 && stats.interpreters <= 4);
+    XCTAssert(stats.checkouts == iterations + 1); // includes the checkout made by load
+    XCTAssert(stats.timeouts == 0);
+}
+
+- (void)testPipelinedInference {
+    TIOModelBundle *bundle = [self bundleWithName:@"1_in_1_out_number_test.tiobundle"];
+    TIOTFLiteModel *model = (TIOTFLiteModel *)[bundle newModel];
+    
+    XCTAssertNotNil(bundle);
+    XCTAssertNotNil(model);
+    
+    model.pipelineDepth = 4;
+    XCTAssert([model load:nil]);
+    
+    NSMutableArray<NSNumber*> *results = [[NSMutableArray alloc] init];
+    NSMutableArray<XCTestExpectation*> *expectations = [[NSMutableArray alloc] init];
+    
+    for ( NSUInteger i = 0; i < 4; i++ ) {
+        XCTestExpectation *expectation = [self expectationWithDescription:@"pipelined inference"];
+        [expectations addObject:expectation];
+        
+        [model runOn:@(i) completion:^(id<TIOData> _Nullable output, NSError * _Nullable error) {
+            XCTAssertNil(error);
+            [results addObject:((NSDictionary *)output)[@"output"]];
+            [expectation fulfill];
+        }];
+    }
+    
+    [self waitForExpectations:expectations timeout:10.0 enforceOrder:YES];
+    
+    // The model squares its input after adding 3, and completions arrive in submission order
+    
+    XCTAssertEqualObjects(results, (@[@(9), @(16), @(25), @(36)]));
+    
+    TIOTFLitePipelineStats stats = model.pipelineStats;
+    
+    XCTAssert(stats.submitted == 4);
+    XCTAssert(stats.completed == 4);
+    XCTAssert(stats.dropped == 0);
+    XCTAssert(stats.invokeTime > 0);
+}
+
+- (void)testPipelineRefusesInputsWhenFull {
+    TIOModelBundle *bundle = [self bundleWithName:@"1_in_1_out_number_test.tiobundle"];
+    TIOTFLiteModel *model = (TIOTFLiteModel *)[bundle newModel];
+    
+    model.pipelineDepth = 1;
+    XCTAssert([model load:nil]);
+    
+    const NSUInteger submissions = 8;
+    dispatch_group_t group = dispatch_group_create();
+    __block BOOL failed = NO;
+    
+    for ( NSUInteger i = 0; i < submissions; i++ ) {
+        dispatch_group_enter(group);
+        [model runOn:@(2) completion:^(id<TIOData> _Nullable output, NSError * _Nullable error) {
+            if ( error != nil ? error != kTIOTFLiteModelPipelineFullError : ![((NSDictionary *)output)[@"output"] isEqualToNumber:@(25)] ) {
+                failed = YES;
+            }
+            dispatch_group_leave(group);
+        }];
+    }
+    
+    XCTAssert(dispatch_group_wait(group, dispatch_time(DISPATCH_TIME_NOW, 10 * NSEC_PER_SEC)) == 0);
+    XCTAssertFalse(failed);
+    
+    TIOTFLitePipelineStats stats = model.pipelineStats;
+    
+    XCTAssert(stats.submitted >= 1);
+    XCTAssert(stats.submitted + stats.dropped == submissions);
+    XCTAssert(stats.completed == stats.submitted);
+}
+
+- (void)testPipelineDepthIsFixedAfterTheFirstSubmission {
+    TIOModelBundle *bundle = [self bundleWithName:@"1_in_1_out_number_test.tiobundle"];
+    TIOTFLiteModel *model = (TIOTFLiteModel *)[bundle newModel];
+    
+    model.pipelineDepth = 1;
+    XCTAssert([model load:nil]);
+    
+    XCTestExpectation *expectation = [self expectationWithDescription:@"pipelined inference"];
+    
+    [model runOn:@(2) completion:^(id<TIOData> _Nullable output, NSError * _Nullable error) {
+        XCTAssertNil(error);
+        [expectation fulfill];
+    }];
+    
+    [self waitForExpectations:@[expectation] timeout:10.0];
+    
+    model.pipelineDepth = 4;
+    XCTAssert(model.pipelineDepth == 1);
+}
+
+- (void)testUnloadDuringConcurrentInference {
+    TIOModelBundle *bundle = [self bundleWithName:@"1_in_1_out_number_test.tiobundle"];
+    TIOTFLiteModel *model = (TIOTFLiteModel *)[bundle newModel];
+    
+    XCTAssertNotNil(bundle);
+    XCTAssertNotNil(model);
+    
+    model.interpreterPoolSize = 4;
+    XCTAssert([model load:nil]);
+    
+    // Runs that overlap an unload finish on the interpreters they checked out, or fail to check
+    // one out with an error, but never produce a wrong output
+    
+    const size_t iterations = 64;
+    __block BOOL failed = NO;
+    
+    dispatch_apply(iterations, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t i) {
+        if ( i % 8 == 0 ) {
+            [model unload];
+            return;
+        }
+        
+        NSError *error;
+        NSDictionary *output = (NSDictionary *)[model runOn:@(2) error:&error];
+        
+        if ( error != nil ? error != kTIOTFLiteModelUnloadedError : ![output[@"output"] isEqualToNumber:@(25)] ) {
+            failed = YES;
+        }
+    });
+    
+    XCTAssertFalse(failed);
+    
+    // The model may be reloaded afterwards
+    
+    NSError *error;
+    NSDictionary *output = (NSDictionary *)[model runOn:@(3) error:&error];
+    XCTAssertNil(error);
+    XCTAssert([output[@"output"] isEqualToNumber:@(36)]);
+}
+
+// MARK: - Shared Model Tests
+
+- (void)testInstancesFromTheSameBundleShareTheLoadedModel {
+    TIOModelBundle *bundle = [self bundleWithName:@"1_in_1_out_number_test.tiobundle"];
+    TIOTFLiteModel *model1 = (TIOTFLiteModel *)[bundle newModel];
+    TIOTFLiteModel *model2 = (TIOTFLiteModel *)[bundle newModel];
+    NSError *error;
+    
+    XCTAssert([model1 load:nil]);
+    XCTAssert([model2 load:nil]);
+    
+    NSDictionary *output1 = (NSDictionary *)[model1 runOn:@(2) error:&error];
+    XCTAssertNil(error);
+    XCTAssert([output1[@"output"] isEqualToNumber:@(25)]);
+    
+    // Unloading one instance leaves the shared model in place for the other
+    
+    [model1 unload];
+    
+    NSDictionary *output2 = (NSDictionary *)[model2 runOn:@(3) error:&error];
+    XCTAssertNil(error);
+    XCTAssert([output2[@"output"] isEqualToNumber:@(36)]);
+    
+    // And the model may be reloaded after every instance has released it
+    
+    [model2 unload];
+    
+    output1 = (NSDictionary *)[model1 runOn:@(2) error:&error];
+    XCTAssertNil(error);
+    XCTAssert([output1[@"output"] isEqualToNumber:@(25)]);
+}
+
+// MARK: - Warmup Tests
+
+- (void)testWarmupRecordsLoadAndInferenceLatencies {
+    TIOModelBundle *bundle = [self bundleWithName:@"1_in_1_out_number_test.tiobundle"];
+    TIOTFLiteModel *model = (TIOTFLiteModel *)[bundle newModel];
+    NSError *error;
+    
+    model.warmupIterations = 2;
+    
+    XCTAssert([model load:&error]);
+    XCTAssertNil(error);
+    
+    XCTAssertGreaterThan(model.loadLatency, 0);
+    XCTAssertGreaterThan(model.warmupLatency, 0);
+    XCTAssertGreaterThan(model.coldInferenceLatency, 0);
+    XCTAssertGreaterThan(model.warmInferenceLatency, 0);
+    
+    // Warming up does not disturb inference
+    
+    NSDictionary *output = (NSDictionary *)[model runOn:@(2) error:&error];
+    XCTAssertNil(error);
+    XCTAssert([output[@"output"] isEqualToNumber:@(25)]);
+}
+
+- (void)testWithoutWarmupTheFirstRunIsCold {
+    TIOModelBundle *bundle = [self bundleWithName:@"1_in_1_out_number_test.tiobundle"];
+    TIOTFLiteModel *model = (TIOTFLiteModel *)[bundle newModel];
+    NSError *error;
+    
+    XCTAssert([model load:&error]);
+    XCTAssertGreaterThan(model.loadLatency, 0);
+    XCTAssertEqual(model.warmupLatency, 0);
+    XCTAssertEqual(model.coldInferenceLatency, 0);
+    
+    [model runOn:@(2) error:&error];
+    XCTAssertNil(error);
+    XCTAssertGreaterThan(model.coldInferenceLatency, 0);
+    XCTAssertEqual(model.warmInferenceLatency, 0);
+}
+
+// MARK: - Tensor View Tests
+
+- (void)testTensorViews1In1OutNumberModel {
+    TIOModelBundle *bundle = [self bundleWithName:@"1_in_1_out_number_test.tiobundle"];
+    TIOTFLiteModel *model = (TIOTFLiteModel *)[self loadModelFromBundle:bundle];
+    NSError *error;
+    
+    XCTAssertNotNil(bundle);
+    XCTAssertNotNil(model);
+    
+    NSDictionary<NSString*,TIOTensorView*> *views = [model runViewsOn:@(2) error:&error];
+    TIOTensorView *view = views[@"output"];
+    
+    XCTAssertNil(error);
+    XCTAssert(views.count == 1);
+    XCTAssertNotNil(view);
+    XCTAssert(view.isValid);
+    XCTAssert(view.dtype == TIODataTypeFloat32);
+    XCTAssert(view.count == 1);
+    XCTAssert(view.length == sizeof(float_t));
+    XCTAssertEqual(((float_t *)view.bytes)[0], 25);
+    
+    // A copied view owns its bytes and survives the next run
+    
+    TIOTensorView *copy = [view copy];
+    
+    [model runViewsOn:@(3) error:&error];
+    
+    XCTAssertFalse(view.isValid);
+    XCTAssert(copy.isValid);
+    XCTAssertEqual(((float_t *)copy.bytes)[0], 25);
+    XCTAssert([(NSNumber *)copy.data isEqualToNumber:@(25)]);
+    
+    // Copying an invalidated view does not copy any bytes and the copy remains invalid
+    
+    TIOTensorView *invalidCopy = [view copy];
+    
+    XCTAssertNotNil(invalidCopy);
+    XCTAssertFalse(invalidCopy.isValid);
+    XCTAssert(invalidCopy.bytes == NULL);
+}
+
 @end
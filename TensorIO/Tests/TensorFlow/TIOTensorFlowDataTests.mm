@@ -41,6 +41,7 @@ namespace tensorflow {
 - (nullable instancetype)initWithTensor:(tensorflow::Tensor)tensor description:(id<TIOLayerDescription>)description;
 - (tensorflow::Tensor)tensorWithDescription:(id<TIOLayerDescription>)description;
 + (tensorflow::Tensor)tensorWithColumn:(NSArray<id<TIOTensorFlowData>>*)column description:(id<TIOLayerDescription>)description;
++ (void)fillTensor:(tensorflow::Tensor &)tensor withColumn:(NSArray<id<TIOTensorFlowData>>*)column description:(id<TIOLayerDescription>)description;
 
 @end
 
@@ -49,6 +50,7 @@ namespace tensorflow {
 - (nullable instancetype)initWithTensor:(tensorflow::Tensor)tensor description:(id<TIOLayerDescription>)description;
 - (tensorflow::Tensor)tensorWithDescription:(id<TIOLayerDescription>)description;
 + (tensorflow::Tensor)tensorWithColumn:(NSArray<id<TIOTensorFlowData>>*)column description:(id<TIOLayerDescription>)description;
++ (void)fillTensor:(tensorflow::Tensor &)tensor withColumn:(NSArray<id<TIOTensorFlowData>>*)column description:(id<TIOLayerDescription>)description;
 
 @end
 
@@ -57,6 +59,7 @@ namespace tensorflow {
 - (nullable instancetype)initWithTensor:(tensorflow::Tensor)tensor description:(id<TIOLayerDescription>)description;
 - (tensorflow::Tensor)tensorWithDescription:(id<TIOLayerDescription>)description;
 + (tensorflow::Tensor)tensorWithColumn:(NSArray<id<TIOTensorFlowData>>*)column description:(id<TIOLayerDescription>)description;
++ (void)fillTensor:(tensorflow::Tensor &)tensor withColumn:(NSArray<id<TIOTensorFlowData>>*)column description:(id<TIOLayerDescription>)description;
 
 @end
 
@@ -65,6 +68,7 @@ namespace tensorflow {
 - (nullable instancetype)initWithTensor:(tensorflow::Tensor)tensor description:(id<TIOLayerDescription>)description;
 - (tensorflow::Tensor)tensorWithDescription:(id<TIOLayerDescription>)description;
 + (tensorflow::Tensor)tensorWithColumn:(NSArray<id<TIOTensorFlowData>>*)column description:(id<TIOLayerDescription>)description;
++ (void)fillTensor:(tensorflow::Tensor &)tensor withColumn:(NSArray<id<TIOTensorFlowData>>*)column description:(id<TIOLayerDescription>)description;
 
 @end
 
@@ -73,6 +77,7 @@ namespace tensorflow {
 - (nullable instancetype)initWithTensor:(tensorflow::Tensor)tensor description:(id<TIOLayerDescription>)description;
 - (tensorflow::Tensor)tensorWithDescription:(id<TIOLayerDescription>)description;
 + (tensorflow::Tensor)tensorWithColumn:(NSArray<id<TIOTensorFlowData>>*)column description:(id<TIOLayerDescription>)description;
++ (void)fillTensor:(tensorflow::Tensor &)tensor withColumn:(NSArray<id<TIOTensorFlowData>>*)column description:(id<TIOLayerDescription>)description;
 
 @end
 
@@ -269,6 +274,29 @@ namespace tensorflow {
     XCTAssertEqual(maped(1,0), 4.0f);
 }
 
+- (void)testBatchNumberFillTensorWritesInPlace {
+    // It should overwrite the values of an existing tensor without reallocating it
+    
+    TIOVectorLayerDescription *description = [[TIOVectorLayerDescription alloc]
+        initWithShape:@[@(-1),@(1)]
+        batched:YES
+        dtype:TIODataTypeUnknown
+        labels:nil
+        quantized:NO
+        quantizer:nil
+        dequantizer:nil];
+    
+    tensorflow::Tensor tensor = [NSNumber tensorWithColumn:@[@(2.0f), @(4.0f)] description:description];
+    const void *data = tensor.tensor_data().data();
+    
+    [NSNumber fillTensor:tensor withColumn:@[@(6.0f), @(8.0f)] description:description];
+    auto maped = tensor.tensor<float_t, 2>();
+    
+    XCTAssertEqual(tensor.tensor_data().data(), data);
+    XCTAssertEqual(maped(0,0), 6.0f);
+    XCTAssertEqual(maped(1,0), 8.0f);
+}
+
 - (void)testBatchNumberGetTensorUInt8QuantizedWithoutQuantizer {
     // It should get the uint8_t numeric values
     
@@ -571,6 +599,37 @@ namespace tensorflow {
     XCTAssertEqual(tensor_mapped(0,2), 255);
 }
 
+- (void)testArrayGetTensorInt8QuantizedWithQuantizer {
+    // It should quantize the float_t numeric values about the zero point to int8_t values
+    
+    TIODataAffineQuantization quantization = {
+        .scale = 0.5,
+        .zero_point = -10
+    };
+    
+    TIOVectorLayerDescription *description = [[TIOVectorLayerDescription alloc]
+        initWithShape:@[@(1),@(3)]
+        batched:NO
+        dtype:TIODataTypeInt8
+        labels:nil
+        quantized:YES
+        quantizer:TIODataQuantizerWithAffineQuantization(quantization, TIODataTypeInt8)
+        dequantizer:TIODataDequantizerWithAffineQuantization(quantization, TIODataTypeInt8)];
+    
+    NSArray *numbers = @[ @(-1.0f), @(0.0f), @(1.0f)];
+    tensorflow::Tensor tensor = [numbers tensorWithDescription:description];
+    XCTAssert(tensor.dtype() == tensorflow::DT_INT8);
+    
+    auto tensor_mapped = tensor.tensor<int8_t, 2>();
+    
+    XCTAssertEqual(tensor_mapped(0,0), -12);
+    XCTAssertEqual(tensor_mapped(0,1), -10);
+    XCTAssertEqual(tensor_mapped(0,2), -8);
+    
+    NSArray *result = [[NSArray alloc] initWithTensor:tensor description:description];
+    XCTAssertEqualObjects(result, numbers);
+}
+
 - (void)testArrayGetTensorInt32 {
     const int32_t min32bit = std::numeric_limits<int32_t>::min();
     const int32_t max32bit = std::numeric_limits<int32_t>::max();
@@ -613,6 +672,32 @@ namespace tensorflow {
     XCTAssertEqual(tensor_mapped(0,1), max64bit);
 }
 
+- (void)testArrayGetTensorFloat16 {
+    // It should narrow the numeric values to half precision
+    
+    TIOVectorLayerDescription *description = [[TIOVectorLayerDescription alloc]
+        initWithShape:@[@(1),@(3)]
+        batched:NO
+        dtype:TIODataTypeFloat16
+        labels:nil
+        quantized:NO
+        quantizer:nil
+        dequantizer:nil];
+    
+    NSArray *numbers = @[ @(-1.0f), @(0.5f), @(2.0f)];
+    tensorflow::Tensor tensor = [numbers tensorWithDescription:description];
+    XCTAssert(tensor.dtype() == tensorflow::DT_HALF);
+    
+    auto tensor_mapped = tensor.tensor<Eigen::half, 2>();
+    
+    XCTAssertEqual((float)tensor_mapped(0,0), -1.0f);
+    XCTAssertEqual((float)tensor_mapped(0,1), 0.5f);
+    XCTAssertEqual((float)tensor_mapped(0,2), 2.0f);
+    
+    NSArray *result = [[NSArray alloc] initWithTensor:tensor description:description];
+    XCTAssertEqualObjects(result, numbers);
+}
+
 // MARK: - Batched
 
 - (void)testBatchArrayGetTensorFloatUnquantized {
@@ -762,6 +847,43 @@ namespace tensorflow {
     XCTAssertEqual(tensor_mapped(1,1), max64bit-1);
 }
 
+- (void)testBatchArrayGetTensorPreparesItemsConcurrently {
+    // It should write every item to its own slice of the tensor when items are prepared in parallel
+    
+    const NSUInteger concurrency = TIOTensorFlowModel.inputPreparationConcurrency;
+    TIOTensorFlowModel.inputPreparationConcurrency = 4;
+    
+    TIOVectorLayerDescription *description = [[TIOVectorLayerDescription alloc]
+        initWithShape:@[@(-1),@(256)]
+        batched:YES
+        dtype:TIODataTypeUnknown
+        labels:nil
+        quantized:NO
+        quantizer:nil
+        dequantizer:nil];
+    
+    NSMutableArray *column = NSMutableArray.array;
+    
+    for ( NSUInteger item = 0; item < 64; item++ ) {
+        NSMutableArray *values = NSMutableArray.array;
+        for ( NSUInteger value = 0; value < 256; value++ ) {
+            [values addObject:@((float_t)(item * 256 + value))];
+        }
+        [column addObject:values];
+    }
+    
+    tensorflow::Tensor tensor = [NSArray tensorWithColumn:column description:description];
+    auto tensor_mapped = tensor.tensor<float_t, 2>();
+    
+    for ( NSUInteger item = 0; item < 64; item++ ) {
+        for ( NSUInteger value = 0; value < 256; value++ ) {
+            XCTAssertEqual(tensor_mapped(item,value), (float_t)(item * 256 + value));
+        }
+    }
+    
+    TIOTensorFlowModel.inputPreparationConcurrency = concurrency;
+}
+
 // MARK: - NSArray + TIOTensorFlowData Init with Tensor
 
 - (void)testArrayInitWithTensorFloatUnquantized {
@@ -150,6 +150,50 @@
     XCTAssert([vectorResults[@"output"] isEqualToNumber:@(25)]);
 }
 
+- (void)test1In1OutNumberModelWarmsUp {
+    TIOModelBundle *bundle = [self bundleWithName:@"1_in_1_out_number_test.tiobundle"];
+    TIOTensorFlowModel *model = (TIOTensorFlowModel *)[bundle newModel];
+    NSError *error;
+    
+    model.warmupIterations = 2;
+    
+    XCTAssert([model load:&error]);
+    XCTAssertNil(error);
+    
+    XCTAssertGreaterThan(model.loadLatency, 0);
+    XCTAssertGreaterThan(model.warmupLatency, 0);
+    XCTAssertGreaterThan(model.coldInferenceLatency, 0);
+    XCTAssertGreaterThan(model.warmInferenceLatency, 0);
+    
+    NSDictionary *results = (NSDictionary *)[model runOn:@(2) error:&error];
+    
+    XCTAssertNil(error);
+    XCTAssert([results[@"output"] isEqualToNumber:@(25)]);
+}
+
+- (void)test1In1OutNumberModelWithSessionOptions {
+    TIOModelBundle *bundle = [self bundleWithName:@"1_in_1_out_number_test.tiobundle"];
+    TIOTensorFlowModel *model = (TIOTensorFlowModel *)[bundle newModel];
+    NSError *error;
+    
+    XCTAssertNotNil(model.sessionOptions);
+    
+    model.sessionOptions = [[TIOModelSessionOptions alloc] initWithIntraOpThreads:1 interOpThreads:1 optimizerLevel:TIOModelOptimizerLevelL1 constantFolding:@(YES)];
+    
+    XCTAssert([model load:&error]);
+    XCTAssertNil(error);
+    
+    NSDictionary *results = (NSDictionary *)[model runOn:@(2) error:&error];
+    
+    XCTAssertNil(error);
+    XCTAssert([results[@"output"] isEqualToNumber:@(25)]);
+    
+    // Resetting the override restores the bundle's options
+    
+    model.sessionOptions = nil;
+    XCTAssertEqual(model.sessionOptions, model.options.session);
+}
+
 // MARK: - Vector, Matrix, Tensor Tests
 
 - (void)test1x1VectorsModel {
@@ -230,6 +274,17 @@
     XCTAssert(byteResults.count == 2);
     XCTAssert([byteResults[@"output1"] isEqualToNumber:@(240)]);
     XCTAssert([byteResults[@"output2"] isEqualToNumber:@(64)]);
+    
+    // Selecting a single output
+    
+    {
+    NSDictionary *output = (NSDictionary *)[model runOn:vectorInputs outputs:@[@"output2"] error:&error];
+    
+    XCTAssertNil(error);
+    XCTAssert(output.count == 1);
+    XCTAssertNil(output[@"output1"]);
+    XCTAssert([output[@"output2"] isEqualToNumber:@(64)]);
+    }
 }
 
 - (void)test2x2MatricesModel {
@@ -925,6 +980,48 @@
     XCTAssert([results[@"output2"] isEqualToNumber:@(64)]);
 }
 
+- (void)test1x1x2VectorsModelReusesTensors {
+    TIOModelBundle *bundle = [self bundleWithName:@"1_in_1_placeholder_2_out_vectors_test.tiobundle"];
+    TIOTensorFlowModel *model = (TIOTensorFlowModel *)[bundle newModel];
+    NSError *error;
+    
+    XCTAssert([model load:&error]);
+    XCTAssertNil(error);
+    
+    NSDictionary *inputs = @{
+        @"input1": @[@1,  @2,  @3,  @4]
+    };
+    NSDictionary *placeholders1 = @{
+        @"input2": @[@10, @20, @30, @40]
+    };
+    NSDictionary *placeholders2 = @{
+        @"input2": @[@5,  @6,  @7,  @8]
+    };
+    
+    // An unchanged placeholder is fed as is, a changed one is rewritten in place
+    
+    NSDictionary *results1 = (NSDictionary *)[model runOn:inputs placeholders:placeholders1 error:&error];
+    NSDictionary *results2 = (NSDictionary *)[model runOn:inputs placeholders:placeholders1 error:&error];
+    NSDictionary *results3 = (NSDictionary *)[model runOn:inputs placeholders:placeholders2 error:&error];
+    NSDictionary *results4 = (NSDictionary *)[model runOn:inputs placeholders:placeholders1 error:&error];
+    
+    XCTAssertNil(error);
+    XCTAssertEqualObjects(results1, results2);
+    XCTAssertNotEqualObjects(results1, results3);
+    XCTAssertEqualObjects(results1, results4);
+    
+    TIOTensorFlowTensorPoolStats stats = model.tensorPoolStats;
+    
+    XCTAssert(stats.allocations == 2);
+    XCTAssert(stats.reuses == 5);
+    XCTAssert(stats.unchanged == 1);
+    
+    // Unloading the model releases its tensors
+    
+    [model unload];
+    XCTAssert(model.tensorPoolStats.allocations == 0);
+}
+
 // MARK: - Tree Tests
 
 - (void)testTreeModelPredicts {
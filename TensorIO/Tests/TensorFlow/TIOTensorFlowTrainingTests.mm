@@ -128,6 +128,47 @@
     XCTAssertNotEqualObjects(results0, results1);
 }
 
+- (void)testTrainCatsDogsModelWithFusedStep {
+    TIOModelBundle *bundle = [self bundleWithName:@"cats-vs-dogs-train.tiobundle"];
+    TIOTensorFlowModel *model = (TIOTensorFlowModel *)[self loadModelFromBundle:bundle];
+    
+    XCTAssertNotNil(bundle);
+    XCTAssertNotNil(model);
+    
+    model.fusesTrainingStep = YES;
+    
+    TIOPixelBuffer *cat = [[TIOPixelBuffer alloc] initWithPixelBuffer:[self imageNamed:@"cat.jpg"].pixelBuffer orientation:kCGImagePropertyOrientationUp];
+    TIOPixelBuffer *dog = [[TIOPixelBuffer alloc] initWithPixelBuffer:[self imageNamed:@"dog.jpg"].pixelBuffer orientation:kCGImagePropertyOrientationUp];
+    
+    TIOBatch *batch = [[TIOBatch alloc] initWithKeys:@[@"image", @"labels"]];
+    
+    [batch addItem:@{
+        @"image": cat,
+        @"labels": @(0)
+    }];
+    
+    [batch addItem:@{
+        @"image": dog,
+        @"labels": @(1)
+    }];
+    
+    for (NSUInteger epoch = 0; epoch < 3; epoch++) {
+        NSError *error;
+        NSDictionary *results = (NSDictionary *)[model train:batch error:&error];
+        
+        XCTAssertNil(error);
+        XCTAssert([results[@"sigmoid_cross_entropy_loss/value"] isKindOfClass:NSNumber.class]);
+    }
+    
+    // Training without fetching the outputs returns no results
+    
+    NSError *error;
+    NSDictionary *results = (NSDictionary *)[model train:batch placeholders:nil fetchOutputs:NO error:&error];
+    
+    XCTAssertNil(error);
+    XCTAssert(results.count == 0);
+}
+
 - (void)testTrainCatsDogsWithPlaceholderModel {
     TIOModelBundle *bundle = [self bundleWithName:@"cats-vs-dogs-train-with-placeholder.tiobundle"];
     id<TIOTrainableModel> model = (id<TIOTrainableModel>)[self loadModelFromBundle:bundle];
@@ -223,6 +264,82 @@
     XCTAssert([contents containsObject:@"checkpoint.data-00000-of-00001"]);
 }
 
+- (void)testExportsModelInTheBackground {
+    TIOModelBundle *bundle = [self bundleWithName:@"cats-vs-dogs-train.tiobundle"];
+    TIOTensorFlowModel *model = (TIOTensorFlowModel *)[self loadModelFromBundle:bundle];
+    
+    XCTAssertNotNil(bundle);
+    XCTAssertNotNil(model);
+    
+    NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:NSUUID.UUID.UUIDString];
+    [NSFileManager.defaultManager createDirectoryAtPath:path withIntermediateDirectories:YES attributes:nil error:nil];
+    NSURL *directory = [NSURL fileURLWithPath:path];
+    
+    // The export should report the size of each file it wrote
+    
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Export completes"];
+    
+    [model exportTo:directory completion:^(NSDictionary<NSString*,NSNumber*> * _Nullable fileSizes, NSError * _Nullable error) {
+        XCTAssertNil(error);
+        XCTAssertGreaterThan(fileSizes[@"checkpoint.index"].unsignedLongLongValue, 0);
+        XCTAssertGreaterThan(fileSizes[@"checkpoint.data-00000-of-00001"].unsignedLongLongValue, 0);
+        [expectation fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:10 handler:nil];
+    
+    // The files should match those written by the saver
+    
+    NSError *error;
+    NSString *savedPath = [NSTemporaryDirectory() stringByAppendingPathComponent:NSUUID.UUID.UUIDString];
+    [NSFileManager.defaultManager createDirectoryAtPath:savedPath withIntermediateDirectories:YES attributes:nil error:nil];
+    
+    XCTAssertTrue([model exportTo:[NSURL fileURLWithPath:savedPath] error:&error]);
+    XCTAssertNil(error);
+    
+    NSData *exported = [NSData dataWithContentsOfFile:[path stringByAppendingPathComponent:@"checkpoint.data-00000-of-00001"]];
+    NSData *saved = [NSData dataWithContentsOfFile:[savedPath stringByAppendingPathComponent:@"checkpoint.data-00000-of-00001"]];
+    
+    XCTAssertEqualObjects(exported, saved);
+}
+
+// MARK: - Batched Inference
+
+- (void)testBatchedPredictionMatchesPerItemPrediction {
+    TIOModelBundle *bundle = [self bundleWithName:@"cats-vs-dogs-predict.tiobundle"];
+    id<TIOModel> model = [self loadModelFromBundle:bundle];
+    NSError *error;
+    
+    XCTAssertNotNil(bundle);
+    XCTAssertNotNil(model);
+    
+    TIOPixelBuffer *cat = [[TIOPixelBuffer alloc] initWithPixelBuffer:[self imageNamed:@"cat.jpg"].pixelBuffer orientation:kCGImagePropertyOrientationUp];
+    TIOPixelBuffer *dog = [[TIOPixelBuffer alloc] initWithPixelBuffer:[self imageNamed:@"dog.jpg"].pixelBuffer orientation:kCGImagePropertyOrientationUp];
+    
+    TIOBatch *batch = [[TIOBatch alloc] initWithKeys:@[@"image"]];
+    
+    [batch addItem:@{
+        @"image": cat
+    }];
+    
+    [batch addItem:@{
+        @"image": dog
+    }];
+    
+    NSArray<NSDictionary*> *results = (NSArray<NSDictionary*> *)[model run:batch error:&error];
+    
+    XCTAssertNil(error);
+    XCTAssert([results isKindOfClass:NSArray.class]);
+    XCTAssert(results.count == 2);
+    
+    NSDictionary *catResults = (NSDictionary *)[model runOn:cat error:&error];
+    NSDictionary *dogResults = (NSDictionary *)[model runOn:dog error:&error];
+    
+    XCTAssertNil(error);
+    XCTAssertEqualWithAccuracy([results[0][@"sigmoid"] floatValue], [catResults[@"sigmoid"] floatValue], 0.0001);
+    XCTAssertEqualWithAccuracy([results[1][@"sigmoid"] floatValue], [dogResults[@"sigmoid"] floatValue], 0.0001);
+}
+
 // MARK: - Model Trainer
 
 - (void)testModelTrainer {